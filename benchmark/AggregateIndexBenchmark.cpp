@@ -0,0 +1,124 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <vector>
+
+#include <TreeDS/index>
+#include <TreeDS/tree>
+
+using namespace std;
+using namespace md;
+
+class AggregateIndexBenchmark : public QObject {
+
+    Q_OBJECT
+
+    // 1000000 nodes attached to the previous one 15 times out of 16
+    nary_tree<long> tree;
+    // Positions (in pre-order) and values of the modifications
+    vector<pair<size_t, long>> edits;
+
+    private slots:
+    void initTestCase();
+    void build();
+    void incremental();
+    void recomputeEverything();
+};
+
+// The baseline: the sum of every subtree computed again with a post-order pass
+long sum_everything(const nary_tree<long>& tree, vector<long>& sums) {
+    size_t i = 0u;
+    for (auto it = tree.begin(policy::post_order()); it != tree.end(policy::post_order()); ++it, ++i) {
+        sums[i] = *it;
+    }
+    // Each node adds its sum to the one of its parent, which comes later in post-order
+    vector<pair<const nary_node<long>*, size_t>> open;
+    i = 0u;
+    for (auto it = tree.begin(policy::post_order()); it != tree.end(policy::post_order()); ++it, ++i) {
+        const nary_node<long>* node = it.get_raw_node();
+        while (!open.empty() && open.back().first->get_parent() == node) {
+            sums[i] += sums[open.back().second];
+            open.pop_back();
+        }
+        open.emplace_back(node, i);
+    }
+    return sums[i - 1u];
+}
+
+void AggregateIndexBenchmark::initTestCase() {
+    mt19937 random(1);
+    const int size = 1000000;
+    vector<long> values(size);
+    vector<int> parents(size);
+    parents[0] = -1;
+    for (int i = 1; i < size; ++i) {
+        values[i]  = static_cast<long>(random() % 1000);
+        parents[i] = random() % 16 != 0 ? i - 1 : static_cast<int>(random() % i);
+    }
+    this->tree = nary_tree<long>::from_parent_indices(values, parents);
+    for (int i = 0; i < 100; ++i) {
+        this->edits.emplace_back(random() % this->tree.size(), static_cast<long>(random() % 1000));
+    }
+}
+
+void AggregateIndexBenchmark::build() {
+    QBENCHMARK {
+        aggregate_index<nary_tree<long>, sum_monoid<long>> index(this->tree);
+        QCOMPARE(index.size(), this->tree.size());
+    }
+}
+
+// 100 modifications each, the sum of the tree is read after each one
+void AggregateIndexBenchmark::incremental() {
+    nary_tree<long> copy(this->tree);
+    vector<nary_node<long>*> nodes;
+    for (auto it = copy.begin(policy::pre_order()); it != copy.end(policy::pre_order()); ++it) {
+        nodes.push_back(it.get_raw_node());
+    }
+    change_log<nary_node<long>> log;
+    copy.set_change_log(&log);
+    aggregate_index<nary_tree<long>, sum_monoid<long>> index(copy);
+    long checksum = 0;
+    QBENCHMARK {
+        for (const auto& [position, value] : this->edits) {
+            if (position % 2u == 0u) {
+                nodes[position]->get_value() = value;
+                log.touch(*nodes[position]);
+            } else {
+                copy.emplace_child_back(copy.root().other_node(nodes[position]), value);
+            }
+            index.update(log);
+            log.clear();
+            checksum += index.aggregate();
+        }
+    }
+    QVERIFY(checksum > 0);
+    vector<long> sums(copy.size());
+    QCOMPARE(index.aggregate(), sum_everything(copy, sums));
+    copy.set_change_log(nullptr);
+}
+
+void AggregateIndexBenchmark::recomputeEverything() {
+    nary_tree<long> copy(this->tree);
+    vector<nary_node<long>*> nodes;
+    for (auto it = copy.begin(policy::pre_order()); it != copy.end(policy::pre_order()); ++it) {
+        nodes.push_back(it.get_raw_node());
+    }
+    vector<long> sums;
+    long checksum = 0;
+    QBENCHMARK {
+        for (const auto& [position, value] : this->edits) {
+            if (position % 2u == 0u) {
+                nodes[position]->get_value() = value;
+            } else {
+                copy.emplace_child_back(copy.root().other_node(nodes[position]), value);
+            }
+            sums.resize(copy.size());
+            checksum += sum_everything(copy, sums);
+        }
+    }
+    QVERIFY(checksum > 0);
+}
+
+QTEST_MAIN(AggregateIndexBenchmark)
+
+#include "AggregateIndexBenchmark.moc"
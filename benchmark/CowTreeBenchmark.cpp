@@ -0,0 +1,94 @@
+#include <QtTest/QtTest>
+#include <random>
+
+#include <TreeDS/tree>
+
+using namespace std;
+using namespace md;
+
+class CowTreeBenchmark : public QObject {
+
+    Q_OBJECT
+
+    // 100 blocks of 300 statements having 3 children each, about 120k nodes
+    nary_tree<int> tree;
+
+    private slots:
+    void initTestCase();
+    void copyNaryTree();
+    void copyCowTree();
+    void requestsNaryTree();
+    void requestsCowTree();
+};
+
+void CowTreeBenchmark::initTestCase() {
+    tree_builder<nary_tree<int>> builder;
+    builder.open(0);
+    for (int i = 0; i < 100; ++i) {
+        builder.open(i);
+        for (int j = 0; j < 300; ++j) {
+            builder.open(j);
+            builder.leaf(1);
+            builder.leaf(2);
+            builder.leaf(3);
+            builder.close();
+        }
+        builder.close();
+    }
+    builder.close();
+    this->tree = builder.build();
+}
+
+void CowTreeBenchmark::copyNaryTree() {
+    QBENCHMARK {
+        nary_tree<int> copy(this->tree);
+        QCOMPARE(copy.size(), this->tree.size());
+    }
+}
+
+void CowTreeBenchmark::copyCowTree() {
+    const cow_tree<nary_tree<int>> shared(this->tree);
+    QBENCHMARK {
+        cow_tree<nary_tree<int>> copy(shared);
+        QCOMPARE(copy.size(), this->tree.size());
+    }
+}
+
+// 1000 requests, each one copies the tree, reads a statement and one in 20 modifies it
+void CowTreeBenchmark::requestsNaryTree() {
+    mt19937 random(1);
+    long sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            nary_tree<int> copy(this->tree);
+            const nary_node<int>* statement = copy.raw_root_node()->get_child(random() % 100)->get_child(random() % 300);
+            sum += statement->get_first_child()->get_value();
+            if (i % 20 == 0) {
+                copy.emplace_child_back(copy.root().other_node(const_cast<nary_node<int>*>(statement)), 4);
+            }
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+void CowTreeBenchmark::requestsCowTree() {
+    const cow_tree<nary_tree<int>> shared(this->tree);
+    mt19937 random(1);
+    long sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            cow_tree<nary_tree<int>> copy(shared);
+            const nary_node<int>* statement = copy.raw_root_node()->get_child(random() % 100)->get_child(random() % 300);
+            sum += statement->get_first_child()->get_value();
+            if (i % 20 == 0) {
+                copy.emplace_child_back(copy.croot().other_node(statement), 4);
+            }
+        }
+    }
+    QVERIFY(sum > 0);
+    QVERIFY(!shared.is_shared());
+}
+
+QTEST_MAIN(CowTreeBenchmark)
+
+#include "CowTreeBenchmark.moc"
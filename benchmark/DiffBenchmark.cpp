@@ -0,0 +1,115 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <vector>
+
+#include <TreeDS/tree>
+
+using namespace std;
+using namespace md;
+
+class DiffBenchmark : public QObject {
+
+    Q_OBJECT
+
+    // Tree shaped like a source file: 500 functions of 100 statements, about 370k nodes
+    nary_tree<int> before;
+    // The same tree after a few hundred localized edits
+    nary_tree<int> after;
+
+    private slots:
+    void initTestCase();
+    void copy();
+    void diffEqual();
+    void diffEdited();
+    void applyScript();
+};
+
+void DiffBenchmark::initTestCase() {
+    mt19937 random(1);
+    tree_builder<nary_tree<int>> builder;
+    auto expression = [&](auto& self, int depth) -> void {
+        const int value = static_cast<int>(random() % 1000);
+        if (depth == 0 || random() % 3 == 0) {
+            builder.leaf(value);
+            return;
+        }
+        builder.open(value);
+        self(self, depth - 1);
+        self(self, depth - 1);
+        builder.close();
+    };
+    builder.open(0);
+    for (int i = 0; i < 500; ++i) {
+        builder.open(1);
+        for (int j = 0; j < 100; ++j) {
+            builder.open(2);
+            expression(expression, 3);
+            builder.close();
+        }
+        builder.close();
+    }
+    builder.close();
+    this->before = builder.build();
+    this->after  = this->before;
+    // Values changed, statements inserted, removed and moved to another function
+    for (int i = 0; i < 100; ++i) {
+        nary_node<int>* function = this->after.raw_root_node()->get_child(random() % 500);
+        nary_node<int>* statement = function->get_child(random() % function->children());
+        statement->get_first_child()->get_value() = -i;
+        auto position = this->after.root().other_node(function);
+        this->after.insert_child(position, random() % (function->children() + 1u), n(2)(n(-i)(n(3), n(4))));
+        if (function->children() > 1u) {
+            this->after.erase(
+                this->after.begin(policy::post_order()).other_node(function->get_child(random() % function->children())));
+        }
+        nary_node<int>* target = this->after.raw_root_node()->get_child(random() % 500);
+        auto moved             = this->after.detach_subtree(this->after.root().other_node(function->get_first_child()));
+        this->after.insert_child(
+            this->after.root().other_node(target),
+            random() % (target->children() + 1u),
+            std::move(moved));
+    }
+}
+
+// Linear baseline: the cost of visiting and allocating every node once
+void DiffBenchmark::copy() {
+    QBENCHMARK {
+        nary_tree<int> copy(this->before);
+        QCOMPARE(copy.size(), this->before.size());
+    }
+}
+
+void DiffBenchmark::diffEqual() {
+    nary_tree<int> copy(this->before);
+    QBENCHMARK {
+        QVERIFY(diff(this->before, copy).empty());
+    }
+}
+
+void DiffBenchmark::diffEdited() {
+    edit_script<int> script;
+    QBENCHMARK {
+        script = diff(this->before, this->after);
+    }
+    // About 400 edits were made (some overlapping), they must be found without replacing whole functions
+    QVERIFY(script.size() <= 600u);
+    size_t inserted = 0u;
+    for (const edit_operation<int>& operation : script) {
+        inserted += operation.subtree.size();
+    }
+    QVERIFY(inserted <= 1000u);
+}
+
+void DiffBenchmark::applyScript() {
+    const edit_script<int> script = diff(this->before, this->after);
+    nary_tree<int> tree;
+    QBENCHMARK {
+        tree = this->before;
+        md::apply(tree, script);
+    }
+    QVERIFY(tree == this->after);
+}
+
+QTEST_MAIN(DiffBenchmark)
+
+#include "DiffBenchmark.moc"
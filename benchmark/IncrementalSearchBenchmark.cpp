@@ -0,0 +1,114 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <vector>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+#include "Trees.hpp"
+
+using namespace std;
+using namespace md;
+
+class IncrementalSearchBenchmark : public QObject {
+
+    Q_OBJECT
+
+    change_log<nary_node<char>> log;
+    nary_tree<char> tree;
+    // Nodes whose value is edited
+    vector<nary_node<char>*> edited;
+
+    private slots:
+    void initTestCase();
+    void fullSearch();
+    void incrementalUpdate();
+    void internalNodeErase();
+    void cleanupTestCase();
+};
+
+// Random tree of 1000000 nodes having values from 'a' to 'j'
+void IncrementalSearchBenchmark::initTestCase() {
+    const int size = 1000000;
+    this->tree     = random_tree(1, size);
+    this->tree.set_change_log(&this->log);
+    vector<nary_node<char>*> nodes;
+    for (auto it = this->tree.begin(policy::pre_order()); it != this->tree.end(policy::pre_order()); ++it) {
+        nodes.push_back(it.get_raw_node());
+    }
+    mt19937 random(2);
+    for (int i = 0; i < 100; ++i) {
+        this->edited.push_back(nodes[random() % size]);
+    }
+}
+
+// Values modified through nodes are not seen by the tree, they are reported to the log
+void edit(change_log<nary_node<char>>& log, nary_node<char>* node) {
+    node->get_value() = node->get_value() == 'b' ? 'a' : 'b';
+    log.touch(*node);
+}
+
+void IncrementalSearchBenchmark::fullSearch() {
+    pattern p(one('a')(one('b'), star()));
+    size_t index = 0;
+    size_t matches = 0;
+    QBENCHMARK {
+        edit(this->log, this->edited[index++ % this->edited.size()]);
+        this->log.clear();
+        matches = 0;
+        for (const auto& match : p.search_all(this->tree)) {
+            (void)match;
+            ++matches;
+        }
+    }
+    QVERIFY(matches > 0u);
+}
+
+void IncrementalSearchBenchmark::incrementalUpdate() {
+    pattern p(one('a')(one('b'), star()));
+    this->log.clear();
+    incremental_search matches(p, this->tree);
+    size_t index = 0;
+    QBENCHMARK {
+        edit(this->log, this->edited[index++ % this->edited.size()]);
+        matches.update(this->log);
+        this->log.clear();
+    }
+    size_t expected = 0;
+    for (const auto& match : p.search_all(this->tree)) {
+        (void)match;
+        ++expected;
+    }
+    QCOMPARE(matches.size(), expected);
+}
+
+// Erasing a node having children makes the tree forget its size, the update must not count the nodes again
+void IncrementalSearchBenchmark::internalNodeErase() {
+    pattern p(one('a')(one('b'), star()));
+    this->log.clear();
+    incremental_search matches(p, this->tree);
+    size_t index = 0;
+    QBENCHMARK {
+        auto position = this->tree.begin(policy::fixed()).other_node(this->edited[index++ % this->edited.size()]);
+        auto inserted = this->tree.insert_child_back(position, n('a')(n('b')));
+        matches.update(this->log);
+        this->log.clear();
+        this->tree.erase(inserted.other_policy(policy::post_order()));
+        matches.update(this->log);
+        this->log.clear();
+    }
+    size_t expected = 0;
+    for (const auto& match : p.search_all(this->tree)) {
+        (void)match;
+        ++expected;
+    }
+    QCOMPARE(matches.size(), expected);
+}
+
+void IncrementalSearchBenchmark::cleanupTestCase() {
+    this->tree.set_change_log(nullptr);
+}
+
+QTEST_MAIN(IncrementalSearchBenchmark)
+
+#include "IncrementalSearchBenchmark.moc"
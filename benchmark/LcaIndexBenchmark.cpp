@@ -0,0 +1,165 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <vector>
+
+#include <TreeDS/index>
+#include <TreeDS/tree>
+
+using namespace std;
+using namespace md;
+
+class LcaIndexBenchmark : public QObject {
+
+    Q_OBJECT
+
+    // 10000000 nodes attached to the previous one 15 times out of 16, about 250 levels deep on average
+    nary_tree<int> tree;
+    lca_index<nary_tree<int>> index;
+    // Random pairs of nodes queried
+    vector<pair<const nary_node<int>*, const nary_node<int>*>> queries;
+
+    private slots:
+    void initTestCase();
+    void build1M();
+    void build10M();
+    void lowestCommonAncestor();
+    void lowestCommonAncestorByNumber();
+    void isAncestor();
+    void walkLowestCommonAncestor();
+    void walkIsAncestor();
+};
+
+nary_tree<int> make_tree(int size) {
+    mt19937 random(1);
+    vector<int> values(size);
+    vector<int> parents(size);
+    parents[0] = -1;
+    for (int i = 1; i < size; ++i) {
+        values[i]  = i;
+        parents[i] = random() % 16 != 0 ? i - 1 : static_cast<int>(random() % i);
+    }
+    return nary_tree<int>::from_parent_indices(values, parents);
+}
+
+size_t depth(const nary_node<int>* node) {
+    size_t result = 0u;
+    for (; node->get_parent() != nullptr; node = node->get_parent()) {
+        ++result;
+    }
+    return result;
+}
+
+// The baseline: walk up to the same depth, then up together
+const nary_node<int>* walk_lca(const nary_node<int>* a, const nary_node<int>* b) {
+    size_t depth_a = depth(a);
+    size_t depth_b = depth(b);
+    for (; depth_a > depth_b; --depth_a) {
+        a = a->get_parent();
+    }
+    for (; depth_b > depth_a; --depth_b) {
+        b = b->get_parent();
+    }
+    while (a != b) {
+        a = a->get_parent();
+        b = b->get_parent();
+    }
+    return a;
+}
+
+void LcaIndexBenchmark::initTestCase() {
+    this->tree = make_tree(10000000);
+    this->index.rebuild(this->tree);
+    vector<const nary_node<int>*> nodes;
+    nodes.reserve(this->tree.size());
+    for (auto it = this->tree.begin(policy::pre_order()); it != this->tree.end(policy::pre_order()); ++it) {
+        nodes.push_back(it.get_raw_node());
+    }
+    mt19937 random(2);
+    for (int i = 0; i < 1000000; ++i) {
+        this->queries.emplace_back(nodes[random() % nodes.size()], nodes[random() % nodes.size()]);
+    }
+}
+
+void LcaIndexBenchmark::build1M() {
+    const nary_tree<int> small = make_tree(1000000);
+    QBENCHMARK {
+        lca_index index(small);
+        QCOMPARE(index.size(), small.size());
+    }
+}
+
+void LcaIndexBenchmark::build10M() {
+    QBENCHMARK {
+        lca_index index(this->tree);
+        QCOMPARE(index.size(), this->tree.size());
+    }
+}
+
+// 1000000 queries each
+void LcaIndexBenchmark::lowestCommonAncestor() {
+    size_t checksum = 0u;
+    QBENCHMARK {
+        for (const auto& [a, b] : this->queries) {
+            checksum += this->index.lowest_common_ancestor(*a, *b)->get_value();
+        }
+    }
+    QVERIFY(checksum > 0u);
+}
+
+void LcaIndexBenchmark::lowestCommonAncestorByNumber() {
+    mt19937 random(3);
+    vector<pair<uint32_t, uint32_t>> numbers;
+    for (int i = 0; i < 1000000; ++i) {
+        numbers.emplace_back(random() % this->index.size(), random() % this->index.size());
+    }
+    size_t checksum = 0u;
+    QBENCHMARK {
+        for (const auto& [a, b] : numbers) {
+            checksum += this->index.lowest_common_ancestor(a, b);
+        }
+    }
+    QVERIFY(checksum > 0u);
+}
+
+void LcaIndexBenchmark::isAncestor() {
+    size_t count = 0u;
+    QBENCHMARK {
+        for (const auto& [a, b] : this->queries) {
+            count += this->index.is_ancestor(*a, *b);
+        }
+    }
+    QVERIFY(count > 0u);
+}
+
+void LcaIndexBenchmark::walkLowestCommonAncestor() {
+    size_t checksum = 0u;
+    QBENCHMARK {
+        for (const auto& [a, b] : this->queries) {
+            checksum += walk_lca(a, b)->get_value();
+        }
+    }
+    QVERIFY(checksum > 0u);
+    // Same answers
+    for (size_t i = 0u; i < 1000u; ++i) {
+        const auto& [a, b] = this->queries[i];
+        QCOMPARE(this->index.lowest_common_ancestor(*a, *b), walk_lca(a, b));
+    }
+}
+
+void LcaIndexBenchmark::walkIsAncestor() {
+    size_t count = 0u;
+    QBENCHMARK {
+        for (const auto& [a, b] : this->queries) {
+            const nary_node<int>* node = b;
+            while (node != nullptr && node != a) {
+                node = node->get_parent();
+            }
+            count += node == a;
+        }
+    }
+    QVERIFY(count > 0u);
+}
+
+QTEST_MAIN(LcaIndexBenchmark)
+
+#include "LcaIndexBenchmark.moc"
@@ -0,0 +1,157 @@
+#include <QtTest/QtTest>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include <TreeDS/index>
+#include <TreeDS/tree>
+
+using namespace std;
+using namespace md;
+
+// Bytes currently allocated on the heap, every allocation of this program goes through the operators below
+static size_t allocated_bytes = 0u;
+
+void* operator new(size_t size) {
+    // The size is stored in front of the block to be subtracted on delete
+    auto* block = static_cast<max_align_t*>(malloc(sizeof(max_align_t) + size));
+    if (block == nullptr) {
+        throw bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    allocated_bytes += size;
+    return block + 1;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    auto* block = static_cast<max_align_t*>(pointer) - 1;
+    allocated_bytes -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+class LevelAncestorIndexBenchmark : public QObject {
+
+    Q_OBJECT
+
+    // 1000000 nodes: 10 chains of 100000 nodes hanging from the root, with a leaf every 50 nodes
+    nary_tree<int> tree;
+    level_ancestor_index<nary_tree<int>> index;
+    // Random nodes and distances up to their depth
+    vector<pair<const nary_node<int>*, size_t>> queries;
+
+    private slots:
+    void initTestCase();
+    void build();
+    void memory();
+    void indexed();
+    void indexedByNumber();
+    void walkParents();
+};
+
+void LevelAncestorIndexBenchmark::initTestCase() {
+    vector<int> values;
+    vector<int> parents {-1};
+    for (int chain = 0; chain < 10; ++chain) {
+        int previous = 0;
+        for (int i = 0; i < 100000; ++i) {
+            parents.push_back(previous);
+            previous = static_cast<int>(parents.size()) - 1;
+            if (i % 50 == 0) {
+                parents.push_back(previous);
+            }
+        }
+    }
+    values.resize(parents.size());
+    for (size_t i = 0u; i < values.size(); ++i) {
+        values[i] = static_cast<int>(i);
+    }
+    this->tree = nary_tree<int>::from_parent_indices(values, parents);
+    this->index.rebuild(this->tree);
+    vector<const nary_node<int>*> nodes;
+    for (auto it = this->tree.begin(policy::pre_order()); it != this->tree.end(policy::pre_order()); ++it) {
+        nodes.push_back(it.get_raw_node());
+    }
+    mt19937 random(1);
+    for (int i = 0; i < 100000; ++i) {
+        const nary_node<int>* node = nodes[random() % nodes.size()];
+        this->queries.emplace_back(node, random() % (this->index.depth(*node) + 1u));
+    }
+}
+
+void LevelAncestorIndexBenchmark::build() {
+    QBENCHMARK {
+        level_ancestor_index index(this->tree);
+        QCOMPARE(index.size(), this->tree.size());
+    }
+}
+
+// Bytes taken by the index, the numbering (shared with lca_index) included
+void LevelAncestorIndexBenchmark::memory() {
+    const size_t before = allocated_bytes;
+    auto* index         = new level_ancestor_index(this->tree);
+    const size_t used   = allocated_bytes - before;
+    QTest::setBenchmarkResult(static_cast<double>(used), QTest::BytesAllocated);
+    QVERIFY(used < 40u * index->size());
+    delete index;
+}
+
+// 100000 queries each
+void LevelAncestorIndexBenchmark::indexed() {
+    size_t checksum = 0u;
+    QBENCHMARK {
+        for (const auto& [node, k] : this->queries) {
+            checksum += this->index.ancestor(*node, k)->get_value();
+        }
+    }
+    QVERIFY(checksum > 0u);
+}
+
+void LevelAncestorIndexBenchmark::indexedByNumber() {
+    vector<pair<uint32_t, size_t>> numbers;
+    for (const auto& [node, k] : this->queries) {
+        numbers.emplace_back(this->index.id(*node), k);
+    }
+    size_t checksum = 0u;
+    QBENCHMARK {
+        for (const auto& [id, k] : numbers) {
+            checksum += this->index.ancestor(id, k);
+        }
+    }
+    QVERIFY(checksum > 0u);
+}
+
+// Only the first 10000 queries, 10 times less than the others
+void LevelAncestorIndexBenchmark::walkParents() {
+    size_t checksum = 0u;
+    QBENCHMARK {
+        for (size_t i = 0u; i < 10000u; ++i) {
+            const auto& [node, k]          = this->queries[i];
+            const nary_node<int>* ancestor = node;
+            for (size_t j = 0u; j < k; ++j) {
+                ancestor = ancestor->get_parent();
+            }
+            checksum += ancestor->get_value();
+        }
+    }
+    QVERIFY(checksum > 0u);
+    for (size_t i = 0u; i < 1000u; ++i) {
+        const auto& [node, k] = this->queries[i];
+        const nary_node<int>* ancestor = node;
+        for (size_t j = 0u; j < k; ++j) {
+            ancestor = ancestor->get_parent();
+        }
+        QCOMPARE(this->index.ancestor(*node, k), ancestor);
+    }
+}
+
+QTEST_MAIN(LevelAncestorIndexBenchmark)
+
+#include "LevelAncestorIndexBenchmark.moc"
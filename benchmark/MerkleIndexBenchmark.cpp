@@ -0,0 +1,110 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <vector>
+
+#include <TreeDS/index>
+#include <TreeDS/tree>
+
+#include "Trees.hpp"
+
+using namespace std;
+using namespace md;
+
+class MerkleIndexBenchmark : public QObject {
+
+    Q_OBJECT
+
+    // Random tree of 1000000 nodes, its copy and a copy differing only in the value of the last node in pre-order
+    nary_tree<char> tree;
+    nary_tree<char> same;
+    nary_tree<char> different;
+
+    private slots:
+    void initTestCase();
+    void build();
+    void compareSame();
+    void compareDifferent();
+    void hashedSame();
+    void hashedDifferent();
+    void updateAfterEdit();
+};
+
+void MerkleIndexBenchmark::initTestCase() {
+    this->tree      = random_tree(1, 1000000);
+    this->same      = nary_tree<char>(this->tree);
+    this->different = nary_tree<char>(this->tree);
+    nary_node<char>* last = this->different.raw_root_node();
+    while (last->get_last_child() != nullptr) {
+        last = last->get_last_child();
+    }
+    last->get_value() = 'x';
+}
+
+void MerkleIndexBenchmark::build() {
+    QBENCHMARK {
+        merkle_index index(this->tree);
+        QCOMPARE(index.size(), this->tree.size());
+    }
+}
+
+void MerkleIndexBenchmark::compareSame() {
+    bool equal = false;
+    QBENCHMARK {
+        equal = this->tree == this->same;
+    }
+    QVERIFY(equal);
+}
+
+void MerkleIndexBenchmark::compareDifferent() {
+    bool equal = true;
+    QBENCHMARK {
+        equal = this->tree == this->different;
+    }
+    QVERIFY(!equal);
+}
+
+void MerkleIndexBenchmark::hashedSame() {
+    merkle_index index(this->tree);
+    merkle_index other(this->same);
+    bool equal = false;
+    QBENCHMARK {
+        equal = index.equal(other);
+    }
+    QVERIFY(equal);
+}
+
+void MerkleIndexBenchmark::hashedDifferent() {
+    merkle_index index(this->tree);
+    merkle_index other(this->different);
+    bool equal = true;
+    QBENCHMARK {
+        equal = index.equal(other);
+    }
+    QVERIFY(!equal);
+}
+
+// Changes the value of a random node and brings the hashes up to date
+void MerkleIndexBenchmark::updateAfterEdit() {
+    nary_tree<char> edited(this->tree);
+    change_log<nary_node<char>> log;
+    edited.set_change_log(&log);
+    merkle_index index(edited);
+    vector<nary_node<char>*> nodes;
+    for (auto it = edited.begin(policy::pre_order()); it != edited.end(policy::pre_order()); ++it) {
+        nodes.push_back(it.get_raw_node());
+    }
+    mt19937 random(2);
+    QBENCHMARK {
+        nary_node<char>* node = nodes[random() % nodes.size()];
+        node->get_value()     = static_cast<char>('a' + random() % 10);
+        log.touch(*node);
+        index.update(log);
+        log.clear();
+    }
+    QCOMPARE(index.hash(), merkle_index(edited).hash());
+    edited.set_change_log(nullptr);
+}
+
+QTEST_MAIN(MerkleIndexBenchmark)
+
+#include "MerkleIndexBenchmark.moc"
@@ -0,0 +1,90 @@
+#include <QtTest/QtTest>
+
+#include <TreeDS/match>
+#include <TreeDS/parallel>
+#include <TreeDS/tree>
+
+#include "Trees.hpp"
+
+using namespace std;
+using namespace md;
+
+class ParallelSearchBenchmark : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree;
+    size_t expected = 0;
+
+    void search(size_t threads);
+
+    private slots:
+    void initTestCase();
+    void sequential();
+    void threads1();
+    void threads2();
+    void threads4();
+    void threads8();
+    void threads16();
+    void threads32();
+    void threads64();
+};
+
+// Random tree of 4000000 nodes having values from 'a' to 'j'
+void ParallelSearchBenchmark::initTestCase() {
+    this->tree = random_tree(1, 4000000);
+}
+
+void ParallelSearchBenchmark::sequential() {
+    pattern p(one('a')(cpt(one('b')), star()(one('c'))));
+    QBENCHMARK {
+        this->expected = 0;
+        for (const auto& match : p.search_all(this->tree)) {
+            (void)match;
+            ++this->expected;
+        }
+    }
+    QVERIFY(this->expected > 0u);
+}
+
+// The scaling is read comparing the results of the slots, the machine must have enough cores
+void ParallelSearchBenchmark::search(size_t threads) {
+    pattern p(one('a')(cpt(one('b')), star()(one('c'))));
+    size_t matches = 0;
+    QBENCHMARK {
+        matches = p.search_all(this->tree, parallel(threads)).size();
+    }
+    QCOMPARE(matches, this->expected);
+}
+
+void ParallelSearchBenchmark::threads1() {
+    this->search(1u);
+}
+
+void ParallelSearchBenchmark::threads2() {
+    this->search(2u);
+}
+
+void ParallelSearchBenchmark::threads4() {
+    this->search(4u);
+}
+
+void ParallelSearchBenchmark::threads8() {
+    this->search(8u);
+}
+
+void ParallelSearchBenchmark::threads16() {
+    this->search(16u);
+}
+
+void ParallelSearchBenchmark::threads32() {
+    this->search(32u);
+}
+
+void ParallelSearchBenchmark::threads64() {
+    this->search(64u);
+}
+
+QTEST_MAIN(ParallelSearchBenchmark)
+
+#include "ParallelSearchBenchmark.moc"
@@ -0,0 +1,100 @@
+#include <QtTest/QtTest>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+#include "Trees.hpp"
+
+using namespace std;
+using namespace md;
+
+class PatternAutomatonBenchmark : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void backtrackingComb();
+    void automatonComb();
+    void backtrackingNestedStars();
+    void automatonNestedStars();
+    void backtrackingComplete();
+    void automatonComplete();
+};
+
+// Chain of 'a' nodes, each one having also a leaf 'b': every 'a' is a candidate whose region is the rest of the chain
+nary_tree<char> make_comb(int length) {
+    tree_builder<nary_tree<char>> builder;
+    for (int i = 0; i < length; ++i) {
+        builder.open('a');
+        builder.leaf('b');
+    }
+    for (int i = 0; i < length; ++i) {
+        builder.close();
+    }
+    return builder.build();
+}
+
+// Complete binary tree of 'a' nodes having 'b' leaves
+nary_tree<char> make_complete(int depth) {
+    return complete_tree<char>(2, depth, [](int, bool leaf) {
+        return leaf ? 'b' : 'a';
+    });
+}
+
+// None of the patterns match: the backtracking engine must try every alternative before giving up
+auto make_star_pattern() {
+    return star()(star('a')(one('b'), one('c')));
+}
+
+auto make_nested_pattern() {
+    return star()(one('a')(star()(one('b'), one('c'))));
+}
+
+template <typename Pattern, typename Tree>
+void run_search(Pattern& pattern, Tree& tree) {
+    bool result = true;
+    QBENCHMARK {
+        result = pattern.search(tree);
+    }
+    QVERIFY(!result);
+}
+
+void PatternAutomatonBenchmark::backtrackingComb() {
+    nary_tree<char> tree = make_comb(4000);
+    pattern p(make_star_pattern());
+    run_search(p, tree);
+}
+
+void PatternAutomatonBenchmark::automatonComb() {
+    nary_tree<char> tree = make_comb(4000);
+    pattern_automaton p(make_star_pattern());
+    run_search(p, tree);
+}
+
+void PatternAutomatonBenchmark::backtrackingNestedStars() {
+    nary_tree<char> tree = make_comb(4000);
+    pattern p(make_nested_pattern());
+    run_search(p, tree);
+}
+
+void PatternAutomatonBenchmark::automatonNestedStars() {
+    nary_tree<char> tree = make_comb(4000);
+    pattern_automaton p(make_nested_pattern());
+    run_search(p, tree);
+}
+
+void PatternAutomatonBenchmark::backtrackingComplete() {
+    nary_tree<char> tree = make_complete(16);
+    pattern p(make_nested_pattern());
+    run_search(p, tree);
+}
+
+void PatternAutomatonBenchmark::automatonComplete() {
+    nary_tree<char> tree = make_complete(16);
+    pattern_automaton p(make_nested_pattern());
+    run_search(p, tree);
+}
+
+QTEST_MAIN(PatternAutomatonBenchmark)
+
+#include "PatternAutomatonBenchmark.moc"
@@ -0,0 +1,132 @@
+#include <QtTest/QtTest>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+using namespace std;
+using namespace md;
+
+/*
+ * Patterns nesting quantifiers that do not match: without remembering the failures, the backtracking tries each inner
+ * matcher again for every choice of the outer ones, which takes O(n^k) time for k nested quantifiers. The largest
+ * chains check that the failures are still all remembered when the tree has tens of thousands of nodes.
+ */
+class PatternBacktrackingBenchmark : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void nestedStars128();
+    void nestedStars512();
+    void nestedStars2048();
+    void nestedStars16384();
+    void nestedStars24576();
+    void nestedOpts512();
+    void nestedOpts2048();
+    void siblingStars512();
+    void siblingStars2048();
+};
+
+// Chain of 'a' nodes
+nary_tree<char> make_chain(int length) {
+    tree_builder<nary_tree<char>> builder;
+    for (int i = 0; i < length; ++i) {
+        builder.open('a');
+    }
+    for (int i = 0; i < length; ++i) {
+        builder.close();
+    }
+    return builder.build();
+}
+
+// Chain of 'a' nodes, each one having also a leaf 'b'
+nary_tree<char> make_comb(int length) {
+    tree_builder<nary_tree<char>> builder;
+    for (int i = 0; i < length; ++i) {
+        builder.open('a');
+        builder.leaf('b');
+    }
+    for (int i = 0; i < length; ++i) {
+        builder.close();
+    }
+    return builder.build();
+}
+
+auto make_nested_stars() {
+    return star()(one('a')(star('a')(one('a')(star('a')(one('a')(star('a')(one('b'))))))));
+}
+
+auto make_nested_opts() {
+    return star()(opt('a')(opt('a')(opt('a')(one('a')(one('b'))))));
+}
+
+auto make_sibling_stars() {
+    return star()(star('a')(one('b'), star('a')(one('b'), one('c'))));
+}
+
+template <typename Pattern, typename Tree>
+void run_search(Pattern& pattern, Tree& tree) {
+    bool result = true;
+    QBENCHMARK {
+        result = pattern.search(tree);
+    }
+    QVERIFY(!result);
+}
+
+void PatternBacktrackingBenchmark::nestedStars128() {
+    nary_tree<char> tree = make_chain(128);
+    pattern p(make_nested_stars());
+    run_search(p, tree);
+}
+
+void PatternBacktrackingBenchmark::nestedStars512() {
+    nary_tree<char> tree = make_chain(512);
+    pattern p(make_nested_stars());
+    run_search(p, tree);
+}
+
+void PatternBacktrackingBenchmark::nestedStars2048() {
+    nary_tree<char> tree = make_chain(2048);
+    pattern p(make_nested_stars());
+    run_search(p, tree);
+}
+
+void PatternBacktrackingBenchmark::nestedStars16384() {
+    nary_tree<char> tree = make_chain(16384);
+    pattern p(make_nested_stars());
+    run_search(p, tree);
+}
+
+void PatternBacktrackingBenchmark::nestedStars24576() {
+    nary_tree<char> tree = make_chain(24576);
+    pattern p(make_nested_stars());
+    run_search(p, tree);
+}
+
+void PatternBacktrackingBenchmark::nestedOpts512() {
+    nary_tree<char> tree = make_chain(512);
+    pattern p(make_nested_opts());
+    run_search(p, tree);
+}
+
+void PatternBacktrackingBenchmark::nestedOpts2048() {
+    nary_tree<char> tree = make_chain(2048);
+    pattern p(make_nested_opts());
+    run_search(p, tree);
+}
+
+void PatternBacktrackingBenchmark::siblingStars512() {
+    nary_tree<char> tree = make_comb(512);
+    pattern p(make_sibling_stars());
+    run_search(p, tree);
+}
+
+void PatternBacktrackingBenchmark::siblingStars2048() {
+    nary_tree<char> tree = make_comb(2048);
+    pattern p(make_sibling_stars());
+    run_search(p, tree);
+}
+
+QTEST_MAIN(PatternBacktrackingBenchmark)
+
+#include "PatternBacktrackingBenchmark.moc"
@@ -0,0 +1,103 @@
+#include <QtTest/QtTest>
+#include <vector>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+#include "Trees.hpp"
+
+using namespace std;
+using namespace md;
+
+class PatternSetBenchmark : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void set1();
+    void set10();
+    void set100();
+    void set1000();
+    void separate1();
+    void separate10();
+    void separate100();
+    void separate1000();
+};
+
+// Random tree of 100000 nodes having values from 'a' to 'j', each node is the child of a random previous node
+nary_tree<char> make_tree() {
+    return random_tree(1, 100000);
+}
+
+// The i-th pattern uses the decimal digits of i as values, so the patterns are all different but share subpatterns
+auto make_pattern(int i) {
+    return star()(
+        one(static_cast<char>('a' + i / 100 % 10))(
+            one(static_cast<char>('a' + i / 10 % 10))),
+        one(static_cast<char>('a' + i % 10)));
+}
+
+void search_set(int count) {
+    nary_tree<char> tree = make_tree();
+    pattern_set<char> set;
+    for (int i = 0; i < count; ++i) {
+        set.insert(make_pattern(i));
+    }
+    size_t matched = 0;
+    QBENCHMARK {
+        matched = set.search(tree);
+    }
+    QVERIFY(matched > 0);
+}
+
+void search_separately(int count) {
+    nary_tree<char> tree = make_tree();
+    vector<pattern_automaton<decltype(make_pattern(0))>> automata;
+    for (int i = 0; i < count; ++i) {
+        automata.emplace_back(make_pattern(i));
+    }
+    size_t matched = 0;
+    QBENCHMARK {
+        matched = 0;
+        for (auto& automaton : automata) {
+            matched += automaton.search(tree);
+        }
+    }
+    QVERIFY(matched > 0);
+}
+
+void PatternSetBenchmark::set1() {
+    search_set(1);
+}
+
+void PatternSetBenchmark::set10() {
+    search_set(10);
+}
+
+void PatternSetBenchmark::set100() {
+    search_set(100);
+}
+
+void PatternSetBenchmark::set1000() {
+    search_set(1000);
+}
+
+void PatternSetBenchmark::separate1() {
+    search_separately(1);
+}
+
+void PatternSetBenchmark::separate10() {
+    search_separately(10);
+}
+
+void PatternSetBenchmark::separate100() {
+    search_separately(100);
+}
+
+void PatternSetBenchmark::separate1000() {
+    search_separately(1000);
+}
+
+QTEST_MAIN(PatternSetBenchmark)
+
+#include "PatternSetBenchmark.moc"
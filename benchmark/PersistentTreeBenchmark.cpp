@@ -0,0 +1,149 @@
+#include <QtTest/QtTest>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include <TreeDS/tree>
+
+using namespace std;
+using namespace md;
+
+// Bytes currently allocated on the heap, every allocation of this program goes through the operators below
+static size_t allocated_bytes = 0u;
+
+void* operator new(size_t size) {
+    // The size is stored in front of the block to be subtracted on delete
+    auto* block = static_cast<max_align_t*>(malloc(sizeof(max_align_t) + size));
+    if (block == nullptr) {
+        throw bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    allocated_bytes += size;
+    return block + 1;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    auto* block = static_cast<max_align_t*>(pointer) - 1;
+    allocated_bytes -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+class PersistentTreeBenchmark : public QObject {
+
+    Q_OBJECT
+
+    // 300 blocks of 300 statements having 3 children each, about 360k nodes
+    nary_tree<int> tree;
+    persistent_tree<int> persistent;
+
+    private slots:
+    void initTestCase();
+    void snapshotNaryTree();
+    void snapshotPersistentTree();
+    void requestsNaryTree();
+    void requestsPersistentTree();
+    void modifyInPlace();
+    void memoryOfVersions();
+};
+
+void PersistentTreeBenchmark::initTestCase() {
+    tree_builder<nary_tree<int>> builder;
+    builder.open(0);
+    for (int i = 0; i < 300; ++i) {
+        builder.open(i);
+        for (int j = 0; j < 300; ++j) {
+            builder.open(j);
+            builder.leaf(1);
+            builder.leaf(2);
+            builder.leaf(3);
+            builder.close();
+        }
+        builder.close();
+    }
+    builder.close();
+    this->tree       = builder.build();
+    this->persistent = persistent_tree<int>(this->tree);
+}
+
+void PersistentTreeBenchmark::snapshotNaryTree() {
+    QBENCHMARK {
+        nary_tree<int> snapshot(this->tree);
+        QCOMPARE(snapshot.size(), this->tree.size());
+    }
+}
+
+void PersistentTreeBenchmark::snapshotPersistentTree() {
+    QBENCHMARK {
+        persistent_tree<int> snapshot(this->persistent);
+        QCOMPARE(snapshot.size(), this->tree.size());
+    }
+}
+
+// 100 requests, each one works on its own snapshot and modifies a statement
+void PersistentTreeBenchmark::requestsNaryTree() {
+    mt19937 random(1);
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            nary_tree<int> snapshot(this->tree);
+            nary_node<int>* block = snapshot.raw_root_node()->get_child(random() % 300);
+            snapshot.emplace_child_back(snapshot.root().other_node(block->get_child(random() % 300)), 4);
+        }
+    }
+}
+
+void PersistentTreeBenchmark::requestsPersistentTree() {
+    using iterator = persistent_tree<int>::const_iterator<policy::fixed>;
+    mt19937 random(1);
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            persistent_tree<int> snapshot(this->persistent);
+            const shared_node_pointer<int> block(snapshot.root().get_node_pointer().get_child(random() % 300));
+            snapshot.emplace_child_back(iterator(snapshot, block.get_child(random() % 300)), 4);
+        }
+    }
+}
+
+// Without snapshots the nodes are owned by the tree alone and modified without copying
+void PersistentTreeBenchmark::modifyInPlace() {
+    using iterator = persistent_tree<int>::const_iterator<policy::fixed>;
+    persistent_tree<int> tree(this->tree);
+    mt19937 random(2);
+    const shared_node<int>* root = tree.raw_root_node();
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            const shared_node_pointer<int> block(tree.root().get_node_pointer().get_child(random() % 300));
+            tree.erase(tree.emplace_child_back(iterator(tree, block.get_child(random() % 300)), 4));
+        }
+    }
+    QCOMPARE(tree.raw_root_node(), root);
+}
+
+// 100 versions, each one differing from the previous one by a statement
+void PersistentTreeBenchmark::memoryOfVersions() {
+    using iterator = persistent_tree<int>::const_iterator<policy::fixed>;
+    mt19937 random(3);
+    const size_t before = allocated_bytes;
+    vector<persistent_tree<int>> versions {this->persistent};
+    for (int i = 0; i < 100; ++i) {
+        persistent_tree<int> next(versions.back());
+        const shared_node_pointer<int> block(next.root().get_node_pointer().get_child(random() % 300));
+        next.emplace_child_back(iterator(next, block.get_child(random() % 300)), 4);
+        versions.push_back(std::move(next));
+    }
+    const size_t used = allocated_bytes - before;
+    QTest::setBenchmarkResult(static_cast<double>(used), QTest::BytesAllocated);
+    // Deep copies would take 100 times the tree, the versions together take less than one
+    QVERIFY(used < this->tree.size() * sizeof(shared_node<int>));
+}
+
+QTEST_MAIN(PersistentTreeBenchmark)
+
+#include "PersistentTreeBenchmark.moc"
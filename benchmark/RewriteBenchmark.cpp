@@ -0,0 +1,134 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <vector>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+using namespace std;
+using namespace md;
+
+class RewriteBenchmark : public QObject {
+
+    Q_OBJECT
+
+    // Random expressions of about 1000000 and 20000 nodes
+    nary_tree<char> large;
+    nary_tree<char> small;
+
+    private slots:
+    void initTestCase();
+    void searchAndInsertSmall();
+    void rewriterSmall();
+    void rewriterLarge();
+};
+
+nary_tree<char> random_expression(int operators, unsigned seed) {
+    mt19937 random(seed);
+    tree_builder<nary_tree<char>> builder;
+    // Explicit stack of the operands still to generate, to support deep expressions
+    vector<int> pending {operators};
+    while (!pending.empty()) {
+        int remaining = pending.back();
+        pending.pop_back();
+        if (remaining < 0) {
+            builder.close();
+            continue;
+        }
+        if (remaining == 0) {
+            builder.leaf("0112xy"[random() % 6]);
+            continue;
+        }
+        builder.open("+*"[random() % 2]);
+        const int left = static_cast<int>(random() % remaining);
+        pending.push_back(-1);
+        pending.push_back(remaining - 1 - left);
+        pending.push_back(left);
+    }
+    return builder.build();
+}
+
+// x + 0 => x, 0 + x => x, x * 1 => x, x * 0 => 0
+auto make_simplifier() {
+    return rewriter(
+        rewrite(one('+')(cpt(one()), one('0')), n(const_index<1>())),
+        rewrite(one('+')(one('0'), cpt(one())), n(const_index<1>())),
+        rewrite(one('*')(cpt(one()), one('1')), n(const_index<1>())),
+        rewrite(one('*')(one(), one('0')), n('0')));
+}
+
+void RewriteBenchmark::initTestCase() {
+    this->large = random_expression(500000, 1);
+    this->small = random_expression(10000, 2);
+}
+
+void copy_subtree(tree_builder<nary_tree<char>>& builder, const nary_node<char>& node) {
+    if (node.get_first_child() == nullptr) {
+        builder.leaf(node.get_value());
+        return;
+    }
+    builder.open(node.get_value());
+    for (const nary_node<char>* child = node.get_first_child(); child; child = child->get_next_sibling()) {
+        copy_subtree(builder, *child);
+    }
+    builder.close();
+}
+
+// Applies the first match of a rule found from the root: the capture is copied and inserted over the match
+template <bool Capture, typename Pattern>
+bool replace_first(nary_tree<char>& tree, Pattern& p) {
+    for (const auto& match : p.search_all(tree)) {
+        auto position = tree.begin(policy::fixed()).other_node(const_cast<nary_node<char>*>(match.get_node()));
+        if constexpr (Capture) {
+            tree_builder<nary_tree<char>> builder;
+            copy_subtree(builder, *match.get_mark(const_index<1>()));
+            tree.insert_over(position, builder.build());
+        } else {
+            tree.insert_over(position, '0');
+        }
+        return true;
+    }
+    return false;
+}
+
+void RewriteBenchmark::searchAndInsertSmall() {
+    pattern plus_zero(one('+')(cpt(one()), one('0')));
+    pattern zero_plus(one('+')(one('0'), cpt(one())));
+    pattern times_one(one('*')(cpt(one()), one('1')));
+    pattern times_zero(one('*')(one(), one('0')));
+    size_t size = 0;
+    QBENCHMARK {
+        nary_tree<char> tree(this->small);
+        while (replace_first<true>(tree, plus_zero) || replace_first<true>(tree, zero_plus)
+               || replace_first<true>(tree, times_one) || replace_first<false>(tree, times_zero)) {
+        }
+        size = tree.size();
+    }
+    nary_tree<char> expected(this->small);
+    make_simplifier().apply(expected);
+    QCOMPARE(size, expected.size());
+}
+
+void RewriteBenchmark::rewriterSmall() {
+    auto simplify = make_simplifier();
+    size_t rewrites = 0;
+    QBENCHMARK {
+        nary_tree<char> tree(this->small);
+        rewrites = simplify.apply(tree);
+    }
+    QVERIFY(rewrites > 0u);
+}
+
+void RewriteBenchmark::rewriterLarge() {
+    auto simplify = make_simplifier();
+    size_t rewrites = 0;
+    QBENCHMARK {
+        nary_tree<char> tree(this->large);
+        rewrites = simplify.apply(tree);
+    }
+    QVERIFY(rewrites > 0u);
+}
+
+QTEST_MAIN(RewriteBenchmark)
+
+#include "RewriteBenchmark.moc"
@@ -0,0 +1,77 @@
+#include <QtTest/QtTest>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+#include "Trees.hpp"
+
+using namespace std;
+using namespace md;
+
+class RuntimePatternBenchmark : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree;
+
+    private slots:
+    void initTestCase();
+    void compiledSearch();
+    void runtimeSearch();
+    void compiledStarSearch();
+    void runtimeStarSearch();
+};
+
+// Random tree of 1000000 nodes having values from 'a' to 'j'
+void RuntimePatternBenchmark::initTestCase() {
+    this->tree = random_tree(1, 1000000);
+}
+
+template <typename Pattern>
+void benchmark_compiled(Pattern& p, const nary_tree<char>& tree) {
+    size_t matches = 0;
+    QBENCHMARK {
+        matches = 0;
+        for (const auto& match : p.search_all(tree)) {
+            (void)match;
+            ++matches;
+        }
+    }
+    QVERIFY(matches > 0u);
+}
+
+void benchmark_runtime(runtime_pattern<char>& p, const nary_tree<char>& tree) {
+    size_t matches = 0;
+    QBENCHMARK {
+        matches = 0;
+        p.for_each_match(tree, [&](const nary_node<char>*) {
+            ++matches;
+        });
+    }
+    QVERIFY(matches > 0u);
+}
+
+void RuntimePatternBenchmark::compiledSearch() {
+    pattern p(one('a')(cpt(one('b')), star()(one('c'))));
+    benchmark_compiled(p, this->tree);
+}
+
+void RuntimePatternBenchmark::runtimeSearch() {
+    runtime_pattern<char> p("one('a')(cpt(one('b')), star()(one('c')))");
+    benchmark_runtime(p, this->tree);
+}
+
+// The star backtracks over the chains of 'a'
+void RuntimePatternBenchmark::compiledStarSearch() {
+    pattern p(star('a')(one('b')(opt('c')), one('d')));
+    benchmark_compiled(p, this->tree);
+}
+
+void RuntimePatternBenchmark::runtimeStarSearch() {
+    runtime_pattern<char> p("star('a')(one('b')(opt('c')), one('d'))");
+    benchmark_runtime(p, this->tree);
+}
+
+QTEST_MAIN(RuntimePatternBenchmark)
+
+#include "RuntimePatternBenchmark.moc"
@@ -0,0 +1,164 @@
+#include <QtTest/QtTest>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include <TreeDS/tree>
+
+using namespace std;
+using namespace md;
+
+// Bytes currently allocated on the heap, every allocation of this program goes through the operators below
+static size_t allocated_bytes = 0u;
+
+void* operator new(size_t size) {
+    // The size is stored in front of the block to be subtracted on delete
+    auto* block = static_cast<max_align_t*>(malloc(sizeof(max_align_t) + size));
+    if (block == nullptr) {
+        throw bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    allocated_bytes += size;
+    return block + 1;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    auto* block = static_cast<max_align_t*>(pointer) - 1;
+    allocated_bytes -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+class SharedTreeBenchmark : public QObject {
+
+    Q_OBJECT
+
+    // Tree shaped like an AST: 200 blocks of 200 statements, each one using up to 3 of 300 distinct expressions
+    nary_tree<char> tree;
+
+    private slots:
+    void initTestCase();
+    void compress();
+    void memoryNaryTree();
+    void memorySharedTree();
+    void traverseNaryTree();
+    void traverseSharedTree();
+    void copyOnWrite();
+};
+
+void SharedTreeBenchmark::initTestCase() {
+    mt19937 random(1);
+    tree_builder<nary_tree<char>> builder;
+    // Random expression of about 9 nodes
+    auto expression = [&](auto& self, int depth) -> void {
+        const char value = static_cast<char>('a' + random() % 10);
+        if (depth == 0 || random() % 4 == 0) {
+            builder.leaf(value);
+            return;
+        }
+        builder.open(value);
+        self(self, depth - 1);
+        self(self, depth - 1);
+        builder.close();
+    };
+    vector<unsigned> seeds(300);
+    for (unsigned& seed : seeds) {
+        seed = static_cast<unsigned>(random());
+    }
+    builder.open('p');
+    for (int i = 0; i < 200; ++i) {
+        builder.open('b');
+        for (int j = 0; j < 200; ++j) {
+            builder.open('s');
+            for (unsigned k = 0, count = 1u + random() % 3; k < count; ++k) {
+                // Reseeding with the seed of an expression generates it again
+                mt19937 saved = random;
+                random.seed(seeds[saved() % seeds.size()]);
+                expression(expression, 4);
+                random = saved;
+                random.discard(1);
+            }
+            builder.close();
+        }
+        builder.close();
+    }
+    builder.close();
+    this->tree = builder.build();
+}
+
+void SharedTreeBenchmark::compress() {
+    QBENCHMARK {
+        shared_tree<char> shared(this->tree);
+        QCOMPARE(shared.size(), this->tree.size());
+    }
+}
+
+void SharedTreeBenchmark::memoryNaryTree() {
+    const size_t before = allocated_bytes;
+    nary_tree<char> copy(this->tree);
+    QTest::setBenchmarkResult(static_cast<double>(allocated_bytes - before), QTest::BytesAllocated);
+    QCOMPARE(copy.size(), this->tree.size());
+}
+
+void SharedTreeBenchmark::memorySharedTree() {
+    const size_t before = allocated_bytes;
+    shared_tree<char> shared(this->tree);
+    const size_t used = allocated_bytes - before;
+    QTest::setBenchmarkResult(static_cast<double>(used), QTest::BytesAllocated);
+    // Interning must save at least 90% of the memory
+    QVERIFY(used * 10u < this->tree.size() * sizeof(nary_node<char>));
+}
+
+void SharedTreeBenchmark::traverseNaryTree() {
+    size_t sum = 0u;
+    QBENCHMARK {
+        sum = 0u;
+        for (auto it = this->tree.begin(policy::pre_order()); it != this->tree.end(policy::pre_order()); ++it) {
+            sum += static_cast<size_t>(*it);
+        }
+    }
+    QVERIFY(sum > 0u);
+}
+
+void SharedTreeBenchmark::traverseSharedTree() {
+    shared_tree<char> shared(this->tree);
+    size_t sum = 0u;
+    QBENCHMARK {
+        sum = 0u;
+        for (auto it = shared.begin(policy::pre_order()); it != shared.end(policy::pre_order()); ++it) {
+            sum += static_cast<size_t>(*it);
+        }
+    }
+    size_t expected = 0u;
+    for (char value : this->tree) {
+        expected += static_cast<size_t>(value);
+    }
+    QCOMPARE(sum, expected);
+}
+
+// Replaces the first expression of a random statement, which is shared with many other statements
+void SharedTreeBenchmark::copyOnWrite() {
+    using iterator = shared_tree<char>::const_iterator<policy::pre_order>;
+    shared_tree<char> shared(this->tree);
+    mt19937 random(2);
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            const shared_node_pointer<char> root(shared.raw_root_node());
+            const shared_node_pointer<char> block = root.get_child(random() % 200);
+            iterator position(shared, block.get_child(random() % 200).get_first_child());
+            shared.insert_over(position, n('x')(n(static_cast<char>('a' + random() % 10))));
+        }
+    }
+    QCOMPARE(shared.size(), shared.expand().size());
+}
+
+QTEST_MAIN(SharedTreeBenchmark)
+
+#include "SharedTreeBenchmark.moc"
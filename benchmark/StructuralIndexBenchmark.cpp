@@ -0,0 +1,105 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <vector>
+
+#include <TreeDS/index>
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+#include "Trees.hpp"
+
+using namespace std;
+using namespace md;
+
+class StructuralIndexBenchmark : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree;
+
+    private slots:
+    void initTestCase();
+    void build();
+    void scan();
+    void valueIndexed();
+    void structuralIndexed();
+};
+
+// f(g(a, b), h(c)) and its near misses f(g(a, b), h(d)), which fail only at the last node
+auto make_pattern() {
+    return pattern(one('f')(one('g')(one('a'), one('b')), one('h')(one('c'))));
+}
+
+/*
+ * Random tree of about 1000000 nodes having values from 'a' to 'e', where 100000 near misses of the pattern and 10
+ * occurrences of it are planted as the last child of random nodes.
+ */
+void StructuralIndexBenchmark::initTestCase() {
+    const int size = 400000;
+    this->tree     = random_tree(1, size, 5);
+    vector<nary_node<char>*> nodes;
+    for (auto it = this->tree.begin(policy::pre_order()); it != this->tree.end(policy::pre_order()); ++it) {
+        nodes.push_back(it.get_raw_node());
+    }
+    mt19937 random(2);
+    auto plant = [&](char last) {
+        auto target = this->tree.begin(policy::pre_order()).other_node(nodes[random() % size]);
+        this->tree.insert_child_back(target, n('f')(n('g')(n('a'), n('b')), n('h')(n(last))));
+    };
+    for (int i = 0; i < 100000; ++i) {
+        plant('d');
+    }
+    for (int i = 0; i < 10; ++i) {
+        plant('c');
+    }
+}
+
+void StructuralIndexBenchmark::build() {
+    QBENCHMARK {
+        structural_index index(this->tree);
+        QCOMPARE(index.size(), this->tree.size());
+    }
+}
+
+template <typename Pattern, typename... Index>
+size_t count_matches(Pattern& pattern, const nary_tree<char>& tree, const Index&... index) {
+    size_t result = 0;
+    for (const auto& match : pattern.search_all(tree, index...)) {
+        (void)match;
+        ++result;
+    }
+    return result;
+}
+
+void StructuralIndexBenchmark::scan() {
+    auto p         = make_pattern();
+    size_t matches = 0;
+    QBENCHMARK {
+        matches = count_matches(p, this->tree);
+    }
+    QVERIFY(matches >= 1u && matches <= 10u);
+}
+
+void StructuralIndexBenchmark::valueIndexed() {
+    value_index index(this->tree);
+    auto p         = make_pattern();
+    size_t matches = 0;
+    QBENCHMARK {
+        matches = count_matches(p, this->tree, index);
+    }
+    QCOMPARE(matches, count_matches(p, this->tree));
+}
+
+void StructuralIndexBenchmark::structuralIndexed() {
+    structural_index index(this->tree);
+    auto p         = make_pattern();
+    size_t matches = 0;
+    QBENCHMARK {
+        matches = count_matches(p, this->tree, index);
+    }
+    QCOMPARE(matches, count_matches(p, this->tree));
+}
+
+QTEST_MAIN(StructuralIndexBenchmark)
+
+#include "StructuralIndexBenchmark.moc"
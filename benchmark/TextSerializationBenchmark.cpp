@@ -0,0 +1,78 @@
+#include <QtTest/QtTest>
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include <TreeDS/serialize>
+#include <TreeDS/tree>
+
+#include "Trees.hpp"
+
+using namespace std;
+using namespace md;
+
+class TextSerializationBenchmark : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void formatInts();
+    void parseInts();
+    void formatStrings();
+    void parseStrings();
+};
+
+template <typename Tree>
+string format_tree(const Tree& tree) {
+    ostringstream stream;
+    {
+        text_writer writer(stream);
+        writer.write(tree);
+    }
+    return stream.str();
+}
+
+template <typename Function>
+void report_throughput(size_t bytes, Function&& function) {
+    auto start = chrono::steady_clock::now();
+    function();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    QTest::setBenchmarkResult(bytes / elapsed.count(), QTest::BytesPerSecond);
+}
+
+void TextSerializationBenchmark::formatInts() {
+    nary_tree<int> tree = complete_tree<int>(4, 10, [](int i, bool) { return i * 7919; });
+    size_t bytes        = format_tree(tree).size();
+    report_throughput(bytes, [&]() {
+        QCOMPARE(format_tree(tree).size(), bytes);
+    });
+}
+
+void TextSerializationBenchmark::parseInts() {
+    string text = format_tree(complete_tree<int>(4, 10, [](int i, bool) { return i * 7919; }));
+    report_throughput(text.size(), [&]() {
+        istringstream stream(text);
+        text_reader reader(stream);
+        QCOMPARE(reader.read<nary_tree<int>>().size(), size_t(1398101));
+    });
+}
+
+void TextSerializationBenchmark::formatStrings() {
+    nary_tree<string> tree = complete_tree<string>(4, 10, [](int i, bool) { return "node " + to_string(i); });
+    size_t bytes           = format_tree(tree).size();
+    report_throughput(bytes, [&]() {
+        QCOMPARE(format_tree(tree).size(), bytes);
+    });
+}
+
+void TextSerializationBenchmark::parseStrings() {
+    string text = format_tree(complete_tree<string>(4, 10, [](int i, bool) { return "node " + to_string(i); }));
+    report_throughput(text.size(), [&]() {
+        istringstream stream(text);
+        text_reader reader(stream);
+        QCOMPARE(reader.read<nary_tree<string>>().size(), size_t(1398101));
+    });
+}
+
+QTEST_MAIN(TextSerializationBenchmark);
+#include "TextSerializationBenchmark.moc"
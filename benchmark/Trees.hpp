@@ -0,0 +1,54 @@
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include <TreeDS/tree>
+
+/*
+ * Random recursive tree: each node but the root is the child of a node chosen uniformly among the previous ones, the
+ * values go from 'a' to 'a' + letters - 1. The depth is logarithmic in the size on average.
+ */
+inline md::nary_tree<char> random_tree(unsigned seed, int size, int letters = 10) {
+    std::mt19937 random(seed);
+    std::vector<char> values(size);
+    std::vector<int> parents(size, -1);
+    for (int i = 0; i < size; ++i) {
+        values[i] = static_cast<char>('a' + random() % letters);
+        if (i > 0) {
+            parents[i] = static_cast<int>(random() % i);
+        }
+    }
+    return md::nary_tree<char>::from_parent_indices(values, parents);
+}
+
+/*
+ * Complete tree whose internal nodes have arity children and whose leaves are at the given depth. The value of a node
+ * is make(index, leaf), where index is its position in pre-order and leaf whether it has no children.
+ */
+template <typename T, typename Make>
+md::nary_tree<T> complete_tree(int arity, int depth, Make make) {
+    md::tree_builder<md::nary_tree<T>> builder;
+    int counter = 0;
+    // Children still to be added to each node open, one per level
+    std::vector<int> pending;
+    auto add = [&]() {
+        if (static_cast<int>(pending.size()) == depth) {
+            builder.leaf(make(counter++, true));
+        } else {
+            builder.open(make(counter++, false));
+            pending.push_back(arity);
+        }
+    };
+    add();
+    while (!pending.empty()) {
+        if (pending.back() == 0) {
+            builder.close();
+            pending.pop_back();
+        } else {
+            --pending.back();
+            add();
+        }
+    }
+    return builder.build();
+}
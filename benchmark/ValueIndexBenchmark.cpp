@@ -0,0 +1,105 @@
+#include <QtTest/QtTest>
+#include <vector>
+
+#include <TreeDS/index>
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+#include "Trees.hpp"
+
+using namespace std;
+using namespace md;
+
+class ValueIndexBenchmark : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree;
+
+    private slots:
+    void initTestCase();
+    void build();
+    void rareScan();
+    void rareIndexed();
+    void commonScan();
+    void commonIndexed();
+};
+
+// Random tree of 1000000 nodes having values from 'a' to 'j', except 3 nodes having value 'x'
+void ValueIndexBenchmark::initTestCase() {
+    this->tree = random_tree(1, 1000000);
+    vector<nary_node<char>*> nodes;
+    for (auto it = this->tree.begin(policy::pre_order()); it != this->tree.end(policy::pre_order()); ++it) {
+        nodes.push_back(it.get_raw_node());
+    }
+    for (size_t i = 1u; i <= 3u; ++i) {
+        nodes[i * nodes.size() / 4u]->get_value() = 'x';
+    }
+}
+
+void ValueIndexBenchmark::build() {
+    QBENCHMARK {
+        value_index index(this->tree);
+        QCOMPARE(index.count('x'), 3u);
+    }
+}
+
+template <typename Pattern>
+size_t count_matches(Pattern& pattern, const nary_tree<char>& tree) {
+    size_t result = 0;
+    for (const auto& match : pattern.search_all(tree)) {
+        (void)match;
+        ++result;
+    }
+    return result;
+}
+
+template <typename Pattern>
+size_t count_matches(Pattern& pattern, const nary_tree<char>& tree, const value_index<nary_tree<char>>& index) {
+    size_t result = 0;
+    for (const auto& match : pattern.search_all(tree, index)) {
+        (void)match;
+        ++result;
+    }
+    return result;
+}
+
+void ValueIndexBenchmark::rareScan() {
+    pattern p(one('x')(star()));
+    size_t matches = 0;
+    QBENCHMARK {
+        matches = count_matches(p, this->tree);
+    }
+    QCOMPARE(matches, 3u);
+}
+
+void ValueIndexBenchmark::rareIndexed() {
+    value_index index(this->tree);
+    pattern p(one('x')(star()));
+    size_t matches = 0;
+    QBENCHMARK {
+        matches = count_matches(p, this->tree, index);
+    }
+    QCOMPARE(matches, 3u);
+}
+
+void ValueIndexBenchmark::commonScan() {
+    pattern p(one('a')(one('b')));
+    QBENCHMARK {
+        count_matches(p, this->tree);
+    }
+}
+
+void ValueIndexBenchmark::commonIndexed() {
+    value_index index(this->tree);
+    pattern p(one('a')(one('b')));
+    size_t matches = 0;
+    QBENCHMARK {
+        matches = count_matches(p, this->tree, index);
+    }
+    QCOMPARE(matches, count_matches(p, this->tree));
+}
+
+QTEST_MAIN(ValueIndexBenchmark)
+
+#include "ValueIndexBenchmark.moc"
@@ -25,6 +25,42 @@ class binary_tree : public tree<binary_node<T>, Policy, Allocator> {
     public:
     using tree<binary_node<T>, Policy, Allocator>::tree;
     using tree<binary_node<T>, Policy, Allocator>::operator=;
+
+    /**
+     * @brief Builds a tree from its pre-order serialization in columnar form.
+     * @details Each value is paired with the number of children of its node (at most 2). Like in the n(...) notation,
+     * a node having a single child will have it on the left.
+     * @param values values of the nodes, in pre-order
+     * @param child_counts number of children of each node, in pre-order
+     * @throw std::invalid_argument if the child counts do not describe exactly as many nodes as the values
+     */
+    template <typename Values, typename ChildCounts>
+    static binary_tree from_preorder(
+        const Values& values,
+        const ChildCounts& child_counts,
+        const Allocator& allocator = Allocator()) {
+        binary_tree result(allocator);
+        result.assign_preorder(values, child_counts);
+        return result;
+    }
+
+    /**
+     * @brief Builds a tree from an array of values paired with the index of their parent.
+     * @details The root is the only node whose parent index is out of range (for example -1). The first child (lower
+     * index) goes to the left, the second to the right.
+     * @param values values of the nodes
+     * @param parents index of the parent of each node (random access)
+     * @throw std::invalid_argument if the parent indexes do not describe a single binary tree
+     */
+    template <typename Values, typename ParentIndexes>
+    static binary_tree from_parent_indices(
+        const Values& values,
+        const ParentIndexes& parents,
+        const Allocator& allocator = Allocator()) {
+        binary_tree result(allocator);
+        result.assign_parent_indices(values, parents);
+        return result;
+    }
 };
 
 } // namespace md
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <unordered_set>
+#include <utility> // std::pair
+#include <vector>
+
+namespace md {
+
+/**
+ * @brief Records the parts of a tree modified since it was last cleared.
+ * @details A tree given a log with tree::set_change_log() reports to it every structural modification: the subtrees
+ * inserted, the subtrees removed and the replacement of the whole tree. Values modified through iterators are not seen
+ * by the tree and must be reported with {@link #touch()}. Whatever depends only on the subtree of a node (for example
+ * whether a pattern matches at that node) must be computed again just for the {@link #for_each_affected() affected}
+ * nodes: the nodes inserted or touched and their ancestors. A log can be read by any number of consumers before being
+ * cleared.
+ * @tparam Node the type of nodes of the tree
+ */
+template <typename Node>
+class change_log {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using node_type = const Node;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    // Roots of the subtrees inserted, they may be removed afterward
+    std::vector<node_type*> inserted_roots;
+    // Nodes whose value or children changed, they may be removed afterward
+    std::vector<node_type*> changed;
+    // Nodes that left the tree, their addresses may be reused by nodes inserted later
+    std::unordered_set<node_type*> removed;
+    // The whole tree was replaced
+    bool reset = false;
+
+    /*   ---   METHODS   ---   */
+    protected:
+    template <typename Function>
+    static void for_each_in_subtree(node_type& root, Function&& function) {
+        node_type* node = &root;
+        while (node != nullptr) {
+            function(*node);
+            if (node->get_first_child() != nullptr) {
+                node = node->get_first_child();
+                continue;
+            }
+            while (node != &root && node->get_next_sibling() == nullptr) {
+                node = node->get_parent();
+            }
+            node = node != &root ? node->get_next_sibling() : nullptr;
+        }
+    }
+
+    public:
+    /// @brief The subtree having the given root was inserted in the tree.
+    void inserted(node_type& root) {
+        if (this->reset) {
+            return;
+        }
+        for_each_in_subtree(root, [this](node_type& node) {
+            this->removed.erase(&node);
+        });
+        this->inserted_roots.push_back(&root);
+    }
+
+    /// @brief The subtree having the given root is going to leave the tree.
+    void removing(node_type& root) {
+        if (this->reset) {
+            return;
+        }
+        if (root.get_parent() != nullptr) {
+            this->changed.push_back(root.get_parent());
+        }
+        for_each_in_subtree(root, [this](node_type& node) {
+            this->removed.insert(&node);
+        });
+    }
+
+    /// @brief The whole tree was replaced.
+    void replaced() {
+        this->inserted_roots.clear();
+        this->changed.clear();
+        this->removed.clear();
+        this->reset = true;
+    }
+
+    /// @brief The value of the node was modified.
+    void touch(node_type& node) {
+        if (!this->reset) {
+            this->changed.push_back(&node);
+        }
+    }
+
+    /// @brief Forgets every modification.
+    void clear() {
+        this->inserted_roots.clear();
+        this->changed.clear();
+        this->removed.clear();
+        this->reset = false;
+    }
+
+    bool empty() const {
+        return !this->reset && this->inserted_roots.empty() && this->changed.empty() && this->removed.empty();
+    }
+
+    /// @brief Whether the whole tree was replaced, in that case the modifications are not recorded in detail.
+    bool is_reset() const {
+        return this->reset;
+    }
+
+    /// @brief Nodes that left the tree, they must not be dereferenced.
+    const std::unordered_set<node_type*>& get_removed() const {
+        return this->removed;
+    }
+
+    /**
+     * @brief Calls the function once for each node still in the tree whose subtree was modified.
+     * @details Those are the nodes of the subtrees inserted, the nodes touched and all their ancestors. The cost is
+     * proportional to their number.
+     */
+    template <typename Function>
+    void for_each_affected(Function&& function) const {
+        // The ancestors of a visited node are visited as well
+        std::unordered_set<node_type*> visited;
+        auto visit_ancestors = [&](node_type* node) {
+            for (; node != nullptr && visited.insert(node).second; node = node->get_parent()) {
+                function(*node);
+            }
+        };
+        for (node_type* root : this->inserted_roots) {
+            if (this->removed.count(root) > 0u || visited.count(root) > 0u) {
+                continue;
+            }
+            // Every node inserted is new
+            for_each_in_subtree(*root, [&](node_type& node) {
+                if (&node != root && visited.insert(&node).second) {
+                    function(node);
+                }
+            });
+            visit_ancestors(root);
+        }
+        for (node_type* node : this->changed) {
+            if (this->removed.count(node) == 0u) {
+                visit_ancestors(node);
+            }
+        }
+    }
+
+    /**
+     * @brief Calls the function once for each node {@link #for_each_affected() affected}, the children before their
+     * parent.
+     * @details Suited to compute again what a node derives from its children: when the function is called on a node, it
+     * was already called on its affected children and the other children were not modified.
+     */
+    template <typename Function>
+    void for_each_affected_post_order(Function&& function) const {
+        std::vector<node_type*> affected;
+        std::unordered_set<node_type*> pending;
+        this->for_each_affected([&](node_type& node) {
+            affected.push_back(&node);
+            pending.insert(&node);
+        });
+        // Post-order among the affected nodes, the others are skipped
+        std::vector<std::pair<node_type*, bool>> stack;
+        for (node_type* root : affected) {
+            if (pending.count(root) == 0u) {
+                continue;
+            }
+            stack.emplace_back(root, false);
+            while (!stack.empty()) {
+                node_type* node = stack.back().first;
+                if (!stack.back().second) {
+                    stack.back().second = true;
+                    for (node_type* child = node->get_first_child(); child != nullptr;
+                         child            = child->get_next_sibling()) {
+                        if (pending.count(child) > 0u) {
+                            stack.emplace_back(child, false);
+                        }
+                    }
+                    continue;
+                }
+                function(*node);
+                pending.erase(node);
+                stack.pop_back();
+            }
+        }
+    }
+};
+
+} // namespace md
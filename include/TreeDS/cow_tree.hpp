@@ -0,0 +1,327 @@
+#pragma once
+
+#include <cstddef>   // std::size_t
+#include <memory>    // std::shared_ptr, std::make_shared()
+#include <stdexcept> // std::invalid_argument
+#include <utility>   // std::move(), std::forward()
+#include <vector>
+
+#include <TreeDS/policy/fixed.hpp>
+#include <TreeDS/policy/post_order.hpp>
+#include <TreeDS/tree.hpp>
+#include <TreeDS/tree_iterator.hpp>
+
+namespace md {
+
+/**
+ * @brief Copy-on-write handle to a tree, copying it costs O(1) and the nodes are copied by the first modification.
+ * @details The copies of a cow_tree refer to the same {@link nary_tree} or {@link binary_tree}. Reading it through
+ * {@link #begin()}, {@link #root()} and the other getters never copies anything: they return constant iterators,
+ * even on a non constant object. The first modifying call made through a copy that is still shared ({@link
+ * #insert_over()}, {@link #emplace_child_back()}, {@link #erase()}, {@link #mutable_begin()}, {@link #mutable_root()},
+ * {@link #detach()} and the like) deep copies the tree for that copy alone. When the copy is the only owner the tree is
+ * modified in place.
+ *
+ * The nodes of these trees know their parent, therefore a subtree cannot belong to two trees: the whole tree is copied
+ * when it is unshared. If most modifications touch a small part of a large tree, {@link persistent_tree} copies only
+ * the path to the modified node.
+ *
+ * The modification that copies the tree accepts an iterator obtained before, while the tree was shared: it is moved to
+ * the node having the same position in the new tree. The iterators returned point into the tree owned by this object,
+ * the older ones must not be used anymore. The iterators returned by the mutable_ methods write to the nodes directly:
+ * they must not be used once this object is copied, a write would be seen by the copy. Like a tree, a cow_tree and the
+ * copies sharing its nodes must be used by one thread at a time.
+ *
+ * @code
+ * cow_tree<nary_tree<char>> t(n('a')(n('b'), n('c')));
+ * cow_tree<nary_tree<char>> copy = t;     // O(1), the nodes are shared
+ * copy.insert_child_back(copy.root(), 'd'); // copy gets its own nodes, t is not modified
+ * @endcode
+ *
+ * @tparam Tree the type of tree shared: nary_tree or binary_tree
+ */
+template <typename Tree>
+class cow_tree {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using tree_type       = Tree;
+    using value_type      = typename Tree::value_type;
+    using reference       = typename Tree::reference;
+    using const_reference = typename Tree::const_reference;
+    using node_type       = typename Tree::node_type;
+    using size_type       = typename Tree::size_type;
+    using policy_type     = typename Tree::policy_type;
+    using allocator_type  = typename Tree::allocator_type;
+    template <typename P>
+    using iterator = typename Tree::template iterator<P>;
+    template <typename P>
+    using const_iterator = typename Tree::template const_iterator<P>;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    // Null when empty, otherwise the tree shared by the copies
+    std::shared_ptr<Tree> shared;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    cow_tree() {
+    }
+
+    /// @brief Copies the given tree once, the copies of this object will share the result.
+    explicit cow_tree(const Tree& tree) :
+            shared(std::make_shared<Tree>(tree)) {
+    }
+
+    explicit cow_tree(Tree&& tree) :
+            shared(std::make_shared<Tree>(std::move(tree))) {
+    }
+
+    template <
+        typename ConvertibleV,
+        typename... Children,
+        typename = std::enable_if_t<std::is_convertible_v<ConvertibleV, value_type>>>
+    cow_tree(const struct_node<ConvertibleV, Children...>& root) :
+            shared(std::make_shared<Tree>(root)) {
+    }
+
+    /// @brief Shares the nodes of other in O(1), they will be copied by the first modification of either tree.
+    cow_tree(const cow_tree& other) = default;
+
+    cow_tree(cow_tree&& other) = default;
+
+    /*   ---   ASSIGNMENT   ---   */
+    public:
+    cow_tree& operator=(const cow_tree& other) = default;
+
+    cow_tree& operator=(cow_tree&& other) = default;
+
+    /*   ---   METHODS   ---   */
+    protected:
+    // The tree to read, an empty one when there are no nodes
+    const Tree& read() const {
+        static const Tree empty_tree;
+        return this->shared ? *this->shared : empty_tree;
+    }
+
+    // Root of the tree the iterators received refer to, before the tree is copied by detach()
+    const node_type* shared_root() const {
+        return this->shared ? this->shared->raw_root_node() : nullptr;
+    }
+
+    // Returns the iterator pointing to the same position of the given one in the tree owned by this object
+    template <typename T, typename P, typename N>
+    iterator<P> locate(const tree_iterator<T, P, N>& position, const node_type* previous) {
+        Tree& tree            = *this->shared;
+        const node_type* node = position.get_raw_node();
+        if (node == nullptr) {
+            return iterator<P>(tree);
+        }
+        if (position.get_raw_root() == tree.raw_root_node()) {
+            // The tree was not copied, see tree::modify_subtree() for the const_cast
+            return iterator<P>(tree, const_cast<node_type*>(node), tree.get_navigator());
+        }
+        if (position.get_raw_root() != previous) {
+            throw std::invalid_argument("The iterator does not belong to this tree.");
+        }
+        // Position of the node among its siblings, from the node up to the root
+        std::vector<std::size_t> path;
+        for (; node->get_parent() != nullptr; node = node->get_parent()) {
+            std::size_t index = 0u;
+            for (const node_type* sibling = node->get_prev_sibling(); sibling != nullptr;
+                 sibling                  = sibling->get_prev_sibling()) {
+                ++index;
+            }
+            path.push_back(index);
+        }
+        node_type* target = tree.raw_root_node();
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            target = target->get_child(*it);
+        }
+        return iterator<P>(tree, target, tree.get_navigator());
+    }
+
+    template <typename T, typename P, typename N>
+    iterator<P> writable(const tree_iterator<T, P, N>& position) {
+        const node_type* previous = this->shared_root();
+        this->detach();
+        return this->locate(position, previous);
+    }
+
+    public:
+    /**
+     * @brief Makes this object the only owner of its tree and returns it.
+     * @details The tree is copied if other objects share it, then it can be modified directly. Once this object is
+     * copied again, the tree must not be modified through the reference anymore, the copy would see the changes.
+     * @return the tree owned by this object
+     */
+    Tree& detach() {
+        if (!this->shared) {
+            this->shared = std::make_shared<Tree>();
+        } else if (this->shared.use_count() > 1) {
+            this->shared = std::make_shared<Tree>(*this->shared);
+        }
+        return *this->shared;
+    }
+
+    /// @brief Whether other objects share the tree of this one (a modification would copy it).
+    bool is_shared() const {
+        return this->shared && this->shared.use_count() > 1;
+    }
+
+    template <typename T, typename P, typename N, typename... Args>
+    iterator<P> insert_over(const tree_iterator<T, P, N>& position, Args&&... args) {
+        iterator<P> target = this->writable(position);
+        return this->shared->insert_over(target, std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename P, typename N, typename... Args>
+    iterator<P> emplace_over(const tree_iterator<T, P, N>& position, Args&&... args) {
+        iterator<P> target = this->writable(position);
+        return this->shared->emplace_over(target, std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename P, typename N, typename... Args>
+    iterator<P> insert_child(const tree_iterator<T, P, N>& position, std::size_t index, Args&&... args) {
+        iterator<P> target = this->writable(position);
+        return this->shared->insert_child(target, index, std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename P, typename N, typename Arg>
+    iterator<P> insert_child_front(const tree_iterator<T, P, N>& position, Arg&& arg) {
+        iterator<P> target = this->writable(position);
+        return this->shared->insert_child_front(target, std::forward<Arg>(arg));
+    }
+
+    template <typename T, typename P, typename N, typename Arg>
+    iterator<P> insert_child_back(const tree_iterator<T, P, N>& position, Arg&& arg) {
+        iterator<P> target = this->writable(position);
+        return this->shared->insert_child_back(target, std::forward<Arg>(arg));
+    }
+
+    template <typename T, typename P, typename N, typename... Args>
+    iterator<P> emplace_child_front(const tree_iterator<T, P, N>& position, Args&&... args) {
+        iterator<P> target = this->writable(position);
+        return this->shared->emplace_child_front(target, std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename P, typename N, typename... Args>
+    iterator<P> emplace_child_back(const tree_iterator<T, P, N>& position, Args&&... args) {
+        iterator<P> target = this->writable(position);
+        return this->shared->emplace_child_back(target, std::forward<Args>(args)...);
+    }
+
+    /// @brief Removes the subtree at position, the copies sharing it keep their nodes.
+    template <typename T, typename N>
+    iterator<policy::post_order> erase(const tree_iterator<T, policy::post_order, N>& position) {
+        iterator<policy::post_order> target = this->writable(position);
+        return this->shared->erase(target);
+    }
+
+    template <typename T1, typename N1, typename T2, typename N2>
+    iterator<policy::post_order> erase(
+        const tree_iterator<T1, policy::post_order, N1>& first,
+        const tree_iterator<T2, policy::post_order, N2>& last) {
+        const node_type* previous = this->shared_root();
+        this->detach();
+        return this->shared->erase(this->locate(first, previous), this->locate(last, previous));
+    }
+
+    /// @brief Drops the reference to the tree, the copies sharing it keep their nodes.
+    void clear() {
+        this->shared.reset();
+    }
+
+    void swap(cow_tree& other) {
+        this->shared.swap(other.shared);
+    }
+
+    /*   ---   ITERATORS   ---   */
+    public:
+    template <typename P = policy_type>
+    const_iterator<P> begin(P policy = P()) const {
+        return this->read().begin(policy);
+    }
+
+    template <typename P = policy_type>
+    const_iterator<P> end(P policy = P()) const {
+        return this->read().end(policy);
+    }
+
+    template <typename P = policy_type>
+    const_iterator<P> cbegin(P policy = P()) const {
+        return this->read().cbegin(policy);
+    }
+
+    template <typename P = policy_type>
+    const_iterator<P> cend(P policy = P()) const {
+        return this->read().cend(policy);
+    }
+
+    /**
+     * @brief Iterator allowing to modify the values, the tree is copied if it is shared.
+     * @details The iterator is invalidated by a copy of this object: writing through it would modify the copy as well.
+     */
+    template <typename P = policy_type>
+    iterator<P> mutable_begin(P policy = P()) {
+        return this->detach().begin(policy);
+    }
+
+    template <typename P = policy_type>
+    iterator<P> mutable_end(P policy = P()) {
+        return this->detach().end(policy);
+    }
+
+    /*   ---   GETTERS   ---   */
+    public:
+    /// @brief The tree shared by the copies, use it to read or to make a view ({@link tree_view}).
+    const Tree& get() const {
+        return this->read();
+    }
+
+    const_iterator<policy::fixed> root() const {
+        return this->read().root();
+    }
+
+    const_iterator<policy::fixed> croot() const {
+        return this->read().croot();
+    }
+
+    /// @brief Iterator allowing to modify the root, the tree is copied if it is shared, see {@link #mutable_begin()}.
+    iterator<policy::fixed> mutable_root() {
+        return this->detach().root();
+    }
+
+    const node_type* raw_root_node() const {
+        return this->read().raw_root_node();
+    }
+
+    size_type size() const {
+        return this->read().size();
+    }
+
+    size_type arity() const {
+        return this->read().arity();
+    }
+
+    bool empty() const {
+        return this->read().empty();
+    }
+
+    /*   ---   COMPARISON   ---   */
+    public:
+    bool operator==(const cow_tree& other) const {
+        return this->shared == other.shared || this->read() == other.read();
+    }
+
+    bool operator!=(const cow_tree& other) const {
+        return !(*this == other);
+    }
+};
+
+template <typename Tree>
+void swap(cow_tree<Tree>& lhs, cow_tree<Tree>& rhs) {
+    lhs.swap(rhs);
+}
+
+} // namespace md
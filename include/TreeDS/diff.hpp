@@ -0,0 +1,849 @@
+#pragma once
+
+#include <algorithm>  // std::min(), std::lower_bound(), std::find_if(), std::remove_if(), std::reverse()
+#include <cstddef>    // std::size_t
+#include <functional> // std::hash
+#include <limits>     // std::numeric_limits
+#include <optional>
+#include <stdexcept> // std::invalid_argument
+#include <unordered_map>
+#include <utility> // std::pair, std::move()
+#include <vector>
+
+#include <TreeDS/nary_tree.hpp>
+#include <TreeDS/policy/post_order.hpp>
+#include <TreeDS/tree_builder.hpp>
+#include <TreeDS/utility.hpp>
+
+namespace md {
+
+/// @brief The kinds of operation of an {@link edit_script}.
+enum class edit_kind {
+    INSERT,
+    REMOVE,
+    UPDATE,
+    MOVE
+};
+
+/**
+ * @brief One operation of an {@link edit_script}.
+ * @details Nodes are addressed by their path: the indices of the children to follow from the root. Each path refers
+ * to the tree as left by the operations that precede it in the script, an empty path is the root.
+ * - INSERT: subtree becomes the child number index of the node at path (an empty tree gets it as root).
+ * - REMOVE: the subtree rooted at path is erased.
+ * - UPDATE: the node at path takes value.
+ * - MOVE: the subtree rooted at path is detached, then it becomes the child number index of the node at target (a
+ *   path resolved after the detachment).
+ */
+template <typename T>
+struct edit_operation {
+    edit_kind kind;
+    std::vector<std::size_t> path;
+    std::vector<std::size_t> target;
+    std::size_t index = 0u;
+    std::optional<T> value;
+    nary_tree<T> subtree;
+};
+
+/// @brief Operations that turn a tree into another one, see {@link diff()} and {@link apply()}.
+template <typename T>
+using edit_script = std::vector<edit_operation<T>>;
+
+namespace detail {
+
+    // Copies the nodes from root (none if null) into a tree of type Tree, whatever the allocator they come from
+    template <typename Tree>
+    Tree copy_nodes(const typename Tree::node_type* root, const typename Tree::allocator_type& allocator) {
+        Tree result(allocator);
+        if (root != nullptr) {
+            auto node_allocator = result.get_node_allocator();
+            result              = allocate(node_allocator, *root, node_allocator);
+        }
+        return result;
+    }
+
+    /*
+     * Computes the edit script between two nary trees in two phases.
+     *
+     * Matching pairs the nodes of a with the nodes of b. Both trees are flattened in pre-order, every node knows the
+     * size and the hash of its subtree. Starting from the roots, two nodes whose subtrees are equal are matched with
+     * all their descendants. Otherwise their children are aligned: the equal subtrees at the beginning and at the end,
+     * then the subtrees whose hash is unique on both sides and that keep the same order (a longest increasing
+     * subsequence) as anchors. The gaps between anchors are matched exactly by the Zhang–Shasha tree edit distance
+     * when small, otherwise by a longest common subsequence of the values, the pairs found are aligned in turn. Last,
+     * the subtrees left unmatched in b are looked up among the ones left unmatched in a: those are moves, and the nodes
+     * still unmatched are matched with an unmatched child of the partner of their parent having the same value.
+     *
+     * Generation (Chawathe et al.) visits b top-down and replays on a mirror of a the operations emitted, so that each
+     * path refers to the tree as modified so far: unmatched nodes are inserted, matched nodes having a different
+     * parent or out of order among their siblings are moved, different values are updated and at the end the nodes
+     * of a left unmatched are removed. Subtrees matched as a whole are skipped, the cost of generation depends on the
+     * size of the differences.
+     */
+    template <typename T, typename Hash>
+    class tree_differ {
+
+        /*   ---   TYPES   ---   */
+        protected:
+        // The pre-order of a tree, each vector is indexed by the position of the node in it
+        struct flat_tree {
+            std::vector<const nary_node<T>*> nodes;
+            std::vector<std::size_t> parents;
+            std::vector<std::size_t> sizes;
+            std::vector<std::size_t> hashes;
+            // Node of the other tree matched with this one
+            std::vector<std::size_t> partners;
+            // The node is matched together with its whole subtree to an equal subtree
+            std::vector<bool> identical;
+
+            const T& value(std::size_t index) const {
+                return this->nodes[index]->get_value();
+            }
+        };
+
+        // The post-order of a forest of one tree, as the Zhang–Shasha algorithm wants it
+        struct post_order_forest {
+            // Index in the flat_tree, NONE for the virtual root that collects the trees of the forest
+            std::vector<std::size_t> nodes;
+            // Post-order position of the leftmost leaf of each node
+            std::vector<std::size_t> leftmost;
+        };
+
+        /*   ---   ATTRIBUTES   ---   */
+        protected:
+        static constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+        // Gaps whose forests have a product of sizes up to this are matched by the exact edit distance
+        static constexpr std::size_t EXACT_LIMIT = 1u << 14;
+        // Gaps having a product of lengths up to this are aligned by a longest common subsequence of the values
+        static constexpr std::size_t ALIGN_LIMIT = 1u << 20;
+        Hash hasher;
+        flat_tree a;
+        flat_tree b;
+
+        /*   ---   CONSTRUCTORS   ---   */
+        public:
+        tree_differ(const nary_node<T>& a, const nary_node<T>& b, const Hash& hasher) :
+                hasher(hasher) {
+            this->flatten(a, this->a);
+            this->flatten(b, this->b);
+        }
+
+        /*   ---   METHODS   ---   */
+        protected:
+        void flatten(const nary_node<T>& root, flat_tree& tree) const {
+            std::vector<std::pair<const nary_node<T>*, std::size_t>> stack {{&root, NONE}};
+            while (!stack.empty()) {
+                auto [node, parent] = stack.back();
+                stack.pop_back();
+                const std::size_t index = tree.nodes.size();
+                tree.nodes.push_back(node);
+                tree.parents.push_back(parent);
+                for (auto child = node->get_last_child(); child != nullptr; child = child->get_prev_sibling()) {
+                    stack.emplace_back(child, index);
+                }
+            }
+            const std::size_t count = tree.nodes.size();
+            tree.sizes.assign(count, 1u);
+            tree.hashes.assign(count, 0u);
+            tree.partners.assign(count, NONE);
+            tree.identical.assign(count, false);
+            // Reverse pre-order visits the children before their parent
+            for (std::size_t i = count; i-- > 1u;) {
+                tree.sizes[tree.parents[i]] += tree.sizes[i];
+            }
+            for (std::size_t i = count; i-- > 0u;) {
+                std::size_t hash     = this->hasher(tree.value(i));
+                std::size_t children = 0u;
+                for (std::size_t child = i + 1u; child < i + tree.sizes[i]; child += tree.sizes[child]) {
+                    hash = detail::hash_combine(hash, tree.hashes[child]);
+                    ++children;
+                }
+                tree.hashes[i] = detail::hash_combine(hash, children);
+            }
+        }
+
+        static std::vector<std::size_t> children(const flat_tree& tree, std::size_t index) {
+            std::vector<std::size_t> result;
+            for (std::size_t child = index + 1u; child < index + tree.sizes[index]; child += tree.sizes[child]) {
+                result.push_back(child);
+            }
+            return result;
+        }
+
+        // Subtree i of a equals subtree j of b (values and shape)
+        bool equal(std::size_t i, std::size_t j) const {
+            if (this->a.hashes[i] != this->b.hashes[j] || this->a.sizes[i] != this->b.sizes[j]) {
+                return false;
+            }
+            for (std::size_t k = 0u; k < this->a.sizes[i]; ++k) {
+                if (this->a.sizes[i + k] != this->b.sizes[j + k] || !(this->a.value(i + k) == this->b.value(j + k))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void match(std::size_t i, std::size_t j) {
+            this->a.partners[i] = j;
+            this->b.partners[j] = i;
+        }
+
+        void match_subtrees(std::size_t i, std::size_t j) {
+            for (std::size_t k = 0u; k < this->a.sizes[i]; ++k) {
+                this->match(i + k, j + k);
+            }
+            this->a.identical[i] = true;
+            this->b.identical[j] = true;
+        }
+
+        static std::size_t forest_size(const flat_tree& tree, const std::vector<std::size_t>& roots) {
+            std::size_t result = 0u;
+            for (std::size_t root : roots) {
+                result += tree.sizes[root];
+            }
+            return result;
+        }
+
+        // Keeps the longest subsequence of pairs (sorted by first) whose second is increasing
+        static std::vector<std::pair<std::size_t, std::size_t>>
+        increasing_subsequence(const std::vector<std::pair<std::size_t, std::size_t>>& pairs) {
+            // tails[k] is the index of the pair that ends the best subsequence of length k + 1
+            std::vector<std::size_t> tails;
+            std::vector<std::size_t> previous(pairs.size(), NONE);
+            for (std::size_t k = 0u; k < pairs.size(); ++k) {
+                auto position = std::lower_bound(
+                    tails.begin(),
+                    tails.end(),
+                    pairs[k].second,
+                    [&](std::size_t tail, std::size_t value) { return pairs[tail].second < value; });
+                if (position != tails.begin()) {
+                    previous[k] = *std::prev(position);
+                }
+                if (position == tails.end()) {
+                    tails.push_back(k);
+                } else {
+                    *position = k;
+                }
+            }
+            std::vector<std::pair<std::size_t, std::size_t>> result;
+            for (std::size_t k = tails.empty() ? NONE : tails.back(); k != NONE; k = previous[k]) {
+                result.push_back(pairs[k]);
+            }
+            std::reverse(result.begin(), result.end());
+            return result;
+        }
+
+        /*   ---   MATCHING   ---   */
+        void match_top_down() {
+            // Pairs of nodes matched whose children must be aligned
+            std::vector<std::pair<std::size_t, std::size_t>> pending {{0u, 0u}};
+            while (!pending.empty()) {
+                auto [i, j] = pending.back();
+                pending.pop_back();
+                if (this->equal(i, j)) {
+                    this->match_subtrees(i, j);
+                    continue;
+                }
+                this->match(i, j);
+                std::vector<std::size_t> left  = children(this->a, i);
+                std::vector<std::size_t> right = children(this->b, j);
+                std::size_t first              = 0u;
+                std::size_t left_end           = left.size();
+                std::size_t right_end          = right.size();
+                while (first < left_end && first < right_end && this->equal(left[first], right[first])) {
+                    this->match_subtrees(left[first], right[first]);
+                    ++first;
+                }
+                while (first < left_end && first < right_end
+                       && this->equal(left[left_end - 1u], right[right_end - 1u])) {
+                    this->match_subtrees(left[--left_end], right[--right_end]);
+                }
+                this->match_anchors(left, first, left_end, right, first, right_end, pending);
+            }
+        }
+
+        void match_anchors(
+            const std::vector<std::size_t>& left,
+            std::size_t left_begin,
+            std::size_t left_end,
+            const std::vector<std::size_t>& right,
+            std::size_t right_begin,
+            std::size_t right_end,
+            std::vector<std::pair<std::size_t, std::size_t>>& pending) {
+            if (left_begin == left_end || right_begin == right_end) {
+                return;
+            }
+            // Position of the subtree having a given hash on each side, NONE when the hash is repeated on that side
+            struct occurrence {
+                std::size_t left  = NONE;
+                std::size_t right = NONE;
+                bool repeated     = false;
+            };
+            std::unordered_map<std::size_t, occurrence> occurrences;
+            for (std::size_t k = left_begin; k < left_end; ++k) {
+                occurrence& entry = occurrences[this->a.hashes[left[k]]];
+                entry.repeated |= entry.left != NONE;
+                entry.left = k;
+            }
+            for (std::size_t k = right_begin; k < right_end; ++k) {
+                auto entry = occurrences.find(this->b.hashes[right[k]]);
+                if (entry != occurrences.end()) {
+                    entry->second.repeated |= entry->second.right != NONE;
+                    entry->second.right = k;
+                }
+            }
+            std::vector<std::pair<std::size_t, std::size_t>> candidates;
+            for (std::size_t k = left_begin; k < left_end; ++k) {
+                const occurrence& entry = occurrences[this->a.hashes[left[k]]];
+                if (!entry.repeated && entry.right != NONE && this->equal(left[k], right[entry.right])) {
+                    candidates.emplace_back(k, entry.right);
+                }
+            }
+            // The anchors out of order are matched as well, they will be moved among their siblings
+            for (auto [l, r] : candidates) {
+                this->match_subtrees(left[l], right[r]);
+            }
+            // Matches the roots still unmatched between two consecutive anchors in order
+            auto gap = [&](std::size_t l_begin, std::size_t l_end, std::size_t r_begin, std::size_t r_end) {
+                std::vector<std::size_t> l;
+                std::vector<std::size_t> r;
+                for (std::size_t k = l_begin; k < l_end; ++k) {
+                    if (this->a.partners[left[k]] == NONE) {
+                        l.push_back(left[k]);
+                    }
+                }
+                for (std::size_t k = r_begin; k < r_end; ++k) {
+                    if (this->b.partners[right[k]] == NONE) {
+                        r.push_back(right[k]);
+                    }
+                }
+                this->match_gap(l, r, pending);
+            };
+            std::size_t previous_left  = left_begin;
+            std::size_t previous_right = right_begin;
+            for (auto [l, r] : increasing_subsequence(candidates)) {
+                gap(previous_left, l, previous_right, r);
+                previous_left  = l + 1u;
+                previous_right = r + 1u;
+            }
+            gap(previous_left, left_end, previous_right, right_end);
+        }
+
+        // Matches two sequences of sibling subtrees
+        void match_gap(
+            const std::vector<std::size_t>& left,
+            const std::vector<std::size_t>& right,
+            std::vector<std::pair<std::size_t, std::size_t>>& pending) {
+            if (left.empty() || right.empty()) {
+                return;
+            }
+            if (forest_size(this->a, left) * forest_size(this->b, right) <= EXACT_LIMIT) {
+                this->match_exact(left, right);
+                return;
+            }
+            const std::size_t rows = left.size();
+            const std::size_t cols = right.size();
+            std::vector<std::pair<std::size_t, std::size_t>> pairs;
+            if (rows * cols <= ALIGN_LIMIT) {
+                // Longest common subsequence of the values of the roots, suffix[l][r] aligns left[l...] with right[r...]
+                std::vector<std::size_t> suffix((rows + 1u) * (cols + 1u), 0u);
+                auto at = [&](std::size_t l, std::size_t r) -> std::size_t& { return suffix[l * (cols + 1u) + r]; };
+                for (std::size_t l = rows; l-- > 0u;) {
+                    for (std::size_t r = cols; r-- > 0u;) {
+                        at(l, r) = this->a.value(left[l]) == this->b.value(right[r])
+                            ? at(l + 1u, r + 1u) + 1u
+                            : std::max(at(l + 1u, r), at(l, r + 1u));
+                    }
+                }
+                std::size_t l = 0u;
+                std::size_t r = 0u;
+                while (l < rows && r < cols) {
+                    if (this->a.value(left[l]) == this->b.value(right[r])
+                        && at(l, r) == at(l + 1u, r + 1u) + 1u) {
+                        pairs.emplace_back(l++, r++);
+                    } else if (at(l + 1u, r) >= at(l, r + 1u)) {
+                        ++l;
+                    } else {
+                        ++r;
+                    }
+                }
+            } else {
+                // Too many to align, the roots having the same value in the same position are paired
+                for (std::size_t k = 0u; k < std::min(rows, cols); ++k) {
+                    if (this->a.value(left[k]) == this->b.value(right[k])) {
+                        pairs.emplace_back(k, k);
+                    }
+                }
+            }
+            // The stretches between two pairs having the same length on both sides are paired too (values updated)
+            pairs.emplace_back(rows, cols);
+            std::size_t previous_left  = 0u;
+            std::size_t previous_right = 0u;
+            for (auto [l, r] : pairs) {
+                if (l - previous_left == r - previous_right) {
+                    for (std::size_t k = 0u; k < l - previous_left; ++k) {
+                        pending.emplace_back(left[previous_left + k], right[previous_right + k]);
+                    }
+                }
+                if (l < rows) {
+                    pending.emplace_back(left[l], right[r]);
+                }
+                previous_left  = l + 1u;
+                previous_right = r + 1u;
+            }
+        }
+
+        static post_order_forest post_order(const flat_tree& tree, const std::vector<std::size_t>& roots) {
+            post_order_forest result;
+            // Node and next child to visit
+            std::vector<std::pair<std::size_t, std::size_t>> stack;
+            for (std::size_t root : roots) {
+                stack.emplace_back(root, root + 1u);
+                while (!stack.empty()) {
+                    auto& [node, child] = stack.back();
+                    if (child < node + tree.sizes[node]) {
+                        const std::size_t next = child;
+                        child += tree.sizes[next];
+                        stack.emplace_back(next, next + 1u);
+                    } else {
+                        // A subtree is contiguous in post-order and it starts with its leftmost leaf
+                        result.leftmost.push_back(result.nodes.size() + 1u - tree.sizes[node]);
+                        result.nodes.push_back(node);
+                        stack.pop_back();
+                    }
+                }
+            }
+            result.leftmost.push_back(0u);
+            result.nodes.push_back(NONE);
+            return result;
+        }
+
+        // Matches two forests by the mapping of the ordered tree edit distance (Zhang and Shasha) with unit costs
+        void match_exact(const std::vector<std::size_t>& left, const std::vector<std::size_t>& right) {
+            const post_order_forest f = post_order(this->a, left);
+            const post_order_forest g = post_order(this->b, right);
+            const std::size_t n       = f.nodes.size();
+            const std::size_t m       = g.nodes.size();
+            // Distance between the subtrees rooted at x and at y
+            std::vector<std::size_t> distance(n * m, 0u);
+            std::vector<std::size_t> forest;
+            std::size_t cols = 0u;
+            auto at          = [&](std::size_t r, std::size_t c) -> std::size_t& { return forest[r * cols + c]; };
+            auto relabel     = [&](std::size_t x, std::size_t y) -> std::size_t {
+                if (f.nodes[x] == NONE || g.nodes[y] == NONE) {
+                    // The virtual roots go only with each other
+                    return f.nodes[x] == g.nodes[y] ? 0u : 2u;
+                }
+                return this->a.value(f.nodes[x]) == this->b.value(g.nodes[y]) ? 0u : 1u;
+            };
+            // Fills forest with the distances between the prefixes of the subtrees rooted at i and j
+            auto compute = [&](std::size_t i, std::size_t j) {
+                const std::size_t li = f.leftmost[i];
+                const std::size_t lj = g.leftmost[j];
+                cols                 = j - lj + 2u;
+                forest.assign((i - li + 2u) * cols, 0u);
+                for (std::size_t r = 1u; r < i - li + 2u; ++r) {
+                    at(r, 0u) = r;
+                }
+                for (std::size_t c = 1u; c < cols; ++c) {
+                    at(0u, c) = c;
+                }
+                for (std::size_t x = li; x <= i; ++x) {
+                    for (std::size_t y = lj; y <= j; ++y) {
+                        const std::size_t r = x - li + 1u;
+                        const std::size_t c = y - lj + 1u;
+                        std::size_t value   = std::min(at(r - 1u, c), at(r, c - 1u)) + 1u;
+                        if (f.leftmost[x] == li && g.leftmost[y] == lj) {
+                            value                  = std::min(value, at(r - 1u, c - 1u) + relabel(x, y));
+                            distance[x * m + y]    = value;
+                        } else {
+                            value = std::min(value, at(f.leftmost[x] - li, g.leftmost[y] - lj) + distance[x * m + y]);
+                        }
+                        at(r, c) = value;
+                    }
+                }
+            };
+            // Key roots: the highest node of each leftmost path
+            auto key_roots = [](const post_order_forest& forest) {
+                std::vector<bool> seen(forest.nodes.size(), false);
+                std::vector<std::size_t> result;
+                for (std::size_t k = forest.nodes.size(); k-- > 0u;) {
+                    if (!seen[forest.leftmost[k]]) {
+                        seen[forest.leftmost[k]] = true;
+                        result.push_back(k);
+                    }
+                }
+                std::reverse(result.begin(), result.end());
+                return result;
+            };
+            const std::vector<std::size_t> f_roots = key_roots(f);
+            const std::vector<std::size_t> g_roots = key_roots(g);
+            for (std::size_t i : f_roots) {
+                for (std::size_t j : g_roots) {
+                    compute(i, j);
+                }
+            }
+            // Backtrack the mapping, subtree pairs met off the leftmost paths are expanded later
+            std::vector<std::pair<std::size_t, std::size_t>> pairs {{n - 1u, m - 1u}};
+            while (!pairs.empty()) {
+                auto [i, j] = pairs.back();
+                pairs.pop_back();
+                compute(i, j);
+                const std::size_t li = f.leftmost[i];
+                const std::size_t lj = g.leftmost[j];
+                std::size_t r        = i - li + 1u;
+                std::size_t c        = j - lj + 1u;
+                while (r > 0u || c > 0u) {
+                    const std::size_t x = li + r - 1u;
+                    const std::size_t y = lj + c - 1u;
+                    if (r > 0u && at(r, c) == at(r - 1u, c) + 1u) {
+                        --r;
+                    } else if (c > 0u && at(r, c) == at(r, c - 1u) + 1u) {
+                        --c;
+                    } else if (f.leftmost[x] == li && g.leftmost[y] == lj) {
+                        if (f.nodes[x] != NONE && g.nodes[y] != NONE) {
+                            this->match(f.nodes[x], g.nodes[y]);
+                        }
+                        --r;
+                        --c;
+                    } else {
+                        pairs.emplace_back(x, y);
+                        r = f.leftmost[x] - li;
+                        c = g.leftmost[y] - lj;
+                    }
+                }
+            }
+        }
+
+        // The nodes whose subtree has no node matched
+        static std::vector<bool> unmatched_subtrees(const flat_tree& tree) {
+            std::vector<bool> result(tree.nodes.size(), false);
+            for (std::size_t i = tree.nodes.size(); i-- > 0u;) {
+                bool unmatched = tree.partners[i] == NONE;
+                for (std::size_t child = i + 1u; unmatched && child < i + tree.sizes[i]; child += tree.sizes[child]) {
+                    unmatched = result[child];
+                }
+                result[i] = unmatched;
+            }
+            return result;
+        }
+
+        // Matches the subtrees of b left unmatched with equal subtrees of a left unmatched, wherever they are
+        void match_moved() {
+            const std::vector<bool> free_a = unmatched_subtrees(this->a);
+            const std::vector<bool> free_b = unmatched_subtrees(this->b);
+            std::unordered_multimap<std::size_t, std::size_t> candidates;
+            for (std::size_t i = 0u; i < this->a.nodes.size(); ++i) {
+                if (free_a[i]) {
+                    candidates.emplace(this->a.hashes[i], i);
+                }
+            }
+            if (candidates.empty()) {
+                return;
+            }
+            auto still_free = [&](std::size_t i) {
+                for (std::size_t k = i; k < i + this->a.sizes[i]; ++k) {
+                    if (this->a.partners[k] != NONE) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+            std::size_t j = 0u;
+            while (j < this->b.nodes.size()) {
+                if (this->b.identical[j]) {
+                    j += this->b.sizes[j];
+                    continue;
+                }
+                if (free_b[j]) {
+                    auto range = candidates.equal_range(this->b.hashes[j]);
+                    auto found = std::find_if(range.first, range.second, [&](const auto& entry) {
+                        return this->equal(entry.second, j) && still_free(entry.second);
+                    });
+                    if (found != range.second) {
+                        this->match_subtrees(found->second, j);
+                        candidates.erase(found);
+                        j += this->b.sizes[j];
+                        continue;
+                    }
+                }
+                ++j;
+            }
+        }
+
+        // Matches the nodes of b left unmatched with a child having the same value of the partner of their parent
+        void match_recovered() {
+            // Children of a node of a left unmatched, filled the first time they are needed
+            std::unordered_map<std::size_t, std::vector<std::size_t>> unmatched_children;
+            std::size_t j = 1u;
+            while (j < this->b.nodes.size()) {
+                if (this->b.identical[j]) {
+                    j += this->b.sizes[j];
+                    continue;
+                }
+                const std::size_t parent = this->b.partners[this->b.parents[j]];
+                if (this->b.partners[j] == NONE && parent != NONE) {
+                    auto it = unmatched_children.find(parent);
+                    if (it == unmatched_children.end()) {
+                        std::vector<std::size_t> candidates = children(this->a, parent);
+                        candidates.erase(
+                            std::remove_if(
+                                candidates.begin(),
+                                candidates.end(),
+                                [&](std::size_t i) { return this->a.partners[i] != NONE; }),
+                            candidates.end());
+                        it = unmatched_children.emplace(parent, std::move(candidates)).first;
+                    }
+                    auto found = std::find_if(it->second.begin(), it->second.end(), [&](std::size_t i) {
+                        return this->a.value(i) == this->b.value(j);
+                    });
+                    if (found != it->second.end()) {
+                        this->match(*found, j);
+                        it->second.erase(found);
+                    }
+                }
+                ++j;
+            }
+        }
+
+        /*   ---   GENERATION   ---   */
+        nary_tree<T> subtree_of_b(std::size_t j) const {
+            tree_builder<nary_tree<T>> builder;
+            // Ends of the nodes opened
+            std::vector<std::size_t> ends;
+            for (std::size_t k = j; k < j + this->b.sizes[j]; ++k) {
+                while (!ends.empty() && ends.back() == k) {
+                    builder.close();
+                    ends.pop_back();
+                }
+                builder.open(this->b.value(k));
+                ends.push_back(k + this->b.sizes[k]);
+            }
+            for (std::size_t k = 0u; k < ends.size(); ++k) {
+                builder.close();
+            }
+            return builder.build();
+        }
+
+        edit_script<T> generate() {
+            edit_script<T> script;
+            const std::size_t count = this->a.nodes.size();
+            // The mirror of a: its nodes keep their index, the nodes inserted follow
+            std::vector<std::size_t> parents = this->a.parents;
+            // Children of the mirror nodes, filled the first time they are needed
+            std::unordered_map<std::size_t, std::vector<std::size_t>> children_of;
+            auto children = [&](std::size_t node) -> std::vector<std::size_t>& {
+                auto it = children_of.find(node);
+                if (it == children_of.end()) {
+                    it = children_of
+                             .emplace(node, node < count ? tree_differ::children(this->a, node) : std::vector<std::size_t>())
+                             .first;
+                }
+                return it->second;
+            };
+            auto index_of = [&](std::size_t node) -> std::size_t {
+                const std::vector<std::size_t>& siblings = children(parents[node]);
+                return static_cast<std::size_t>(std::find(siblings.begin(), siblings.end(), node) - siblings.begin());
+            };
+            auto path = [&](std::size_t node) {
+                std::vector<std::size_t> result;
+                for (; parents[node] != NONE; node = parents[node]) {
+                    result.push_back(index_of(node));
+                }
+                std::reverse(result.begin(), result.end());
+                return result;
+            };
+            auto emit = [&](edit_kind kind, std::size_t node) -> edit_operation<T>& {
+                script.push_back(edit_operation<T> {kind, path(node), {}, 0u, std::nullopt, nary_tree<T>()});
+                return script.back();
+            };
+            // Subtrees of b whose nodes are all unmatched, they are inserted at once
+            const std::vector<bool> unmatched = unmatched_subtrees(this->b);
+            if (!(this->a.value(0u) == this->b.value(0u))) {
+                emit(edit_kind::UPDATE, 0u).value = this->b.value(0u);
+            }
+            // Position of the mirror nodes among the children of the node being aligned
+            std::vector<std::size_t> positions(count, NONE);
+            std::vector<std::size_t> stack {0u};
+            while (!stack.empty()) {
+                const std::size_t y = stack.back();
+                stack.pop_back();
+                if (this->b.identical[y]) {
+                    continue;
+                }
+                const std::size_t parent             = this->b.partners[y];
+                const std::vector<std::size_t> right = tree_differ::children(this->b, y);
+                // The children already under parent that keep their relative order stay where they are
+                const std::vector<std::size_t>& current = children(parent);
+                for (std::size_t k = 0u; k < current.size(); ++k) {
+                    if (current[k] < count) {
+                        positions[current[k]] = k;
+                    }
+                }
+                std::vector<std::pair<std::size_t, std::size_t>> in_place;
+                for (std::size_t k = 0u; k < right.size(); ++k) {
+                    const std::size_t partner = this->b.partners[right[k]];
+                    if (partner != NONE && parents[partner] == parent) {
+                        in_place.emplace_back(k, positions[partner]);
+                    }
+                }
+                std::vector<bool> keep(right.size(), false);
+                for (auto [k, position] : increasing_subsequence(in_place)) {
+                    keep[k] = true;
+                }
+                std::size_t previous = NONE;
+                for (std::size_t k = 0u; k < right.size(); ++k) {
+                    const std::size_t x = right[k];
+                    std::size_t partner = this->b.partners[x];
+                    if (partner == NONE) {
+                        const std::size_t index = previous == NONE ? 0u : index_of(previous) + 1u;
+                        edit_operation<T>& operation = emit(edit_kind::INSERT, parent);
+                        operation.index              = index;
+                        operation.subtree = unmatched[x] ? this->subtree_of_b(x) : nary_tree<T>(n(this->b.value(x)));
+                        partner           = parents.size();
+                        parents.push_back(parent);
+                        std::vector<std::size_t>& siblings = children(parent);
+                        siblings.insert(siblings.begin() + static_cast<std::ptrdiff_t>(index), partner);
+                        this->b.partners[x] = partner;
+                    } else {
+                        if (!keep[k]) {
+                            edit_operation<T>& operation = emit(edit_kind::MOVE, partner);
+                            std::vector<std::size_t>& old_siblings = children(parents[partner]);
+                            old_siblings.erase(std::find(old_siblings.begin(), old_siblings.end(), partner));
+                            parents[partner]        = parent;
+                            const std::size_t index = previous == NONE ? 0u : index_of(previous) + 1u;
+                            operation.target        = path(parent);
+                            operation.index         = index;
+                            std::vector<std::size_t>& siblings = children(parent);
+                            siblings.insert(siblings.begin() + static_cast<std::ptrdiff_t>(index), partner);
+                        }
+                        if (!(this->a.value(partner) == this->b.value(x))) {
+                            emit(edit_kind::UPDATE, partner).value = this->b.value(x);
+                        }
+                    }
+                    previous = partner;
+                }
+                for (std::size_t k = right.size(); k-- > 0u;) {
+                    if (!unmatched[right[k]]) {
+                        stack.push_back(right[k]);
+                    }
+                }
+            }
+            // The nodes of a left unmatched are removed with their subtree, from the highest ones
+            for (std::size_t i = 1u; i < count; ++i) {
+                if (this->a.partners[i] == NONE && this->a.partners[this->a.parents[i]] != NONE) {
+                    emit(edit_kind::REMOVE, i);
+                    std::vector<std::size_t>& siblings = children(parents[i]);
+                    siblings.erase(std::find(siblings.begin(), siblings.end(), i));
+                }
+            }
+            return script;
+        }
+
+        public:
+        edit_script<T> compute() {
+            this->match_top_down();
+            this->match_moved();
+            this->match_recovered();
+            return this->generate();
+        }
+    };
+
+} // namespace detail
+
+/**
+ * @brief Computes the operations that turn tree a into tree b.
+ * @details Equal subtrees are recognized by their hash, therefore the cost is close to linear in the size of the trees
+ * when the differences are localized, the nodes that moved from a place to another are found as long as their
+ * subtree is unchanged. Small regions that differ are matched exactly by the ordered tree edit distance (Zhang and
+ * Shasha). The script is short but not guaranteed minimal: minimality with moves is NP-hard. Applying the script to a
+ * (see {@link apply()}) gives a tree equal to b.
+ *
+ * @code
+ * edit_script<char> script = diff(before, after);
+ * apply(before, script); // before == after
+ * @endcode
+ *
+ * @param hasher hash function of the values
+ * @return the list of operations, empty if the trees are equal
+ */
+template <
+    typename T,
+    typename P1,
+    typename A1,
+    typename P2,
+    typename A2,
+    typename Hash = std::hash<T>>
+edit_script<T> diff(const nary_tree<T, P1, A1>& a, const nary_tree<T, P2, A2>& b, const Hash& hasher = Hash()) {
+    edit_script<T> script;
+    if (a.empty() && b.empty()) {
+        return script;
+    }
+    if (b.empty()) {
+        script.push_back(edit_operation<T> {edit_kind::REMOVE, {}, {}, 0u, std::nullopt, nary_tree<T>()});
+    } else if (a.empty()) {
+        script.push_back(edit_operation<T> {edit_kind::INSERT, {}, {}, 0u, std::nullopt, detail::copy_nodes<nary_tree<T>>(b.raw_root_node(), {})});
+    } else {
+        script = detail::tree_differ<T, Hash>(*a.raw_root_node(), *b.raw_root_node(), hasher).compute();
+    }
+    return script;
+}
+
+/**
+ * @brief Executes the operations of the script on the tree, by means of its modifiers.
+ * @details A change_log attached to the tree records the modifications. Call it as md::apply(): the script is an
+ * std::vector, therefore an unqualified call finds std::apply() as well.
+ * @throw std::invalid_argument if a path of the script does not lead to a node of the tree
+ */
+template <typename T, typename Policy, typename Allocator>
+void apply(nary_tree<T, Policy, Allocator>& tree, const edit_script<T>& script) {
+    // The subtrees of the script are copied by the allocator of the tree
+    auto copy = [&](const nary_tree<T>& subtree) {
+        return detail::copy_nodes<nary_tree<T, Policy, Allocator>>(subtree.raw_root_node(), tree.get_allocator());
+    };
+    auto resolve = [&](const std::vector<std::size_t>& path) {
+        nary_node<T>* node = tree.raw_root_node();
+        for (std::size_t index : path) {
+            if (node == nullptr) {
+                break;
+            }
+            node = node->get_child(index);
+        }
+        if (node == nullptr) {
+            throw std::invalid_argument("The edit script does not apply to the tree: a path leads nowhere.");
+        }
+        return node;
+    };
+    for (const edit_operation<T>& operation : script) {
+        switch (operation.kind) {
+        case edit_kind::INSERT:
+            if (tree.empty() && operation.path.empty()) {
+                tree = copy(operation.subtree);
+            } else {
+                tree.insert_child(
+                    tree.root().other_node(resolve(operation.path)),
+                    operation.index,
+                    copy(operation.subtree));
+            }
+            break;
+        case edit_kind::REMOVE:
+            tree.erase(tree.begin(policy::post_order()).other_node(resolve(operation.path)));
+            break;
+        case edit_kind::UPDATE: {
+            nary_node<T>* node = resolve(operation.path);
+            node->get_value()  = *operation.value;
+            if (tree.get_change_log() != nullptr) {
+                tree.get_change_log()->touch(*node);
+            }
+            break;
+        }
+        case edit_kind::MOVE: {
+            auto detached = tree.detach_subtree(tree.root().other_node(resolve(operation.path)));
+            tree.insert_child(tree.root().other_node(resolve(operation.target)), operation.index, std::move(detached));
+            break;
+        }
+        }
+    }
+}
+
+} // namespace md
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>   // std::min(), std::max()
+#include <cstddef>     // std::size_t
+#include <limits>      // std::numeric_limits
+#include <stdexcept>   // std::invalid_argument
+#include <type_traits> // std::remove_const_t
+#include <unordered_map>
+
+#include <TreeDS/change_log.hpp>
+#include <TreeDS/policy/post_order.hpp>
+#include <TreeDS/tree_iterator.hpp>
+
+namespace md {
+
+/// @brief Sum of the values, T() for no value.
+template <typename T>
+struct sum_monoid {
+    using result_type = T;
+
+    result_type identity() const {
+        return T();
+    }
+
+    result_type lift(const T& value) const {
+        return value;
+    }
+
+    result_type combine(const result_type& lhs, const result_type& rhs) const {
+        return lhs + rhs;
+    }
+};
+
+/// @brief Minimum of the values, the maximum possible value for no value.
+template <typename T>
+struct min_monoid {
+    using result_type = T;
+
+    result_type identity() const {
+        return std::numeric_limits<T>::max();
+    }
+
+    result_type lift(const T& value) const {
+        return value;
+    }
+
+    result_type combine(const result_type& lhs, const result_type& rhs) const {
+        return std::min(lhs, rhs);
+    }
+};
+
+/// @brief Maximum of the values, the lowest possible value for no value.
+template <typename T>
+struct max_monoid {
+    using result_type = T;
+
+    result_type identity() const {
+        return std::numeric_limits<T>::lowest();
+    }
+
+    result_type lift(const T& value) const {
+        return value;
+    }
+
+    result_type combine(const result_type& lhs, const result_type& rhs) const {
+        return std::max(lhs, rhs);
+    }
+};
+
+/// @brief Number of values.
+template <typename T>
+struct count_monoid {
+    using result_type = std::size_t;
+
+    result_type identity() const {
+        return 0u;
+    }
+
+    result_type lift(const T&) const {
+        return 1u;
+    }
+
+    result_type combine(result_type lhs, result_type rhs) const {
+        return lhs + rhs;
+    }
+};
+
+/**
+ * @brief Associates each node of a tree to the aggregate of the values of its subtree under a monoid.
+ * @details The monoid provides identity(), lift() turning a value into an aggregate and an associative combine(). The
+ * aggregate of a node combines its value and the aggregates of its children, in pre-order. {@link #aggregate()} answers
+ * in constant time. After some modifications, recorded by a {@link change_log} attached to the tree, {@link #update()}
+ * computes again only the aggregates of the nodes inserted or touched and of their ancestors: the path to the root of
+ * each modification. Values modified through iterators must be reported to the log with change_log::touch(), otherwise
+ * their aggregates are stale.
+ *
+ * @code
+ * change_log<nary_node<int>> log;
+ * tree.set_change_log(&log);
+ * aggregate_index<nary_tree<int>, sum_monoid<int>> sums(tree);
+ * tree.emplace_child_back(position, 4);
+ * sums.update(log);
+ * log.clear();
+ * int total = sums.aggregate();
+ * @endcode
+ *
+ * @tparam Tree the type of tree indexed
+ * @tparam Monoid the operation aggregating the values, for example {@link sum_monoid}
+ */
+template <typename Tree, typename Monoid>
+class aggregate_index {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using tree_type   = Tree;
+    using value_type  = typename Tree::value_type;
+    using node_type   = const typename Tree::node_type;
+    using monoid_type = Monoid;
+    using result_type = typename Monoid::result_type;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    std::unordered_map<node_type*, result_type> aggregates;
+    const Tree* tree;
+    Monoid monoid;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    /// @brief Computes the aggregates of every node of the tree.
+    explicit aggregate_index(const Tree& tree, const Monoid& monoid = Monoid()) :
+            tree(&tree),
+            monoid(monoid) {
+        this->rebuild();
+    }
+
+    /*   ---   METHODS   ---   */
+    protected:
+    // The aggregate of the node, given the ones of its children
+    result_type compute(node_type& node) const {
+        result_type result = this->monoid.lift(node.get_value());
+        for (node_type* child = node.get_first_child(); child != nullptr; child = child->get_next_sibling()) {
+            result = this->monoid.combine(result, this->aggregates.find(child)->second);
+        }
+        return result;
+    }
+
+    public:
+    /// @brief Forgets the aggregates and computes again the ones of every node.
+    void rebuild() {
+        this->aggregates.clear();
+        this->aggregates.reserve(this->tree->size());
+        // Post-order visits the children before their parent
+        for (auto it = this->tree->begin(policy::post_order()); it != this->tree->end(policy::post_order()); ++it) {
+            this->aggregates.emplace(it.get_raw_node(), this->compute(*it.get_raw_node()));
+        }
+    }
+
+    /**
+     * @brief Brings the aggregates up to date with the modifications in the log.
+     * @details The log must have recorded every modification since the previous update (or the construction). The
+     * cost is proportional to the number of nodes affected by the modifications, see change_log::for_each_affected().
+     */
+    void update(const change_log<std::remove_const_t<node_type>>& log) {
+        if (log.is_reset()) {
+            this->rebuild();
+            return;
+        }
+        for (node_type* node : log.get_removed()) {
+            this->aggregates.erase(node);
+        }
+        // The aggregates of the nodes not affected are still valid
+        log.for_each_affected_post_order([this](node_type& node) {
+            this->aggregates[&node] = this->compute(node);
+        });
+    }
+
+    /// @brief The aggregate of the whole tree, the identity of the monoid if it is empty.
+    result_type aggregate() const {
+        node_type* root = this->tree->raw_root_node();
+        return root != nullptr ? this->aggregates.find(root)->second : this->monoid.identity();
+    }
+
+    /**
+     * @brief The aggregate of the subtree of a node.
+     * @throw std::invalid_argument if the node is not in the tree indexed
+     */
+    const result_type& aggregate(node_type& node) const {
+        auto it = this->aggregates.find(&node);
+        if (it == this->aggregates.end()) {
+            throw std::invalid_argument("Tried to get the aggregate of a node that is not in the tree indexed.");
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief The aggregate of the subtree at position.
+     * @throw std::invalid_argument if the iterator does not point to a node of the tree indexed
+     */
+    template <typename T, typename P, typename N>
+    const result_type& aggregate(const tree_iterator<T, P, N>& position) const {
+        if (position.get_raw_node() == nullptr) {
+            throw std::invalid_argument("Tried to get the aggregate of a non valid position (end).");
+        }
+        return this->aggregate(*position.get_raw_node());
+    }
+
+    /// @brief Number of nodes indexed.
+    std::size_t size() const {
+        return this->aggregates.size();
+    }
+
+    /// @brief Whether the index was built from the given tree.
+    template <typename OtherTree>
+    bool is_index_of(const OtherTree& tree) const {
+        return static_cast<const void*>(this->tree) == static_cast<const void*>(&tree);
+    }
+};
+
+} // namespace md
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm> // std::min(), std::swap()
+#include <cstddef>   // std::size_t
+#include <cstdint>   // std::uint32_t
+#include <vector>
+
+#include <TreeDS/indexer/preorder_numbering.hpp>
+
+namespace md {
+
+namespace detail {
+
+    // Position of the lowest bit set, value must not be 0 (de Bruijn sequence)
+    inline unsigned lowest_bit_index(std::uint32_t value) {
+        static constexpr unsigned char POSITIONS[32] = {
+            0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+            31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9};
+        return POSITIONS[static_cast<std::uint32_t>((value & (~value + 1u)) * 0x077CB531u) >> 27];
+    }
+
+    // Position of the highest bit set, value must not be 0
+    inline unsigned highest_bit_index(std::uint32_t value) {
+        value |= value >> 1;
+        value |= value >> 2;
+        value |= value >> 4;
+        value |= value >> 8;
+        value |= value >> 16;
+        return lowest_bit_index(value - (value >> 1));
+    }
+
+} // namespace detail
+
+/**
+ * @brief Finds the lowest common ancestor of two nodes of a tree in constant time.
+ * @details The nodes are numbered in pre-order as {@link preorder_numbering} does, the ancestry checks are inherited
+ * from it. Given two nodes numbered u < v, every node numbered in (u, v] descends from their lowest common ancestor and
+ * the one closest to the root is its child: the ancestor is the minimum among the numbers of the parents in that range.
+ * The range minimum is answered in constant time by a sparse table over blocks of 32 nodes and, inside a block, by a
+ * bit mask per node of the positions that are the minimum of a suffix of the block. The index takes between 30 and 40
+ * bytes per node (the pointers to the nodes included) and is built in linear time. It is not updated when the tree is
+ * modified: it must be rebuilt with {@link #rebuild()}.
+ *
+ * @code
+ * lca_index index(tree);
+ * const nary_node<char>* common = index.lowest_common_ancestor(*a, *b);
+ * bool below = index.is_ancestor(*common, *a); // true
+ * @endcode
+ *
+ * @tparam Tree the type of tree indexed
+ */
+template <typename Tree>
+class lca_index : public preorder_numbering<Tree> {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using typename preorder_numbering<Tree>::tree_type;
+    using typename preorder_numbering<Tree>::value_type;
+    using typename preorder_numbering<Tree>::node_type;
+    using typename preorder_numbering<Tree>::id_type;
+    using preorder_numbering<Tree>::NONE;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    static constexpr std::size_t BLOCK_BITS = 5u;
+    static constexpr std::size_t BLOCK_SIZE = std::size_t(1u) << BLOCK_BITS;
+    // Bit i of the mask of a node is set if position i of its block holds the minimum of the block from i to the node
+    std::vector<std::uint32_t> masks;
+    // Level k holds the minimum of the 2^k blocks starting at each block
+    std::vector<std::vector<id_type>> levels;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    lca_index() {
+    }
+
+    explicit lca_index(const Tree& tree) {
+        this->rebuild(tree);
+    }
+
+    /*   ---   METHODS   ---   */
+    protected:
+    // Minimum of the parents numbered from first to last, both in the same block
+    id_type block_minimum(std::size_t first, std::size_t last) const {
+        const std::uint32_t candidates = this->masks[last] & (~std::uint32_t(0u) << (first & (BLOCK_SIZE - 1u)));
+        return this->parents[(last & ~(BLOCK_SIZE - 1u)) + detail::lowest_bit_index(candidates)];
+    }
+
+    // Minimum of the parents numbered from first to last
+    id_type minimum(std::size_t first, std::size_t last) const {
+        const std::size_t first_block = first >> BLOCK_BITS;
+        const std::size_t last_block  = last >> BLOCK_BITS;
+        if (first_block == last_block) {
+            return this->block_minimum(first, last);
+        }
+        id_type result = std::min(
+            this->block_minimum(first, ((first_block + 1u) << BLOCK_BITS) - 1u),
+            this->block_minimum(last_block << BLOCK_BITS, last));
+        if (first_block + 1u < last_block) {
+            const std::size_t count = last_block - first_block - 1u;
+            const unsigned level    = detail::highest_bit_index(static_cast<std::uint32_t>(count));
+            const auto& minimums    = this->levels[level];
+            result                  = std::min(
+                result,
+                std::min(minimums[first_block + 1u], minimums[last_block - (std::size_t(1u) << level)]));
+        }
+        return result;
+    }
+
+    public:
+    /**
+     * @brief Indexes again the tree, the previous content is discarded.
+     * @throw std::length_error if the tree has too many nodes to be numbered in 32 bits
+     */
+    void rebuild(const Tree& tree) {
+        preorder_numbering<Tree>::rebuild(tree);
+        const std::size_t size = this->size();
+        this->masks.assign(size, 0u);
+        this->levels.clear();
+        if (size == 0u) {
+            return;
+        }
+        // The positions of the suffix minimums form a stack, the parent of the root (NONE) is never a minimum
+        const std::size_t blocks = ((size - 1u) >> BLOCK_BITS) + 1u;
+        std::vector<id_type> minimums(blocks);
+        for (std::size_t block = 0u; block < blocks; ++block) {
+            const std::size_t first = block << BLOCK_BITS;
+            const std::size_t last  = std::min(first + BLOCK_SIZE, size);
+            std::uint32_t mask      = 0u;
+            for (std::size_t i = first; i < last; ++i) {
+                const id_type parent = this->parents[i];
+                while (mask != 0u && this->parents[first + detail::highest_bit_index(mask)] >= parent) {
+                    mask &= ~(std::uint32_t(1u) << detail::highest_bit_index(mask));
+                }
+                mask |= std::uint32_t(1u) << (i - first);
+                this->masks[i] = mask;
+            }
+            minimums[block] = this->parents[first + detail::lowest_bit_index(mask)];
+        }
+        this->levels.push_back(std::move(minimums));
+        for (std::size_t width = 1u; 2u * width <= blocks; width *= 2u) {
+            const std::vector<id_type>& previous = this->levels.back();
+            std::vector<id_type> next(blocks - 2u * width + 1u);
+            for (std::size_t i = 0u; i < next.size(); ++i) {
+                next[i] = std::min(previous[i], previous[i + width]);
+            }
+            this->levels.push_back(std::move(next));
+        }
+    }
+
+    /// @brief The number of the lowest common ancestor of the nodes numbered a and b.
+    id_type lowest_common_ancestor(id_type a, id_type b) const {
+        if (a == b) {
+            return a;
+        }
+        if (a > b) {
+            std::swap(a, b);
+        }
+        return this->minimum(std::size_t(a) + 1u, b);
+    }
+
+    /**
+     * @brief The lowest common ancestor of two nodes, which is one of them when it is an ancestor of the other.
+     * @throw std::invalid_argument if a node is not in the tree indexed
+     */
+    node_type* lowest_common_ancestor(const node_type& a, const node_type& b) const {
+        return this->nodes[this->lowest_common_ancestor(this->id(a), this->id(b))];
+    }
+};
+
+} // namespace md
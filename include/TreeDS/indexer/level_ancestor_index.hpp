@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm> // std::max(), std::upper_bound()
+#include <cstddef>   // std::size_t
+#include <vector>
+
+#include <TreeDS/indexer/preorder_numbering.hpp>
+
+namespace md {
+
+/**
+ * @brief Finds the ancestor of a node k levels up, without visiting the levels in between.
+ * @details The nodes are numbered in pre-order as {@link preorder_numbering} does and grouped by depth, keeping the
+ * pre-order within each depth. The ancestor of a node at a given depth is the last node of that depth numbered before
+ * it, therefore {@link #ancestor()} is a binary search in one depth: O(log n) whatever the distance, where walking the
+ * parents costs one hop per level. The index takes at most 12 bytes per node besides the numbering and is built in
+ * linear time. It is not updated when the tree is modified: it must be rebuilt with {@link #rebuild()}.
+ *
+ * @code
+ * level_ancestor_index index(tree);
+ * const nary_node<char>* grandparent = index.ancestor(*node, 2); // nullptr if node is less than 2 levels deep
+ * @endcode
+ *
+ * @tparam Tree the type of tree indexed
+ */
+template <typename Tree>
+class level_ancestor_index : public preorder_numbering<Tree> {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using typename preorder_numbering<Tree>::tree_type;
+    using typename preorder_numbering<Tree>::value_type;
+    using typename preorder_numbering<Tree>::node_type;
+    using typename preorder_numbering<Tree>::id_type;
+    using preorder_numbering<Tree>::NONE;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    // Distance of each node from the root
+    std::vector<id_type> depths;
+    // Numbers of the nodes grouped by depth, in pre-order within each depth
+    std::vector<id_type> levels;
+    // Position in levels of the first node of each depth, followed by the number of nodes
+    std::vector<id_type> level_starts;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    level_ancestor_index() {
+    }
+
+    explicit level_ancestor_index(const Tree& tree) {
+        this->rebuild(tree);
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    /**
+     * @brief Indexes again the tree, the previous content is discarded.
+     * @throw std::length_error if the tree has too many nodes to be numbered in 32 bits
+     */
+    void rebuild(const Tree& tree) {
+        preorder_numbering<Tree>::rebuild(tree);
+        const std::size_t size = this->size();
+        this->depths.assign(size, 0u);
+        this->levels.assign(size, 0u);
+        this->level_starts.clear();
+        if (size == 0u) {
+            return;
+        }
+        // The parent precedes its children
+        id_type height = 0u;
+        for (std::size_t i = 1u; i < size; ++i) {
+            this->depths[i] = this->depths[this->parents[i]] + 1u;
+            height          = std::max(height, this->depths[i]);
+        }
+        // Counting sort by depth, stable: the pre-order is kept within each depth
+        this->level_starts.assign(std::size_t(height) + 2u, 0u);
+        for (std::size_t i = 0u; i < size; ++i) {
+            ++this->level_starts[this->depths[i] + 1u];
+        }
+        for (std::size_t depth = 1u; depth < this->level_starts.size(); ++depth) {
+            this->level_starts[depth] += this->level_starts[depth - 1u];
+        }
+        std::vector<id_type> next(this->level_starts.begin(), this->level_starts.end() - 1);
+        for (std::size_t i = 0u; i < size; ++i) {
+            this->levels[next[this->depths[i]]++] = static_cast<id_type>(i);
+        }
+    }
+
+    /// @brief Number of levels between the node numbered id and the root.
+    id_type depth(id_type id) const {
+        return this->depths[id];
+    }
+
+    /**
+     * @brief Number of levels between the node and the root.
+     * @throw std::invalid_argument if the node is not in the tree indexed
+     */
+    id_type depth(const node_type& node) const {
+        return this->depths[this->id(node)];
+    }
+
+    /// @brief Number of levels below the root, 0 for an empty tree.
+    std::size_t height() const {
+        return !this->level_starts.empty() ? this->level_starts.size() - 2u : 0u;
+    }
+
+    /// @brief The number of the ancestor of the node numbered id at the given depth, {@link #NONE} if deeper than it.
+    id_type ancestor_at_depth(id_type id, std::size_t depth) const {
+        if (depth > this->depths[id]) {
+            return NONE;
+        }
+        auto first = this->levels.begin() + this->level_starts[depth];
+        auto last  = this->levels.begin() + this->level_starts[depth + 1u];
+        return *(std::upper_bound(first, last, id) - 1);
+    }
+
+    /// @brief The number of the ancestor k levels above the node numbered id, {@link #NONE} past the root.
+    id_type ancestor(id_type id, std::size_t k) const {
+        return k <= this->depths[id] ? this->ancestor_at_depth(id, this->depths[id] - k) : NONE;
+    }
+
+    /**
+     * @brief The ancestor k levels above the node: the node itself for 0, its parent for 1 and so on.
+     * @return the ancestor or nullptr if the node is less than k levels deep
+     * @throw std::invalid_argument if the node is not in the tree indexed
+     */
+    node_type* ancestor(const node_type& node, std::size_t k) const {
+        const id_type result = this->ancestor(this->id(node), k);
+        return result != NONE ? this->nodes[result] : nullptr;
+    }
+};
+
+} // namespace md
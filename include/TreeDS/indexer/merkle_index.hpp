@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef>     // std::size_t
+#include <functional>  // std::hash
+#include <stdexcept>   // std::invalid_argument
+#include <type_traits> // std::is_same_v, std::decay_t, std::remove_const_t
+#include <unordered_map>
+
+#include <TreeDS/change_log.hpp>
+#include <TreeDS/node/binary_node.hpp>
+#include <TreeDS/policy/post_order.hpp>
+#include <TreeDS/utility.hpp>
+
+namespace md {
+
+/**
+ * @brief Associates each node of a tree to a hash of its subtree (value and children, in order), a Merkle tree.
+ * @details Two equal subtrees have the same hash, therefore two trees having different hashes are different: {@link
+ * #equal()} answers in constant time in that case, and the hash of the root can be used as the key of a cache. After
+ * some modifications, recorded by a {@link change_log} attached to the tree, {@link #update()} computes again only the
+ * hashes of the nodes inserted or touched and of their ancestors. Values modified through iterators must be reported
+ * to the log with change_log::touch(), otherwise their hashes are stale.
+ *
+ * @code
+ * change_log<nary_node<char>> log;
+ * tree.set_change_log(&log);
+ * merkle_index hashes(tree);
+ * tree.insert_over(position, 'x');
+ * hashes.update(log);
+ * log.clear();
+ * @endcode
+ *
+ * @tparam Tree the type of tree indexed
+ * @tparam Hash hash function of the values
+ */
+template <typename Tree, typename Hash = std::hash<typename Tree::value_type>>
+class merkle_index {
+
+    /*   ---   FRIENDS   ---   */
+    template <typename, typename>
+    friend class merkle_index;
+
+    /*   ---   TYPES   ---   */
+    public:
+    using tree_type  = Tree;
+    using value_type = typename Tree::value_type;
+    using node_type  = const typename Tree::node_type;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    // Hash of the empty tree and of the missing children of a binary node
+    static constexpr std::size_t EMPTY_HASH = 0x6A09E667F3BCC908u;
+    std::unordered_map<node_type*, std::size_t> hashes;
+    const Tree* tree;
+    Hash hasher;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    /// @brief Computes the hashes of every node of the tree.
+    explicit merkle_index(const Tree& tree, const Hash& hasher = Hash()) :
+            tree(&tree),
+            hasher(hasher) {
+        this->rebuild();
+    }
+
+    /*   ---   METHODS   ---   */
+    protected:
+    // The hash of the node, given the hashes of its children
+    template <typename ChildHash>
+    std::size_t compute(node_type& node, ChildHash&& child_hash) const {
+        std::size_t result = this->hasher(node.get_value());
+        if constexpr (std::is_same_v<std::decay_t<node_type>, binary_node<value_type>>) {
+            // The position matters: a left child differs from a right child
+            node_type* left  = node.get_left_child();
+            node_type* right = node.get_right_child();
+            result           = detail::hash_combine(result, left ? child_hash(*left) : EMPTY_HASH);
+            result           = detail::hash_combine(result, right ? child_hash(*right) : EMPTY_HASH);
+        } else {
+            std::size_t children = 0u;
+            for (node_type* child = node.get_first_child(); child != nullptr; child = child->get_next_sibling()) {
+                result = detail::hash_combine(result, child_hash(*child));
+                ++children;
+            }
+            result = detail::hash_combine(result, children);
+        }
+        return result;
+    }
+
+    public:
+    /// @brief Forgets the hashes and computes again the ones of every node.
+    void rebuild() {
+        this->hashes.clear();
+        this->hashes.reserve(this->tree->size());
+        auto child_hash = [this](node_type& child) {
+            return this->hashes.find(&child)->second;
+        };
+        // Post-order visits the children before their parent
+        for (auto it = this->tree->begin(policy::post_order()); it != this->tree->end(policy::post_order()); ++it) {
+            this->hashes.emplace(it.get_raw_node(), this->compute(*it.get_raw_node(), child_hash));
+        }
+    }
+
+    /**
+     * @brief Brings the hashes up to date with the modifications in the log.
+     * @details The log must have recorded every modification since the previous update (or the construction). The
+     * cost is proportional to the number of nodes affected by the modifications, see change_log::for_each_affected().
+     */
+    void update(const change_log<std::remove_const_t<node_type>>& log) {
+        if (log.is_reset()) {
+            this->rebuild();
+            return;
+        }
+        for (node_type* node : log.get_removed()) {
+            this->hashes.erase(node);
+        }
+        auto child_hash = [this](node_type& child) {
+            return this->hashes.find(&child)->second;
+        };
+        // The hashes of the nodes not affected are still valid
+        log.for_each_affected_post_order([&](node_type& node) {
+            this->hashes[&node] = this->compute(node, child_hash);
+        });
+    }
+
+    /// @brief The hash of the whole tree, equal trees have equal hashes.
+    std::size_t hash() const {
+        node_type* root = this->tree->raw_root_node();
+        return root != nullptr ? this->hashes.find(root)->second : EMPTY_HASH;
+    }
+
+    /**
+     * @brief The hash of the subtree of a node.
+     * @throw std::invalid_argument if the node is not in the tree indexed
+     */
+    std::size_t hash(node_type& node) const {
+        auto it = this->hashes.find(&node);
+        if (it == this->hashes.end()) {
+            throw std::invalid_argument("Tried to get the hash of a node that is not in the tree indexed.");
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Whether the tree indexed is equal to the one indexed by other.
+     * @details When the hashes differ the answer is given in constant time, otherwise the trees are compared node by
+     * node to exclude a collision. Both indexes must be up to date and use the same hash function.
+     */
+    template <typename OtherTree>
+    bool equal(const merkle_index<OtherTree, Hash>& other) const {
+        static_assert(
+            std::is_same_v<node_type, typename merkle_index<OtherTree, Hash>::node_type>,
+            "The hashes of trees having different types of nodes are not comparable.");
+        return this->hash() == other.hash() && *this->tree == *other.tree;
+    }
+
+    /// @brief Number of nodes indexed.
+    std::size_t size() const {
+        return this->hashes.size();
+    }
+
+    /// @brief Whether the index was built from the given tree.
+    template <typename OtherTree>
+    bool is_index_of(const OtherTree& tree) const {
+        return static_cast<const void*>(this->tree) == static_cast<const void*>(&tree);
+    }
+};
+
+} // namespace md
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>   // std::size_t
+#include <cstdint>   // std::uint32_t
+#include <limits>    // std::numeric_limits
+#include <stdexcept> // std::invalid_argument, std::length_error
+#include <vector>
+
+#include <TreeDS/utility.hpp>
+
+namespace md {
+
+/**
+ * @brief Numbers the nodes of a tree in pre-order and finds the number of a node in constant time.
+ * @details The descendants of a node are numbered right after it, therefore a node is an ancestor of another one when
+ * the number of the other falls in the range of its subtree: {@link #is_ancestor()} answers in constant time without
+ * walking the parents. The numbers are kept in 32 bits to save memory, which limits the tree to about 4 billions of
+ * nodes. The numbering can be built from a tree or a view, whose root is numbered 0 even when it has a parent in the
+ * tree viewed. It is not updated when the tree is modified: it must be rebuilt with {@link #rebuild()}.
+ * @tparam Tree the type of tree numbered
+ */
+template <typename Tree>
+class preorder_numbering {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using tree_type  = Tree;
+    using value_type = typename Tree::value_type;
+    using node_type  = const typename Tree::node_type;
+    using id_type    = std::uint32_t;
+
+    /// @brief The number of no node: the parent of the root, the nodes not in the tree.
+    static constexpr id_type NONE = std::numeric_limits<id_type>::max();
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    // Nodes in pre-order
+    std::vector<node_type*> nodes;
+    // Number of the parent of each node
+    std::vector<id_type> parents;
+    // Number following the last descendant of each node
+    std::vector<id_type> ends;
+    // Open addressing table probed linearly, each slot holds the number of a node or NONE
+    std::vector<id_type> table;
+    unsigned bits    = 0u;
+    const Tree* tree = nullptr;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    preorder_numbering() {
+    }
+
+    explicit preorder_numbering(const Tree& tree) {
+        this->rebuild(tree);
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    /**
+     * @brief Numbers again the nodes of the tree, the previous content is discarded.
+     * @throw std::length_error if the tree has too many nodes to be numbered in 32 bits
+     */
+    void rebuild(const Tree& tree) {
+        this->nodes.clear();
+        this->parents.clear();
+        this->ends.clear();
+        this->table.clear();
+        this->tree = &tree;
+        node_type* root = tree.raw_root_node();
+        if (root == nullptr) {
+            return;
+        }
+        this->nodes.reserve(tree.size());
+        this->parents.reserve(tree.size());
+        // The children are reached from the first one and the siblings, the parent of the root is never visited
+        std::vector<id_type> path;
+        node_type* node = root;
+        while (true) {
+            if (this->nodes.size() >= NONE) {
+                throw std::length_error("The tree has too many nodes to be numbered.");
+            }
+            this->parents.push_back(path.empty() ? NONE : path.back());
+            this->nodes.push_back(node);
+            if (node->get_first_child() != nullptr) {
+                path.push_back(static_cast<id_type>(this->nodes.size() - 1u));
+                node = node->get_first_child();
+                continue;
+            }
+            while (!path.empty() && node->get_next_sibling() == nullptr) {
+                node = node->get_parent();
+                path.pop_back();
+            }
+            if (path.empty()) {
+                break;
+            }
+            node = node->get_next_sibling();
+        }
+        const std::size_t size = this->nodes.size();
+        // The parent precedes its children: the sizes of the subtrees are accumulated in reverse pre-order
+        this->ends.assign(size, 1u);
+        for (std::size_t i = size - 1u; i > 0u; --i) {
+            this->ends[this->parents[i]] += this->ends[i];
+        }
+        for (std::size_t i = 0u; i < size; ++i) {
+            this->ends[i] += static_cast<id_type>(i);
+        }
+        // At most half of the slots are taken
+        std::size_t capacity = 2u;
+        this->bits           = 1u;
+        while (capacity < 2u * size) {
+            capacity <<= 1u;
+            ++this->bits;
+        }
+        this->table.assign(capacity, NONE);
+        const std::size_t mask = capacity - 1u;
+        for (std::size_t i = 0u; i < size; ++i) {
+            std::size_t slot = detail::fibonacci_slot(this->nodes[i], this->bits);
+            while (this->table[slot] != NONE) {
+                slot = (slot + 1u) & mask;
+            }
+            this->table[slot] = static_cast<id_type>(i);
+        }
+    }
+
+    /// @brief The number of the node, or {@link #NONE} if it is not in the tree numbered.
+    id_type find(const node_type& node) const {
+        if (this->table.empty()) {
+            return NONE;
+        }
+        const std::size_t mask = this->table.size() - 1u;
+        for (std::size_t slot = detail::fibonacci_slot(&node, this->bits);; slot = (slot + 1u) & mask) {
+            const id_type id = this->table[slot];
+            if (id == NONE || this->nodes[id] == &node) {
+                return id;
+            }
+        }
+    }
+
+    /**
+     * @brief The number of the node.
+     * @throw std::invalid_argument if the node is not in the tree numbered
+     */
+    id_type id(const node_type& node) const {
+        const id_type result = this->find(node);
+        if (result == NONE) {
+            throw std::invalid_argument("Tried to get the number of a node that is not in the tree indexed.");
+        }
+        return result;
+    }
+
+    /// @brief The node having the given number.
+    node_type* node(id_type id) const {
+        return this->nodes[id];
+    }
+
+    /// @brief The number of the parent of a node, {@link #NONE} for the root.
+    id_type parent(id_type id) const {
+        return this->parents[id];
+    }
+
+    /// @brief The number following the last descendant of a node, the subtree is numbered from id to this excluded.
+    id_type subtree_end(id_type id) const {
+        return this->ends[id];
+    }
+
+    /// @brief Whether ancestor is node or one of its ancestors.
+    bool is_ancestor(id_type ancestor, id_type node) const {
+        return ancestor <= node && node < this->ends[ancestor];
+    }
+
+    /**
+     * @brief Whether ancestor is node or one of its ancestors.
+     * @throw std::invalid_argument if a node is not in the tree numbered
+     */
+    bool is_ancestor(const node_type& ancestor, const node_type& node) const {
+        return this->is_ancestor(this->id(ancestor), this->id(node));
+    }
+
+    /// @brief Number of nodes numbered.
+    std::size_t size() const {
+        return this->nodes.size();
+    }
+
+    /// @brief Whether the numbering was built from the given tree.
+    template <typename OtherTree>
+    bool is_index_of(const OtherTree& tree) const {
+        return static_cast<const void*>(this->tree) == static_cast<const void*>(&tree);
+    }
+};
+
+} // namespace md
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>  // std::max()
+#include <cstddef>    // std::size_t
+#include <functional> // std::hash
+#include <vector>
+
+#include <TreeDS/matcher/structural_signature.hpp>
+#include <TreeDS/policy/pre_order.hpp>
+
+namespace md {
+
+/**
+ * @brief Associates each node of a tree to the {@link structural_signature} of its subtree.
+ * @details The index is built with one traversal and can be reused by any number of searches, for example by {@link
+ * pattern#search_all()} to skip in constant time the nodes whose subtree lacks some value or some parent-child pair
+ * required by the pattern, before trying to match them. The nodes are stored in pre-order. The index is not updated
+ * when the tree is modified: it must be rebuilt with {@link #rebuild()}.
+ * @tparam Tree the type of tree indexed
+ * @tparam Hash hash function of the values
+ */
+template <typename Tree, typename Hash = std::hash<typename Tree::value_type>>
+class structural_index {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using tree_type       = Tree;
+    using value_type      = typename Tree::value_type;
+    using node_type       = const typename Tree::node_type;
+    using nodes_type      = std::vector<node_type*>;
+    using signatures_type = std::vector<structural_signature>;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    nodes_type nodes;
+    signatures_type signatures;
+    const Tree* tree = nullptr;
+    Hash hasher;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    structural_index() {
+    }
+
+    explicit structural_index(const Tree& tree, const Hash& hasher = Hash()) :
+            hasher(hasher) {
+        this->rebuild(tree);
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    /// @brief Indexes again the tree, the previous content is discarded.
+    void rebuild(const Tree& tree) {
+        this->nodes.clear();
+        this->signatures.clear();
+        this->tree = &tree;
+        for (auto it = tree.begin(policy::pre_order()); it != tree.end(policy::pre_order()); ++it) {
+            this->nodes.push_back(it.get_raw_node());
+        }
+        std::vector<std::size_t> hashes(this->nodes.size());
+        this->signatures.resize(this->nodes.size());
+        // Reverse pre-order visits the children before their parent, the first child of a node follows it in pre-order
+        // and each sibling follows the subtree of the previous one
+        for (std::size_t i = this->nodes.size(); i-- > 0u;) {
+            structural_signature& signature = this->signatures[i];
+            hashes[i]                       = this->hash(this->nodes[i]->get_value());
+            signature.value                 = structural_signature::value_bit(hashes[i]);
+            signature.values                = signature.value;
+            signature.size                  = 1u;
+            signature.height                = 1u;
+            std::size_t child_index         = i + 1u;
+            for (node_type* child = this->nodes[i]->get_first_child(); child != nullptr;
+                 child            = child->get_next_sibling()) {
+                const structural_signature& child_signature = this->signatures[child_index];
+                signature.values |= child_signature.values;
+                signature.edges |= child_signature.edges;
+                signature.edges |= structural_signature::edge_bit(hashes[i], hashes[child_index]);
+                signature.size += child_signature.size;
+                signature.height = std::max(signature.height, child_signature.height + 1u);
+                child_index += child_signature.size;
+            }
+        }
+    }
+
+    /// @brief The hash of a value, as used by the signatures.
+    std::size_t hash(const value_type& value) const {
+        return this->hasher(value);
+    }
+
+    /// @brief The nodes of the tree, in pre-order.
+    const nodes_type& get_nodes() const {
+        return this->nodes;
+    }
+
+    /// @brief The signatures of the subtrees of the nodes, in the same order as {@link #get_nodes()}.
+    const signatures_type& get_signatures() const {
+        return this->signatures;
+    }
+
+    /// @brief Number of nodes indexed.
+    std::size_t size() const {
+        return this->nodes.size();
+    }
+
+    /// @brief Whether the index was built from the given tree.
+    template <typename OtherTree>
+    bool is_index_of(const OtherTree& tree) const {
+        return static_cast<const void*>(this->tree) == static_cast<const void*>(&tree);
+    }
+};
+
+} // namespace md
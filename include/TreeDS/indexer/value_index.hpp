@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>    // std::size_t
+#include <functional> // std::hash, std::equal_to
+#include <unordered_map>
+#include <vector>
+
+#include <TreeDS/policy/pre_order.hpp>
+
+namespace md {
+
+/**
+ * @brief Associates each value of a tree to the nodes holding it.
+ * @details The index is built with one traversal and can be reused by any number of searches, for example by {@link
+ * pattern#search_all()} to try only the nodes having the value of the root of the pattern. The nodes of each value are
+ * stored in pre-order. The index is not updated when the tree is modified: it must be rebuilt with {@link #rebuild()}.
+ * @tparam Tree the type of tree indexed
+ * @tparam Hash hash function of the values
+ * @tparam KeyEqual equality of the values
+ */
+template <
+    typename Tree,
+    typename Hash     = std::hash<typename Tree::value_type>,
+    typename KeyEqual = std::equal_to<typename Tree::value_type>>
+class value_index {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using tree_type  = Tree;
+    using value_type = typename Tree::value_type;
+    using node_type  = const typename Tree::node_type;
+    using nodes_type = std::vector<node_type*>;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    std::unordered_map<value_type, nodes_type, Hash, KeyEqual> nodes;
+    const Tree* tree = nullptr;
+    // Returned for the values that are not in the tree
+    nodes_type none;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    value_index() {
+    }
+
+    explicit value_index(const Tree& tree) {
+        this->rebuild(tree);
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    /// @brief Indexes again the tree, the previous content is discarded.
+    void rebuild(const Tree& tree) {
+        this->nodes.clear();
+        this->tree = &tree;
+        for (auto it = tree.begin(policy::pre_order()); it != tree.end(policy::pre_order()); ++it) {
+            this->nodes[*it].push_back(it.get_raw_node());
+        }
+    }
+
+    /// @brief The nodes having the given value, in pre-order.
+    const nodes_type& find(const value_type& value) const {
+        auto it = this->nodes.find(value);
+        return it != this->nodes.end() ? it->second : this->none;
+    }
+
+    /// @brief Number of nodes having the given value.
+    std::size_t count(const value_type& value) const {
+        return this->find(value).size();
+    }
+
+    /// @brief Number of distinct values.
+    std::size_t size() const {
+        return this->nodes.size();
+    }
+
+    /// @brief Whether the index was built from the given tree.
+    template <typename OtherTree>
+    bool is_index_of(const OtherTree& tree) const {
+        return static_cast<const void*>(this->tree) == static_cast<const void*>(&tree);
+    }
+};
+
+} // namespace md
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstddef>   // std::size_t
+#include <cstdint>   // std::uint64_t, std::uintptr_t
+#include <cstring>   // std::memcmp()
+#include <memory>    // std::allocator
+#include <stdexcept> // std::invalid_argument, std::runtime_error
+#include <string>
+#include <vector>
+
+#include <fcntl.h>    // open()
+#include <sys/mman.h> // mmap(), munmap()
+#include <sys/stat.h> // fstat()
+#include <unistd.h>   // close()
+
+#include <TreeDS/node/mapped_node.hpp>
+#include <TreeDS/serializer/binary_format.hpp>
+#include <TreeDS/tree_base.hpp>
+
+namespace md {
+
+/**
+ * @brief Read-only tree that uses in place the nodes of a file written by {@link mapped_writer}.
+ * @details The file is mapped in memory and the nodes are never copied nor converted: opening a tree takes constant
+ * time regardless of its size and the pages are loaded lazily and shared among the processes mapping the same file.
+ * Opening checks only the header and the length of the data, the distances stored in the nodes are trusted. Data that
+ * may be corrupted must be checked by {@link #validate()} before being read, otherwise the iterators could leave it.
+ * The tree offers the same read-only interface of any other tree (iterators with any policy, root(), size(), arity())
+ * and can be searched by a pattern. The tree can also be constructed over a memory buffer owned by the caller.
+ *
+ * The mapping uses the POSIX API.
+ *
+ * @tparam T the type of value hold by this tree, it must be trivially copyable
+ * @tparam Policy default traversal algorithm
+ */
+template <typename T, typename Policy = default_policy>
+class mapped_tree : public tree_base<const mapped_node<T>, Policy, std::allocator<T>> {
+
+    /*   ---   TYPES   ---   */
+    public:
+    DECLARE_TREEDS_TYPES(const mapped_node<T>, Policy, std::allocator<T>)
+    using super = tree_base<const mapped_node<T>, Policy, std::allocator<T>>;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    /// @brief The memory mapped, null if the data is owned by the caller.
+    void* mapping              = nullptr;
+    std::size_t mapping_length = 0u;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    /**
+     * @brief Maps the file at the given path.
+     * @throw std::runtime_error if the file cannot be mapped
+     * @throw std::invalid_argument if the file is not a mapped tree having values of type T
+     */
+    explicit mapped_tree(const std::string& path) {
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            throw std::runtime_error("Could not open the file \"" + path + "\".");
+        }
+        struct stat status;
+        if (::fstat(file, &status) != 0 || status.st_size == 0) {
+            ::close(file);
+            throw std::runtime_error("Could not read the size of the file \"" + path + "\".");
+        }
+        void* mapping = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+        // The mapping stays valid after the file is closed
+        ::close(file);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Could not map the file \"" + path + "\".");
+        }
+        this->mapping        = mapping;
+        this->mapping_length = static_cast<std::size_t>(status.st_size);
+        try {
+            this->attach(mapping, this->mapping_length);
+        } catch (...) {
+            ::munmap(this->mapping, this->mapping_length);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Uses the nodes stored in memory, which must outlive this tree.
+     * @throw std::invalid_argument if the data is not a mapped tree having values of type T or it is misaligned
+     */
+    mapped_tree(const void* data, std::size_t length) {
+        this->attach(data, length);
+    }
+
+    mapped_tree(const mapped_tree&) = delete;
+
+    mapped_tree(mapped_tree&& other) :
+            super(other.root_node, other.size_value, other.arity_value, other.navigator),
+            mapping(other.mapping),
+            mapping_length(other.mapping_length) {
+        other.root_node      = nullptr;
+        other.size_value     = 0u;
+        other.arity_value    = 0u;
+        other.navigator      = navigator_type();
+        other.mapping        = nullptr;
+        other.mapping_length = 0u;
+    }
+
+    ~mapped_tree() {
+        if (this->mapping != nullptr) {
+            ::munmap(this->mapping, this->mapping_length);
+        }
+    }
+
+    /*   ---   METHODS   ---   */
+    protected:
+    void attach(const void* data, std::size_t length) {
+        using record_type = mapped_node<T>;
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        if (length < binary_format::MAPPED_HEADER_SIZE
+            || std::memcmp(bytes, binary_format::MAPPED_MAGIC, sizeof(binary_format::MAPPED_MAGIC)) != 0) {
+            throw std::invalid_argument("The data is not a mapped tree.");
+        }
+        if (bytes[4] != binary_format::VERSION) {
+            throw std::invalid_argument("Unsupported version of the mapped tree format.");
+        }
+        if (((bytes[5] & binary_format::BIG_ENDIAN_FLAG) != 0u) != binary_format::is_big_endian()) {
+            throw std::invalid_argument("The mapped tree was written by a machine with a different byte order.");
+        }
+        const std::uint64_t size  = binary_format::read_integer(bytes + 8u);
+        const std::uint64_t arity = binary_format::read_integer(bytes + 16u);
+        if (binary_format::read_integer(bytes + 24u, 4u) != sizeof(record_type)
+            || binary_format::read_integer(bytes + 28u, 4u) != sizeof(T)) {
+            throw std::invalid_argument("The mapped tree holds values of a different type.");
+        }
+        if ((length - binary_format::MAPPED_HEADER_SIZE) / sizeof(record_type) < size) {
+            throw std::invalid_argument("The mapped tree is truncated.");
+        }
+        if (reinterpret_cast<std::uintptr_t>(bytes + binary_format::MAPPED_HEADER_SIZE) % alignof(record_type) != 0) {
+            throw std::invalid_argument("The mapped tree is not properly aligned in memory.");
+        }
+        this->root_node = size > 0u
+            ? reinterpret_cast<const record_type*>(bytes + binary_format::MAPPED_HEADER_SIZE)
+            : nullptr;
+        this->size_value  = static_cast<size_type>(size);
+        this->arity_value = static_cast<size_type>(arity);
+        this->navigator   = navigator_type(this->root_node);
+    }
+
+    public:
+    /**
+     * @brief Checks that the distances stored in the nodes describe the pre-order layout of a tree, for untrusted data.
+     * @details Every node is read once, which loads the whole file in memory. The nodes are visited in order keeping
+     * the path from the root to the current one: each node must fit in the subtree of its parent and link to the parent
+     * and to the previous sibling that precede it. This bounds every distance followed by the getters of
+     * {@link mapped_node} to the data.
+     * @throw std::invalid_argument if a distance is inconsistent
+     */
+    void validate() const {
+        const mapped_node<T>* nodes = this->root_node;
+        const std::uint64_t size    = this->size_value;
+        struct open_node {
+            std::uint64_t index;
+            std::uint64_t end;
+            /// @brief Index of the last child found so far, 0 if none.
+            std::uint64_t last_child;
+        };
+        auto fail = []() {
+            throw std::invalid_argument("The mapped tree has corrupted nodes.");
+        };
+        std::vector<open_node> path;
+        auto close = [&]() {
+            const open_node& node = path.back();
+            if (node.last_child != 0u && nodes[node.index].last_child_distance != node.last_child - node.index) {
+                fail();
+            }
+            path.pop_back();
+        };
+        for (std::uint64_t i = 0u; i < size; ++i) {
+            while (!path.empty() && path.back().end == i) {
+                close();
+            }
+            const mapped_node<T>& node = nodes[i];
+            const std::uint64_t end    = path.empty() ? size : path.back().end;
+            if (node.subtree_size == 0u || node.subtree_size > end - i
+                || (node.last_child_distance == 0u) != (node.subtree_size == 1u)
+                || node.last_child_distance >= node.subtree_size
+                || (node.following_size == 0u) != (i + node.subtree_size == end)) {
+                fail();
+            }
+            if (path.empty()) {
+                // Only the root, the first node, has no parent: its subtree ends with the data
+                if (i != 0u || node.parent_distance != 0u || node.prev_sibling_distance != 0u) {
+                    fail();
+                }
+            } else {
+                open_node& parent = path.back();
+                if (node.parent_distance != i - parent.index
+                    || (parent.last_child == 0u
+                            ? node.prev_sibling_distance != 0u
+                            : node.prev_sibling_distance != i - parent.last_child
+                                || nodes[parent.last_child].following_size != node.following_size + 1u)) {
+                    fail();
+                }
+                parent.last_child = i;
+            }
+            path.push_back({i, i + node.subtree_size, 0u});
+        }
+        while (!path.empty()) {
+            close();
+        }
+    }
+};
+
+} // namespace md
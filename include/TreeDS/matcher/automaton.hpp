@@ -0,0 +1,561 @@
+#pragma once
+
+#include <algorithm>   // std::fill(), std::pop_heap(), std::push_heap(), std::sort()
+#include <cstddef>     // std::size_t
+#include <functional>  // std::greater
+#include <type_traits> // std::decay_t
+#include <vector>
+
+#include <TreeDS/matcher/node/capture.hpp>
+#include <TreeDS/matcher/node/multi_matcher.hpp>
+#include <TreeDS/matcher/node/one_matcher.hpp>
+#include <TreeDS/matcher/node/opt_matcher.hpp>
+#include <TreeDS/matcher/pattern.hpp>
+#include <TreeDS/tree_base.hpp>
+
+namespace md {
+
+namespace detail {
+
+    enum class automaton_kind {
+        ONE,
+        OPT,
+        STAR,
+        CAPTURE
+    };
+
+    template <typename T>
+    constexpr automaton_kind automaton_kind_of = automaton_kind::ONE;
+
+    template <quantifier Quantifier, typename ValueMatcher, typename FirstChild, typename NextSibling>
+    constexpr automaton_kind automaton_kind_of<opt_matcher<Quantifier, ValueMatcher, FirstChild, NextSibling>>
+        = automaton_kind::OPT;
+
+    template <quantifier Quantifier, typename ValueMatcher, typename FirstChild, typename NextSibling>
+    constexpr automaton_kind automaton_kind_of<multi_matcher<Quantifier, ValueMatcher, FirstChild, NextSibling>>
+        = automaton_kind::STAR;
+
+    template <typename Name, typename Captured, typename NextSibling>
+    constexpr automaton_kind automaton_kind_of<capture_node<Name, Captured, NextSibling>> = automaton_kind::CAPTURE;
+
+    /// @brief Runtime description of a matcher that cannot match nothing (the other ones never affect a match).
+    struct automaton_state {
+        automaton_kind kind;
+        bool possessive;
+        // One of the children can match the node of this matcher (see matcher::child_may_steal_node())
+        bool steals;
+        // Value test of this matcher
+        std::size_t test;
+        // Children that do not match null, they are the only ones deciding whether this matcher matches
+        std::size_t required_begin;
+        std::size_t required_count;
+        // Matchers having this one as a required child
+        std::size_t users_begin;
+        std::size_t users_count;
+    };
+
+    /// @brief Progress of the children of a matcher within the children of a node being visited.
+    struct automaton_progress {
+        std::size_t state;
+        std::size_t depth;
+        // Progress of the same state in the closest ancestor having one
+        std::size_t previous;
+        // Position of the data in the progress pool
+        std::size_t data;
+    };
+
+} // namespace detail
+
+/**
+ * @brief The part of a bottom-up tree automaton that does not depend on the matcher types: the flattened matchers, the
+ * transition function and the post-order visit of the tree.
+ * @details Each matcher that cannot match nothing gets a state, after the states of its children. While visiting a
+ * node, the derived class writes in {@link #test_results} the result of each value test and lists the successful ones
+ * in {@link #passed_tests}, then {@link #close_node()} computes in {@link #matched_states} the states that match the
+ * node.
+ *
+ * The work is proportional to what happens in the tree rather than to the number of states: a state is considered
+ * only if it has no children and its value test succeeds, if some of its children matched or if its children matched
+ * something in the subtree of the node. The progress of the states is kept sparse, a state that did not progress
+ * within the children of a node has no data for them.
+ */
+class automaton_base {
+
+    /*   ---   TYPES   ---   */
+    protected:
+    using state_type    = detail::automaton_state;
+    using progress_type = detail::automaton_progress;
+
+    /*   ---   ATTRIBUTES   ---   */
+    public:
+    /// @brief Index of the state of matchers that can match nothing, they do not need a state.
+    static constexpr std::size_t NO_STATE = static_cast<std::size_t>(-1);
+
+    protected:
+    std::vector<state_type> states;
+    // Indexes of the required children of each state, contiguous for each state
+    std::vector<std::size_t> required;
+    // Users of each state and the position of the state within their required children, contiguous for each state
+    std::vector<std::pair<std::size_t, std::size_t>> users;
+    // States without required children, for each test
+    std::vector<std::vector<std::size_t>> leaves;
+    // Results of the tests for the node being visited
+    std::vector<char> test_results;
+    std::vector<std::size_t> passed_tests;
+    // States matching the node just completed, in increasing order
+    std::vector<std::size_t> matched_states;
+
+    private:
+    // Stack of the progress of the nodes whose children are being visited, deepest last
+    std::vector<progress_type> progress;
+    std::vector<std::size_t> progress_data;
+    // Deepest progress of each state
+    std::vector<std::size_t> last_progress;
+    // First progress of each level
+    std::vector<std::size_t> level_begin;
+    // Changes to apply to the progress of the parent of the node just completed
+    std::vector<std::pair<std::size_t, std::size_t>> changes;
+    std::vector<std::size_t> change_data;
+    // Stamps telling whether a state was matched (queued, changed) for the current node
+    std::size_t stamp = 0u;
+    std::vector<std::size_t> matched_stamp;
+    std::vector<std::size_t> queued_stamp;
+    std::vector<std::size_t> changed_stamp;
+    std::vector<std::size_t> candidates;
+    // Candidates found while computing the others, kept as a heap
+    std::vector<std::size_t> late_candidates;
+
+    /*   ---   METHODS   ---   */
+    private:
+    // Fills the users of each state, kept contiguous for each state
+    void link_users() {
+        std::vector<std::size_t> counts(this->states.size() + 1u, 0u);
+        for (std::size_t child : this->required) {
+            ++counts[child + 1u];
+        }
+        for (std::size_t i = 0u; i < this->states.size(); ++i) {
+            counts[i + 1u] += counts[i];
+            this->states[i].users_begin = counts[i];
+            this->states[i].users_count = 0u;
+        }
+        this->users.resize(this->required.size());
+        for (std::size_t user = 0u; user < this->states.size(); ++user) {
+            const state_type& state = this->states[user];
+            for (std::size_t j = 0u; j < state.required_count; ++j) {
+                state_type& child = this->states[this->required[state.required_begin + j]];
+                this->users[child.users_begin + child.users_count++] = {user, j};
+            }
+        }
+    }
+
+    protected:
+    /**
+     * @brief Flattens the matcher (and its siblings) in post-order.
+     * @param make_state function called as make_state(matcher, kind, children) for each matcher that cannot match
+     * nothing, with the states of its required children, returning the state of the matcher (see {@link #add_state()})
+     * @return the state of the matcher or {@link #NO_STATE} if it can match nothing
+     */
+    template <typename Matcher, typename MakeState>
+    std::size_t compile(const Matcher& matcher, MakeState& make_state) {
+        constexpr detail::automaton_kind kind = detail::automaton_kind_of<Matcher>;
+        if constexpr (kind == detail::automaton_kind::CAPTURE) {
+            return this->compile(matcher.get_first_child(), make_state);
+        } else if constexpr (Matcher::info.matches_null) {
+            // Then all its children can match nothing as well
+            return NO_STATE;
+        } else {
+            std::vector<std::size_t> children;
+            if constexpr (Matcher::has_first_child()) {
+                this->compile_siblings(matcher.get_first_child(), children, make_state);
+            }
+            return make_state(matcher, kind, children);
+        }
+    }
+
+    template <typename Matcher, typename MakeState>
+    void compile_siblings(const Matcher& matcher, std::vector<std::size_t>& children, MakeState& make_state) {
+        std::size_t state = this->compile(matcher, make_state);
+        if (state != NO_STATE) {
+            children.push_back(state);
+        }
+        if constexpr (Matcher::has_next_sibling()) {
+            this->compile_siblings(matcher.get_next_sibling(), children, make_state);
+        }
+    }
+
+    /// @brief Makes room for the result of one more value test.
+    std::size_t add_test() {
+        this->test_results.push_back(0);
+        this->leaves.emplace_back();
+        return this->test_results.size() - 1u;
+    }
+
+    template <typename Matcher>
+    std::size_t add_state(detail::automaton_kind kind, std::size_t test, const std::vector<std::size_t>& children) {
+        const std::size_t index = this->states.size();
+        this->states.push_back(state_type {
+            kind,
+            Matcher::info.possessive,
+            kind != detail::automaton_kind::ONE && Matcher::child_may_steal_node(),
+            test,
+            this->required.size(),
+            children.size(),
+            0u,
+            0u});
+        this->required.insert(this->required.end(), children.begin(), children.end());
+        if (children.empty()) {
+            this->leaves[test].push_back(index);
+        }
+        this->last_progress.push_back(NO_STATE);
+        this->matched_stamp.push_back(0u);
+        this->queued_stamp.push_back(0u);
+        this->changed_stamp.push_back(0u);
+        return index;
+    }
+
+    bool is_matched(std::size_t state) const {
+        return this->matched_stamp[state] == this->stamp;
+    }
+
+    // Progress of the state within the children of the node at depth, null if it did not progress
+    const std::size_t* find_progress(std::size_t state, std::size_t depth) const {
+        std::size_t position = this->last_progress[state];
+        if (position != NO_STATE && this->progress[position].depth == depth) {
+            return this->progress_data.data() + this->progress[position].data;
+        }
+        return nullptr;
+    }
+
+    void open_node(std::size_t depth) {
+        if (this->level_begin.size() <= depth) {
+            this->level_begin.resize(depth + 1u);
+        }
+        this->level_begin[depth] = this->progress.size();
+    }
+
+    /*
+     * Computes the states matching a node whose children were all visited, then advances the progress of its parent.
+     * The children of one and opt match the children of a node: the required ones are embedded greedily, each one in the
+     * first node it can match. The children of star match nodes below, in the region of the nodes accepted by its value,
+     * that are disjoint and in pre-order: the greedy choice is the node ending first, so a node is taken if no node was
+     * taken in its subtree. The progress of a star is thus a function from the number of its children matched before
+     * entering the subtree of a node to the number of them matched after leaving it (the identity if absent).
+     */
+    void close_node(std::size_t depth) {
+        ++this->stamp;
+        this->matched_states.clear();
+        const std::size_t level = this->level_begin[depth];
+        // Candidates: states without children whose test succeeded and states that progressed, children first
+        this->candidates.clear();
+        for (std::size_t test : this->passed_tests) {
+            for (std::size_t state : this->leaves[test]) {
+                this->enqueue(state);
+            }
+        }
+        for (std::size_t i = level; i < this->progress.size(); ++i) {
+            this->enqueue(this->progress[i].state);
+        }
+        std::sort(this->candidates.begin(), this->candidates.end());
+        std::size_t next = 0u;
+        while (next < this->candidates.size() || !this->late_candidates.empty()) {
+            std::size_t current;
+            if (this->late_candidates.empty()
+                || (next < this->candidates.size() && this->candidates[next] < this->late_candidates.front())) {
+                current = this->candidates[next++];
+            } else {
+                std::pop_heap(
+                    this->late_candidates.begin(), this->late_candidates.end(), std::greater<std::size_t>());
+                current = this->late_candidates.back();
+                this->late_candidates.pop_back();
+            }
+            const state_type& state = this->states[current];
+            const bool value        = this->test_results[state.test];
+            bool result             = false;
+            if (value) {
+                // The value is accepted and all the required children found a node
+                const std::size_t* data = this->find_progress(current, depth);
+                result                  = state.required_count == 0u || (data && data[0] == state.required_count);
+            }
+            if (!result && state.steals && (!value || !state.possessive)) {
+                // The only required child matches this node in place of its parent
+                result = this->is_matched(this->required[state.required_begin]);
+            }
+            if (!result) {
+                continue;
+            }
+            this->matched_stamp[current] = this->stamp;
+            this->matched_states.push_back(current);
+            for (std::size_t i = 0u; i < state.users_count; ++i) {
+                const std::size_t user = this->users[state.users_begin + i].first;
+                if (this->states[user].steals && this->queued_stamp[user] != this->stamp) {
+                    // Users come after their children, it will be computed later
+                    this->queued_stamp[user] = this->stamp;
+                    this->late_candidates.push_back(user);
+                    std::push_heap(
+                        this->late_candidates.begin(), this->late_candidates.end(), std::greater<std::size_t>());
+                }
+            }
+        }
+        // What the parent must change, computed before removing the progress of this node
+        this->changes.clear();
+        this->change_data.clear();
+        if (depth > 0u) {
+            for (std::size_t i = level; i < this->progress.size(); ++i) {
+                if (this->states[this->progress[i].state].kind == detail::automaton_kind::STAR) {
+                    this->add_star_change(this->progress[i].state, depth);
+                }
+            }
+            for (std::size_t matched : this->matched_states) {
+                const state_type& state = this->states[matched];
+                for (std::size_t i = 0u; i < state.users_count; ++i) {
+                    const auto [user, position] = this->users[state.users_begin + i];
+                    if (this->states[user].kind == detail::automaton_kind::STAR) {
+                        this->add_star_change(user, depth);
+                    } else {
+                        this->changes.emplace_back(user, position);
+                    }
+                }
+            }
+        }
+        // Remove the progress of this node
+        for (std::size_t i = this->progress.size(); i-- > level;) {
+            this->last_progress[this->progress[i].state] = this->progress[i].previous;
+        }
+        if (level < this->progress.size()) {
+            this->progress_data.resize(this->progress[level].data);
+            this->progress.resize(level);
+        }
+        // Apply the changes to the parent
+        for (const auto& [user, position] : this->changes) {
+            const state_type& state = this->states[user];
+            if (state.kind == detail::automaton_kind::STAR) {
+                // Compose the transition of this node after the ones of the previous siblings
+                std::size_t* data             = this->get_progress(user, depth - 1u);
+                const std::size_t* transition = this->change_data.data() + position;
+                for (std::size_t j = 0u; j <= state.required_count; ++j) {
+                    data[j] = transition[data[j]];
+                }
+            } else {
+                // A node is matched by at most one required child
+                const std::size_t* data = this->find_progress(user, depth - 1u);
+                if (this->changed_stamp[user] != this->stamp && (data ? *data : 0u) == position) {
+                    this->changed_stamp[user] = this->stamp;
+                    ++*this->get_progress(user, depth - 1u);
+                }
+            }
+        }
+    }
+
+    private:
+    void enqueue(std::size_t state) {
+        if (this->queued_stamp[state] != this->stamp) {
+            this->queued_stamp[state] = this->stamp;
+            this->candidates.push_back(state);
+        }
+    }
+
+    // Computes the transition of a star through the node just completed, if it is not the identity
+    void add_star_change(std::size_t star, std::size_t depth) {
+        if (this->changed_stamp[star] == this->stamp) {
+            return;
+        }
+        this->changed_stamp[star] = this->stamp;
+        const state_type& state   = this->states[star];
+        const bool value          = this->test_results[state.test];
+        const std::size_t* data   = value ? this->find_progress(star, depth) : nullptr;
+        const std::size_t* needed = this->required.data() + state.required_begin;
+        const std::size_t begin   = this->change_data.size();
+        bool identity             = true;
+        for (std::size_t j = 0u; j <= state.required_count; ++j) {
+            std::size_t next = data ? data[j] : j;
+            if (next == j && j < state.required_count && this->is_matched(needed[j])
+                && (!value || !state.possessive)) {
+                next = j + 1u;
+            }
+            identity = identity && next == j;
+            this->change_data.push_back(next);
+        }
+        if (identity) {
+            this->change_data.resize(begin);
+        } else {
+            this->changes.emplace_back(star, begin);
+        }
+    }
+
+    // Progress of the state within the children of the node at depth (the deepest one), created if missing
+    std::size_t* get_progress(std::size_t state, std::size_t depth) {
+        std::size_t position = this->last_progress[state];
+        if (position == NO_STATE || this->progress[position].depth != depth) {
+            const std::size_t data = this->progress_data.size();
+            this->progress.push_back(progress_type {state, depth, position, data});
+            position                     = this->progress.size() - 1u;
+            this->last_progress[state]   = position;
+            const state_type& definition = this->states[state];
+            if (definition.kind == detail::automaton_kind::STAR) {
+                // Identity transition
+                for (std::size_t j = 0u; j <= definition.required_count; ++j) {
+                    this->progress_data.push_back(j);
+                }
+            } else {
+                this->progress_data.push_back(0u);
+            }
+        }
+        return this->progress_data.data() + this->progress[position].data;
+    }
+
+    protected:
+    /**
+     * @brief Visits the subtree of root in post-order computing the states of each node.
+     * @param evaluate function called with each node to fill {@link #test_results} and {@link #passed_tests}
+     * @param visit function called with each node after its states are computed in {@link #matched_states}
+     */
+    template <typename Node, typename Evaluate, typename Visit>
+    void traverse(const Node* root, Evaluate&& evaluate, Visit&& visit) {
+        if (this->users.size() != this->required.size()) {
+            // States were added since the last visit
+            this->link_users();
+        }
+        // Clean up after a previous visit interrupted by an exception
+        this->progress.clear();
+        this->progress_data.clear();
+        std::fill(this->last_progress.begin(), this->last_progress.end(), NO_STATE);
+        this->changed_stamp.assign(this->states.size(), 0u);
+        const Node* node  = root;
+        std::size_t depth = 0u;
+        this->open_node(depth);
+        while (true) {
+            if (node->get_first_child()) {
+                node = node->get_first_child();
+                this->open_node(++depth);
+                continue;
+            }
+            // Complete the nodes whose subtrees were entirely visited
+            while (true) {
+                this->passed_tests.clear();
+                evaluate(*node);
+                this->close_node(depth);
+                visit(*node);
+                if (node == root) {
+                    return;
+                }
+                if (node->get_next_sibling()) {
+                    node = node->get_next_sibling();
+                    this->open_node(depth);
+                    break;
+                }
+                node = node->get_parent();
+                --depth;
+            }
+        }
+    }
+
+    public:
+    /// @brief Number of states, one for each matcher that cannot match nothing (captures excluded).
+    std::size_t state_count() const {
+        return this->states.size();
+    }
+};
+
+/**
+ * @brief A pattern compiled into a deterministic bottom-up tree automaton.
+ * @details {@link pattern#search()} tries the matchers against the nodes top down and backtracks whenever a choice
+ * leaves the following matchers without a target, which can take superlinear time. The automaton instead visits the
+ * tree once, in post-order, and assigns each node a state that depends only on its value and on the states of its
+ * children: the set of matchers that can match there (together with the greedy progress of the children of each
+ * matcher). No choice is ever undone, so deciding whether the pattern matches takes
+ * O(tree size * pattern size) time and memory proportional to the height of the tree.
+ *
+ * The states are not enumerated ahead of time, which would not be possible for arbitrary value matchers, but each one
+ * is computed as the tree is visited. The matcher tree is flattened when the automaton is constructed, while the value
+ * tests are expanded at compile time from the matcher types.
+ *
+ * The automaton answers the same question as {@link pattern#search()} (whether some assignment of the matchers to
+ * the nodes satisfies the pattern) without computing which nodes are matched and therefore without results and
+ * captures. The quantifiers only change the nodes preferred by a match, except for the possessive ones whose children
+ * can match only the first nodes not accepted by the quantifier. The answer is exact: when a matcher that can match
+ * nothing takes a node needed by a following sibling, the backtracking may give up on a match that the automaton
+ * finds.
+ *
+ * @tparam PatternTree the type of the root matcher
+ */
+template <typename PatternTree>
+class pattern_automaton : public automaton_base {
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    PatternTree pattern_tree;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    pattern_automaton(PatternTree&& tree) :
+            pattern_tree(tree) {
+        this->compile_pattern();
+    }
+
+    pattern_automaton(const pattern<PatternTree>& pattern) :
+            pattern_tree(pattern.get_pattern()) {
+        this->compile_pattern();
+    }
+
+    /*   ---   METHODS   ---   */
+    protected:
+    void compile_pattern() {
+        // Each state has its own test, having the same index
+        auto make_state = [this](const auto& matcher, detail::automaton_kind kind, const auto& children) {
+            return this->template add_state<std::decay_t<decltype(matcher)>>(kind, this->add_test(), children);
+        };
+        this->compile(this->pattern_tree, make_state);
+    }
+
+    // Tests the value against every state, in the same order used by compile()
+    template <typename Matcher, typename Value>
+    void evaluate(Matcher& matcher, const Value& value, std::size_t& index) {
+        if constexpr (detail::automaton_kind_of<Matcher> == detail::automaton_kind::CAPTURE) {
+            this->evaluate(matcher.get_first_child(), value, index);
+        } else if constexpr (!Matcher::info.matches_null) {
+            if constexpr (Matcher::has_first_child()) {
+                this->evaluate(matcher.get_first_child(), value, index);
+            }
+            const bool result         = matcher.match_value(value);
+            this->test_results[index] = result;
+            if (result) {
+                this->passed_tests.push_back(index);
+            }
+            ++index;
+        }
+        if constexpr (Matcher::has_next_sibling()) {
+            this->evaluate(matcher.get_next_sibling(), value, index);
+        }
+    }
+
+    public:
+    /**
+     * @brief Determines if the pattern matches the tree, visiting each node once.
+     * @return true if some assignment of the matchers to the nodes satisfies the pattern
+     */
+    template <typename Node, typename Policy, typename Allocator>
+    bool search(const tree_base<Node, Policy, Allocator>& tree) {
+        if constexpr (PatternTree::info.matches_null) {
+            return true;
+        }
+        const Node* root = tree.raw_root_node();
+        if (root == nullptr) {
+            return false;
+        }
+        this->traverse(
+            root,
+            [this](const Node& node) {
+                std::size_t index = 0u;
+                this->evaluate(this->pattern_tree, node.get_value(), index);
+            },
+            [](const Node&) {});
+        // The root matcher has the last state
+        return this->is_matched(this->states.size() - 1u);
+    }
+
+    const PatternTree& get_pattern() const {
+        return this->pattern_tree;
+    }
+};
+
+} // namespace md
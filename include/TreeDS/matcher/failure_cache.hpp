@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef> // std::size_t
+#include <utility> // std::pair
+#include <vector>
+
+#include <TreeDS/utility.hpp>
+
+namespace md::detail {
+
+/**
+ * @brief Remembers the nodes where a matcher failed during a search, so that the backtracking does not try them again.
+ * @details The nodes are kept in an open addressing table probed linearly, doubled when it becomes half full. Nothing
+ * is ever evicted: each node is tried at most once by each matcher during a search. The table has twice the slots of
+ * the tree size estimated at the start of the search, or four times the failures stored if there are more, therefore
+ * the memory is O(nodes) for each matcher. Clearing the cache takes constant time because every entry is tagged with
+ * the search that stored it.
+ */
+class failure_cache {
+
+    /*   ---   ATTRIBUTES   ---   */
+    private:
+    std::vector<std::pair<const void*, std::size_t>> entries;
+    // Number of entries stored by the current search
+    std::size_t count = 0u;
+    // Number of bits of the slot, initial one for the current search
+    unsigned bits         = 0u;
+    unsigned initial_bits = 0u;
+    std::size_t search    = 1u;
+
+    /*   ---   METHODS   ---   */
+    private:
+    void store(const void* node) {
+        const std::size_t mask = this->entries.size() - 1u;
+        std::size_t slot       = detail::fibonacci_slot(node, this->bits);
+        while (this->entries[slot].second == this->search) {
+            slot = (slot + 1u) & mask;
+        }
+        this->entries[slot] = {node, this->search};
+    }
+
+    void grow() {
+        std::vector<std::pair<const void*, std::size_t>> previous(2u * this->entries.size(), {nullptr, 0u});
+        previous.swap(this->entries);
+        ++this->bits;
+        for (const auto& entry : previous) {
+            if (entry.second == this->search) {
+                this->store(entry.first);
+            }
+        }
+    }
+
+    public:
+    /**
+     * @brief Forgets every failure and prepares for a search in a tree.
+     * @param nodes an estimate of the number of nodes in the tree, used to size the table at the first failure
+     */
+    void clear(std::size_t nodes) {
+        ++this->search;
+        this->count        = 0u;
+        this->initial_bits = 1u;
+        while ((std::size_t(1u) << this->initial_bits) < 2u * nodes) {
+            ++this->initial_bits;
+        }
+    }
+
+    bool contains(const void* node) const {
+        if (this->count == 0u) {
+            return false;
+        }
+        const std::size_t mask = this->entries.size() - 1u;
+        for (std::size_t slot = detail::fibonacci_slot(node, this->bits);; slot = (slot + 1u) & mask) {
+            const auto& entry = this->entries[slot];
+            if (entry.second != this->search) {
+                return false;
+            }
+            if (entry.first == node) {
+                return true;
+            }
+        }
+    }
+
+    void insert(const void* node) {
+        if (this->initial_bits == 0u) {
+            // Not prepared for a search
+            return;
+        }
+        if (this->count == 0u && this->entries.size() < (std::size_t(1u) << this->initial_bits)) {
+            // Allocated at the first failure, searches that do not backtrack do not pay for it. A larger table left by
+            // a previous search is reused, its entries have an older tag.
+            this->bits = this->initial_bits;
+            this->entries.assign(std::size_t(1u) << this->bits, {nullptr, 0u});
+        }
+        if (2u * (this->count + 1u) > this->entries.size()) {
+            this->grow();
+        }
+        this->store(node);
+        ++this->count;
+    }
+};
+
+} // namespace md::detail
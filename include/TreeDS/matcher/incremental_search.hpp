@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>     // std::size_t
+#include <type_traits> // std::remove_const_t
+#include <unordered_set>
+#include <vector>
+
+#include <TreeDS/change_log.hpp>
+#include <TreeDS/policy/fixed.hpp>
+
+namespace md {
+
+/**
+ * @brief The nodes of a tree where a pattern matches, kept up to date while the tree is modified.
+ * @details Whether a pattern matches at a node depends only on the subtree of that node. After some modifications,
+ * recorded by a {@link change_log} attached to the tree, {@link #update()} searches the pattern again only at the
+ * nodes inserted or touched and at their ancestors, and forgets the nodes removed. The rest of the matches are kept.
+ * Many searches can be updated from the same log, which is then cleared by the user.
+ *
+ * @code
+ * change_log<nary_node<char>> log;
+ * tree.set_change_log(&log);
+ * incremental_search matches(pattern, tree);
+ * tree.insert_over(position, 'x');
+ * matches.update(log);
+ * log.clear();
+ * @endcode
+ *
+ * @tparam Pattern the type of the pattern searched
+ * @tparam Tree the type of tree searched
+ */
+template <typename Pattern, typename Tree>
+class incremental_search {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using node_type    = const typename Tree::node_type;
+    using matches_type = std::unordered_set<node_type*>;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    Pattern* pattern;
+    const Tree* tree;
+    matches_type matches;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    /// @brief Searches the pattern at every node of the tree.
+    incremental_search(Pattern& pattern, const Tree& tree) :
+            pattern(&pattern),
+            tree(&tree) {
+        this->rebuild();
+    }
+
+    /*   ---   METHODS   ---   */
+    protected:
+    void search_at(node_type& node) {
+        if (this->pattern->search_at(*this->tree, this->tree->begin(policy::fixed()).other_node(&node))) {
+            this->matches.insert(&node);
+        } else {
+            this->matches.erase(&node);
+        }
+    }
+
+    public:
+    /// @brief Forgets the matches and searches the pattern again at every node.
+    void rebuild() {
+        this->matches.clear();
+        for (const auto& match : this->pattern->search_all(*this->tree)) {
+            this->matches.insert(match.get_node());
+        }
+    }
+
+    /**
+     * @brief Brings the matches up to date with the modifications in the log.
+     * @details The log must have recorded every modification since the previous update (or the construction).
+     */
+    void update(const change_log<std::remove_const_t<node_type>>& log) {
+        if (log.is_reset()) {
+            this->rebuild();
+            return;
+        }
+        for (node_type* node : log.get_removed()) {
+            this->matches.erase(node);
+        }
+        std::vector<node_type*> affected;
+        log.for_each_affected([&](node_type& node) {
+            affected.push_back(&node);
+        });
+        /*
+         * The size of the tree is not asked: after some modifications it is computed again by visiting every node. The
+         * failures remembered grow with the nodes actually visited.
+         */
+        this->pattern->start_search(affected.size());
+        for (node_type* node : affected) {
+            this->search_at(*node);
+        }
+    }
+
+    const matches_type& get_matches() const {
+        return this->matches;
+    }
+
+    bool contains(node_type* node) const {
+        return this->matches.count(node) > 0u;
+    }
+
+    std::size_t size() const {
+        return this->matches.size();
+    }
+};
+
+} // namespace md
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <array>
+#include <cstddef>  // std::size_t, std::ptrdiff_t
+#include <iterator> // std::forward_iterator_tag
+#include <tuple>    // std::apply(), std::tuple_size_v
+#include <vector>
+
+#include <TreeDS/matcher/structural_signature.hpp>
+#include <TreeDS/matcher/utility.hpp>
+#include <TreeDS/policy/pre_order.hpp>
+
+namespace md {
+
+/**
+ * @brief An occurrence of a pattern: the node where its root matched and the nodes matched by its captures.
+ * @details The nodes belong to the tree that was searched and are valid as long as the tree is not modified.
+ * @tparam Node the type of nodes of the tree searched
+ * @tparam Captures the type of the captures of the pattern, see {@link matcher#captures_t}
+ */
+template <typename Node, typename Captures>
+class pattern_match {
+
+    /*   ---   ATTRIBUTES   ---   */
+    public:
+    static constexpr std::size_t MARK_COUNT = std::tuple_size_v<Captures>;
+
+    protected:
+    const Node* node = nullptr;
+    std::array<const Node*, MARK_COUNT> marks {};
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    pattern_match() = default;
+
+    pattern_match(const Node* node, const std::array<const Node*, MARK_COUNT>& marks) :
+            node(node),
+            marks(marks) {
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    /// @brief The node matched by the root of the pattern.
+    const Node* get_node() const {
+        return this->node;
+    }
+
+    /// @brief The node matched by the capture having the given index (starting from 1), null if it matched nothing.
+    template <std::size_t Index>
+    const Node* get_mark(const_index<Index>) const {
+        static_assert(Index - 1 < MARK_COUNT, "There is no capture with the index requested.");
+        return this->marks[Index - 1];
+    }
+
+    /// @brief The node matched by the capture having the given name, null if it matched nothing.
+    template <char... Name>
+    const Node* get_mark(const_name<Name...>) const {
+        static_assert(
+            sizeof...(Name) > 0,
+            "Capture's name must be not empty. For example const_name<'a'> is OK, while const_name<> is not.");
+        static_assert(
+            detail::is_valid_name<const_name<Name...>, Captures>,
+            "There is no capture with the name requested.");
+        return this->marks[detail::index_of_capture<const_name<Name...>, Captures>];
+    }
+
+    constexpr std::size_t mark_count() const {
+        return MARK_COUNT;
+    }
+};
+
+/**
+ * @brief Iterator over the occurrences of a pattern in a tree, found lazily in pre-order.
+ * @details Each increment resumes from the node of the current occurrence and tries the following nodes as root of the
+ * pattern, until one matches. The matchers remember where they failed across the attempts, so the work done for a
+ * node is not repeated for the following roots. When a list of candidates is given (in pre-order), only those nodes
+ * are tried, and when their signatures are given as well, only the ones covering the signature required by the pattern
+ * (see {@link structural_index}). The iterator is invalidated when the tree is modified or when the pattern is used
+ * for another search.
+ * @tparam Pattern the type of the pattern searched
+ * @tparam Tree the type of tree searched
+ */
+template <typename Pattern, typename Tree>
+class match_iterator {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using node_type     = typename Tree::node_type;
+    using position_type = typename Tree::template const_iterator<policy::pre_order>;
+    // Iterators mandatory type declarations
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = pattern_match<node_type, typename Pattern::captures_type>;
+    using pointer           = const value_type*;
+    using reference         = const value_type&;
+    using candidates_type   = std::vector<const node_type*>;
+    using signatures_type   = std::vector<structural_signature>;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    Pattern* pattern = nullptr;
+    const Tree* tree = nullptr;
+    position_type position;
+    value_type current;
+    // Nodes to try as root of the pattern, every node when null
+    const candidates_type* candidates = nullptr;
+    std::size_t candidate             = 0u;
+    // Signatures of the candidates, every candidate is tried when null
+    const signatures_type* signatures = nullptr;
+    structural_signature required;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    /// @brief Constructs a match_iterator pointing nowhere.
+    match_iterator() = default;
+
+    match_iterator(Pattern& pattern, const Tree& tree, const position_type& position) :
+            pattern(&pattern),
+            tree(&tree),
+            position(position) {
+        this->find();
+    }
+
+    match_iterator(
+        Pattern& pattern,
+        const Tree& tree,
+        const candidates_type& candidates,
+        std::size_t candidate) :
+            pattern(&pattern),
+            tree(&tree),
+            position(tree.end(policy::pre_order())),
+            candidates(&candidates),
+            candidate(candidate) {
+        this->seek();
+        this->find();
+    }
+
+    match_iterator(
+        Pattern& pattern,
+        const Tree& tree,
+        const candidates_type& candidates,
+        const signatures_type& signatures,
+        const structural_signature& required,
+        std::size_t candidate) :
+            pattern(&pattern),
+            tree(&tree),
+            position(tree.end(policy::pre_order())),
+            candidates(&candidates),
+            candidate(candidate),
+            signatures(&signatures),
+            required(required) {
+        this->seek();
+        this->find();
+    }
+
+    /*   ---   METHODS   ---   */
+    protected:
+    // Moves position to the first candidate, starting from the current one, whose signature covers the required one
+    void seek() {
+        if (this->signatures != nullptr) {
+            while (this->candidate < this->candidates->size()
+                   && !(*this->signatures)[this->candidate].covers(this->required)) {
+                ++this->candidate;
+            }
+        }
+        if (this->candidate < this->candidates->size()) {
+            this->position = this->position.other_node((*this->candidates)[this->candidate]);
+        } else {
+            this->position = this->tree->end(policy::pre_order());
+        }
+    }
+
+    // Moves position to the next node to try
+    void advance() {
+        if (this->candidates == nullptr) {
+            ++this->position;
+        } else {
+            ++this->candidate;
+            this->seek();
+        }
+    }
+
+    // Moves position to the first node, starting from the current one, where the pattern matches
+    void find() {
+        while (this->position != this->tree->end(policy::pre_order())) {
+            if (this->pattern->search_at(*this->tree, this->position)) {
+                this->current = value_type(this->position.get_raw_node(), this->pattern->get_marks(*this->tree));
+                return;
+            }
+            this->advance();
+        }
+        this->current = value_type();
+    }
+
+    public:
+    reference operator*() const {
+        return this->current;
+    }
+
+    pointer operator->() const {
+        return &this->current;
+    }
+
+    match_iterator& operator++() {
+        this->advance();
+        this->find();
+        return *this;
+    }
+
+    match_iterator operator++(int) {
+        match_iterator it(*this);
+        ++(*this);
+        return it;
+    }
+
+    bool operator==(const match_iterator& other) const {
+        return this->position == other.position;
+    }
+
+    bool operator!=(const match_iterator& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief All the occurrences of a pattern in a tree, see {@link pattern#search_all()}.
+ * @details Nothing is searched until the range is iterated.
+ */
+template <typename Pattern, typename Tree>
+class match_range {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using iterator        = match_iterator<Pattern, Tree>;
+    using const_iterator  = match_iterator<Pattern, Tree>;
+    using candidates_type = typename iterator::candidates_type;
+    using signatures_type = typename iterator::signatures_type;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    Pattern* pattern;
+    const Tree* tree;
+    const candidates_type* candidates = nullptr;
+    const signatures_type* signatures = nullptr;
+    structural_signature required;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    match_range(Pattern& pattern, const Tree& tree) :
+            pattern(&pattern),
+            tree(&tree) {
+    }
+
+    /// @brief Range that tries only the given nodes (in pre-order) as root of the pattern.
+    match_range(Pattern& pattern, const Tree& tree, const candidates_type& candidates) :
+            pattern(&pattern),
+            tree(&tree),
+            candidates(&candidates) {
+    }
+
+    /// @brief Range that tries only the given nodes (in pre-order) whose signature covers the required one.
+    match_range(
+        Pattern& pattern,
+        const Tree& tree,
+        const candidates_type& candidates,
+        const signatures_type& signatures,
+        const structural_signature& required) :
+            pattern(&pattern),
+            tree(&tree),
+            candidates(&candidates),
+            signatures(&signatures),
+            required(required) {
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    iterator begin() const {
+        if (this->signatures != nullptr) {
+            return iterator(*this->pattern, *this->tree, *this->candidates, *this->signatures, this->required, 0u);
+        } else if (this->candidates != nullptr) {
+            return iterator(*this->pattern, *this->tree, *this->candidates, 0u);
+        }
+        return iterator(*this->pattern, *this->tree, this->tree->begin(policy::pre_order()));
+    }
+
+    iterator end() const {
+        return iterator(*this->pattern, *this->tree, this->tree->end(policy::pre_order()));
+    }
+};
+
+} // namespace md
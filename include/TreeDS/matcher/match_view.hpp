@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstddef> // std::size_t
+
+#include <TreeDS/node/navigator/match_navigator.hpp>
+#include <TreeDS/tree_iterator.hpp>
+#include <TreeDS/viewer/binary_tree_view.hpp>
+#include <TreeDS/viewer/nary_tree_view.hpp>
+
+namespace md {
+
+namespace detail {
+    /// @brief The type of view of a tree having the given type of nodes.
+    template <typename Node, typename Policy, typename Allocator>
+    struct tree_view_of {};
+
+    template <typename T, typename Policy, typename Allocator>
+    struct tree_view_of<nary_node<T>, Policy, Allocator> {
+        using type = nary_tree_view<T, Policy, Allocator>;
+    };
+
+    template <typename T, typename Policy, typename Allocator>
+    struct tree_view_of<const nary_node<T>, Policy, Allocator> {
+        using type = nary_tree_view<T, Policy, Allocator>;
+    };
+
+    template <typename T, typename Policy, typename Allocator>
+    struct tree_view_of<binary_node<T>, Policy, Allocator> {
+        using type = binary_tree_view<T, Policy, Allocator>;
+    };
+
+    template <typename T, typename Policy, typename Allocator>
+    struct tree_view_of<const binary_node<T>, Policy, Allocator> {
+        using type = binary_tree_view<T, Policy, Allocator>;
+    };
+} // namespace detail
+
+/**
+ * @brief The part of a tree matched by a pattern (or by a capture), visited in place.
+ * @details The view shows the node matched by each matcher together with the nodes connecting them to the root of the
+ * match, through a {@link match_navigator}. This is the shape of the result of reluctant quantifiers: the nodes that
+ * greedy quantifiers would add to the result of {@link pattern#assign_result()} are not shown. Nothing is copied or
+ * allocated, therefore the view is valid as long as the tree is not modified.
+ * @tparam Tree the type of the tree searched
+ * @tparam Count the number of matchers whose nodes are shown
+ */
+template <typename Tree, std::size_t Count>
+class match_view {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using node_type      = const typename Tree::node_type;
+    using value_type     = typename Tree::value_type;
+    using navigator_type = match_navigator<node_type*, Count>;
+    template <typename P>
+    using const_iterator = tree_iterator<const Tree, P, navigator_type>;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    navigator_type navigator;
+    typename Tree::node_allocator_type allocator;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    match_view() {
+    }
+
+    /**
+     * @param root the node matched by the root matcher
+     * @param matched the nodes matched by the matchers (null for the ones that matched nothing)
+     * @param allocator allocator used by the policies of the iterators
+     */
+    match_view(
+        node_type* root,
+        const std::array<node_type*, Count>& matched,
+        const typename Tree::node_allocator_type& allocator) :
+            navigator(root, matched),
+            allocator(allocator) {
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    template <typename P = typename Tree::policy_type>
+    const_iterator<P> begin(P = P()) const {
+        // Incremented to shift it to the first element (initially it's end-equivalent)
+        return ++this->end(P());
+    }
+
+    template <typename P = typename Tree::policy_type>
+    const_iterator<P> end(P = P()) const {
+        return const_iterator<P>(P().get_instance(static_cast<node_type*>(nullptr), this->navigator, this->allocator));
+    }
+
+    node_type* raw_root_node() const {
+        return this->navigator.get_root();
+    }
+
+    const navigator_type& get_navigator() const {
+        return this->navigator;
+    }
+
+    bool empty() const {
+        return this->navigator.get_root() == nullptr;
+    }
+
+    /// @brief Whether the node is part of the match.
+    bool contains(const node_type* node) const {
+        return this->navigator.is_matched(node);
+    }
+};
+
+} // namespace md
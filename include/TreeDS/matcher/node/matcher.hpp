@@ -1,9 +1,15 @@
 #pragma once
 
+#include <algorithm>   // std::max()
+#include <array>
 #include <cstddef>     // std::size_t
+#include <tuple>       // std::apply(), std::tuple_size_v
 #include <type_traits> // std::is_same_v, std::is_convertible_v
 #include <utility>     // std::declval()
 
+#include <TreeDS/matcher/failure_cache.hpp>
+#include <TreeDS/matcher/statistics.hpp>
+#include <TreeDS/matcher/structural_signature.hpp>
 #include <TreeDS/matcher/utility.hpp>
 #include <TreeDS/matcher/value/alternative_match.hpp>
 #include <TreeDS/matcher/value/product_match.hpp>
@@ -14,12 +20,21 @@
 namespace md {
 
 template <typename Derived, typename ValueMatcher, typename FirstChild, typename NextSibling>
-class matcher : public struct_node_base<Derived, ValueMatcher, FirstChild, NextSibling> {
+class matcher : public struct_node_base<Derived, ValueMatcher, FirstChild, NextSibling>,
+                protected detail::matcher_statistics_storage<Derived> {
 
     /*   ---   FRIENDS   ---   */
     template <typename, typename, typename, typename>
     friend class matcher;
 
+    friend class automaton_base;
+
+    template <typename>
+    friend class pattern_automaton;
+
+    template <typename>
+    friend class pattern_set;
+
     /*   ---   CONSTANTS   ---   */
     static constexpr bool IS_CAPTURE = is_same_template<ValueMatcher, const_name<>>;
 
@@ -45,9 +60,10 @@ class matcher : public struct_node_base<Derived, ValueMatcher, FirstChild, NextS
     /*   ---   ATTRIBUTES   ---   */
     protected:
     const void* matched_node = nullptr;
-    std::size_t steps        = 0u;
     captures_t captures      = this->get_following_captures();
     std::array<const void*, matcher::children()> child_match_attempt_begin{};
+    // Nodes where search_node_impl() failed in the current search
+    detail::failure_cache failures;
 
     /*   ---   CONSTRUCTORS   ---   */
     public:
@@ -93,7 +109,93 @@ class matcher : public struct_node_base<Derived, ValueMatcher, FirstChild, NextS
         }
     }
 
+    matcher_statistics* write_statistics(matcher_statistics* output) const {
+        if constexpr (MD_MATCHER_STATISTICS) {
+            *output = this->statistics;
+        }
+        ++output;
+        if constexpr (matcher::has_first_child()) {
+            output = this->first_child.write_sibling_statistics(output);
+        }
+        return output;
+    }
+
+    matcher_statistics* write_sibling_statistics(matcher_statistics* output) const {
+        output = this->write_statistics(output);
+        if constexpr (matcher::has_next_sibling()) {
+            output = this->next_sibling.write_sibling_statistics(output);
+        }
+        return output;
+    }
+
+    template <typename NodePtr>
+    NodePtr* write_matched_nodes(NodePtr* output) const {
+        *output++ = static_cast<NodePtr>(this->matched_node);
+        if constexpr (matcher::has_first_child()) {
+            output = this->first_child.write_matched_siblings(output);
+        }
+        return output;
+    }
+
+    template <typename NodePtr>
+    NodePtr* write_matched_siblings(NodePtr* output) const {
+        output = this->write_matched_nodes(output);
+        if constexpr (matcher::has_next_sibling()) {
+            output = this->next_sibling.write_matched_siblings(output);
+        }
+        return output;
+    }
+
+    // Adds the node matched to the signature, returns whether its value is known (and its hash is written in hash)
+    template <typename Index>
+    bool require_node(structural_signature& result, const Index& index, std::size_t depth, std::size_t& hash) const {
+        if constexpr (IS_CAPTURE) {
+            return this->first_child.require_node(result, index, depth, hash);
+        } else if constexpr (Derived::info.shallow_matches_null) {
+            return false;
+        } else {
+            bool known = false;
+            ++result.size;
+            result.height = std::max(result.height, depth);
+            if constexpr (matcher::has_value_key()) {
+                using key_t = std::decay_t<decltype(this->get_value_key())>;
+                if constexpr (std::is_convertible_v<key_t, typename Index::value_type>) {
+                    hash  = index.hash(this->get_value_key());
+                    known = true;
+                    result.values |= structural_signature::value_bit(hash);
+                }
+            }
+            if constexpr (matcher::has_first_child()) {
+                this->first_child.require_siblings(result, index, depth + 1u, known, hash);
+            }
+            return known;
+        }
+    }
+
+    template <typename Index>
+    void require_siblings(
+        structural_signature& result,
+        const Index& index,
+        std::size_t depth,
+        bool parent_known,
+        std::size_t parent) const {
+        std::size_t hash = 0u;
+        if (this->require_node(result, index, depth, hash) && parent_known) {
+            result.edges |= structural_signature::edge_bit(parent, hash);
+        }
+        if constexpr (matcher::has_next_sibling()) {
+            this->next_sibling.require_siblings(result, index, depth, parent_known, parent);
+        }
+    }
+
     protected:
+    // Increments a counter of the statistics, nothing is done when they are disabled
+    void count(std::size_t matcher_statistics::*counter) const {
+        if constexpr (MD_MATCHER_STATISTICS) {
+            ++(this->statistics.*counter);
+        }
+    }
+
     constexpr static bool child_may_steal_node() {
         return Derived::info.shallow_matches_null
             && matcher::foldl_children_types( // Count the children that do NOT match null
@@ -141,6 +243,78 @@ class matcher : public struct_node_base<Derived, ValueMatcher, FirstChild, NextS
         return this->matched_node == nullptr;
     }
 
+    /**
+     * @brief Whether every node matched by this matcher holds the same value, the one returned by get_value_key().
+     * @details The nodes holding that value are the only places where the matcher can match, an index of the values
+     * gives them without trying every node of the tree.
+     */
+    static constexpr bool has_value_key() {
+        if constexpr (IS_CAPTURE) {
+            return matcher::first_child_t::has_value_key();
+        } else {
+            return !Derived::info.shallow_matches_null
+                && !std::is_same_v<ValueMatcher, true_matcher>
+                && !is_same_template<ValueMatcher, product_match<std::nullptr_t, std::nullptr_t>>
+                && !is_same_template<ValueMatcher, alternative_match<>>;
+        }
+    }
+
+    const auto& get_value_key() const {
+        static_assert(matcher::has_value_key(), "The nodes matched can hold different values.");
+        if constexpr (IS_CAPTURE) {
+            return this->get_first_child().get_value_key();
+        } else {
+            return this->value;
+        }
+    }
+
+    /**
+     * @brief The signature covered by the subtree of every node where this matcher can match, see {@link
+     * structural_index}.
+     * @details It is computed once from the pattern, then each node is checked in constant time. Only the matchers that
+     * match exactly one node (one() and the captures of it) are counted, together with their values and the pairs they
+     * form with their children: the others (opt(), star()) may match no node, or nodes deeper in the tree.
+     * @param index gives the hash of the values
+     */
+    template <typename Index>
+    structural_signature required_structure(const Index& index) const {
+        structural_signature result;
+        std::size_t hash = 0u;
+        if (this->require_node(result, index, 1u, hash)) {
+            result.value = structural_signature::value_bit(hash);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Forgets the nodes where this matcher and the ones below failed.
+     * @details The failures are remembered because search_node_impl() depends only on the matcher and on the node: when
+     * the backtracking tries again a node, the result is known. This must be called before searching another tree.
+     * @param nodes the number of nodes of the tree that will be searched
+     */
+    void clear_failures(std::size_t nodes) {
+        this->failures.clear(nodes);
+        if constexpr (matcher::has_first_child()) {
+            this->first_child.clear_failures(nodes);
+        }
+        if constexpr (matcher::has_next_sibling()) {
+            this->next_sibling.clear_failures(nodes);
+        }
+    }
+
+    /// @brief Sets to zero the statistics of this matcher and of the ones below.
+    void clear_statistics() {
+        if constexpr (MD_MATCHER_STATISTICS) {
+            this->statistics = matcher_statistics();
+        }
+        if constexpr (matcher::has_first_child()) {
+            this->first_child.clear_statistics();
+        }
+        if constexpr (matcher::has_next_sibling()) {
+            this->next_sibling.clear_statistics();
+        }
+    }
+
     void reset() {
         this->matched_node = nullptr;
         if constexpr (matcher::has_first_child()) {
@@ -163,6 +337,7 @@ class matcher : public struct_node_base<Derived, ValueMatcher, FirstChild, NextS
 
     template <typename NodeAllocator>
     unique_ptr_alloc<NodeAllocator> clone_matched_node(NodeAllocator& allocator) const {
+        this->count(&matcher_statistics::allocations);
         return allocate(allocator, this->get_matched_node(allocator)->get_value());
     }
 
@@ -184,15 +359,18 @@ class matcher : public struct_node_base<Derived, ValueMatcher, FirstChild, NextS
         Iterator begin = it;
         // Try to match something
         while (it) {
-            ++this->steps;
+            this->count(&matcher_statistics::steps);
             node_ptr candidate = it.get_raw_node(); // save current node because it may be modified by search_node_impl
-            if (this->cast()->search_node_impl(allocator, it)) {
-                this->matched_node = candidate;
-                if constexpr (!is_empty<AckowledgeFunction>) {
-                    ackowledge(candidate);
+            if (!this->failures.contains(candidate)) {
+                if (this->cast()->search_node_impl(allocator, it)) {
+                    this->matched_node = candidate;
+                    if constexpr (!is_empty<AckowledgeFunction>) {
+                        ackowledge(candidate);
+                    }
+                    ++it;
+                    return true;
                 }
-                ++it;
-                return true;
+                this->failures.insert(candidate);
             }
             ++it;
         }
@@ -241,7 +419,9 @@ class matcher : public struct_node_base<Derived, ValueMatcher, FirstChild, NextS
                 if constexpr (!is_empty<std::decay_t<RematchFunction>>) {
                     it_t search_start = begin;
                     it                = search_start; // Go back to where we started
-                    while (it && rematch(*this, it)) {
+                    // The first rematch starts from the node matched, even if the sibling had no node left to try
+                    for (bool first = true; (first || it) && rematch(*this, it); first = false) {
+                        this->count(&matcher_statistics::backtracks);
                         search_start = it;
                         if (!this->cast()->search_node_this(allocator, it, ackowledge)) {
                             continue; // Rematched it doesn't satisfy this matcher
@@ -253,6 +433,8 @@ class matcher : public struct_node_base<Derived, ValueMatcher, FirstChild, NextS
                     }
                 }
                 if (Derived::info.matches_null && !this->empty()) {
+                    this->count(&matcher_statistics::backtracks);
+                    this->count(&matcher_statistics::iterator_rebuilds);
                     it = it.other_node(this->get_matched_node(allocator)); // This matched renonunces to its node
                     this->reset();
                     return this->cast()->get_next_sibling().search_node(allocator, it, ackowledge, rematch);
@@ -293,14 +475,16 @@ class matcher : public struct_node_base<Derived, ValueMatcher, FirstChild, NextS
         return this->cast()->result_impl(allocator);
     }
 
-    template <std::size_t Index, typename NodeAllocator>
-    unique_ptr_alloc<NodeAllocator> marked_result(const_index<Index>, NodeAllocator& allocator) {
+    /// @brief The capture having the given index (starting from 1).
+    template <std::size_t Index>
+    auto& get_mark_matcher(const_index<Index>) const {
         static_assert(Index - 1 < std::tuple_size_v<captures_t>, "There is no capture with the index requested.");
-        return std::get<Index - 1>(this->captures).result(allocator);
+        return std::get<Index - 1>(this->captures);
     }
 
-    template <char... Name, typename NodeAllocator>
-    unique_ptr_alloc<NodeAllocator> marked_result(const_name<Name...>, NodeAllocator& allocator) {
+    /// @brief The capture having the given name.
+    template <char... Name>
+    auto& get_mark_matcher(const_name<Name...>) const {
         static_assert(
             sizeof...(Name) > 0,
             "Capture's name must be not empty. For example const_name<'a'> is OK, while const_name<> is not.");
@@ -308,7 +492,43 @@ class matcher : public struct_node_base<Derived, ValueMatcher, FirstChild, NextS
             detail::is_valid_name<const_name<Name...>, captures_t>,
             "There is no capture with the name requested.");
         constexpr std::size_t index = detail::index_of_capture<const_name<Name...>, captures_t>;
-        return std::get<index>(this->captures).result(allocator);
+        return std::get<index>(this->captures);
+    }
+
+    template <typename Mark, typename NodeAllocator>
+    unique_ptr_alloc<NodeAllocator> marked_result(Mark mark, NodeAllocator& allocator) {
+        return this->get_mark_matcher(mark).result(allocator);
+    }
+
+    /// @brief Statistics of this matcher and of the ones below, in pre-order of the matchers.
+    std::array<matcher_statistics, matcher::subtree_size()> get_statistics() const {
+        std::array<matcher_statistics, matcher::subtree_size()> result {};
+        this->write_statistics(result.data());
+        return result;
+    }
+
+    /**
+     * @brief Nodes matched by this matcher and the ones below, in pre-order of the matchers.
+     * @details Matchers that did not match anything have a null node. Nothing is copied.
+     */
+    template <typename NodeAllocator>
+    std::array<const allocator_value_type<NodeAllocator>*, matcher::subtree_size()>
+    matched_nodes(NodeAllocator&) const {
+        std::array<const allocator_value_type<NodeAllocator>*, matcher::subtree_size()> result {};
+        this->write_matched_nodes(result.data());
+        return result;
+    }
+
+    /// @brief Nodes matched by the captures, in the same order as captures_t (null for the ones that matched nothing).
+    template <typename NodeAllocator>
+    std::array<const allocator_value_type<NodeAllocator>*, std::tuple_size_v<captures_t>>
+    marked_nodes(NodeAllocator& allocator) const {
+        return std::apply(
+            [&](auto&... capture) {
+                return std::array<const allocator_value_type<NodeAllocator>*, std::tuple_size_v<captures_t>> {
+                    capture.get_matched_node(allocator)...};
+            },
+            this->captures);
     }
 
     constexpr std::size_t mark_count() const {
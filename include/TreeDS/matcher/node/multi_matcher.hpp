@@ -69,6 +69,7 @@ class multi_matcher
         };
         using navigator_t = node_pred_navigator<node_ptr_t, decltype(predicate)>;
         navigator_t navigator(it.get_raw_node(), predicate);
+        this->count(&matcher_statistics::iterator_rebuilds);
         if constexpr (multi_matcher::info.possessive) {
             auto predicate = [this](typename Iterator::value_type& value) {
                 return !this->match_value(value);
@@ -128,13 +129,14 @@ class multi_matcher
                                   .go_depth_first_ramification();
                 it                = it_t(policy);
                 this->subtree_cut = nullptr;
+                this->count(&matcher_statistics::iterator_rebuilds);
                 return true;
             };
         }
     }
 
     template <typename NodeAllocator, typename CheckNode>
-    static void keep_assigning_children(
+    void keep_assigning_children(
         allocator_value_type<NodeAllocator>& target,
         const allocator_value_type<NodeAllocator>& reference,
         NodeAllocator& allocator,
@@ -143,10 +145,12 @@ class multi_matcher
         const node_t* child = reference.get_first_child();
         while (child) {
             if (!check_function(*child)) {
+                child = child->get_next_sibling();
                 continue;
             }
+            this->count(&matcher_statistics::allocations);
             node_t* new_target = target.assign_child_like(allocate(allocator, child->get_value()), *child);
-            keep_assigning_children(*new_target, *child, allocator, check_function);
+            this->keep_assigning_children(*new_target, *child, allocator, check_function);
             child = child->get_next_sibling();
         }
     }
@@ -162,7 +166,7 @@ class multi_matcher
         case quantifier::POSSESSIVE:
             // Greedy and possessive multi_matcher without children matches everithing they can
             result = this->clone_matched_node(allocator);
-            multi_matcher::keep_assigning_children(
+            this->keep_assigning_children(
                 *result,
                 *this->get_matched_node(allocator),
                 allocator,
@@ -195,6 +199,7 @@ class multi_matcher
             auto it = cloned_nodes.find(child_head.first->get_parent());
             while (it == cloned_nodes.end()) { // while parent does not exist in cloned_nodes
                 cloned_nodes[child_head.first] = child_head.second.get();
+                this->count(&matcher_statistics::allocations);
                 child_head                     = {
                     child_head.first->get_parent(), // reference node goes to parent
                     child_head.second.release()->allocate_assign_parent(allocator, *child_head.first)};
@@ -204,7 +209,9 @@ class multi_matcher
         };
         this->foldl_children(
             [&](bool, auto& child) {
-                attach_child(child);
+                if (!child.empty()) {
+                    attach_child(child);
+                }
                 return true;
             },
             true);
@@ -252,7 +259,12 @@ class multi_matcher
                 // We reached the child of a node that was matched by some children: discard because already mapped
                 return false;
             }
-            return this->match_value(multi_ptr->get_value());
+            if (!this->match_value(multi_ptr->get_value())) {
+                return false;
+            }
+            // The navigator allocates the copy of the node
+            this->count(&matcher_statistics::allocations);
+            return true;
         };
         generative_navigator nav(roots, check_target, allocator);
         detail::breadth_first_impl iterator(policy::breadth_first().get_instance(roots, nav, allocator));
@@ -267,11 +279,14 @@ class multi_matcher
         if (!this->match_value(*it)) {
             // If this matcher does not accepth the node, there is still one possibility: a single child can match it
             if constexpr (multi_matcher::child_may_steal_node()) {
+                this->count(&matcher_statistics::iterator_rebuilds);
                 return this->search_node_child(allocator, it.other_policy(policy::fixed()));
             } else {
                 return false;
             }
         }
+        // Nothing is cut yet, a previous search must not change the result
+        this->subtree_cut   = nullptr;
         auto target_it      = this->get_match_iterator(allocator, it);
         using node_t        = allocator_value_type<NodeAllocator>;
         auto do_acknowledge = [this](const node_t* matched) {
@@ -282,6 +297,7 @@ class multi_matcher
         if constexpr (!multi_matcher::info.possessive && multi_matcher::child_may_steal_node()) {
             // Every other match failed, we try the last possibility: one of the children matches this node
             if (!result) {
+                this->count(&matcher_statistics::iterator_rebuilds);
                 return this->search_node_child(allocator, it.other_policy(policy::fixed()));
             }
         }
@@ -41,6 +41,7 @@ class one_matcher : public matcher<
             return false;
         }
         using basic_navigator = node_navigator<decltype(it.get_raw_node())>;
+        this->count(&matcher_statistics::iterator_rebuilds);
         // Iterator that gives the children potential nodes to match
         tree_iterator target_it
             = tree_iterator<
@@ -47,6 +47,7 @@ class opt_matcher : public matcher<
     bool search_node_impl(NodeAllocator& allocator, Iterator& it) {
         if (!this->match_value(*it)) {
             if constexpr (opt_matcher::child_may_steal_node()) {
+                this->count(&matcher_statistics::iterator_rebuilds);
                 auto fixed_it = it.other_policy(policy::fixed());
                 return this->search_node_child(allocator, fixed_it);
             } else {
@@ -54,6 +55,7 @@ class opt_matcher : public matcher<
             }
         }
         using basic_navigator = node_navigator<typename Iterator::node_type*>;
+        this->count(&matcher_statistics::iterator_rebuilds);
         auto target_it
             = tree_iterator<
                   // Even though we have template argument deduction, clang has a bug that fails to infer them
@@ -70,6 +72,7 @@ class opt_matcher : public matcher<
             && opt_matcher::child_may_steal_node()) {
             // Every other match failed, we try the last possibility: one of the children matches this node
             if (!result) {
+                this->count(&matcher_statistics::iterator_rebuilds);
                 return this->search_node_child(allocator, it.other_policy(policy::fixed()));
             }
         }
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm> // std::max()
+#include <atomic>
+#include <condition_variable>
+#include <cstddef> // std::size_t
+#include <deque>
+#include <exception> // std::exception_ptr
+#include <memory>    // std::unique_ptr
+#include <mutex>
+#include <thread>
+#include <utility> // std::pair
+#include <vector>
+
+#include <TreeDS/matcher/match_iterator.hpp>
+#include <TreeDS/matcher/pattern.hpp>
+#include <TreeDS/policy/fixed.hpp>
+
+namespace md {
+
+/**
+ * @brief Requests a search run by many threads, see {@link pattern#search_all()}.
+ * @details The number of threads is the one of the hardware when 0 (or when it cannot be determined, 1). This header
+ * is not included by the others (it needs the threads library), include <TreeDS/parallel> to use it.
+ */
+struct parallel {
+    std::size_t threads;
+
+    explicit parallel(std::size_t threads = 0u) :
+            threads(threads != 0u ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+    }
+};
+
+namespace detail {
+
+    /**
+     * @brief Finds every occurrence of a pattern in a tree using a pool of threads that steal work from each other.
+     * @details A task is the search in the subtrees of a node and of its following siblings (of the root alone for the
+     * first task). Each thread has a copy of the pattern (matched nodes, captures and failures are per thread) and a
+     * queue of tasks. A thread runs a task visiting the nodes in pre-order, with a stack that holds for each level the
+     * sibling where the visit continues. While other threads are idle, it hands off the entry at the bottom of the stack
+     * (the highest level, having the most work left) as a new task, leaving in its output the position where the output
+     * of that task goes. Idle threads take tasks from the other queues. The outputs are finally joined following those
+     * positions, which gives the matches in pre-order regardless of the scheduling. Threads finding no task wait until
+     * one is created or the search ends. The first exception thrown by a thread stops the search and is rethrown to the
+     * caller once every thread finished.
+     * @tparam Pattern the type of the pattern searched
+     * @tparam Tree the type of tree searched
+     */
+    template <typename Pattern, typename Tree>
+    class parallel_search {
+
+        /*   ---   TYPES   ---   */
+        public:
+        using node_type  = typename Tree::node_type;
+        using match_type = pattern_match<node_type, typename Pattern::captures_type>;
+
+        protected:
+        struct task;
+
+        // Either a match or the place where the output of a task handed off goes
+        struct item {
+            task* handed_off;
+            match_type match;
+        };
+
+        struct task {
+            const node_type* first;
+            // Whether the siblings following the first node are searched as well
+            bool siblings;
+            std::vector<item> items;
+        };
+
+        struct worker_queue {
+            std::mutex mutex;
+            std::deque<task*> tasks;
+        };
+
+        // The next node to visit (followed by its siblings) or a task already handed off
+        struct entry {
+            const node_type* node;
+            task* handed_off;
+        };
+
+        /*   ---   ATTRIBUTES   ---   */
+        protected:
+        const Pattern& prototype;
+        const Tree& tree;
+        // The references to the elements of a deque remain valid when new ones are appended
+        std::deque<task> tasks;
+        std::mutex tasks_mutex;
+        std::unique_ptr<worker_queue[]> queues;
+        std::size_t threads;
+        // Tasks created and not yet completed
+        std::atomic<std::size_t> pending {0u};
+        // Tasks waiting in some queue
+        std::atomic<std::size_t> queued {0u};
+        // Threads looking for a task
+        std::atomic<std::size_t> idle {0u};
+        // Guards the waiting of the idle threads and the error
+        std::mutex state_mutex;
+        std::condition_variable state_changed;
+        std::atomic<bool> failed {false};
+        std::exception_ptr error;
+
+        /*   ---   CONSTRUCTORS   ---   */
+        public:
+        parallel_search(const Pattern& prototype, const Tree& tree, const parallel& execution) :
+                prototype(prototype),
+                tree(tree),
+                queues(new worker_queue[execution.threads]),
+                threads(execution.threads) {
+        }
+
+        /*   ---   METHODS   ---   */
+        protected:
+        task* create_task(const node_type* first, bool siblings, std::size_t worker) {
+            task* result;
+            {
+                std::lock_guard<std::mutex> lock(this->tasks_mutex);
+                this->tasks.push_back({first, siblings, {}});
+                result = &this->tasks.back();
+            }
+            this->pending.fetch_add(1u);
+            this->queued.fetch_add(1u);
+            {
+                std::lock_guard<std::mutex> lock(this->queues[worker].mutex);
+                this->queues[worker].tasks.push_back(result);
+            }
+            this->notify(false);
+            return result;
+        }
+
+        // Wakes the threads waiting for a task, after they checked the state or while they wait
+        void notify(bool all) {
+            {
+                std::lock_guard<std::mutex> lock(this->state_mutex);
+            }
+            if (all) {
+                this->state_changed.notify_all();
+            } else {
+                this->state_changed.notify_one();
+            }
+        }
+
+        // Stops the search, only the first error is kept
+        void fail(std::exception_ptr exception) {
+            {
+                std::lock_guard<std::mutex> lock(this->state_mutex);
+                if (!this->error) {
+                    this->error = exception;
+                }
+                this->failed.store(true);
+            }
+            this->state_changed.notify_all();
+        }
+
+        // Takes the newest task of its own queue, or else steals the oldest task of another queue
+        task* take_task(std::size_t worker) {
+            for (std::size_t i = 0u; i < this->threads; ++i) {
+                worker_queue& queue = this->queues[(worker + i) % this->threads];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (!queue.tasks.empty()) {
+                    task* result;
+                    if (i == 0u) {
+                        result = queue.tasks.back();
+                        queue.tasks.pop_back();
+                    } else {
+                        result = queue.tasks.front();
+                        queue.tasks.pop_front();
+                    }
+                    this->queued.fetch_sub(1u);
+                    return result;
+                }
+            }
+            return nullptr;
+        }
+
+        void run(Pattern& pattern, task& current, std::size_t worker) {
+            std::vector<entry> stack {{current.first, nullptr}};
+            // The entries below this index were handed off
+            std::size_t handed_off = 0u;
+            auto position          = this->tree.begin(policy::fixed());
+            while (!stack.empty() && !this->failed.load(std::memory_order_relaxed)) {
+                const entry visited = stack.back();
+                stack.pop_back();
+                if (handed_off > stack.size()) {
+                    handed_off = stack.size();
+                }
+                if (visited.handed_off != nullptr) {
+                    current.items.push_back({visited.handed_off, {}});
+                    continue;
+                }
+                const node_type* node = visited.node;
+                if (pattern.search_at(this->tree, position.other_node(node))) {
+                    current.items.push_back({nullptr, match_type(node, pattern.get_marks(this->tree))});
+                }
+                if (node->get_next_sibling() != nullptr && (current.siblings || node != current.first)) {
+                    stack.push_back({node->get_next_sibling(), nullptr});
+                }
+                if (node->get_first_child() != nullptr) {
+                    stack.push_back({node->get_first_child(), nullptr});
+                }
+                if (handed_off < stack.size()
+                    && this->idle.load(std::memory_order_relaxed) > this->queued.load(std::memory_order_relaxed)) {
+                    stack[handed_off].handed_off = this->create_task(stack[handed_off].node, true, worker);
+                    ++handed_off;
+                }
+            }
+        }
+
+        void work(std::size_t worker) {
+            try {
+                Pattern pattern(this->prototype);
+                pattern.start_search(this->tree);
+                while (!this->failed.load()) {
+                    task* current = this->take_task(worker);
+                    if (current == nullptr) {
+                        std::unique_lock<std::mutex> lock(this->state_mutex);
+                        this->idle.fetch_add(1u);
+                        this->state_changed.wait(lock, [&] {
+                            current = this->take_task(worker);
+                            return current != nullptr || this->pending.load() == 0u || this->failed.load();
+                        });
+                        this->idle.fetch_sub(1u);
+                        if (current == nullptr) {
+                            return;
+                        }
+                    }
+                    this->run(pattern, *current, worker);
+                    if (this->pending.fetch_sub(1u) == 1u) {
+                        // The last task completed, the idle threads can exit
+                        this->notify(true);
+                    }
+                }
+            } catch (...) {
+                this->fail(std::current_exception());
+            }
+        }
+
+        // Appends the matches of the task, and of the tasks it handed off, in pre-order
+        void join(const task& root, std::vector<match_type>& result) const {
+            std::vector<std::pair<const task*, std::size_t>> stack {{&root, 0u}};
+            while (!stack.empty()) {
+                auto& [current, index] = stack.back();
+                if (index == current->items.size()) {
+                    stack.pop_back();
+                    continue;
+                }
+                const item& next = current->items[index++];
+                if (next.handed_off != nullptr) {
+                    stack.emplace_back(next.handed_off, 0u);
+                } else {
+                    result.push_back(next.match);
+                }
+            }
+        }
+
+        public:
+        std::vector<match_type> run() {
+            std::vector<match_type> result;
+            if (this->tree.empty()) {
+                return result;
+            }
+            task* root = this->create_task(this->tree.raw_root_node(), false, 0u);
+            std::vector<std::thread> workers;
+            try {
+                for (std::size_t i = 1u; i < this->threads; ++i) {
+                    workers.emplace_back(&parallel_search::work, this, i);
+                }
+            } catch (...) {
+                this->fail(std::current_exception());
+            }
+            this->work(0u);
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+            if (this->error) {
+                std::rethrow_exception(this->error);
+            }
+            this->join(*root, result);
+            return result;
+        }
+    };
+
+} // namespace detail
+
+} // namespace md
@@ -1,23 +1,63 @@
 #pragma once
 
-#include <cstddef> // std::size_t
+#include <chrono>
+#include <cstddef>     // std::size_t
 #include <optional>
-#include <stdexcept> // std::invalid_argument
+#include <stdexcept>   // std::invalid_argument
+#include <type_traits> // std::is_convertible_v, std::decay_t
 #include <typeindex>
+#include <vector>
 
+#include <TreeDS/matcher/match_iterator.hpp>
+#include <TreeDS/matcher/match_view.hpp>
 #include <TreeDS/matcher/node/matcher.hpp>
+#include <TreeDS/matcher/statistics.hpp>
+#include <TreeDS/policy/fixed.hpp>
 #include <TreeDS/tree.hpp>
 #include <TreeDS/tree_base.hpp>
 
 namespace md {
 
+// Declared in <TreeDS/parallel>, which is included only by the users of threads
+struct parallel;
+
+// Declared in <TreeDS/index>, the indexes depend on the matchers and not the other way around
+template <typename, typename, typename>
+class value_index;
+
+template <typename, typename>
+class structural_index;
+
+namespace detail {
+    template <typename, typename>
+    class parallel_search;
+} // namespace detail
+
 template <typename PatternTree>
-class pattern {
+class pattern : protected detail::search_time_storage<PatternTree> {
+
+    /*   ---   FRIENDS   ---   */
+    template <typename, typename>
+    friend class match_iterator;
+
+    template <typename, typename>
+    friend class incremental_search;
+
+    template <typename, typename>
+    friend class detail::parallel_search;
+
+    template <typename...>
+    friend class rewriter;
+
+    /*   ---   TYPES   ---   */
+    public:
+    using captures_type   = typename PatternTree::captures_t;
+    using statistics_type = search_statistics<PatternTree::subtree_size()>;
 
     protected:
     PatternTree pattern_tree;
     std::optional<std::type_index> node_type = std::nullopt;
-    void* matched_tree                       = nullptr;
+    const void* matched_tree                 = nullptr;
 
     public:
     pattern(PatternTree&& tree) :
@@ -25,14 +65,34 @@ class pattern {
     }
 
     private:
+    void clear_statistics() {
+        if constexpr (MD_MATCHER_STATISTICS) {
+            this->pattern_tree.clear_statistics();
+            this->elapsed = std::chrono::steady_clock::duration(0);
+        }
+    }
+
+    // Calls the function and adds the time it took to the statistics
+    template <typename Function>
+    bool timed(Function&& function) {
+        if constexpr (MD_MATCHER_STATISTICS) {
+            auto start  = std::chrono::steady_clock::now();
+            bool result = function();
+            this->elapsed += std::chrono::steady_clock::now() - start;
+            return result;
+        } else {
+            return function();
+        }
+    }
+
     template <typename Tree>
     bool do_search(Tree& tree) {
         std::type_index tree_type(typeid(tree.raw_root_node()));
-        if (matched_tree != nullptr && matched_tree == tree.raw_root_node()) {
-            return true;
-        }
+        this->matched_tree = nullptr;
+        this->clear_statistics();
         pattern_tree.reset();
-        if (this->pattern_tree.search_node(tree.get_node_allocator(), tree.root())) {
+        pattern_tree.clear_failures(tree.size());
+        if (this->timed([&] { return this->pattern_tree.search_node(tree.get_node_allocator(), tree.root()); })) {
             this->node_type    = tree_type;
             this->matched_tree = &tree;
             return true;
@@ -40,6 +100,59 @@ class pattern {
         return false;
     }
 
+    // Prepares for a sequence of search_at() visiting about the given number of nodes
+    void start_search(std::size_t nodes) {
+        this->matched_tree = nullptr;
+        this->clear_statistics();
+        this->pattern_tree.clear_failures(nodes);
+    }
+
+    // Prepares for a sequence of search_at() in the tree
+    template <typename Tree>
+    void start_search(const Tree& tree) {
+        this->start_search(tree.size());
+    }
+
+    // Tries the node of the iterator as root, the failures remembered for the same tree are still valid
+    template <typename Tree, typename Iterator>
+    bool search_at(const Tree& tree, const Iterator& position) {
+        this->pattern_tree.reset();
+        return this->timed([&] {
+            return this->pattern_tree.search_node(tree.get_node_allocator(), position.other_policy(policy::fixed()));
+        });
+    }
+
+    template <typename Tree>
+    auto get_marks(const Tree& tree) const {
+        auto allocator = tree.get_node_allocator();
+        return this->pattern_tree.marked_nodes(allocator);
+    }
+
+    template <typename Node, typename Policy, typename Allocator>
+    void check_viewed_tree(const tree_base<Node, Policy, Allocator>& tree) const {
+        if (this->matched_tree != &tree) {
+            throw std::invalid_argument("Tried to view the result of a search in a different tree.");
+        }
+    }
+
+    template <typename Node, typename Policy, typename Allocator, typename Matcher>
+    static typename detail::tree_view_of<Node, Policy, Allocator>::type
+    subtree_view(const tree_base<Node, Policy, Allocator>& tree, const Matcher& matcher) {
+        auto allocator   = tree.get_node_allocator();
+        const Node* node = matcher.get_matched_node(allocator);
+        if (node == nullptr) {
+            return {};
+        }
+        return {tree, tree.begin(policy::fixed()).other_node(node)};
+    }
+
+    template <typename Node, typename Policy, typename Allocator, typename Matcher>
+    static match_view<tree_base<Node, Policy, Allocator>, Matcher::subtree_size()>
+    matched_view(const tree_base<Node, Policy, Allocator>& tree, const Matcher& matcher) {
+        auto allocator = tree.get_node_allocator();
+        return {matcher.get_matched_node(allocator), matcher.matched_nodes(allocator), allocator};
+    }
+
     public:
     /// @brief Returns the number of marked nodes within the pattern
     std::size_t mark_count() const {
@@ -59,6 +172,89 @@ class pattern {
         return this->do_search(tree);
     }
 
+    /**
+     * @brief Finds lazily every node of the tree where the pattern matches, in pre-order.
+     * @details Each occurrence reports the node matched by the root of the pattern and the nodes matched by the
+     * captures. The search of an occurrence resumes from the previous one and reuses the failures found so far, instead
+     * of starting again from the root. The range and its iterators are invalidated when the tree is modified or the
+     * pattern is used for another search. The results of {@link #search()} are discarded.
+     * @return a forward range of {@link pattern_match}
+     */
+    template <typename Node, typename Policy, typename Allocator>
+    match_range<pattern, tree_base<Node, Policy, Allocator>> search_all(const tree_base<Node, Policy, Allocator>& tree) {
+        this->start_search(tree);
+        return {*this, tree};
+    }
+
+    /**
+     * @brief Like {@link #search_all()} but only the nodes holding the value of the root of the pattern are tried.
+     * @details The candidates are taken from the index, therefore a pattern whose root value is rare is searched in time
+     * proportional to the number of its occurrences instead of the size of the tree. When the root of the pattern can
+     * match different values (e.g. one() or star()), every node is tried as in {@link #search_all()}.
+     * @param tree the tree to search
+     * @param index an index built from that tree and not invalidated by modifications since
+     * @throw std::invalid_argument if the index was built from a different tree
+     */
+    template <typename Node, typename Policy, typename Allocator, typename Tree, typename Hash, typename KeyEqual>
+    match_range<pattern, tree_base<Node, Policy, Allocator>> search_all(
+        const tree_base<Node, Policy, Allocator>& tree,
+        const value_index<Tree, Hash, KeyEqual>& index) {
+        if (!index.is_index_of(tree)) {
+            throw std::invalid_argument("Tried to search a tree using the index of a different tree.");
+        }
+        this->start_search(tree);
+        if constexpr (PatternTree::has_value_key()) {
+            using key_t = std::decay_t<decltype(this->pattern_tree.get_value_key())>;
+            if constexpr (std::is_convertible_v<key_t, typename Tree::value_type>) {
+                return {*this, tree, index.find(this->pattern_tree.get_value_key())};
+            }
+        }
+        return {*this, tree};
+    }
+
+    /**
+     * @brief Like {@link #search_all()} but the nodes whose subtree lacks what the pattern requires are skipped.
+     * @details The pattern is reduced to the values, parent-child pairs, size and height of the nodes it requires, then
+     * each node is rejected in constant time if the signature of its subtree does not cover them, before being tried
+     * as root of the pattern. This saves the most on trees having many subtrees that almost match the pattern.
+     * @param tree the tree to search
+     * @param index an index built from that tree and not invalidated by modifications since
+     * @throw std::invalid_argument if the index was built from a different tree
+     */
+    template <typename Node, typename Policy, typename Allocator, typename Tree, typename Hash>
+    match_range<pattern, tree_base<Node, Policy, Allocator>> search_all(
+        const tree_base<Node, Policy, Allocator>& tree,
+        const structural_index<Tree, Hash>& index) {
+        if (!index.is_index_of(tree)) {
+            throw std::invalid_argument("Tried to search a tree using the index of a different tree.");
+        }
+        this->start_search(tree);
+        return {
+            *this,
+            tree,
+            index.get_nodes(),
+            index.get_signatures(),
+            this->pattern_tree.required_structure(index)};
+    }
+
+    /**
+     * @brief Finds every node of the tree where the pattern matches, in pre-order, using many threads.
+     * @details The nodes tried as root of the pattern are split by subtree among the threads, each one searching with
+     * its own copy of the pattern, see {@link detail::parallel_search}. The result is the same as the one of
+     * {@link #search_all()}, whatever the number of threads. The tree must not be modified during the search. The
+     * results of {@link #search()} are discarded and the statistics of the copies are not collected. Needs
+     * <TreeDS/parallel>.
+     * @param tree the tree to search
+     * @param execution the number of threads to use
+     * @return the occurrences of the pattern, see {@link pattern_match}
+     */
+    template <typename Node, typename Policy, typename Allocator>
+    std::vector<pattern_match<Node, captures_type>>
+    search_all(const tree_base<Node, Policy, Allocator>& tree, const parallel& execution) {
+        this->start_search(tree);
+        return detail::parallel_search<pattern, tree_base<Node, Policy, Allocator>>(*this, tree, execution).run();
+    }
+
     template <typename Node, typename Policy, typename Allocator>
     void assign_result(tree<Node, Policy, Allocator>& tree) {
         if (this->node_type != typeid(tree.raw_root_node())) {
@@ -86,6 +282,78 @@ class pattern {
         tree = pattern_tree.marked_result(name, tree.allocator);
     }
 
+    /**
+     * @brief View of the subtree of the node matched by the pattern in the last successful {@link #search()}.
+     * @details The view shares the nodes of the searched tree, nothing is copied. Unlike {@link #assign_result()}, the
+     * whole subtree is shown, use {@link #result_match_view()} to see only the nodes matched. The view is valid as long
+     * as the tree is not modified.
+     * @param tree the tree that was searched
+     * @return a view of the subtree, empty if the pattern did not match
+     * @throw std::invalid_argument if the last successful search was not in the given tree
+     */
+    template <typename Node, typename Policy, typename Allocator>
+    typename detail::tree_view_of<Node, Policy, Allocator>::type
+    result_view(const tree_base<Node, Policy, Allocator>& tree) const {
+        this->check_viewed_tree(tree);
+        return subtree_view(tree, this->pattern_tree);
+    }
+
+    /**
+     * @brief View of the subtree of the node matched by a capture in the last successful {@link #search()}.
+     * @param mark the index (starting from 1) or the name of the capture
+     * @param tree the tree that was searched
+     * @return a view of the subtree, empty if the capture did not match
+     * @throw std::invalid_argument if the last successful search was not in the given tree
+     */
+    template <typename Mark, typename Node, typename Policy, typename Allocator>
+    typename detail::tree_view_of<Node, Policy, Allocator>::type
+    mark_view(Mark mark, const tree_base<Node, Policy, Allocator>& tree) const {
+        this->check_viewed_tree(tree);
+        return subtree_view(tree, this->pattern_tree.get_mark_matcher(mark));
+    }
+
+    /**
+     * @brief View of the nodes matched by the pattern in the last successful {@link #search()}.
+     * @details It shows the nodes matched by the matchers and the ones connecting them, directly in the searched tree.
+     * See {@link match_view}.
+     * @param tree the tree that was searched
+     * @throw std::invalid_argument if the last successful search was not in the given tree
+     */
+    template <typename Node, typename Policy, typename Allocator>
+    auto result_match_view(const tree_base<Node, Policy, Allocator>& tree) const {
+        this->check_viewed_tree(tree);
+        return matched_view(tree, this->pattern_tree);
+    }
+
+    /**
+     * @brief View of the nodes matched by a capture in the last successful {@link #search()}, see {@link match_view}.
+     * @param mark the index (starting from 1) or the name of the capture
+     * @param tree the tree that was searched
+     * @throw std::invalid_argument if the last successful search was not in the given tree
+     */
+    template <typename Mark, typename Node, typename Policy, typename Allocator>
+    auto mark_match_view(Mark mark, const tree_base<Node, Policy, Allocator>& tree) const {
+        this->check_viewed_tree(tree);
+        return matched_view(tree, this->pattern_tree.get_mark_matcher(mark));
+    }
+
+    /**
+     * @brief Work done by each matcher since the beginning of the last search.
+     * @details The statistics of a {@link #search()} or of all the occurrences enumerated by a {@link #search_all()} are
+     * accumulated, together with the allocations of the results assigned after it. The matchers are in pre-order of the
+     * pattern. Available only when MD_MATCHER_STATISTICS is defined as 1 before including the library, otherwise the
+     * matchers do not count anything.
+     */
+    statistics_type get_statistics() const {
+        static_assert(
+            MD_MATCHER_STATISTICS != 0 && sizeof(PatternTree) > 0,
+            "The statistics are not collected, define MD_MATCHER_STATISTICS as 1 to enable them.");
+        statistics_type result;
+        result.matchers = this->pattern_tree.get_statistics();
+        result.elapsed  = this->elapsed;
+        return result;
+    }
+
     const PatternTree& get_pattern() const {
         return this->pattern_tree;
     }
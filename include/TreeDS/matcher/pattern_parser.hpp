@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cctype>    // std::isalnum(), std::isalpha(), std::isspace(), std::tolower()
+#include <cstddef>   // std::size_t
+#include <cstdio>    // EOF
+#include <stdexcept> // std::invalid_argument
+#include <string>
+#include <string_view>
+
+#include <TreeDS/matcher/pattern_program.hpp>
+#include <TreeDS/serializer/text_codec.hpp>
+
+namespace md {
+
+namespace detail {
+
+    /**
+     * @brief Recursive descent parser of the textual patterns, see {@link parse_pattern()}.
+     * @details It offers to the codec of the values the same interface as {@link text_reader}.
+     */
+    template <typename T, typename Codec>
+    class pattern_parser {
+
+        /*   ---   ATTRIBUTES   ---   */
+        protected:
+        std::string_view text;
+        std::size_t position = 0u;
+        const Codec& codec;
+        pattern_program<T>& program;
+
+        /*   ---   CONSTRUCTORS   ---   */
+        public:
+        pattern_parser(std::string_view text, const Codec& codec, pattern_program<T>& program) :
+                text(text),
+                codec(codec),
+                program(program) {
+        }
+
+        /*   ---   METHODS   ---   */
+        protected:
+        [[noreturn]] void unexpected(const char* expected) {
+            int c = this->peek();
+            throw std::invalid_argument(
+                std::string("Expected ") + expected + " at offset " + std::to_string(this->position) + " but found "
+                + (c == EOF ? std::string("the end of the text") : std::string("'") + static_cast<char>(c) + "'")
+                + ".");
+        }
+
+        void skip_whitespaces() {
+            while (this->position < this->text.size()
+                   && std::isspace(static_cast<unsigned char>(this->text[this->position]))) {
+                ++this->position;
+            }
+        }
+
+        std::string_view read_identifier() {
+            const std::size_t begin = this->position;
+            while (this->position < this->text.size()
+                   && (std::isalnum(static_cast<unsigned char>(this->text[this->position]))
+                       || this->text[this->position] == '_')) {
+                ++this->position;
+            }
+            return this->text.substr(begin, this->position - begin);
+        }
+
+        quantifier read_quantifier() {
+            this->skip_whitespaces();
+            std::string_view name = this->read_identifier();
+            if (name == "quantifier" && this->text.substr(this->position, 2u) == "::") {
+                this->position += 2u;
+                name = this->read_identifier();
+            }
+            std::string lower;
+            for (char c : name) {
+                lower.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+            }
+            if (lower == "default") {
+                return quantifier::DEFAULT;
+            } else if (lower == "reluctant") {
+                return quantifier::RELUCTANT;
+            } else if (lower == "greedy") {
+                return quantifier::GREEDY;
+            } else if (lower == "possessive") {
+                return quantifier::POSSESSIVE;
+            }
+            this->position -= name.size();
+            this->unexpected("a quantifier");
+        }
+
+        void parse_capture() {
+            this->skip_whitespaces();
+            this->expect('(');
+            this->skip_whitespaces();
+            // Either the name followed by a comma or the captured matcher
+            const std::size_t begin = this->position;
+            std::string name(this->read_identifier());
+            this->skip_whitespaces();
+            if (!name.empty() && this->peek() == ',') {
+                this->get();
+                this->skip_whitespaces();
+            } else {
+                name.clear();
+                this->position = begin;
+            }
+            this->program.begin(instruction_kind::CAPTURE, quantifier::DEFAULT, nullptr, name);
+            this->parse_matcher();
+            this->skip_whitespaces();
+            this->expect(')');
+            this->program.end();
+        }
+
+        void parse_matcher() {
+            this->skip_whitespaces();
+            const std::size_t begin     = this->position;
+            const std::string_view word = this->read_identifier();
+            instruction_kind kind;
+            if (word == "one") {
+                kind = instruction_kind::ONE;
+            } else if (word == "opt") {
+                kind = instruction_kind::OPT;
+            } else if (word == "star") {
+                kind = instruction_kind::STAR;
+            } else if (word == "cpt") {
+                this->parse_capture();
+                return;
+            } else {
+                this->position = begin;
+                this->unexpected("one, opt, star or cpt");
+            }
+            quantifier quantifier_value = quantifier::DEFAULT;
+            this->skip_whitespaces();
+            if (kind != instruction_kind::ONE && this->peek() == '<') {
+                this->get();
+                quantifier_value = this->read_quantifier();
+                this->skip_whitespaces();
+                this->expect('>');
+                this->skip_whitespaces();
+            }
+            this->expect('(');
+            this->skip_whitespaces();
+            if (this->peek() == ')') {
+                this->program.begin(kind, quantifier_value);
+            } else {
+                T value = this->codec.read(*this);
+                this->program.begin(kind, quantifier_value, &value);
+                this->skip_whitespaces();
+            }
+            this->expect(')');
+            // Children
+            this->skip_whitespaces();
+            if (this->peek() == '(') {
+                this->get();
+                this->skip_whitespaces();
+                if (this->peek() != ')') {
+                    this->parse_matcher();
+                    this->skip_whitespaces();
+                    while (this->peek() == ',') {
+                        this->get();
+                        this->parse_matcher();
+                        this->skip_whitespaces();
+                    }
+                }
+                this->expect(')');
+            }
+            this->program.end();
+        }
+
+        public:
+        int peek() const {
+            return this->position < this->text.size()
+                ? static_cast<unsigned char>(this->text[this->position])
+                : EOF;
+        }
+
+        int get() {
+            int result = this->peek();
+            if (result != EOF) {
+                ++this->position;
+            }
+            return result;
+        }
+
+        void expect(char c) {
+            if (this->peek() != static_cast<unsigned char>(c)) {
+                const char expected[] = {'\'', c, '\'', '\0'};
+                this->unexpected(expected);
+            }
+            ++this->position;
+        }
+
+        void parse() {
+            this->parse_matcher();
+            this->skip_whitespaces();
+            if (this->peek() != EOF) {
+                this->unexpected("the end of the text");
+            }
+        }
+    };
+
+} // namespace detail
+
+/**
+ * @brief Compiles a pattern written in the same notation used in the code, to be searched by {@link runtime_pattern}.
+ * @details The matchers are written as in C++: <code>one(v)</code>, <code>opt(v)</code> and <code>star(v)</code>
+ * followed by their children in parentheses, where <code>v</code> is a value written as in the n(...) notation (see
+ * {@link text_codec}) and can be omitted to accept any value. Opt and star take an optional quantifier in angle
+ * brackets (<code>default</code>, <code>reluctant</code>, <code>greedy</code> or <code>possessive</code>, also written
+ * as <code>quantifier::RELUCTANT</code>). A capture is written <code>cpt(m)</code> or <code>cpt(name, m)</code> where
+ * the name is an identifier. Whitespaces are allowed between the tokens. For example:
+ *
+ * @code
+ * one('a')(star<reluctant>()(cpt(x, one('b'))), opt('c'))
+ * @endcode
+ *
+ * @param text the text of the pattern
+ * @param codec the codec used to read the values
+ * @return the pattern compiled
+ * @throw std::invalid_argument if the text is not a valid pattern (the message has the offset of the error) or two
+ * captures have the same name
+ */
+template <typename T, typename Codec = text_codec<T>>
+pattern_program<T> parse_pattern(std::string_view text, const Codec& codec = Codec()) {
+    pattern_program<T> program;
+    detail::pattern_parser<T, Codec>(text, codec, program).parse();
+    return program;
+}
+
+} // namespace md
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <cstddef>   // std::size_t
+#include <cstdint>   // std::uint8_t, std::uint32_t
+#include <stdexcept> // std::invalid_argument
+#include <string>
+#include <utility> // std::pair
+#include <vector>
+
+#include <TreeDS/matcher/utility.hpp>
+
+namespace md {
+
+/// @brief The matcher executed by an instruction of a {@link pattern_program}.
+enum class instruction_kind : std::uint8_t {
+    ONE,
+    OPT,
+    STAR,
+    CAPTURE
+};
+
+/**
+ * @brief A matcher of a {@link pattern_program}.
+ * @details The flags are the ones of {@link matcher_info_t}, computed when the program is built, together with
+ * whether a child can match the node of its parent (see matcher::child_may_steal_node()).
+ */
+struct pattern_instruction {
+    static constexpr std::uint32_t NONE = static_cast<std::uint32_t>(-1);
+
+    enum flag : std::uint8_t {
+        MATCHES_NULL         = 1u << 0,
+        SHALLOW_MATCHES_NULL = 1u << 1,
+        PREFERS_NULL         = 1u << 2,
+        POSSESSIVE           = 1u << 3,
+        MAY_STEAL            = 1u << 4
+    };
+
+    instruction_kind kind;
+    quantifier quantifier_value;
+    std::uint8_t flags;
+    // Index of the value tested in the program, NONE if any value is accepted
+    std::uint32_t value;
+    // Index of the next sibling, NONE if this is the last child
+    std::uint32_t next_sibling;
+    // One past the last instruction of the subtree, the first child (if any) is the next instruction
+    std::uint32_t end;
+    // Index of the name of a capture, NONE if it has no name (or it is not a capture)
+    std::uint32_t name;
+
+    bool has(flag f) const {
+        return (this->flags & f) != 0u;
+    }
+};
+
+/**
+ * @brief The matchers of a pattern laid out in pre-order in a flat array of instructions.
+ * @details This is the runtime counterpart of the matcher types (one, opt, star and cpt): it is built while parsing
+ * a textual pattern (see {@link parse_pattern()}) and executed by {@link runtime_pattern}. Each instruction knows
+ * where its subtree ends and where its next sibling starts, its first child is the following instruction. The values
+ * tested are stored once, apart from the instructions.
+ * @tparam T the type of the values tested
+ */
+template <typename T>
+class pattern_program {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using value_type = T;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    std::vector<pattern_instruction> instructions;
+    std::vector<T> values;
+    std::vector<std::string> names;
+    // Instructions of the captures, in pre-order
+    std::vector<std::uint32_t> captures;
+    // Instructions whose subtree is not closed yet with their last child so far, see begin() and end()
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> open;
+
+    /*   ---   METHODS   ---   */
+    protected:
+    // Computes the flags of an instruction whose children are complete
+    void compute_flags(std::uint32_t index) {
+        pattern_instruction& instruction = this->instructions[index];
+        std::uint8_t flags               = 0u;
+        if (instruction.kind == instruction_kind::CAPTURE) {
+            if (instruction.end == index + 1u || this->instructions[index + 1u].end != instruction.end) {
+                throw std::invalid_argument("A capture must contain exactly one matcher.");
+            }
+            // Behaves like what it captures
+            flags = this->instructions[index + 1u].flags & ~pattern_instruction::MAY_STEAL;
+        } else if (instruction.kind == instruction_kind::ONE) {
+            flags = pattern_instruction::POSSESSIVE;
+        } else {
+            bool matches_null   = true;
+            std::size_t needing = 0u; // Children that do not match null
+            std::uint32_t child = instruction.end > index + 1u ? index + 1u : pattern_instruction::NONE;
+            for (; child != pattern_instruction::NONE; child = this->instructions[child].next_sibling) {
+                if (!this->instructions[child].has(pattern_instruction::MATCHES_NULL)) {
+                    matches_null = false;
+                    ++needing;
+                }
+            }
+            flags = pattern_instruction::SHALLOW_MATCHES_NULL;
+            if (matches_null) {
+                flags |= pattern_instruction::MATCHES_NULL;
+                if (instruction.quantifier_value == quantifier::RELUCTANT) {
+                    flags |= pattern_instruction::PREFERS_NULL;
+                }
+            }
+            if (instruction.quantifier_value == quantifier::POSSESSIVE) {
+                flags |= pattern_instruction::POSSESSIVE;
+            }
+            if (needing <= 1u) {
+                flags |= pattern_instruction::MAY_STEAL;
+            }
+        }
+        instruction.flags = flags;
+    }
+
+    public:
+    /**
+     * @brief Appends a matcher, the following ones are its children until {@link #end()} is called.
+     * @param kind the kind of matcher, a capture must have a single child
+     * @param quantifier_value the quantifier of opt and star
+     * @param value the value tested, null to accept any value
+     * @param name the name of a capture, empty if it has no name
+     * @throw std::invalid_argument if another capture has the same name
+     */
+    void begin(
+        instruction_kind kind,
+        quantifier quantifier_value,
+        const T* value          = nullptr,
+        const std::string& name = {}) {
+        const auto index = static_cast<std::uint32_t>(this->instructions.size());
+        if (!this->open.empty()) {
+            // Link the previous sibling, if any
+            std::uint32_t& last_child = this->open.back().second;
+            if (last_child != pattern_instruction::NONE) {
+                this->instructions[last_child].next_sibling = index;
+            }
+            last_child = index;
+        } else if (!this->instructions.empty()) {
+            throw std::invalid_argument("A pattern has a single root.");
+        }
+        pattern_instruction instruction {
+            kind,
+            quantifier_value,
+            0u,
+            pattern_instruction::NONE,
+            pattern_instruction::NONE,
+            index + 1u,
+            pattern_instruction::NONE};
+        if (value != nullptr) {
+            instruction.value = static_cast<std::uint32_t>(this->values.size());
+            this->values.push_back(*value);
+        }
+        if (kind == instruction_kind::CAPTURE) {
+            if (!name.empty()) {
+                if (this->find_capture(name) != 0u) {
+                    throw std::invalid_argument("Named captures must have unique names.");
+                }
+                instruction.name = static_cast<std::uint32_t>(this->names.size());
+                this->names.push_back(name);
+            }
+            this->captures.push_back(index);
+        }
+        this->instructions.push_back(instruction);
+        this->open.emplace_back(index, pattern_instruction::NONE);
+    }
+
+    /// @brief Closes the last matcher not closed yet.
+    void end() {
+        if (this->open.empty()) {
+            throw std::logic_error("There is no matcher to close.");
+        }
+        const std::uint32_t index     = this->open.back().first;
+        this->instructions[index].end = static_cast<std::uint32_t>(this->instructions.size());
+        this->open.pop_back();
+        this->compute_flags(index);
+    }
+
+    /// @brief Whether every matcher was closed.
+    bool complete() const {
+        return this->open.empty() && !this->instructions.empty();
+    }
+
+    const std::vector<pattern_instruction>& get_instructions() const {
+        return this->instructions;
+    }
+
+    const pattern_instruction& operator[](std::size_t index) const {
+        return this->instructions[index];
+    }
+
+    const T& get_value(std::uint32_t index) const {
+        return this->values[index];
+    }
+
+    /// @brief Number of matchers (captures included).
+    std::size_t size() const {
+        return this->instructions.size();
+    }
+
+    /// @brief Number of captures.
+    std::size_t mark_count() const {
+        return this->captures.size();
+    }
+
+    /// @brief The instruction of the capture having the given index (starting from 1).
+    std::uint32_t get_capture(std::size_t index) const {
+        if (index == 0u || index > this->captures.size()) {
+            throw std::invalid_argument("There is no capture with the index requested.");
+        }
+        return this->captures[index - 1u];
+    }
+
+    /// @brief The index (starting from 1) of the capture having the given name, 0 if there is none.
+    std::size_t find_capture(const std::string& name) const {
+        for (std::size_t i = 0u; i < this->captures.size(); ++i) {
+            const pattern_instruction& capture = this->instructions[this->captures[i]];
+            if (capture.name != pattern_instruction::NONE && this->names[capture.name] == name) {
+                return i + 1u;
+            }
+        }
+        return 0u;
+    }
+};
+
+} // namespace md
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>  // std::fill(), std::sort()
+#include <cstddef>    // std::size_t
+#include <functional> // std::function, std::hash
+#include <map>
+#include <type_traits> // std::conditional_t, std::is_same_v, std::void_t
+#include <unordered_map>
+#include <utility> // std::declval(), std::pair
+#include <vector>
+
+#include <TreeDS/matcher/automaton.hpp>
+#include <TreeDS/matcher/pattern.hpp>
+#include <TreeDS/matcher/value/product_match.hpp>
+#include <TreeDS/matcher/value/true_matcher.hpp>
+#include <TreeDS/tree_base.hpp>
+
+namespace md {
+
+namespace detail {
+    template <typename T, typename = void>
+    constexpr bool is_hashable = false;
+
+    template <typename T>
+    constexpr bool is_hashable<T, std::void_t<decltype(std::hash<T>()(std::declval<const T&>()))>> = true;
+} // namespace detail
+
+/**
+ * @brief Many patterns searched together, visiting the tree once.
+ * @details The patterns are compiled into a single {@link pattern_automaton}-like automaton whose states are shared
+ * among the patterns: matchers having the same kind, the same value matcher and the same children (recursively) get a
+ * single state, which is computed once for each node regardless of how many patterns contain it. Value tests are
+ * shared as well: matchers comparing the node with the same value (the ones constructed from a value of type T, like
+ * <code>one('a')</code> for trees of char) need a single lookup per node, whatever the number of distinct values.
+ * Other value matchers (like {@link product_match}) are tested once per matcher.
+ *
+ * Like {@link pattern#search()}, a pattern matches a tree if it can be matched starting from its root. Because the
+ * states are computed for each node, the set can also report all the nodes whose subtree would be matched by a
+ * pattern.
+ *
+ * @tparam T the type of values of the trees searched
+ */
+template <typename T>
+class pattern_set : public automaton_base {
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    // Test accepting any value
+    std::size_t true_test = this->add_test();
+    // Tests comparing the value for equality, from value to test
+    std::conditional_t<
+        detail::is_hashable<T>,
+        std::unordered_map<T, std::size_t>,
+        std::vector<std::pair<T, std::size_t>>>
+        constants;
+    std::vector<std::pair<std::function<bool(const T&)>, std::size_t>> predicates;
+    // Key: kind, possessive, test and children of a state
+    std::map<std::vector<std::size_t>, std::size_t> known_states;
+    // State of the root matcher of each pattern
+    std::vector<std::size_t> pattern_states;
+    // Patterns having each state as root
+    std::vector<std::vector<std::size_t>> state_patterns;
+    // Patterns that can match nothing and thus match every tree
+    std::vector<std::size_t> null_patterns;
+    std::vector<char> results;
+
+    /*   ---   METHODS   ---   */
+    protected:
+    template <typename ValueMatcher>
+    std::size_t find_test(const ValueMatcher& value_matcher) {
+        if constexpr (std::is_same_v<ValueMatcher, true_matcher>) {
+            return this->true_test;
+        } else if constexpr (std::is_same_v<ValueMatcher, T>) {
+            if constexpr (detail::is_hashable<T>) {
+                auto it = this->constants.find(value_matcher);
+                if (it != this->constants.end()) {
+                    return it->second;
+                }
+                return this->constants.emplace(value_matcher, this->add_test()).first->second;
+            } else {
+                for (const auto& [value, test] : this->constants) {
+                    if (value == value_matcher) {
+                        return test;
+                    }
+                }
+                this->constants.emplace_back(value_matcher, this->add_test());
+                return this->constants.back().second;
+            }
+        } else if constexpr (is_same_template<ValueMatcher, product_match<std::nullptr_t, std::nullptr_t>>) {
+            this->predicates.emplace_back(
+                [product = value_matcher](const T& value) mutable {
+                    return product.match_value(value);
+                },
+                this->add_test());
+            return this->predicates.back().second;
+        } else {
+            this->predicates.emplace_back(
+                [value_matcher](const T& value) {
+                    return value_matcher == value;
+                },
+                this->add_test());
+            return this->predicates.back().second;
+        }
+    }
+
+    void evaluate(const T& value) {
+        this->passed_tests.push_back(this->true_test);
+        if constexpr (detail::is_hashable<T>) {
+            auto it = this->constants.find(value);
+            if (it != this->constants.end()) {
+                this->passed_tests.push_back(it->second);
+            }
+        } else {
+            for (const auto& [constant, test] : this->constants) {
+                if (constant == value) {
+                    this->passed_tests.push_back(test);
+                }
+            }
+        }
+        for (auto& [predicate, test] : this->predicates) {
+            if (predicate(value)) {
+                this->passed_tests.push_back(test);
+            }
+        }
+        for (std::size_t test : this->passed_tests) {
+            this->test_results[test] = 1;
+        }
+    }
+
+    // Resets the tests passed by the node just completed
+    void clear_tests() {
+        for (std::size_t test : this->passed_tests) {
+            this->test_results[test] = 0;
+        }
+    }
+
+    public:
+    /**
+     * @brief Adds a pattern to the set.
+     * @return the index of the pattern, used to retrieve the results
+     */
+    template <typename PatternTree>
+    std::size_t insert(const PatternTree& tree) {
+        auto make_state = [this](const auto& matcher, detail::automaton_kind kind, const auto& children) {
+            using matcher_t = std::decay_t<decltype(matcher)>;
+            std::vector<std::size_t> key {
+                static_cast<std::size_t>(kind),
+                matcher_t::info.possessive,
+                this->find_test(matcher.get_value())};
+            key.insert(key.end(), children.begin(), children.end());
+            auto it = this->known_states.find(key);
+            if (it != this->known_states.end()) {
+                return it->second;
+            }
+            std::size_t state = this->template add_state<matcher_t>(kind, key[2], children);
+            this->state_patterns.emplace_back();
+            this->known_states.emplace(std::move(key), state);
+            return state;
+        };
+        const std::size_t index = this->pattern_states.size();
+        const std::size_t state = this->compile(tree, make_state);
+        this->pattern_states.push_back(state);
+        this->results.push_back(0);
+        if (state == NO_STATE) {
+            this->null_patterns.push_back(index);
+            return index;
+        }
+        this->state_patterns[state].push_back(index);
+        return index;
+    }
+
+    template <typename PatternTree>
+    std::size_t insert(const pattern<PatternTree>& pattern) {
+        return this->insert(pattern.get_pattern());
+    }
+
+    /// @brief Number of patterns in the set.
+    std::size_t size() const {
+        return this->pattern_states.size();
+    }
+
+    /**
+     * @brief Determines which patterns match the tree, visiting each node once.
+     * @return the number of patterns that match, see {@link #matched()} for the single patterns
+     */
+    template <typename Node, typename Policy, typename Allocator>
+    std::size_t search(const tree_base<Node, Policy, Allocator>& tree) {
+        std::fill(this->results.begin(), this->results.end(), 0);
+        for (std::size_t index : this->null_patterns) {
+            this->results[index] = 1;
+        }
+        std::size_t count = this->null_patterns.size();
+        const Node* root  = tree.raw_root_node();
+        if (root == nullptr || this->states.empty()) {
+            return count;
+        }
+        this->traverse(
+            root,
+            [this](const Node& node) {
+                this->evaluate(node.get_value());
+            },
+            [this](const Node&) {
+                this->clear_tests();
+            });
+        for (std::size_t index = 0u; index < this->pattern_states.size(); ++index) {
+            const std::size_t state = this->pattern_states[index];
+            if (state != NO_STATE && this->is_matched(state)) {
+                this->results[index] = 1;
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Reports every node whose subtree matches some pattern, visiting each node once.
+     * @details The nodes are reported in post-order and, for each node, the patterns in the order they were inserted.
+     * Patterns that can match nothing are reported for every node.
+     * @param callback function called as callback(pattern index, node) for each match
+     */
+    template <typename Node, typename Policy, typename Allocator, typename Callback>
+    void search(const tree_base<Node, Policy, Allocator>& tree, Callback&& callback) {
+        const Node* root = tree.raw_root_node();
+        if (root == nullptr) {
+            return;
+        }
+        std::vector<std::size_t> found;
+        this->traverse(
+            root,
+            [this](const Node& node) {
+                this->evaluate(node.get_value());
+            },
+            [&](const Node& node) {
+                this->clear_tests();
+                found.clear();
+                found.insert(found.end(), this->null_patterns.begin(), this->null_patterns.end());
+                for (std::size_t state : this->matched_states) {
+                    const std::vector<std::size_t>& patterns = this->state_patterns[state];
+                    found.insert(found.end(), patterns.begin(), patterns.end());
+                }
+                std::sort(found.begin(), found.end());
+                for (std::size_t index : found) {
+                    callback(index, node);
+                }
+            });
+    }
+
+    /// @brief Whether the pattern having the given index matched the tree of the last call to {@link #search()}.
+    bool matched(std::size_t index) const {
+        return this->results[index];
+    }
+};
+
+} // namespace md
@@ -0,0 +1,368 @@
+#pragma once
+
+#include <algorithm>   // std::reverse()
+#include <cstddef>     // std::size_t
+#include <tuple>       // std::apply()
+#include <type_traits> // std::is_same_v, std::decay_t
+#include <utility>     // std::move(), std::pair
+#include <vector>
+
+#include <TreeDS/allocator_utility.hpp>
+#include <TreeDS/matcher/pattern.hpp>
+#include <TreeDS/node/binary_node.hpp>
+#include <TreeDS/node/nary_node.hpp>
+#include <TreeDS/node/struct_node.hpp>
+#include <TreeDS/policy/fixed.hpp>
+#include <TreeDS/tree.hpp>
+#include <TreeDS/utility.hpp>
+
+namespace md {
+
+namespace detail {
+
+    // Whether a value of the replacement refers to a capture of the pattern
+    template <typename T>
+    constexpr bool is_mark_reference = false;
+
+    template <std::size_t Index>
+    constexpr bool is_mark_reference<const_index<Index>> = true;
+
+    template <char... Name>
+    constexpr bool is_mark_reference<const_name<Name...>> = true;
+
+} // namespace detail
+
+/**
+ * @brief A rule of a {@link rewriter}: the subtree matched by a pattern is replaced by the nodes of a template.
+ * @details The replacement is written in the n(...) notation. A leaf whose value is a mark, n(const_index<1>()) or
+ * n(const_name<'x'>()), stands for the subtree captured by that mark, which is moved there from the tree instead of
+ * being copied. A capture that matched nothing leaves no node. Use {@link rewrite()} to create a rule.
+ * @tparam PatternTree the type of the pattern searched
+ * @tparam Replacement the type of the struct_node used as template
+ */
+template <typename PatternTree, typename Replacement>
+class rewrite_rule {
+
+    /*   ---   FRIENDS   ---   */
+    template <typename...>
+    friend class rewriter;
+
+    /*   ---   VALIDATION   ---   */
+    static_assert(!is_empty_node<Replacement>, "The replacement must have a root: n() is not allowed.");
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    pattern<PatternTree> searched;
+    Replacement replacement;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    rewrite_rule(PatternTree&& pattern_tree, const Replacement& replacement) :
+            searched(std::move(pattern_tree)),
+            replacement(replacement) {
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    const pattern<PatternTree>& get_pattern() const {
+        return this->searched;
+    }
+
+    const Replacement& get_replacement() const {
+        return this->replacement;
+    }
+};
+
+/**
+ * @brief Creates a {@link rewrite_rule} that replaces the subtree matched by a pattern.
+ * @code
+ * // x + 0 => x
+ * rewrite(one('+')(cpt(one()), one('0')), n(const_index<1>()))
+ * @endcode
+ */
+template <typename PatternTree, typename Replacement>
+rewrite_rule<PatternTree, Replacement> rewrite(PatternTree&& pattern_tree, const Replacement& replacement) {
+    return {std::move(pattern_tree), replacement};
+}
+
+/**
+ * @brief Applies a set of {@link rewrite_rule} to a tree, in place, until none of them matches anywhere.
+ * @details The rules are tried at each node, anchored there, after the subtrees of its children reached the fixed
+ * point, in the order given: the first one matching replaces the node. The nodes created by the replacement are then
+ * tried like the others, while the captured subtrees moved into it are not tried again because they did not change.
+ * The nodes left to try are kept in an explicit worklist, therefore the depth of the tree does not matter and no
+ * search starts again from the root. The ancestors of a rewritten node are tried afterward because they come later in
+ * post-order. Rules that keep producing new matches (e.g. x => x + 0) never reach a fixed point.
+ *
+ * @code
+ * rewriter simplify(
+ *     rewrite(one('+')(cpt(one()), one('0')), n(const_index<1>())),
+ *     rewrite(one('*')(one(), one('0')), n('0')));
+ * std::size_t rewrites = simplify.apply(tree);
+ * @endcode
+ *
+ * @tparam Rules the types of the rules
+ */
+template <typename... Rules>
+class rewriter {
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    std::tuple<Rules...> rules;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    explicit rewriter(Rules... rules) :
+            rules(std::move(rules)...) {
+    }
+
+    /*   ---   METHODS   ---   */
+    protected:
+    template <typename Node>
+    static void link_child(Node& parent, Node* child, std::size_t position) {
+        if constexpr (std::is_same_v<Node, binary_node<typename Node::value_type>>) {
+            parent.link_child(child, position == 0u);
+        } else {
+            // The siblings that follow are counted at the end, see finish_children()
+            parent.link_last_child(child, 0u);
+        }
+    }
+
+    template <typename Node>
+    static void finish_children(Node& parent) {
+        if constexpr (!std::is_same_v<Node, binary_node<typename Node::value_type>>) {
+            std::size_t following = 0u;
+            for (Node* child = parent.last_child; child != nullptr; child = child->prev_sibling) {
+                child->following_size = following++;
+            }
+        }
+    }
+
+    // Copies a subtree, unlike the copy constructor of nary_node the following siblings are not copied
+    template <typename Node, typename Allocator>
+    static Node* clone(const Node& node, Allocator& allocator) {
+        unique_ptr_alloc<Allocator> result = allocate(allocator, node.get_value());
+        for (const Node* child = node.get_first_child(); child != nullptr; child = child->get_next_sibling()) {
+            std::size_t position = 0u;
+            if constexpr (std::is_same_v<Node, binary_node<typename Node::value_type>>) {
+                position = child->is_left_child() ? 0u : 1u;
+            }
+            link_child(*result, clone(*child, allocator), position);
+        }
+        finish_children(*result);
+        return result.release();
+    }
+
+    // Calls the function with the node matched by each mark referenced in the replacement, in pre-order
+    template <typename Pattern, typename TemplateNode, typename Allocator, typename Function>
+    static void for_each_reference(
+        const Pattern& searched,
+        const TemplateNode& node,
+        Allocator& allocator,
+        Function&& function) {
+        if constexpr (detail::is_mark_reference<typename TemplateNode::value_t>) {
+            static_assert(!TemplateNode::has_first_child(), "A mark in the replacement cannot have children.");
+            function(searched.get_pattern().get_mark_matcher(node.get_value()).get_matched_node(allocator));
+        } else if constexpr (TemplateNode::is_valid_node()) {
+            std::apply(
+                [&](const auto&... child) {
+                    (..., for_each_reference(searched, child, allocator, function));
+                },
+                node.get_children());
+        }
+    }
+
+    /*
+     * Allocates the nodes of the template, the marks take the nodes prepared in the same order. The new nodes are
+     * appended to created in pre-order, the nodes moved or copied are not.
+     */
+    template <typename Node, typename TemplateNode, typename Allocator>
+    static Node* build(
+        const TemplateNode& node,
+        Allocator& allocator,
+        typename std::vector<Node*>::const_iterator& prepared,
+        std::vector<Node*>& created) {
+        if constexpr (detail::is_mark_reference<typename TemplateNode::value_t>) {
+            return *prepared++;
+        } else {
+            unique_ptr_alloc<Allocator> result = allocate(allocator, node.get_value());
+            created.push_back(result.get());
+            std::size_t position = 0u;
+            std::apply(
+                [&](const auto&... child) {
+                    (..., [&](const auto& child) {
+                        if constexpr (std::decay_t<decltype(child)>::is_valid_node()) {
+                            Node* linked = build<Node>(child, allocator, prepared, created);
+                            if (linked != nullptr) {
+                                link_child(*result, linked, position);
+                            }
+                        }
+                        ++position;
+                    }(child));
+                },
+                node.get_children());
+            finish_children(*result);
+            return result.release();
+        }
+    }
+
+    // Replaces the node with the replacement of the rule whose pattern was just found there
+    template <typename Node, typename Policy, typename Allocator, typename Rule>
+    void replace(
+        tree<Node, Policy, Allocator>& target,
+        Node* node,
+        Rule& rule,
+        std::vector<std::pair<Node*, bool>>& worklist) {
+        using node_allocator_type = typename tree<Node, Policy, Allocator>::node_allocator_type;
+        node_allocator_type& allocator = target.allocator;
+        // The nodes that replace the marks: moved from the tree if possible, copied otherwise
+        std::vector<Node*> sources;
+        for_each_reference(rule.searched, rule.replacement, allocator, [&](Node* source) {
+            sources.push_back(source);
+        });
+        std::vector<bool> moved(sources.size(), false);
+        for (std::size_t i = 0u; i < sources.size(); ++i) {
+            Node* source = sources[i];
+            if (source == nullptr || source == node) {
+                continue;
+            }
+            bool movable = true;
+            for (std::size_t j = 0u; j < i && movable; ++j) {
+                movable = sources[j] != source;
+            }
+            // A subtree inside another one that is referenced must be copied as well
+            for (Node* ancestor = source->get_parent(); ancestor != node && movable;
+                 ancestor       = ancestor->get_parent()) {
+                for (Node* other : sources) {
+                    if (other == ancestor) {
+                        movable = false;
+                        break;
+                    }
+                }
+            }
+            moved[i] = movable;
+        }
+        std::size_t added = 0u;
+        // Copies are made first because moving changes the subtrees they are made from
+        std::vector<Node*> prepared(sources.size(), nullptr);
+        for (std::size_t i = 0u; i < sources.size(); ++i) {
+            if (sources[i] != nullptr && !moved[i]) {
+                prepared[i] = clone(*sources[i], allocator);
+                added += calculate_size(*prepared[i]);
+            }
+        }
+        const bool is_root = node == target.root_node;
+        if (!is_root && target.changes != nullptr) {
+            target.changes->removing(*node);
+        }
+        for (std::size_t i = 0u; i < sources.size(); ++i) {
+            if (moved[i]) {
+                sources[i]->replace_with(nullptr);
+                prepared[i] = sources[i];
+            }
+        }
+        std::vector<Node*> created;
+        auto next    = static_cast<const std::vector<Node*>&>(prepared).begin();
+        Node* result = build<Node>(rule.replacement, allocator, next, created);
+        added += created.size();
+        // What is left of the subtree is deallocated
+        const std::size_t removed = calculate_size(*node);
+        if (is_root) {
+            target.assign(result, target.size_value + added - removed, 0u);
+        } else {
+            node->replace_with(result);
+            deallocate(allocator, node);
+            target.size_value  = target.size_value + added - removed;
+            target.arity_value = 0u; // Computed again when needed
+            if (target.changes != nullptr) {
+                target.changes->inserted(*result);
+            }
+        }
+        // New nodes in pre-order: each one is tried after its descendants, the root of the replacement last
+        for (Node* created_node : created) {
+            worklist.emplace_back(created_node, true);
+        }
+    }
+
+    /*
+     * The failures remembered by the patterns stay valid until the tree is modified, after that the addresses of the
+     * nodes deallocated can be taken by new nodes.
+     */
+    template <typename Tree>
+    void start_searches(const Tree& target) {
+        std::apply(
+            [&](auto&... rule) {
+                (..., rule.searched.start_search(target));
+            },
+            this->rules);
+    }
+
+    // Tries the rules at the node, returns true if one of them replaced it
+    template <typename Node, typename Policy, typename Allocator>
+    bool rewrite_at(
+        tree<Node, Policy, Allocator>& target,
+        Node* node,
+        std::vector<std::pair<Node*, bool>>& worklist) {
+        const bool replaced = std::apply(
+            [&](auto&... rule) {
+                return (... || [&](auto& rule) {
+                    if (!rule.searched.search_at(target, target.begin(policy::fixed()).other_node(node))) {
+                        return false;
+                    }
+                    this->replace(target, node, rule, worklist);
+                    return true;
+                }(rule));
+            },
+            this->rules);
+        if (replaced) {
+            this->start_searches(target);
+        }
+        return replaced;
+    }
+
+    public:
+    /**
+     * @brief Rewrites the tree until no rule matches at any node.
+     * @details The iterators of the tree are invalidated. A change log attached to the tree receives the subtrees
+     * replaced.
+     * @param target the tree to rewrite
+     * @return the number of replacements made
+     */
+    template <typename Node, typename Policy, typename Allocator>
+    std::size_t apply(tree<Node, Policy, Allocator>& target) {
+        if (target.empty()) {
+            return 0u;
+        }
+        // From now on the size is kept exact, it is needed for each search
+        target.size();
+        this->start_searches(target);
+        std::size_t rewrites = 0u;
+        // Nodes to try, paired with whether their children were already added
+        std::vector<std::pair<Node*, bool>> worklist {{target.root_node, false}};
+        while (!worklist.empty()) {
+            auto [node, expanded] = worklist.back();
+            if (!expanded) {
+                worklist.back().second = true;
+                // The last child is pushed first so that the children are tried from the first one
+                const std::size_t first = worklist.size();
+                for (Node* child = node->get_first_child(); child != nullptr; child = child->get_next_sibling()) {
+                    worklist.emplace_back(child, false);
+                }
+                std::reverse(worklist.begin() + first, worklist.end());
+                continue;
+            }
+            worklist.pop_back();
+            if (this->rewrite_at(target, node, worklist)) {
+                ++rewrites;
+            }
+        }
+        return rewrites;
+    }
+
+    /// @brief Number of rules.
+    static constexpr std::size_t size() {
+        return sizeof...(Rules);
+    }
+};
+
+} // namespace md
@@ -0,0 +1,518 @@
+#pragma once
+
+#include <algorithm> // std::fill()
+#include <cstddef>   // std::size_t
+#include <cstdint>   // std::uint32_t
+#include <stdexcept> // std::invalid_argument
+#include <string>
+#include <string_view>
+#include <utility> // std::move()
+#include <vector>
+
+#include <TreeDS/matcher/failure_cache.hpp>
+#include <TreeDS/matcher/match_view.hpp>
+#include <TreeDS/matcher/pattern_parser.hpp>
+#include <TreeDS/matcher/pattern_program.hpp>
+#include <TreeDS/policy/fixed.hpp>
+#include <TreeDS/policy/pre_order.hpp>
+#include <TreeDS/tree_base.hpp>
+
+namespace md {
+
+namespace detail {
+
+    enum class cursor_kind {
+        // Children of a node
+        SIBLINGS,
+        // A single node
+        FIXED,
+        // Descendants of the node of a star (not possessive) in pre-order
+        PRE_ORDER,
+        // First descendants of the node of a possessive star not accepted by its value, in pre-order
+        LEAVES
+    };
+
+    /**
+     * @brief Position of the nodes tried by a matcher of a {@link runtime_pattern}.
+     * @details It replaces the tree iterators used by the matchers of {@link pattern}, visiting the same nodes in the
+     * same order.
+     */
+    template <typename Node>
+    struct pattern_cursor {
+        cursor_kind kind;
+        const Node* current;
+        // The node of the star whose descendants are visited
+        const Node* root;
+        // Instruction of the star
+        std::uint32_t star;
+        // A possessive cursor moved with other_node() does not continue after the node
+        bool detached;
+
+        explicit operator bool() const {
+            return this->current != nullptr;
+        }
+    };
+
+} // namespace detail
+
+/**
+ * @brief A pattern defined at runtime, searched by interpreting a {@link pattern_program}.
+ * @details The program is usually parsed from a text written in the same notation as the code (see {@link
+ * parse_pattern()}). The interpreter executes the instructions with the same algorithm of the matchers of
+ * {@link pattern}, therefore the nodes matched by each matcher and by each capture are the same as those of the
+ * corresponding compile-time pattern. The work of the tree iterators is done on the node pointers directly and the
+ * state of the matchers is kept in flat arrays indexed by instruction.
+ *
+ * Unlike {@link pattern}, the results are not copied into trees: the nodes matched are read through {@link
+ * #get_matched_nodes()} and {@link #get_mark()} or shown by {@link #result_view()} and {@link #mark_view()}.
+ *
+ * @tparam T the type of the values of the trees searched
+ */
+template <typename T>
+class runtime_pattern {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using value_type   = T;
+    using program_type = pattern_program<T>;
+
+    protected:
+    using instruction_type = pattern_instruction;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    program_type program;
+    // Node matched by each instruction
+    std::vector<const void*> matched;
+    // For each star, the node whose subtree is excluded from the nodes visited by its children
+    std::vector<const void*> subtree_cut;
+    std::vector<detail::failure_cache> failures;
+    const void* matched_tree = nullptr;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    explicit runtime_pattern(program_type program) :
+            program(std::move(program)),
+            matched(this->program.size(), nullptr),
+            subtree_cut(this->program.size(), nullptr),
+            failures(this->program.size()) {
+        if (!this->program.complete()) {
+            throw std::invalid_argument("The program of the pattern is incomplete.");
+        }
+    }
+
+    /// @brief Parses the pattern from its text, see {@link parse_pattern()}.
+    explicit runtime_pattern(std::string_view text) :
+            runtime_pattern(parse_pattern<T>(text)) {
+    }
+
+    /*   ---   METHODS   ---   */
+    protected:
+    const instruction_type& at(std::uint32_t index) const {
+        return this->program[index];
+    }
+
+    template <typename Node>
+    bool match_value(std::uint32_t index, const Node* node) const {
+        const instruction_type& instruction = this->at(index);
+        return instruction.value == instruction_type::NONE
+            || this->program.get_value(instruction.value) == node->get_value();
+    }
+
+    // Forgets the nodes matched by the instruction, by its subtree and by its following siblings
+    void reset(std::uint32_t index, std::uint32_t parent_end) {
+        std::fill(this->matched.begin() + index, this->matched.begin() + parent_end, nullptr);
+    }
+
+    /*   ---   CURSORS   ---   */
+    template <typename Node>
+    static detail::pattern_cursor<Node> fixed(const Node* node) {
+        return {detail::cursor_kind::FIXED, node, nullptr, instruction_type::NONE, false};
+    }
+
+    template <typename Node>
+    static detail::pattern_cursor<Node> siblings(const Node* first) {
+        return {detail::cursor_kind::SIBLINGS, first, nullptr, instruction_type::NONE, false};
+    }
+
+    // Whether the cursor of a star can visit the children of the node
+    template <typename Node>
+    bool enters(const detail::pattern_cursor<Node>& cursor, const Node* node) const {
+        if (cursor.kind == detail::cursor_kind::PRE_ORDER && node == this->subtree_cut[cursor.star]) {
+            return false;
+        }
+        return this->match_value(cursor.star, node);
+    }
+
+    template <typename Node>
+    const Node* descend_leftmost(const detail::pattern_cursor<Node>& cursor, const Node* node) const {
+        while (this->enters(cursor, node) && node->get_first_child() != nullptr) {
+            node = node->get_first_child();
+        }
+        return node;
+    }
+
+    template <typename Node>
+    const Node* next_pre_order(const detail::pattern_cursor<Node>& cursor) const {
+        const Node* node = cursor.current;
+        if (node->get_first_child() != nullptr && this->enters(cursor, node)) {
+            return node->get_first_child();
+        }
+        // Cross to another branch (on the right)
+        while (node != cursor.root) {
+            const Node* parent = node->get_parent();
+            if (node != parent->get_last_child()) {
+                return this->enters(cursor, parent) ? node->get_next_sibling() : nullptr;
+            }
+            node = parent;
+        }
+        return nullptr;
+    }
+
+    template <typename Node>
+    const Node* next_leaf(const detail::pattern_cursor<Node>& cursor) const {
+        if (cursor.detached) {
+            return nullptr;
+        }
+        // Climb to the closest node having a next sibling, then take its leftmost leaf
+        const Node* node = cursor.current;
+        while (node != cursor.root) {
+            const Node* parent = node->get_parent();
+            if (node->get_next_sibling() != nullptr && this->enters(cursor, parent)) {
+                return this->descend_leftmost(cursor, node->get_next_sibling());
+            }
+            node = parent;
+        }
+        return nullptr;
+    }
+
+    // The leaves of a possessive star skip the nodes accepted by its value
+    template <typename Node>
+    void skip_accepted(detail::pattern_cursor<Node>& cursor) const {
+        while (cursor.current != nullptr && this->match_value(cursor.star, cursor.current)) {
+            cursor.current = this->next_leaf(cursor);
+        }
+    }
+
+    template <typename Node>
+    void increment(detail::pattern_cursor<Node>& cursor) const {
+        switch (cursor.kind) {
+        case detail::cursor_kind::SIBLINGS:
+            cursor.current = cursor.current->get_next_sibling();
+            break;
+        case detail::cursor_kind::FIXED:
+            cursor.current = nullptr;
+            break;
+        case detail::cursor_kind::PRE_ORDER:
+            cursor.current = this->next_pre_order(cursor);
+            break;
+        case detail::cursor_kind::LEAVES:
+            cursor.current = this->next_leaf(cursor);
+            this->skip_accepted(cursor);
+            break;
+        }
+    }
+
+    // Moves the cursor to the node, keeping the nodes it visits
+    template <typename Node>
+    void other_node(detail::pattern_cursor<Node>& cursor, const Node* node) const {
+        cursor.current = node;
+        if (cursor.kind == detail::cursor_kind::LEAVES) {
+            cursor.detached = true;
+            this->skip_accepted(cursor);
+        }
+    }
+
+    template <typename Node>
+    detail::pattern_cursor<Node> star_cursor(std::uint32_t star, const Node* node) const {
+        if (this->at(star).has(instruction_type::POSSESSIVE)) {
+            detail::pattern_cursor<Node> cursor {detail::cursor_kind::LEAVES, nullptr, node, star, false};
+            cursor.current = this->descend_leftmost(cursor, node);
+            this->skip_accepted(cursor);
+            return cursor;
+        }
+        detail::pattern_cursor<Node> cursor {detail::cursor_kind::PRE_ORDER, node, node, star, false};
+        this->increment(cursor);
+        return cursor;
+    }
+
+    /*
+     * Moves the cursor of a star below the node matched by one of its children: following the first children until
+     * one has siblings, that child is the new position. See policy::pre_order::go_depth_first_ramification().
+     */
+    template <typename Node>
+    bool rematch(std::uint32_t index, detail::pattern_cursor<Node>& cursor) {
+        this->subtree_cut[cursor.star] = nullptr;
+        if (this->matched[index] == nullptr) {
+            return false;
+        }
+        const Node* node  = static_cast<const Node*>(this->matched[index]);
+        const Node* child = this->enters(cursor, node) ? node->get_first_child() : nullptr;
+        bool found        = child != nullptr;
+        while (child != nullptr && child == child->get_parent()->get_last_child()) {
+            node  = child;
+            child = this->enters(cursor, node) ? node->get_first_child() : nullptr;
+        }
+        cursor.kind    = detail::cursor_kind::PRE_ORDER;
+        cursor.current = !found ? nullptr : child != nullptr ? child : node;
+        return true;
+    }
+
+    /*   ---   INTERPRETER   ---   */
+    // Whether the instruction matches the node, see the search_node_impl() of the matchers
+    template <typename Node>
+    bool match_node(std::uint32_t index, const Node* node) {
+        const instruction_type& instruction = this->at(index);
+        const bool value                    = this->match_value(index, node);
+        if (instruction.kind == instruction_kind::ONE) {
+            return value && this->search_children(index, siblings(node->get_first_child()));
+        }
+        const bool steals = instruction.has(instruction_type::MAY_STEAL);
+        if (!value) {
+            // A single child can still match the node
+            return steals && this->search_children(index, fixed(node));
+        }
+        bool result;
+        if (instruction.kind == instruction_kind::OPT) {
+            result = this->search_children(index, siblings(node->get_first_child()));
+        } else {
+            this->subtree_cut[index] = nullptr;
+            result                   = this->search_children(
+                index,
+                this->star_cursor(index, node),
+                index,
+                !instruction.has(instruction_type::POSSESSIVE));
+        }
+        if (!result && steals && !instruction.has(instruction_type::POSSESSIVE)) {
+            // Every other match failed, the last possibility: one of the children matches this node
+            return this->search_children(index, fixed(node));
+        }
+        return result;
+    }
+
+    template <typename Node>
+    bool search_children(
+        std::uint32_t index,
+        detail::pattern_cursor<Node> cursor,
+        std::uint32_t star = instruction_type::NONE,
+        bool can_rematch   = false) {
+        if (this->at(index).end == index + 1u) {
+            return true;
+        }
+        return this->search_node(index + 1u, cursor, index, star, can_rematch);
+    }
+
+    // Searches the node of this instruction, see matcher::search_node_this()
+    template <typename Node>
+    bool search_this(std::uint32_t index, detail::pattern_cursor<Node>& cursor, std::uint32_t star) {
+        const instruction_type& instruction = this->at(index);
+        if (instruction.kind == instruction_kind::CAPTURE) {
+            if (this->search_node(index + 1u, cursor, index, star, false)) {
+                this->matched[index] = this->matched[index + 1u];
+                return true;
+            }
+            return false;
+        }
+        if (instruction.has(instruction_type::PREFERS_NULL)) {
+            return true;
+        }
+        const detail::pattern_cursor<Node> begin = cursor;
+        while (cursor) {
+            const Node* candidate = cursor.current;
+            if (!this->failures[index].contains(candidate)) {
+                if (this->match_node(index, candidate)) {
+                    this->matched[index] = candidate;
+                    if (star != instruction_type::NONE) {
+                        this->subtree_cut[star] = candidate;
+                    }
+                    this->increment(cursor);
+                    return true;
+                }
+                this->failures[index].insert(candidate);
+            }
+            this->increment(cursor);
+        }
+        if (instruction.has(instruction_type::MATCHES_NULL)) {
+            cursor = begin;
+            return true;
+        }
+        return false;
+    }
+
+    // Searches this instruction and the following siblings, see matcher::search_node() and search_node_sibling()
+    template <typename Node>
+    bool search_node(
+        std::uint32_t index,
+        detail::pattern_cursor<Node>& cursor,
+        std::uint32_t parent,
+        std::uint32_t star,
+        bool can_rematch) {
+        if (!this->search_this(index, cursor, star)) {
+            return false;
+        }
+        const std::uint32_t next = this->at(index).next_sibling;
+        if (next == instruction_type::NONE) {
+            return true;
+        }
+        detail::pattern_cursor<Node> begin = cursor;
+        if (this->search_node(next, cursor, parent, star, can_rematch)) {
+            return true;
+        }
+        if (can_rematch) {
+            cursor = begin;
+            // The first rematch starts from the node matched, even if the sibling had no node left to try
+            for (bool first = true; (first || cursor) && this->rematch(index, cursor); first = false) {
+                begin = cursor;
+                if (!this->search_this(index, cursor, star)) {
+                    continue;
+                }
+                if (this->search_node(next, cursor, parent, star, can_rematch)) {
+                    return true;
+                }
+                cursor = begin;
+            }
+        }
+        if (this->at(index).has(instruction_type::MATCHES_NULL) && this->matched[index] != nullptr) {
+            // This matcher renounces to its node
+            this->other_node(cursor, static_cast<const Node*>(this->matched[index]));
+            this->reset(index, this->at(parent).end);
+            return this->search_node(next, cursor, parent, star, can_rematch);
+        }
+        return false;
+    }
+
+    void start_search(std::size_t nodes) {
+        this->matched_tree = nullptr;
+        for (detail::failure_cache& cache : this->failures) {
+            cache.clear(nodes);
+        }
+    }
+
+    // Searches the pattern with the root matcher fixed on the node
+    template <typename Node>
+    bool search_at(const Node* node) {
+        std::fill(this->matched.begin(), this->matched.end(), nullptr);
+        detail::pattern_cursor<Node> cursor = fixed(node);
+        return this->search_this(0u, cursor, instruction_type::NONE);
+    }
+
+    template <typename Node, typename Policy, typename Allocator>
+    void check_tree(const tree_base<Node, Policy, Allocator>& tree) const {
+        if (this->matched_tree != &tree) {
+            throw std::invalid_argument("Tried to read the result of a search in a different tree.");
+        }
+    }
+
+    template <typename Node, typename Policy, typename Allocator>
+    static typename detail::tree_view_of<Node, Policy, Allocator>::type
+    subtree_view(const tree_base<Node, Policy, Allocator>& tree, const void* node) {
+        if (node == nullptr) {
+            return {};
+        }
+        return {tree, tree.begin(policy::fixed()).other_node(static_cast<const Node*>(node))};
+    }
+
+    public:
+    /**
+     * @brief Determines if the pattern matches the tree, its root matcher is tried on the root of the tree.
+     * @details Like {@link pattern#search()}, the search must be repeated after the tree is modified.
+     */
+    template <typename Node, typename Policy, typename Allocator>
+    bool search(const tree_base<Node, Policy, Allocator>& tree) {
+        this->start_search(tree.size());
+        if (this->search_at(tree.raw_root_node())) {
+            this->matched_tree = &tree;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Calls the function with every node of the tree where the pattern matches, in pre-order.
+     * @details During each call the results of the match can be read as after {@link #search()}. The failures found
+     * trying a node are reused for the following ones.
+     * @param tree the tree to search
+     * @param function called with a pointer to the node matched by the root of the pattern
+     */
+    template <typename Node, typename Policy, typename Allocator, typename Function>
+    void for_each_match(const tree_base<Node, Policy, Allocator>& tree, Function&& function) {
+        this->start_search(tree.size());
+        for (auto it = tree.begin(policy::pre_order()); it != tree.end(policy::pre_order()); ++it) {
+            if (this->search_at(it.get_raw_node())) {
+                this->matched_tree = &tree;
+                function(it.get_raw_node());
+                this->matched_tree = nullptr;
+            }
+        }
+    }
+
+    const program_type& get_program() const {
+        return this->program;
+    }
+
+    /// @brief Returns the number of marked nodes within the pattern
+    std::size_t mark_count() const {
+        return this->program.mark_count();
+    }
+
+    /**
+     * @brief Nodes matched by each matcher in the last successful {@link #search()}, in pre-order of the pattern.
+     * @details Matchers that did not match anything have a null node, as in matcher::matched_nodes().
+     * @throw std::invalid_argument if the last successful search was not in the given tree
+     */
+    template <typename Node, typename Policy, typename Allocator>
+    std::vector<const Node*> get_matched_nodes(const tree_base<Node, Policy, Allocator>& tree) const {
+        this->check_tree(tree);
+        std::vector<const Node*> result;
+        result.reserve(this->matched.size());
+        for (const void* node : this->matched) {
+            result.push_back(static_cast<const Node*>(node));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Node matched by a capture in the last successful {@link #search()}, null if it matched nothing.
+     * @param index the index of the capture, starting from 1
+     * @throw std::invalid_argument if there is no such capture or the last successful search was not in the tree
+     */
+    template <typename Node, typename Policy, typename Allocator>
+    const Node* get_mark(std::size_t index, const tree_base<Node, Policy, Allocator>& tree) const {
+        this->check_tree(tree);
+        return static_cast<const Node*>(this->matched[this->program.get_capture(index)]);
+    }
+
+    /// @brief Node matched by the capture having the given name, see {@link #get_mark()}.
+    template <typename Node, typename Policy, typename Allocator>
+    const Node* get_mark(const std::string& name, const tree_base<Node, Policy, Allocator>& tree) const {
+        const std::size_t index = this->program.find_capture(name);
+        if (index == 0u) {
+            throw std::invalid_argument("There is no capture with the name requested.");
+        }
+        return this->get_mark(index, tree);
+    }
+
+    /**
+     * @brief View of the subtree of the node matched by the pattern in the last successful {@link #search()}.
+     * @see pattern::result_view()
+     */
+    template <typename Node, typename Policy, typename Allocator>
+    typename detail::tree_view_of<Node, Policy, Allocator>::type
+    result_view(const tree_base<Node, Policy, Allocator>& tree) const {
+        this->check_tree(tree);
+        return subtree_view(tree, this->matched[0]);
+    }
+
+    /**
+     * @brief View of the subtree of the node matched by a capture in the last successful {@link #search()}.
+     * @param mark the index (starting from 1) or the name of the capture
+     * @see pattern::mark_view()
+     */
+    template <typename Mark, typename Node, typename Policy, typename Allocator>
+    typename detail::tree_view_of<Node, Policy, Allocator>::type
+    mark_view(const Mark& mark, const tree_base<Node, Policy, Allocator>& tree) const {
+        return subtree_view(tree, this->get_mark(mark, tree));
+    }
+};
+
+} // namespace md
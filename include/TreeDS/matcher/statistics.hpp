@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef> // std::size_t
+
+/*
+ * Define as 1 to count the work done by each matcher, see pattern::get_statistics(). When it is 0 (default), nothing is
+ * counted and the counters take no space: matchers and patterns inherit an empty storage.
+ */
+#ifndef MD_MATCHER_STATISTICS
+#define MD_MATCHER_STATISTICS 0
+#endif
+
+namespace md {
+
+/// @brief Work done by a single matcher.
+struct matcher_statistics {
+    /// @brief Nodes tried as target of the matcher.
+    std::size_t steps = 0u;
+    /// @brief Times the matcher gave up its node (or tried another one) to let the following siblings match.
+    std::size_t backtracks = 0u;
+    /// @brief Iterators rebuilt to search the children with a different node, policy or navigator.
+    std::size_t iterator_rebuilds = 0u;
+    /// @brief Nodes allocated to build the result, see pattern::assign_result().
+    std::size_t allocations = 0u;
+
+    matcher_statistics& operator+=(const matcher_statistics& other) {
+        this->steps += other.steps;
+        this->backtracks += other.backtracks;
+        this->iterator_rebuilds += other.iterator_rebuilds;
+        this->allocations += other.allocations;
+        return *this;
+    }
+};
+
+/**
+ * @brief Work done by a pattern since the beginning of its last search.
+ * @tparam Count number of matchers of the pattern
+ */
+template <std::size_t Count>
+struct search_statistics {
+    /// @brief Statistics of each matcher, in pre-order of the pattern (the root is the first).
+    std::array<matcher_statistics, Count> matchers {};
+    /// @brief Time spent searching.
+    std::chrono::steady_clock::duration elapsed {0};
+
+    /// @brief Sum of the statistics of all the matchers.
+    matcher_statistics total() const {
+        matcher_statistics result;
+        for (const matcher_statistics& statistics : this->matchers) {
+            result += statistics;
+        }
+        return result;
+    }
+};
+
+namespace detail {
+
+    /*
+     * Counters of a matcher, inherited so that the empty specialization takes no space. Owner, the matcher itself,
+     * makes the storage of each matcher a different type: nested empty bases of the same type cannot share an address
+     * and would take space again.
+     */
+    template <typename Owner, bool Enabled = MD_MATCHER_STATISTICS != 0>
+    struct matcher_statistics_storage {
+        // Mutable because the results are built by const methods
+        mutable matcher_statistics statistics;
+    };
+
+    template <typename Owner>
+    struct matcher_statistics_storage<Owner, false> {
+    };
+
+    // Time spent searching by a pattern, empty when the statistics are disabled
+    template <typename Owner, bool Enabled = MD_MATCHER_STATISTICS != 0>
+    struct search_time_storage {
+        std::chrono::steady_clock::duration elapsed {0};
+    };
+
+    template <typename Owner>
+    struct search_time_storage<Owner, false> {
+    };
+
+} // namespace detail
+
+} // namespace md
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+namespace md {
+
+/**
+ * @brief Summary of the structure of a subtree: what values it holds, how they are connected, how large it is.
+ * @details The values and the pairs (parent value, child value) are hashed into one of 64 bits each, therefore a
+ * signature is a superset of the ones of its subtrees. A pattern reduced to the signature of the nodes it requires can
+ * match in a subtree only if the signature of the subtree covers it, which is checked in constant time.
+ */
+struct structural_signature {
+
+    /*   ---   ATTRIBUTES   ---   */
+    // Bit of the value of the node itself
+    std::uint64_t value = 0u;
+    // Bits of the values in the subtree
+    std::uint64_t values = 0u;
+    // Bits of the pairs (parent value, child value) in the subtree
+    std::uint64_t edges = 0u;
+    std::size_t size    = 0u;
+    std::size_t height  = 0u;
+
+    /*   ---   METHODS   ---   */
+    /// @brief The bit representing the value having the given hash.
+    static constexpr std::uint64_t value_bit(std::size_t hash) {
+        return std::uint64_t(1u) << ((static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15u) >> 58);
+    }
+
+    /// @brief The bit representing a node whose value has the hash parent with a child whose value has the hash child.
+    static constexpr std::uint64_t edge_bit(std::size_t parent, std::size_t child) {
+        return value_bit(static_cast<std::size_t>(
+            (static_cast<std::uint64_t>(parent) * 0xC2B2AE3D27D4EB4Fu) ^ static_cast<std::uint64_t>(child)));
+    }
+
+    /// @brief Whether a subtree having this signature may contain everything the other signature requires.
+    constexpr bool covers(const structural_signature& other) const {
+        return (other.value & ~this->value) == 0u
+            && (other.values & ~this->values) == 0u
+            && (other.edges & ~this->edges) == 0u
+            && other.size <= this->size
+            && other.height <= this->height;
+    }
+};
+
+} // namespace md
@@ -13,6 +13,14 @@ class matcher;
 template <typename, typename, typename>
 class capture_node;
 
+class automaton_base;
+
+template <typename>
+class pattern_automaton;
+
+template <typename>
+class pattern_set;
+
 /*   ---   TYPES DEINITIONS   ---   */
 struct matcher_info_t {
     bool matches_null;
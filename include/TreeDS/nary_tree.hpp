@@ -41,6 +41,42 @@ class nary_tree : public tree<nary_node<T>, Policy, Allocator> {
             "Tried to construct an nary_tree from a binary_tree containing a non copyable type.");
     }
 
+    /**
+     * @brief Builds a tree from its pre-order serialization in columnar form.
+     * @details Each value is paired with the number of children of its node. All the nodes are linked in a single pass
+     * and the resulting tree knows its exact size and arity.
+     * @param values values of the nodes, in pre-order
+     * @param child_counts number of children of each node, in pre-order
+     * @throw std::invalid_argument if the child counts do not describe exactly as many nodes as the values
+     */
+    template <typename Values, typename ChildCounts>
+    static nary_tree from_preorder(
+        const Values& values,
+        const ChildCounts& child_counts,
+        const Allocator& allocator = Allocator()) {
+        nary_tree result(allocator);
+        result.assign_preorder(values, child_counts);
+        return result;
+    }
+
+    /**
+     * @brief Builds a tree from an array of values paired with the index of their parent.
+     * @details The root is the only node whose parent index is out of range (for example -1). The children of a node
+     * keep the order of their indexes.
+     * @param values values of the nodes
+     * @param parents index of the parent of each node (random access)
+     * @throw std::invalid_argument if the parent indexes do not describe a single tree
+     */
+    template <typename Values, typename ParentIndexes>
+    static nary_tree from_parent_indices(
+        const Values& values,
+        const ParentIndexes& parents,
+        const Allocator& allocator = Allocator()) {
+        nary_tree result(allocator);
+        result.assign_parent_indices(values, parents);
+        return result;
+    }
+
     // Import the overloads of the operator= into the current class (that would be shadowed otherwise)
     using tree<nary_node<T>, Policy, Allocator>::operator=;
 
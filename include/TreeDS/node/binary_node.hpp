@@ -25,6 +25,12 @@ class binary_node : public node<T, binary_node<T>> {
     template <typename, typename, typename, typename>
     friend class generative_navigator;
 
+    template <typename>
+    friend class tree_builder;
+
+    template <typename...>
+    friend class rewriter;
+
     template <typename A>
     friend void deallocate(A&, allocator_value_type<A>*);
 
@@ -262,6 +268,15 @@ class binary_node : public node<T, binary_node<T>> {
         return nullptr;
     }
 
+    /// Link node in the (free) left or right position, used by bulk construction
+    binary_node* link_child(binary_node* node, bool left) {
+        assert(node != nullptr && node->is_root());
+        binary_node*& target_position = left ? this->left : this->right;
+        assert(target_position == nullptr);
+        target_position = node;
+        return this->attach_child(target_position);
+    }
+
     binary_node* do_assign_child_like(binary_node* child, const binary_node& reference_child) {
         assert(child);
         binary_node*& target_position = reference_child.is_left_child() ? this->left : this->right;
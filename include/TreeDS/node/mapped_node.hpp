@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint64_t
+#include <type_traits> // std::is_trivially_copyable_v
+
+#include <TreeDS/utility.hpp>
+
+namespace md {
+
+class mapped_writer;
+
+template <typename, typename>
+class mapped_tree;
+
+/**
+ * @brief Read-only node stored in a contiguous array of nodes, laid out in pre-order.
+ * @details The node does not store pointers but distances from itself, expressed in number of nodes, so that an array
+ * of these nodes is valid wherever it is placed in memory (for example a file mapped by {@link mapped_tree}). The
+ * first child of a node is always the next one in the array and the next sibling is just after the subtree of the
+ * node, the other links are computed from the distances stored.
+ *
+ * @tparam T the type of value hold by the node, it must be trivially copyable
+ */
+template <typename T>
+class mapped_node {
+
+    static_assert(std::is_trivially_copyable_v<T>, "Mapped nodes can hold only trivially copyable values.");
+
+    /*   ---   FRIENDS   ---   */
+    friend class mapped_writer;
+
+    template <typename, typename>
+    friend class mapped_tree;
+
+    /*   ---   TYPES   ---   */
+    public:
+    using value_type = T;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    T value;
+    /// @brief Distance backward to the parent, 0 for the root.
+    std::uint64_t parent_distance;
+    /// @brief Distance backward to the previous sibling, 0 for the first child.
+    std::uint64_t prev_sibling_distance;
+    /// @brief Distance forward to the last child, 0 for a leaf.
+    std::uint64_t last_child_distance;
+    /// @brief Number of nodes in the subtree rooted here (this node included).
+    std::uint64_t subtree_size;
+    /// @brief Number of siblings after this node.
+    std::uint64_t following_size;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    protected:
+    mapped_node(
+        const T& value,
+        std::uint64_t parent_distance,
+        std::uint64_t prev_sibling_distance,
+        std::uint64_t last_child_distance,
+        std::uint64_t subtree_size,
+        std::uint64_t following_size) :
+            value(value),
+            parent_distance(parent_distance),
+            prev_sibling_distance(prev_sibling_distance),
+            last_child_distance(last_child_distance),
+            subtree_size(subtree_size),
+            following_size(following_size) {
+    }
+
+    public:
+    mapped_node(const mapped_node&) = delete;
+
+    /*   ---   GETTERS   ---   */
+    public:
+    const T& get_value() const {
+        return this->value;
+    }
+
+    const mapped_node* get_parent() const {
+        return this->parent_distance ? this - this->parent_distance : nullptr;
+    }
+
+    const mapped_node* get_prev_sibling() const {
+        return this->prev_sibling_distance ? this - this->prev_sibling_distance : nullptr;
+    }
+
+    const mapped_node* get_next_sibling() const {
+        return this->following_size ? this + this->subtree_size : nullptr;
+    }
+
+    const mapped_node* get_first_child() const {
+        return this->last_child_distance ? this + 1 : nullptr;
+    }
+
+    const mapped_node* get_last_child() const {
+        return this->last_child_distance ? this + this->last_child_distance : nullptr;
+    }
+
+    const mapped_node* get_child(std::size_t index) const {
+        const mapped_node* current = this->get_first_child();
+        for (std::size_t i = 0; current && i < index; ++i) {
+            current = current->get_next_sibling();
+        }
+        return current;
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    bool is_root() const {
+        return this->parent_distance == 0u;
+    }
+
+    bool is_first_child() const {
+        return this->parent_distance == 1u;
+    }
+
+    bool is_last_child() const {
+        return this->parent_distance != 0u && this->following_size == 0u;
+    }
+
+    bool is_unique_child() const {
+        return this->is_first_child() && this->is_last_child();
+    }
+
+    bool has_children() const {
+        return this->last_child_distance != 0u;
+    }
+
+    std::size_t children() const {
+        return this->has_children()
+            ? this->get_first_child()->following_size + 1u
+            : 0u;
+    }
+
+    std::size_t following_siblings() const {
+        return this->following_size;
+    }
+
+    std::size_t get_subtree_size() const {
+        return this->subtree_size;
+    }
+};
+
+template <typename T>
+std::size_t calculate_size(const mapped_node<T>& node) {
+    return node.get_subtree_size();
+}
+
+} // namespace md
@@ -22,6 +22,12 @@ class nary_node : public node<T, nary_node<T>> {
     template <typename, typename, typename, typename>
     friend class generative_navigator;
 
+    template <typename>
+    friend class tree_builder;
+
+    template <typename...>
+    friend class rewriter;
+
     /*   ---   ATTRIBUTES   ---   */
     protected:
     std::size_t following_size = 0u;
@@ -290,6 +296,7 @@ class nary_node : public node<T, nary_node<T>> {
                 link_target = node;
             } else {
                 nary_node* child = this->parent->first_child;
+                back_link        = &this->parent->first_child;
                 // get_prev_sibling
                 while (child && child != this) {
                     --child->following_size;
@@ -301,7 +308,7 @@ class nary_node : public node<T, nary_node<T>> {
             *back_link = link_target;
             // Set parent's last_child
             if (this->is_last_child()) {
-                this->parent->last_child = link_target;
+                this->parent->last_child = node ? node : this->prev_sibling;
             } else {
                 this->next_sibling->prev_sibling = node ? node : this->prev_sibling;
             }
@@ -353,6 +360,55 @@ class nary_node : public node<T, nary_node<T>> {
         return node;
     }
 
+    // Link node as the child number index (at most the number of children), the following children are shifted
+    nary_node* insert_child(nary_node* node, std::size_t index) {
+        assert(node != nullptr);
+        assert(node->parent == nullptr);
+        assert(node->next_sibling == nullptr);
+        assert(index <= this->children());
+        if (index == 0u) {
+            return this->prepend_child(node);
+        }
+        // The children before the new one have one more following sibling
+        nary_node* previous = this->first_child;
+        ++previous->following_size;
+        for (std::size_t i = 1u; i < index; ++i) {
+            previous = previous->next_sibling;
+            ++previous->following_size;
+        }
+        node->parent         = this;
+        node->following_size = previous->following_size - 1u;
+        node->prev_sibling   = previous;
+        node->next_sibling   = previous->next_sibling;
+        if (node->next_sibling) {
+            node->next_sibling->prev_sibling = node;
+        } else {
+            this->last_child = node;
+        }
+        previous->next_sibling = node;
+        return node;
+    }
+
+    /**
+     * Link node as the last child when the caller already knows how many siblings will follow it. Unlike
+     * append_child() the previous siblings are not visited again, this is what makes bulk construction linear.
+     */
+    nary_node* link_last_child(nary_node* node, std::size_t following) {
+        assert(node != nullptr);
+        assert(node->parent == nullptr);
+        assert(node->next_sibling == nullptr);
+        node->parent         = this;
+        node->following_size = following;
+        node->prev_sibling   = this->last_child;
+        if (this->last_child) {
+            this->last_child->next_sibling = node;
+        } else {
+            this->first_child = node;
+        }
+        this->last_child = node;
+        return node;
+    }
+
     template <typename Node>
     static Node* calculate_child(Node* ptr, std::size_t index) {
         Node* current = ptr->first_child;
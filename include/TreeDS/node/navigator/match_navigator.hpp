@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <cstddef> // std::size_t
+
+#include <TreeDS/node/navigator/navigator_base.hpp>
+#include <TreeDS/utility.hpp>
+
+namespace md {
+
+/**
+ * @brief Navigator that shows only the nodes on the paths from the root to a fixed set of nodes.
+ * @details It is used to look at the part of a tree matched by a pattern without copying it: the set contains the node
+ * matched by each matcher and the navigator shows them together with the nodes connecting them. Null elements of the
+ * set are ignored. Deciding whether a node is shown takes a walk from each node of the set up to the root, nothing is
+ * allocated.
+ * @tparam NodePtr type of pointer to the nodes
+ * @tparam Count number of nodes in the set
+ */
+template <typename NodePtr, std::size_t Count>
+class match_navigator : public navigator_base<match_navigator<NodePtr, Count>, NodePtr> {
+
+    /*   ---   FRIENDS   ---   */
+    template <typename, std::size_t>
+    friend class match_navigator;
+
+    /*   ---   TYPES   ---   */
+    public:
+    using typename navigator_base<match_navigator, NodePtr>::node_pointer;
+    using typename navigator_base<match_navigator, NodePtr>::node_type;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    std::array<NodePtr, Count> matched {};
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    match_navigator() {
+    }
+
+    match_navigator(NodePtr root, const std::array<NodePtr, Count>& matched) :
+            navigator_base<match_navigator, NodePtr>(root),
+            matched(matched) {
+    }
+
+    template <typename OtherNodePtr, typename = std::enable_if_t<std::is_convertible_v<OtherNodePtr, NodePtr>>>
+    match_navigator(const match_navigator<OtherNodePtr, Count>& other) :
+            navigator_base<match_navigator, NodePtr>(other.get_root()) {
+        for (std::size_t i = 0; i < Count; ++i) {
+            this->matched[i] = other.matched[i];
+        }
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    /// @brief Whether the node is shown: it is in the set or it is an ancestor of a node in the set.
+    bool is_matched(NodePtr node) const {
+        if (node == nullptr) {
+            return false;
+        }
+        for (NodePtr target : this->matched) {
+            while (target != nullptr) {
+                if (target == node) {
+                    return true;
+                }
+                if (target == this->root) {
+                    break;
+                }
+                target = target->get_parent();
+            }
+        }
+        return false;
+    }
+
+    bool is_valid(NodePtr node) {
+        return this->is_matched(node);
+    }
+
+    bool is_first_child(NodePtr node) {
+        return !this->is_root(node) && this->get_prev_sibling(node) == nullptr;
+    }
+
+    bool is_last_child(NodePtr node) {
+        return !this->is_root(node) && this->get_next_sibling(node) == nullptr;
+    }
+
+    NodePtr get_prev_sibling(NodePtr node) {
+        NodePtr result = this->navigator_base<match_navigator, NodePtr>::get_prev_sibling(node);
+        while (result && !this->is_matched(result)) {
+            result = this->navigator_base<match_navigator, NodePtr>::get_prev_sibling(result);
+        }
+        return result;
+    }
+
+    NodePtr get_next_sibling(NodePtr node) {
+        NodePtr result = this->navigator_base<match_navigator, NodePtr>::get_next_sibling(node);
+        while (result && !this->is_matched(result)) {
+            result = this->navigator_base<match_navigator, NodePtr>::get_next_sibling(result);
+        }
+        return result;
+    }
+
+    NodePtr get_first_child(NodePtr node) {
+        NodePtr result = node->get_first_child();
+        while (result && !this->is_matched(result)) {
+            result = result->get_next_sibling();
+        }
+        return result;
+    }
+
+    NodePtr get_last_child(NodePtr node) {
+        NodePtr result = node->get_last_child();
+        while (result && !this->is_matched(result)) {
+            result = result->get_prev_sibling();
+        }
+        return result;
+    }
+
+    NodePtr get_child(NodePtr node, std::size_t index) {
+        NodePtr result = this->get_first_child(node);
+        while (result && index-- > 0) {
+            result = this->get_next_sibling(result);
+        }
+        return result;
+    }
+
+    template <
+        typename N = NodePtr,
+        typename   = std::enable_if_t<is_binary_node_pointer<N>>>
+    NodePtr get_left_child(N node) {
+        NodePtr result = node->get_left_child();
+        return this->is_matched(result) ? result : N();
+    }
+
+    template <
+        typename N = NodePtr,
+        typename   = std::enable_if_t<is_binary_node_pointer<N>>>
+    NodePtr get_right_child(N node) {
+        NodePtr result = node->get_right_child();
+        return this->is_matched(result) ? result : N();
+    }
+};
+
+} // namespace md
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <TreeDS/node/navigator/navigator_base.hpp>
+#include <TreeDS/node/shared_node.hpp>
+
+namespace md {
+
+/**
+ * @brief Navigator over the expanded tree of a {@link shared_tree}.
+ * @details It is a plain navigator over {@link shared_node_pointer}, except that the position among the siblings is
+ * read from the pointer instead of being compared with the first and the last child of the parent (which would
+ * allocate the frame of the parent again).
+ */
+template <typename T>
+class shared_navigator : public navigator_base<shared_navigator<T>, shared_node_pointer<T>> {
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    using navigator_base<shared_navigator<T>, shared_node_pointer<T>>::navigator_base;
+
+    /*   ---   METHODS   ---   */
+    public:
+    bool is_first_child(const shared_node_pointer<T>& node) {
+        return !this->is_root(node) && node.is_first_child();
+    }
+
+    bool is_last_child(const shared_node_pointer<T>& node) {
+        return !this->is_root(node) && node.is_last_child();
+    }
+};
+
+} // namespace md
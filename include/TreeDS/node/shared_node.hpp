@@ -0,0 +1,207 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef> // std::size_t, std::nullptr_t
+#include <memory>  // std::shared_ptr, std::make_shared()
+#include <utility> // std::move(), std::forward()
+#include <vector>
+
+namespace md {
+
+/**
+ * @brief Node of a {@link shared_tree} or of a {@link persistent_tree}, it can be the child of many parents at once.
+ * @details The node does not know its parent nor its siblings (they differ from an occurrence to another), it holds
+ * only the value and the ordered list of its children. Nodes are immutable once shared and are kept alive by a
+ * reference count: one reference for each parent slot and one for each tree having the node as root. The count is
+ * atomic, trees sharing nodes can be destroyed by different threads.
+ */
+template <typename T>
+class shared_node {
+
+    /*   ---   FRIENDS   ---   */
+    template <typename, typename, typename, typename>
+    friend class shared_tree;
+
+    template <typename, typename, typename>
+    friend class persistent_tree;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    T value;
+    std::vector<shared_node*> children;
+    // Hash of the subtree, it depends only on the values and the shape
+    std::size_t hash_value = 0u;
+    // Number of nodes of the subtree once expanded (each occurrence of a shared node counted)
+    std::size_t subtree_size = 1u;
+    std::atomic<std::size_t> references {0u};
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    template <typename... Args>
+    explicit shared_node(std::vector<shared_node*>&& children, Args&&... args) :
+            value(std::forward<Args>(args)...),
+            children(std::move(children)) {
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    const T& get_value() const {
+        return this->value;
+    }
+
+    const std::vector<shared_node*>& get_children() const {
+        return this->children;
+    }
+
+    std::size_t get_hash() const {
+        return this->hash_value;
+    }
+
+    std::size_t get_subtree_size() const {
+        return this->subtree_size;
+    }
+
+    /// @brief Number of parent slots (plus the tree itself for the root) that refer to this node.
+    std::size_t get_references() const {
+        return this->references;
+    }
+};
+
+/**
+ * @brief Pointer to an occurrence of a {@link shared_node} in the expanded tree.
+ * @details The same shared node can appear in many places, therefore this pointer carries the path that led to it: the
+ * pointer to the parent occurrence (shared among the siblings) and the index among its children. It offers the same
+ * interface of a pointer to an nary_node, therefore a navigator and every traversal policy walk the expanded tree
+ * through it as they would walk any other tree. Descending allocates the frame of the parent, moving among siblings and
+ * climbing do not.
+ */
+template <typename T>
+class shared_node_pointer {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using node_type = shared_node<T>;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    const node_type* node = nullptr;
+    std::size_t index     = 0u;
+    std::shared_ptr<const shared_node_pointer> parent;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    shared_node_pointer() {
+    }
+
+    shared_node_pointer(std::nullptr_t) {
+    }
+
+    /// @brief Points to the given node as the root of the expanded tree.
+    explicit shared_node_pointer(const node_type* root) :
+            node(root) {
+    }
+
+    shared_node_pointer(
+        const node_type* node,
+        std::size_t index,
+        std::shared_ptr<const shared_node_pointer> parent) :
+            node(node),
+            index(index),
+            parent(std::move(parent)) {
+    }
+
+    /*   ---   METHODS   ---   */
+    protected:
+    shared_node_pointer sibling(std::size_t index) const {
+        return shared_node_pointer(this->parent->node->get_children()[index], index, this->parent);
+    }
+
+    shared_node_pointer child(std::size_t index) const {
+        return shared_node_pointer(
+            this->node->get_children()[index],
+            index,
+            std::make_shared<const shared_node_pointer>(*this));
+    }
+
+    public:
+    const T& get_value() const {
+        return this->node->get_value();
+    }
+
+    const node_type* get_node() const {
+        return this->node;
+    }
+
+    /// @brief Index of the occurrence among the children of its parent (0 for the root).
+    std::size_t get_index() const {
+        return this->index;
+    }
+
+    bool is_first_child() const {
+        return this->parent && this->index == 0u;
+    }
+
+    bool is_last_child() const {
+        return this->parent && this->index + 1u == this->parent->node->get_children().size();
+    }
+
+    shared_node_pointer get_parent() const {
+        return this->parent ? *this->parent : shared_node_pointer();
+    }
+
+    shared_node_pointer get_prev_sibling() const {
+        return this->parent && this->index > 0u ? this->sibling(this->index - 1u) : shared_node_pointer();
+    }
+
+    shared_node_pointer get_next_sibling() const {
+        return this->is_last_child() || !this->parent ? shared_node_pointer() : this->sibling(this->index + 1u);
+    }
+
+    shared_node_pointer get_first_child() const {
+        return !this->node->get_children().empty() ? this->child(0u) : shared_node_pointer();
+    }
+
+    shared_node_pointer get_last_child() const {
+        const std::size_t count = this->node->get_children().size();
+        return count > 0u ? this->child(count - 1u) : shared_node_pointer();
+    }
+
+    shared_node_pointer get_child(std::size_t index) const {
+        return index < this->node->get_children().size() ? this->child(index) : shared_node_pointer();
+    }
+
+    operator bool() const {
+        return this->node != nullptr;
+    }
+
+    const shared_node_pointer* operator->() const {
+        return this;
+    }
+
+    const shared_node_pointer& operator*() const {
+        return *this;
+    }
+
+    /// @brief Two pointers are equal when they point to the same occurrence: same node reached by the same path.
+    bool operator==(const shared_node_pointer& other) const {
+        const shared_node_pointer* left  = this;
+        const shared_node_pointer* right = &other;
+        while (left->node == right->node && left->index == right->index) {
+            if (left->parent == right->parent) {
+                return true;
+            }
+            if (!left->parent || !right->parent) {
+                return false;
+            }
+            left  = left->parent.get();
+            right = right->parent.get();
+        }
+        return false;
+    }
+
+    bool operator!=(const shared_node_pointer& other) const {
+        return !(*this == other);
+    }
+};
+
+} // namespace md
@@ -0,0 +1,494 @@
+#pragma once
+
+#include <algorithm>   // std::min(), std::reverse()
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <memory>      // std::allocator, std::allocator_traits
+#include <stdexcept>   // std::invalid_argument
+#include <type_traits> // std::is_convertible_v, std::enable_if_t
+#include <utility>     // std::move(), std::forward(), std::pair
+#include <vector>
+
+#include <TreeDS/allocator_utility.hpp>
+#include <TreeDS/nary_tree.hpp>
+#include <TreeDS/node/navigator/shared_navigator.hpp>
+#include <TreeDS/node/shared_node.hpp>
+#include <TreeDS/node/struct_node.hpp>
+#include <TreeDS/policy/fixed.hpp>
+#include <TreeDS/shared_tree.hpp>
+#include <TreeDS/tree_builder.hpp>
+
+namespace md {
+
+/**
+ * @brief N-ary tree whose copies share the nodes, a copy (snapshot) costs O(1) whatever the size.
+ * @details Nodes are {@link shared_node}: they do not know their parent, therefore a subtree can belong to many
+ * versions of the tree at once, and they are reclaimed by a reference count when no version uses them anymore.
+ * Copying a tree takes one more reference to the root. Modifying a node through {@link #insert_over()},
+ * {@link #emplace_child_back()}, {@link #erase()} and the like copies the path from the root to that node (path
+ * copying), the other subtrees are shared with the previous version. The copy starts at the first node of the path
+ * that is shared: when no snapshot is alive the nodes are owned by this tree only and they are modified in place,
+ * without allocating.
+ *
+ * The tree is iterated as a {@link shared_tree} is, the iterators are constant and any modification invalidates them,
+ * the ones returned point into the new version. Each tree object must be modified by one thread at a time, but
+ * snapshots can be read and destroyed by other threads while the original is modified.
+ *
+ * @code
+ * persistent_tree<char> t(n('a')(n('b'), n('c')));
+ * persistent_tree<char> snapshot = t; // O(1)
+ * t.insert_child_back(t.root(), 'd'); // copies only the root, b and c are shared with snapshot
+ * @endcode
+ *
+ * @tparam T the type of value hold by this tree
+ * @tparam Policy default traversal algorithm
+ * @tparam Allocator the allocater used to allocate nodes, the snapshots share it
+ */
+template <
+    typename T,
+    typename Policy    = default_policy,
+    typename Allocator = std::allocator<T>>
+class persistent_tree {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using value_type          = T;
+    using const_reference     = const T&;
+    using size_type           = std::size_t;
+    using node_type           = shared_node<T>;
+    using node_pointer        = shared_node_pointer<T>;
+    using navigator_type      = shared_navigator<T>;
+    using policy_type         = Policy;
+    using allocator_type      = Allocator;
+    using node_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<node_type>;
+    template <typename P>
+    using const_iterator = shared_tree_iterator<persistent_tree, P>;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    node_allocator_type allocator;
+    node_type* root_node = nullptr;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    explicit persistent_tree(const Allocator& allocator = Allocator()) :
+            allocator(allocator) {
+    }
+
+    /// @brief Copies the given tree, which is not modified.
+    template <typename OtherPolicy, typename OtherAllocator>
+    explicit persistent_tree(
+        const nary_tree<T, OtherPolicy, OtherAllocator>& tree,
+        const Allocator& allocator = Allocator()) :
+            allocator(allocator) {
+        if (tree.raw_root_node() != nullptr) {
+            this->root_node = this->copy_subtree(*tree.raw_root_node());
+        }
+    }
+
+    template <
+        typename ConvertibleV,
+        typename... Children,
+        typename = std::enable_if_t<std::is_convertible_v<ConvertibleV, value_type>>>
+    persistent_tree(const struct_node<ConvertibleV, Children...>& root) :
+            persistent_tree(nary_tree<T, Policy, Allocator>(root)) {
+    }
+
+    /// @brief Takes a snapshot of other in O(1), the two trees share every node until one of them is modified.
+    persistent_tree(const persistent_tree& other) :
+            allocator(other.allocator),
+            root_node(other.root_node) {
+        if (this->root_node != nullptr) {
+            ++this->root_node->references;
+        }
+    }
+
+    persistent_tree(persistent_tree&& other) :
+            allocator(std::move(other.allocator)),
+            root_node(other.root_node) {
+        other.root_node = nullptr;
+    }
+
+    ~persistent_tree() {
+        this->clear();
+    }
+
+    /*   ---   ASSIGNMENT   ---   */
+    public:
+    persistent_tree& operator=(const persistent_tree& other) {
+        if (this != &other) {
+            if (other.root_node != nullptr) {
+                ++other.root_node->references;
+            }
+            this->release(this->root_node);
+            this->allocator = other.allocator;
+            this->root_node = other.root_node;
+        }
+        return *this;
+    }
+
+    persistent_tree& operator=(persistent_tree&& other) {
+        if (this != &other) {
+            this->release(this->root_node);
+            this->allocator = std::move(other.allocator);
+            this->root_node = other.root_node;
+            other.root_node = nullptr;
+        }
+        return *this;
+    }
+
+    /*   ---   METHODS   ---   */
+    protected:
+    // Creates a node owned by the caller (one reference), which gives away one reference to each child
+    node_type* make_node(T&& value, std::vector<node_type*>&& children) {
+        std::size_t size = 1u;
+        for (node_type* child : children) {
+            size += child->subtree_size;
+        }
+        node_type* result   = allocate(this->allocator, std::move(children), std::move(value)).release();
+        result->subtree_size = size;
+        result->references   = 1u;
+        return result;
+    }
+
+    // Drops one reference to the node, destroying the nodes that are no more referenced
+    void release(node_type* node) {
+        if (node == nullptr || --node->references > 0u) {
+            return;
+        }
+        std::vector<node_type*> unreferenced {node};
+        while (!unreferenced.empty()) {
+            node_type* current = unreferenced.back();
+            unreferenced.pop_back();
+            for (node_type* child : current->children) {
+                if (--child->references == 0u) {
+                    unreferenced.push_back(child);
+                }
+            }
+            deallocate(this->allocator, current);
+        }
+    }
+
+    // Copies an nary_node and its subtree, children before their parent
+    node_type* copy_subtree(const nary_node<T>& root) {
+        struct frame {
+            const nary_node<T>* node;
+            const nary_node<T>* next_child;
+            std::size_t first_result;
+        };
+        std::vector<node_type*> results;
+        std::vector<frame> stack {{&root, root.get_first_child(), 0u}};
+        while (!stack.empty()) {
+            frame& top = stack.back();
+            if (top.next_child != nullptr) {
+                const nary_node<T>* child = top.next_child;
+                top.next_child            = child->get_next_sibling();
+                stack.push_back({child, child->get_first_child(), results.size()});
+                continue;
+            }
+            std::vector<node_type*> children(results.begin() + top.first_result, results.end());
+            results.resize(top.first_result);
+            results.push_back(this->make_node(T(top.node->get_value()), std::move(children)));
+            stack.pop_back();
+        }
+        return results.front();
+    }
+
+    template <typename ConvertibleV, typename... Children>
+    node_type* copy_struct(const struct_node<ConvertibleV, Children...>& node) {
+        nary_tree<T, Policy, Allocator> tree(node);
+        return this->copy_subtree(*tree.raw_root_node());
+    }
+
+    // The path from the root to position (included), it releases pending and throws if position is not in this tree
+    std::vector<node_pointer> path_to(const node_pointer& position, node_type* pending) {
+        std::vector<node_pointer> path;
+        for (node_pointer node = position; node; node = node.get_parent()) {
+            path.push_back(node);
+        }
+        if (path.empty()) {
+            this->release(pending);
+            throw std::invalid_argument("Tried to modify a persistent_tree at a position that is not a node.");
+        }
+        if (path.back().get_node() != this->root_node) {
+            this->release(pending);
+            throw std::invalid_argument("Tried to modify a persistent_tree through an iterator of another tree.");
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // The children of node, each one referenced once more (by the copy of node that will hold them)
+    static std::vector<node_type*> share_children(const node_type& node) {
+        for (node_type* child : node.children) {
+            ++child->references;
+        }
+        return node.children;
+    }
+
+    /*
+     * Calls edit(children) on the children of the last node of the path, each child in the vector holds one reference
+     * for it: edit releases the children it removes and gives one reference to the children it adds. The nodes from
+     * the first shared one of the path down to the last are copied (path copying), the ones above are referenced by
+     * this version alone and they are modified in place. Returns the pointer to the node edited in the new version.
+     */
+    template <typename Edit>
+    node_pointer edit_children(const std::vector<node_pointer>& path, Edit&& edit) {
+        // path[0...owned) are referenced just once, through nodes referenced just once: no other version sees them
+        std::size_t owned = 0u;
+        while (owned < path.size() && path[owned].get_node()->references == 1u) {
+            ++owned;
+        }
+        const node_type* target    = path.back().get_node();
+        const std::size_t old_size = target->subtree_size;
+        std::size_t new_size       = 0u;
+        if (owned == path.size()) {
+            node_type* node = const_cast<node_type*>(target);
+            edit(node->children);
+            node->subtree_size = 1u;
+            for (node_type* child : node->children) {
+                node->subtree_size += child->subtree_size;
+            }
+            new_size = node->subtree_size;
+        } else {
+            std::vector<node_type*> children = share_children(*target);
+            edit(children);
+            node_type* current = this->make_node(T(target->value), std::move(children));
+            new_size           = current->subtree_size;
+            // Copy the shared ancestors, each one having the copy of its child in place of the old one
+            for (std::size_t i = path.size() - 1u; i-- > owned;) {
+                children         = share_children(*path[i].get_node());
+                node_type*& slot = children[path[i + 1u].get_index()];
+                --slot->references;
+                slot    = current;
+                current = this->make_node(T(path[i].get_node()->value), std::move(children));
+            }
+            node_type*& slot = owned == 0u
+                ? this->root_node
+                : const_cast<node_type*>(path[owned - 1u].get_node())->children[path[owned].get_index()];
+            this->release(slot);
+            slot = current;
+        }
+        // The ancestors modified in place grow (or shrink, modulo arithmetic) as the node edited
+        for (std::size_t i = 0u; i < std::min(owned, path.size() - 1u); ++i) {
+            const_cast<node_type*>(path[i].get_node())->subtree_size += new_size - old_size;
+        }
+        node_pointer result(this->root_node);
+        for (std::size_t i = 1u; i < path.size(); ++i) {
+            result = result.get_child(path[i].get_index());
+        }
+        return result;
+    }
+
+    // Replaces the subtree at position with replacement (the caller gives away its reference) or removes it if null
+    node_pointer replace(const node_pointer& position, node_type* replacement) {
+        if (!position && this->root_node == nullptr && replacement != nullptr) {
+            this->root_node = replacement;
+            return node_pointer(this->root_node);
+        }
+        std::vector<node_pointer> path = this->path_to(position, replacement);
+        if (path.size() == 1u) {
+            this->release(this->root_node);
+            this->root_node = replacement;
+            return node_pointer(this->root_node);
+        }
+        const std::size_t index = path.back().get_index();
+        path.pop_back();
+        node_pointer parent = this->edit_children(path, [&](std::vector<node_type*>& children) {
+            this->release(children[index]);
+            if (replacement != nullptr) {
+                children[index] = replacement;
+            } else {
+                children.erase(children.begin() + static_cast<std::ptrdiff_t>(index));
+            }
+        });
+        return replacement != nullptr ? parent.get_child(index) : node_pointer();
+    }
+
+    // Gives child (and the caller's reference to it) to the node at position as first or last child
+    template <bool Front>
+    node_pointer add_child(const node_pointer& position, node_type* child) {
+        node_pointer result = this->edit_children(
+            this->path_to(position, child),
+            [&](std::vector<node_type*>& children) {
+                children.insert(Front ? children.begin() : children.end(), child);
+            });
+        return Front ? result.get_first_child() : result.get_last_child();
+    }
+
+    public:
+    template <typename P = Policy>
+    const_iterator<P> begin(P = P()) const {
+        return ++const_iterator<P>(*this, node_pointer());
+    }
+
+    template <typename P = Policy>
+    const_iterator<P> end(P = P()) const {
+        return const_iterator<P>(*this, node_pointer());
+    }
+
+    const_iterator<policy::fixed> root() const {
+        return const_iterator<policy::fixed>(*this, node_pointer(this->root_node));
+    }
+
+    /// @brief Replaces the subtree at position with a single node having the given value.
+    template <typename P>
+    const_iterator<P> insert_over(const const_iterator<P>& position, const T& value) {
+        node_type* node = this->make_node(T(value), {});
+        return const_iterator<P>(*this, this->replace(position.get_node_pointer(), node));
+    }
+
+    /// @brief Replaces the subtree at position with the given structure.
+    template <
+        typename P,
+        typename ConvertibleV,
+        typename... Children,
+        typename = std::enable_if_t<std::is_convertible_v<ConvertibleV, value_type>>>
+    const_iterator<P> insert_over(const const_iterator<P>& position, const struct_node<ConvertibleV, Children...>& node) {
+        node_type* subtree = this->copy_struct(node);
+        return const_iterator<P>(*this, this->replace(position.get_node_pointer(), subtree));
+    }
+
+    /// @brief Replaces the subtree at position with the whole other tree, whose nodes are shared and not copied.
+    template <typename P>
+    const_iterator<P> insert_over(const const_iterator<P>& position, const persistent_tree& other) {
+        if (other.root_node != nullptr) {
+            ++other.root_node->references;
+        }
+        return const_iterator<P>(*this, this->replace(position.get_node_pointer(), other.root_node));
+    }
+
+    template <typename P, typename... Args>
+    const_iterator<P> emplace_over(const const_iterator<P>& position, Args&&... args) {
+        node_type* node = this->make_node(T(std::forward<Args>(args)...), {});
+        return const_iterator<P>(*this, this->replace(position.get_node_pointer(), node));
+    }
+
+    template <typename P>
+    const_iterator<P> insert_child_front(const const_iterator<P>& position, const T& value) {
+        node_type* child = this->make_node(T(value), {});
+        return const_iterator<P>(*this, this->template add_child<true>(position.get_node_pointer(), child));
+    }
+
+    template <
+        typename P,
+        typename ConvertibleV,
+        typename... Children,
+        typename = std::enable_if_t<std::is_convertible_v<ConvertibleV, value_type>>>
+    const_iterator<P> insert_child_front(
+        const const_iterator<P>& position,
+        const struct_node<ConvertibleV, Children...>& node) {
+        node_type* child = this->copy_struct(node);
+        return const_iterator<P>(*this, this->template add_child<true>(position.get_node_pointer(), child));
+    }
+
+    template <typename P, typename... Args>
+    const_iterator<P> emplace_child_front(const const_iterator<P>& position, Args&&... args) {
+        node_type* child = this->make_node(T(std::forward<Args>(args)...), {});
+        return const_iterator<P>(*this, this->template add_child<true>(position.get_node_pointer(), child));
+    }
+
+    template <typename P>
+    const_iterator<P> insert_child_back(const const_iterator<P>& position, const T& value) {
+        node_type* child = this->make_node(T(value), {});
+        return const_iterator<P>(*this, this->template add_child<false>(position.get_node_pointer(), child));
+    }
+
+    template <
+        typename P,
+        typename ConvertibleV,
+        typename... Children,
+        typename = std::enable_if_t<std::is_convertible_v<ConvertibleV, value_type>>>
+    const_iterator<P> insert_child_back(
+        const const_iterator<P>& position,
+        const struct_node<ConvertibleV, Children...>& node) {
+        node_type* child = this->copy_struct(node);
+        return const_iterator<P>(*this, this->template add_child<false>(position.get_node_pointer(), child));
+    }
+
+    template <typename P, typename... Args>
+    const_iterator<P> emplace_child_back(const const_iterator<P>& position, Args&&... args) {
+        node_type* child = this->make_node(T(std::forward<Args>(args)...), {});
+        return const_iterator<P>(*this, this->template add_child<false>(position.get_node_pointer(), child));
+    }
+
+    /// @brief Removes the subtree at position.
+    template <typename P>
+    void erase(const const_iterator<P>& position) {
+        this->replace(position.get_node_pointer(), nullptr);
+    }
+
+    /// @brief Removes every node, the ones shared with other versions survive in them.
+    void clear() {
+        this->release(this->root_node);
+        this->root_node = nullptr;
+    }
+
+    /// @brief Copies the nodes into an nary_tree.
+    nary_tree<T, Policy, Allocator> to_nary_tree() const {
+        if (this->root_node == nullptr) {
+            return nary_tree<T, Policy, Allocator>();
+        }
+        tree_builder<nary_tree<T, Policy, Allocator>> builder;
+        std::vector<std::pair<const node_type*, std::size_t>> stack {{this->root_node, 0u}};
+        builder.open(this->root_node->value);
+        while (!stack.empty()) {
+            const node_type* node = stack.back().first;
+            std::size_t next      = stack.back().second;
+            if (next < node->children.size()) {
+                ++stack.back().second;
+                builder.open(node->children[next]->value);
+                stack.emplace_back(node->children[next], 0u);
+                continue;
+            }
+            builder.close();
+            stack.pop_back();
+        }
+        return builder.build();
+    }
+
+    /*   ---   GETTERS   ---   */
+    public:
+    const node_type* raw_root_node() const {
+        return this->root_node;
+    }
+
+    size_type size() const {
+        return this->root_node != nullptr ? this->root_node->subtree_size : 0u;
+    }
+
+    bool empty() const {
+        return this->root_node == nullptr;
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_type(this->allocator);
+    }
+
+    /*   ---   COMPARISON   ---   */
+    public:
+    /// @brief Whether the two trees have the same values and shape, the subtrees shared by both are not visited.
+    bool operator==(const persistent_tree& other) const {
+        std::vector<std::pair<const node_type*, const node_type*>> pending {{this->root_node, other.root_node}};
+        while (!pending.empty()) {
+            auto [left, right] = pending.back();
+            pending.pop_back();
+            if (left == right) {
+                continue;
+            }
+            if (left == nullptr || right == nullptr || left->subtree_size != right->subtree_size
+                || left->children.size() != right->children.size() || !(left->value == right->value)) {
+                return false;
+            }
+            for (std::size_t i = 0u; i < left->children.size(); ++i) {
+                pending.emplace_back(left->children[i], right->children[i]);
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const persistent_tree& other) const {
+        return !(*this == other);
+    }
+};
+
+} // namespace md
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint8_t, std::uint16_t, std::uint64_t
+#include <cstring> // std::memcpy()
+
+namespace md {
+
+/**
+ * @brief Layout of the compact binary format used by {@link binary_writer} and {@link binary_reader}.
+ * @details A serialized tree is made of a fixed size header followed by one record per node, in pre-order.
+ * <ul>
+ *     <li>Header (16 bytes): the magic bytes "TDST", the format version, the flags, two reserved bytes and the number
+ *     of nodes as a 64 bits little endian integer.</li>
+ *     <li>Node record: the shape of the node as a varint, then the value as written by the value codec. The shape is
+ *     the number of children for nary trees, for binary trees it is a mask having bit 0 set if there is a left child
+ *     and bit 1 set if there is a right child.</li>
+ * </ul>
+ * Varints are unsigned LEB128: 7 bits per byte, least significant group first, high bit set on all but the last byte.
+ *
+ * The mapped variant, written by {@link mapped_writer} and read in place by {@link mapped_tree}, has a 32 bytes header
+ * (the magic bytes "TDSM", version, flags, two reserved bytes, the number of nodes and the arity as 64 bits integers,
+ * the size of a node record and the size of a value as 32 bits integers, all little endian) followed by an array of
+ * {@link mapped_node}.
+ */
+struct binary_format {
+
+    static constexpr char MAGIC[4]           = {'T', 'D', 'S', 'T'};
+    static constexpr std::uint8_t VERSION    = 1u;
+    static constexpr std::size_t HEADER_SIZE = 16u;
+    static constexpr std::size_t MAX_VARINT  = 10u;
+
+    static constexpr char MAPPED_MAGIC[4]           = {'T', 'D', 'S', 'M'};
+    static constexpr std::size_t MAPPED_HEADER_SIZE = 32u;
+
+    /// @brief The shape of the nodes is a left/right mask instead of a children count.
+    static constexpr std::uint8_t BINARY_FLAG = 0x01u;
+    /// @brief Trivially copyable values were written by a big endian machine.
+    static constexpr std::uint8_t BIG_ENDIAN_FLAG = 0x02u;
+
+    static constexpr std::uint8_t LEFT_MASK  = 0x01u;
+    static constexpr std::uint8_t RIGHT_MASK = 0x02u;
+
+    static bool is_big_endian() {
+        const std::uint16_t value = 1u;
+        unsigned char first_byte;
+        std::memcpy(&first_byte, &value, 1u);
+        return first_byte == 0u;
+    }
+
+    /// @brief Writes the lowest bytes of value in little endian order.
+    static void write_integer(unsigned char* destination, std::uint64_t value, std::size_t bytes = 8u) {
+        for (std::size_t i = 0u; i < bytes; ++i) {
+            destination[i] = static_cast<unsigned char>(value >> (8u * i));
+        }
+    }
+
+    static std::uint64_t read_integer(const unsigned char* source, std::size_t bytes = 8u) {
+        std::uint64_t result = 0u;
+        for (std::size_t i = 0u; i < bytes; ++i) {
+            result |= static_cast<std::uint64_t>(source[i]) << (8u * i);
+        }
+        return result;
+    }
+};
+
+} // namespace md
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint8_t, std::uint64_t
+#include <cstring>     // std::memcpy(), std::memcmp()
+#include <istream>     // std::istream
+#include <stdexcept>   // std::invalid_argument
+#include <type_traits> // std::is_same_v
+#include <vector>
+
+#include <TreeDS/node/binary_node.hpp>
+#include <TreeDS/serializer/binary_format.hpp>
+#include <TreeDS/serializer/value_codec.hpp>
+#include <TreeDS/tree_builder.hpp>
+
+namespace md {
+
+/**
+ * @brief Reads trees written by {@link binary_writer} from a stream.
+ * @details The nodes are linked by a {@link tree_builder} as soon as they are read, the memory used besides the tree
+ * is a fixed size input buffer plus one counter for each level of the tree. Trees written as binary can be read as
+ * nary and the other way around, provided that no node has more than 2 children; in that case a single child becomes
+ * the left one.
+ *
+ * The reader fills its buffer reading ahead from the stream, so many trees written on the same stream must be read
+ * by the same reader.
+ */
+class binary_reader {
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    std::istream& stream;
+    std::vector<char> buffer;
+    std::size_t position = 0u;
+    std::size_t limit    = 0u;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    explicit binary_reader(std::istream& stream, std::size_t buffer_size = 1u << 16) :
+            stream(stream),
+            buffer(buffer_size < binary_format::HEADER_SIZE ? binary_format::HEADER_SIZE : buffer_size) {
+    }
+
+    binary_reader(const binary_reader&) = delete;
+
+    /*   ---   METHODS   ---   */
+    protected:
+    // Returns false if the stream has no more data
+    bool fill() {
+        this->stream.read(this->buffer.data(), static_cast<std::streamsize>(this->buffer.size()));
+        this->position = 0u;
+        this->limit    = static_cast<std::size_t>(this->stream.gcount());
+        return this->limit > 0u;
+    }
+
+    [[noreturn]] static void truncated() {
+        throw std::invalid_argument("The serialized tree is truncated.");
+    }
+
+    public:
+    void read_bytes(void* data, std::size_t count) {
+        char* output = static_cast<char*>(data);
+        while (count > this->limit - this->position) {
+            std::size_t available = this->limit - this->position;
+            std::memcpy(output, this->buffer.data() + this->position, available);
+            output += available;
+            count -= available;
+            if (!this->fill()) {
+                truncated();
+            }
+        }
+        std::memcpy(output, this->buffer.data() + this->position, count);
+        this->position += count;
+    }
+
+    std::uint64_t read_varint() {
+        std::uint64_t result = 0u;
+        for (unsigned shift = 0u; shift < 7u * binary_format::MAX_VARINT; shift += 7u) {
+            if (this->position == this->limit && !this->fill()) {
+                truncated();
+            }
+            auto byte = static_cast<unsigned char>(this->buffer[this->position++]);
+            result |= static_cast<std::uint64_t>(byte & 0x7Fu) << shift;
+            if ((byte & 0x80u) == 0u) {
+                return result;
+            }
+        }
+        throw std::invalid_argument("Malformed varint in the serialized tree.");
+    }
+
+    /**
+     * @brief Reads the next tree from the stream.
+     * @param codec the object used to read the values, see {@link value_codec}
+     * @param allocator the allocator used by the tree returned
+     * @throw std::invalid_argument if the data is not a valid tree or it cannot be stored in a Tree
+     */
+    template <typename Tree, typename Codec = value_codec<typename Tree::value_type>>
+    Tree read(const Codec& codec = Codec(), const typename Tree::allocator_type& allocator = {}) {
+        constexpr bool to_binary
+            = std::is_same_v<std::decay_t<typename Tree::node_type>, binary_node<typename Tree::value_type>>;
+        using size_type = typename Tree::size_type;
+
+        unsigned char header[binary_format::HEADER_SIZE];
+        this->read_bytes(header, binary_format::HEADER_SIZE);
+        if (std::memcmp(header, binary_format::MAGIC, sizeof(binary_format::MAGIC)) != 0) {
+            throw std::invalid_argument("The data is not a serialized tree.");
+        }
+        if (header[4] != binary_format::VERSION) {
+            throw std::invalid_argument("Unsupported version of the serialized tree format.");
+        }
+        const bool from_binary = (header[5] & binary_format::BINARY_FLAG) != 0u;
+        if (((header[5] & binary_format::BIG_ENDIAN_FLAG) != 0u) != binary_format::is_big_endian()) {
+            throw std::invalid_argument("The serialized tree was written by a machine with a different byte order.");
+        }
+        const std::uint64_t size = binary_format::read_integer(header + 8u);
+
+        tree_builder<Tree> builder(allocator);
+        // Children still to be read for each open node
+        std::vector<size_type> missing;
+        for (std::uint64_t i = 0u; i < size; ++i) {
+            if (i > 0u && missing.empty()) {
+                throw std::invalid_argument("The serialized tree has fewer nodes than declared.");
+            }
+            std::uint64_t shape    = this->read_varint();
+            std::uint64_t children = shape;
+            if (from_binary) {
+                if (shape > (binary_format::LEFT_MASK | binary_format::RIGHT_MASK)) {
+                    throw std::invalid_argument("Invalid shape of a binary node in the serialized tree.");
+                }
+                children = (shape & binary_format::LEFT_MASK) + ((shape & binary_format::RIGHT_MASK) >> 1);
+            }
+            if (to_binary && children > 2u) {
+                throw std::invalid_argument("Tried to read a node with more than 2 children into a binary tree.");
+            }
+            if (!missing.empty()) {
+                --missing.back();
+            }
+            if (children == 0u) {
+                builder.leaf(codec.read(*this));
+            } else {
+                builder.open(codec.read(*this));
+                if constexpr (to_binary) {
+                    if (from_binary && shape == binary_format::RIGHT_MASK) {
+                        builder.skip();
+                    }
+                }
+                missing.push_back(static_cast<size_type>(children));
+            }
+            while (!missing.empty() && missing.back() == 0u) {
+                builder.close();
+                missing.pop_back();
+            }
+        }
+        if (!missing.empty()) {
+            throw std::invalid_argument("The serialized tree has more nodes than declared.");
+        }
+        return builder.build();
+    }
+};
+
+} // namespace md
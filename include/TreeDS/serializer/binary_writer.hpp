@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>   // std::size_t
+#include <cstdint>   // std::uint8_t, std::uint64_t
+#include <cstring>   // std::memcpy()
+#include <ostream>   // std::ostream
+#include <stdexcept> // std::runtime_error
+#include <vector>
+
+#include <TreeDS/node/binary_node.hpp>
+#include <TreeDS/serializer/binary_format.hpp>
+#include <TreeDS/serializer/value_codec.hpp>
+#include <TreeDS/tree_base.hpp>
+
+namespace md {
+
+/**
+ * @brief Writes trees to a stream using the {@link binary_format}.
+ * @details The nodes are visited in pre-order following the links between nodes, without recursion and without any
+ * memory other than a fixed size output buffer. Any tree or view can be written, a view is written as a tree having
+ * the root of the view as root. Many trees can be written one after the other on the same stream.
+ *
+ * The buffer is flushed to the stream when full, when {@link #flush()} is called and when the writer is destroyed.
+ */
+class binary_writer {
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    std::ostream& stream;
+    std::vector<char> buffer;
+    std::size_t position = 0u;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    explicit binary_writer(std::ostream& stream, std::size_t buffer_size = 1u << 16) :
+            stream(stream),
+            buffer(buffer_size < binary_format::HEADER_SIZE ? binary_format::HEADER_SIZE : buffer_size) {
+    }
+
+    binary_writer(const binary_writer&) = delete;
+
+    ~binary_writer() {
+        // Destructors must not throw, errors are visible on the stream state anyway
+        this->stream.write(this->buffer.data(), static_cast<std::streamsize>(this->position));
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    /**
+     * @brief Writes the content of the buffer to the stream.
+     * @throw std::runtime_error if the stream is in a failure state
+     */
+    void flush() {
+        this->stream.write(this->buffer.data(), static_cast<std::streamsize>(this->position));
+        this->position = 0u;
+        if (!this->stream) {
+            throw std::runtime_error("Failed to write the serialized tree to the stream.");
+        }
+    }
+
+    void write_bytes(const void* data, std::size_t count) {
+        if (this->buffer.size() - this->position < count) {
+            this->flush();
+            if (count >= this->buffer.size()) {
+                // Too big to be buffered
+                this->stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(count));
+                return;
+            }
+        }
+        std::memcpy(this->buffer.data() + this->position, data, count);
+        this->position += count;
+    }
+
+    void write_varint(std::uint64_t value) {
+        if (this->buffer.size() - this->position < binary_format::MAX_VARINT) {
+            this->flush();
+        }
+        char* output = this->buffer.data() + this->position;
+        char* begin  = output;
+        while (value >= 0x80u) {
+            *output++ = static_cast<char>(value | 0x80u);
+            value >>= 7;
+        }
+        *output++ = static_cast<char>(value);
+        this->position += static_cast<std::size_t>(output - begin);
+    }
+
+    /**
+     * @brief Writes a tree (or a view) to the stream.
+     * @param tree the tree to write
+     * @param codec the object used to write the values, see {@link value_codec}
+     */
+    template <
+        typename Node,
+        typename Policy,
+        typename Allocator,
+        typename Codec = value_codec<std::decay_t<node_value_t<Node>>>>
+    void write(const tree_base<Node, Policy, Allocator>& tree, const Codec& codec = Codec()) {
+        constexpr bool is_binary = std::is_same_v<std::decay_t<Node>, binary_node<std::decay_t<node_value_t<Node>>>>;
+        this->write_header(is_binary, tree.size());
+        const Node* root = tree.raw_root_node();
+        const Node* node = root;
+        while (node != nullptr) {
+            if constexpr (is_binary) {
+                this->write_varint(
+                    (node->get_left_child() ? binary_format::LEFT_MASK : 0u)
+                    | (node->get_right_child() ? binary_format::RIGHT_MASK : 0u));
+            } else {
+                this->write_varint(node->children());
+            }
+            codec.write(*this, node->get_value());
+            // Next node in pre-order, never leaving the subtree of root
+            if (node->get_first_child()) {
+                node = node->get_first_child();
+                continue;
+            }
+            while (node != root && node->get_next_sibling() == nullptr) {
+                node = node->get_parent();
+            }
+            node = node != root ? node->get_next_sibling() : nullptr;
+        }
+    }
+
+    protected:
+    void write_header(bool is_binary, std::uint64_t size) {
+        unsigned char header[binary_format::HEADER_SIZE] = {};
+        std::memcpy(header, binary_format::MAGIC, sizeof(binary_format::MAGIC));
+        header[4] = binary_format::VERSION;
+        header[5] = (is_binary ? binary_format::BINARY_FLAG : 0u)
+            | (binary_format::is_big_endian() ? binary_format::BIG_ENDIAN_FLAG : 0u);
+        binary_format::write_integer(header + 8u, size);
+        this->write_bytes(header, binary_format::HEADER_SIZE);
+    }
+};
+
+} // namespace md
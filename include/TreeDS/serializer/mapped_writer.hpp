@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint64_t
+#include <cstring>     // std::memcpy()
+#include <new>         // placement new
+#include <type_traits> // std::is_same_v, std::decay_t
+#include <utility>     // std::pair
+#include <vector>
+
+#include <TreeDS/node/mapped_node.hpp>
+#include <TreeDS/node/nary_node.hpp>
+#include <TreeDS/serializer/binary_format.hpp>
+#include <TreeDS/serializer/binary_writer.hpp>
+#include <TreeDS/tree_base.hpp>
+
+namespace md {
+
+/**
+ * @brief Writes nary trees to a stream as arrays of {@link mapped_node}, ready to be used in place by
+ * {@link mapped_tree}.
+ * @details Records must know the size of their subtree before being written, so the tree is visited twice: the first
+ * time to compute the subtree sizes (kept in memory, one integer per node), the second one to write the records. The
+ * values are copied as they are, so they must be trivially copyable.
+ */
+class mapped_writer : public binary_writer {
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    using binary_writer::binary_writer;
+
+    /*   ---   METHODS   ---   */
+    public:
+    /**
+     * @brief Writes a nary tree (or a view) to the stream.
+     * @param tree the tree to write
+     */
+    template <typename Node, typename Policy, typename Allocator>
+    void write(const tree_base<Node, Policy, Allocator>& tree) {
+        using value_type  = std::decay_t<node_value_t<Node>>;
+        using record_type = mapped_node<value_type>;
+        static_assert(
+            std::is_same_v<std::decay_t<Node>, nary_node<value_type>>,
+            "Only nary trees can be written as mapped trees.");
+        static_assert(
+            binary_format::MAPPED_HEADER_SIZE % alignof(record_type) == 0,
+            "The header would misalign the nodes.");
+
+        const std::uint64_t size = tree.size();
+
+        unsigned char header[binary_format::MAPPED_HEADER_SIZE] = {};
+        std::memcpy(header, binary_format::MAPPED_MAGIC, sizeof(binary_format::MAPPED_MAGIC));
+        header[4] = binary_format::VERSION;
+        header[5] = binary_format::is_big_endian() ? binary_format::BIG_ENDIAN_FLAG : 0u;
+        binary_format::write_integer(header + 8u, size);
+        binary_format::write_integer(header + 16u, tree.arity());
+        binary_format::write_integer(header + 24u, sizeof(record_type), 4u);
+        binary_format::write_integer(header + 28u, sizeof(value_type), 4u);
+        this->write_bytes(header, binary_format::MAPPED_HEADER_SIZE);
+        if (size == 0u) {
+            return;
+        }
+
+        const Node* root                               = tree.raw_root_node();
+        const std::vector<std::uint64_t> subtree_sizes = calculate_subtree_sizes(root, size);
+        // Rank of each ancestor of the current node and rank of the last child written for it (0 if none)
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> ancestors;
+        const Node* node   = root;
+        std::uint64_t rank = 0u;
+        while (node != nullptr) {
+            std::uint64_t parent_distance       = 0u;
+            std::uint64_t prev_sibling_distance = 0u;
+            std::uint64_t last_child_distance   = 0u;
+            if (!ancestors.empty()) {
+                auto& [parent_rank, last_written] = ancestors.back();
+                parent_distance                   = rank - parent_rank;
+                prev_sibling_distance             = last_written ? rank - last_written : 0u;
+                last_written                      = rank;
+            }
+            if (subtree_sizes[rank] > 1u) {
+                // Skip the subtrees of the children until the last one
+                const std::uint64_t end = rank + subtree_sizes[rank];
+                std::uint64_t child     = rank + 1u;
+                while (child + subtree_sizes[child] < end) {
+                    child += subtree_sizes[child];
+                }
+                last_child_distance = child - rank;
+            }
+            alignas(record_type) unsigned char record[sizeof(record_type)] = {};
+            new (record) record_type(
+                node->get_value(),
+                parent_distance,
+                prev_sibling_distance,
+                last_child_distance,
+                subtree_sizes[rank],
+                node != root ? node->following_siblings() : 0u);
+            this->write_bytes(record, sizeof(record_type));
+            // Next node in pre-order, never leaving the subtree of root
+            ++rank;
+            if (node->get_first_child()) {
+                ancestors.emplace_back(rank - 1u, 0u);
+                node = node->get_first_child();
+                continue;
+            }
+            while (node != root && node->get_next_sibling() == nullptr) {
+                node = node->get_parent();
+                ancestors.pop_back();
+            }
+            node = node != root ? node->get_next_sibling() : nullptr;
+        }
+    }
+
+    protected:
+    template <typename Node>
+    static std::vector<std::uint64_t> calculate_subtree_sizes(const Node* root, std::uint64_t size) {
+        std::vector<std::uint64_t> result(size, 1u);
+        std::vector<std::uint64_t> ancestors;
+        const Node* node   = root;
+        std::uint64_t rank = 0u;
+        while (node != nullptr) {
+            if (node->get_first_child()) {
+                ancestors.push_back(rank++);
+                node = node->get_first_child();
+                continue;
+            }
+            // The subtree of each ancestor climbed ends with this node
+            while (node != root && node->get_next_sibling() == nullptr) {
+                node                     = node->get_parent();
+                result[ancestors.back()] = rank + 1u - ancestors.back();
+                ancestors.pop_back();
+            }
+            node = node != root ? node->get_next_sibling() : nullptr;
+            ++rank;
+        }
+        return result;
+    }
+};
+
+} // namespace md
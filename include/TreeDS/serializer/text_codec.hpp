@@ -0,0 +1,221 @@
+#pragma once
+
+#include <charconv>    // std::to_chars(), std::from_chars()
+#include <cstddef>     // std::size_t
+#include <cstdio>      // EOF
+#include <stdexcept>   // std::invalid_argument
+#include <string>      // std::basic_string
+#include <string_view>
+#include <type_traits> // std::is_arithmetic_v, std::enable_if_t
+
+namespace md {
+
+/**
+ * @brief Describes how values of type T are formatted and parsed in the n(...) notation.
+ * @details A codec has two functions: <code>write(Writer&, const T&)</code> and <code>T read(Reader&)</code>. The
+ * writer offers <code>write_text(const char*, std::size_t)</code> and <code>write_char(char)</code>, the reader offers
+ * <code>peek()</code> and <code>get()</code> (both return the character as an int, or EOF at the end of the stream)
+ * and <code>expect(char)</code>. A value starts right after the opening parenthesis of its node and must leave the
+ * reader on the closing one. Users can specialize this template or pass any object having the same interface to
+ * {@link text_writer} and {@link text_reader}.
+ *
+ * Numbers are written with std::to_chars (shortest round-trip representation), booleans as true/false, characters
+ * and strings quoted as in C++ source code.
+ *
+ * @tparam T the type of the values
+ */
+template <typename T, typename = void>
+struct text_codec {
+    static_assert(
+        std::is_arithmetic_v<T>,
+        "No text_codec for this type: specialize md::text_codec or provide a custom codec.");
+};
+
+namespace detail {
+    // Unquoted values end at the closing parenthesis of their node or at a whitespace
+    inline bool is_token_end(int c) {
+        return c == ')' || c == EOF || c == ' ' || c == '\n' || c == '\t' || c == '\r';
+    }
+
+    template <typename Reader>
+    std::size_t read_token(Reader& reader, char* buffer, std::size_t capacity) {
+        std::size_t length = 0u;
+        while (!is_token_end(reader.peek())) {
+            if (length == capacity) {
+                throw std::invalid_argument("Value too long in the text.");
+            }
+            buffer[length++] = static_cast<char>(reader.get());
+        }
+        return length;
+    }
+
+    template <typename Writer>
+    void write_escaped(Writer& writer, char c, char quote) {
+        constexpr char digits[] = "0123456789abcdef";
+        switch (c) {
+        case '\n':
+            writer.write_text("\\n", 2u);
+            break;
+        case '\t':
+            writer.write_text("\\t", 2u);
+            break;
+        case '\r':
+            writer.write_text("\\r", 2u);
+            break;
+        case '\\':
+            writer.write_text("\\\\", 2u);
+            break;
+        default:
+            if (c == quote) {
+                writer.write_char('\\');
+                writer.write_char(c);
+            } else if (static_cast<unsigned char>(c) < 0x20u || c == 0x7F) {
+                const char escape[4] = {
+                    '\\',
+                    'x',
+                    digits[static_cast<unsigned char>(c) >> 4],
+                    digits[static_cast<unsigned char>(c) & 0xFu]};
+                writer.write_text(escape, 4u);
+            } else {
+                writer.write_char(c);
+            }
+        }
+    }
+
+    inline int hex_digit_value(int c) {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        throw std::invalid_argument("Invalid hexadecimal digit in an escape sequence.");
+    }
+
+    template <typename Reader>
+    char read_escaped(Reader& reader) {
+        int c = reader.get();
+        if (c == '\\') {
+            c = reader.get();
+            switch (c) {
+            case 'n':
+                return '\n';
+            case 't':
+                return '\t';
+            case 'r':
+                return '\r';
+            case '0':
+                return '\0';
+            case 'x': {
+                int high = hex_digit_value(reader.get());
+                return static_cast<char>(high * 16 + hex_digit_value(reader.get()));
+            }
+            case '\\':
+            case '\'':
+            case '"':
+                return static_cast<char>(c);
+            default:
+                throw std::invalid_argument("Invalid escape sequence.");
+            }
+        }
+        if (c == EOF) {
+            throw std::invalid_argument("Unexpected end of the text while reading a quoted value.");
+        }
+        return static_cast<char>(c);
+    }
+} // namespace detail
+
+template <typename T>
+struct text_codec<T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>>> {
+
+    template <typename Writer>
+    void write(Writer& writer, T value) const {
+        char buffer[64];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        writer.write_text(buffer, static_cast<std::size_t>(result.ptr - buffer));
+    }
+
+    template <typename Reader>
+    T read(Reader& reader) const {
+        char buffer[64];
+        std::size_t length = detail::read_token(reader, buffer, sizeof(buffer));
+        T value {};
+        auto result = std::from_chars(buffer, buffer + length, value);
+        if (length == 0u || result.ec != std::errc() || result.ptr != buffer + length) {
+            throw std::invalid_argument("Invalid number in the text.");
+        }
+        return value;
+    }
+};
+
+template <>
+struct text_codec<bool> {
+
+    template <typename Writer>
+    void write(Writer& writer, bool value) const {
+        if (value) {
+            writer.write_text("true", 4u);
+        } else {
+            writer.write_text("false", 5u);
+        }
+    }
+
+    template <typename Reader>
+    bool read(Reader& reader) const {
+        char buffer[5];
+        const std::string_view text(buffer, detail::read_token(reader, buffer, sizeof(buffer)));
+        if (text == "true") {
+            return true;
+        } else if (text == "false") {
+            return false;
+        }
+        throw std::invalid_argument("Invalid boolean in the text.");
+    }
+};
+
+template <>
+struct text_codec<char> {
+
+    template <typename Writer>
+    void write(Writer& writer, char value) const {
+        writer.write_char('\'');
+        detail::write_escaped(writer, value, '\'');
+        writer.write_char('\'');
+    }
+
+    template <typename Reader>
+    char read(Reader& reader) const {
+        reader.expect('\'');
+        char value = detail::read_escaped(reader);
+        reader.expect('\'');
+        return value;
+    }
+};
+
+template <typename Traits, typename Allocator>
+struct text_codec<std::basic_string<char, Traits, Allocator>> {
+    using string_type = std::basic_string<char, Traits, Allocator>;
+
+    template <typename Writer>
+    void write(Writer& writer, const string_type& value) const {
+        writer.write_char('"');
+        for (char c : value) {
+            detail::write_escaped(writer, c, '"');
+        }
+        writer.write_char('"');
+    }
+
+    template <typename Reader>
+    string_type read(Reader& reader) const {
+        string_type value;
+        reader.expect('"');
+        while (reader.peek() != '"') {
+            value.push_back(detail::read_escaped(reader));
+        }
+        reader.get();
+        return value;
+    }
+};
+
+} // namespace md
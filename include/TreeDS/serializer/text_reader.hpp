@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstddef>     // std::size_t
+#include <cstdio>      // EOF
+#include <istream>     // std::istream
+#include <stdexcept>   // std::invalid_argument
+#include <string>      // std::to_string()
+#include <type_traits> // std::is_same_v
+#include <utility>     // std::move()
+#include <vector>
+
+#include <TreeDS/serializer/text_codec.hpp>
+#include <TreeDS/tree_builder.hpp>
+
+namespace md {
+
+/**
+ * @brief Parses trees written in the n(...) notation, like the ones produced by {@link text_writer}.
+ * @details The text is read from the stream through a fixed size buffer and the nodes are linked by a
+ * {@link tree_builder} as soon as their value is parsed, without recursion. Whitespaces are allowed between the
+ * tokens. For binary trees, <code>n()</code> leaves a child position empty (as in the code notation), a node with a
+ * single child gets it as the left one. Many trees can be read one after the other from the same stream.
+ */
+class text_reader {
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    std::istream& stream;
+    std::vector<char> buffer;
+    std::size_t position = 0u;
+    std::size_t limit    = 0u;
+    /// @brief Number of characters consumed before the current buffer, used for error messages.
+    std::size_t offset = 0u;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    explicit text_reader(std::istream& stream, std::size_t buffer_size = 1u << 16) :
+            stream(stream),
+            buffer(buffer_size < 1u ? 1u : buffer_size) {
+    }
+
+    text_reader(const text_reader&) = delete;
+
+    /*   ---   METHODS   ---   */
+    protected:
+    bool fill() {
+        this->offset += this->limit;
+        this->stream.read(this->buffer.data(), static_cast<std::streamsize>(this->buffer.size()));
+        this->position = 0u;
+        this->limit    = static_cast<std::size_t>(this->stream.gcount());
+        return this->limit > 0u;
+    }
+
+    [[noreturn]] void unexpected(const char* expected) {
+        int c = this->peek();
+        throw std::invalid_argument(
+            std::string("Expected ") + expected + " at offset " + std::to_string(this->tell()) + " but found "
+            + (c == EOF ? std::string("the end of the text") : std::string("'") + static_cast<char>(c) + "'")
+            + ".");
+    }
+
+    public:
+    /// @brief Returns the next character without consuming it, or EOF at the end of the stream.
+    int peek() {
+        if (this->position == this->limit && !this->fill()) {
+            return EOF;
+        }
+        return static_cast<unsigned char>(this->buffer[this->position]);
+    }
+
+    /// @brief Consumes and returns the next character, or EOF at the end of the stream.
+    int get() {
+        int result = this->peek();
+        if (result != EOF) {
+            ++this->position;
+        }
+        return result;
+    }
+
+    /// @brief Consumes the next character that must be c.
+    void expect(char c) {
+        if (this->peek() != static_cast<unsigned char>(c)) {
+            const char expected[] = {'\'', c, '\'', '\0'};
+            this->unexpected(expected);
+        }
+        ++this->position;
+    }
+
+    void skip_whitespaces() {
+        for (int c = this->peek(); c == ' ' || c == '\n' || c == '\t' || c == '\r'; c = this->peek()) {
+            ++this->position;
+        }
+    }
+
+    /// @brief Number of characters consumed so far.
+    std::size_t tell() const {
+        return this->offset + this->position;
+    }
+
+    /**
+     * @brief Reads the next tree from the stream.
+     * @param codec the object used to parse the values, see {@link text_codec}
+     * @param allocator the allocator used by the tree returned
+     * @throw std::invalid_argument if the text is not a valid tree
+     * @throw std::logic_error if a node has more than 2 children and Tree is a binary tree
+     */
+    template <typename Tree, typename Codec = text_codec<typename Tree::value_type>>
+    Tree read(const Codec& codec = Codec(), const typename Tree::allocator_type& allocator = {}) {
+        constexpr bool to_binary
+            = std::is_same_v<std::decay_t<typename Tree::node_type>, binary_node<typename Tree::value_type>>;
+        tree_builder<Tree> builder(allocator);
+        this->skip_whitespaces();
+        while (true) {
+            // Node: n(value) optionally followed by (children)
+            this->expect('n');
+            this->skip_whitespaces();
+            this->expect('(');
+            this->skip_whitespaces();
+            if (this->peek() == ')') {
+                ++this->position;
+                if (builder.depth() == 0u) {
+                    return builder.build();
+                }
+                if constexpr (to_binary) {
+                    builder.skip();
+                } else {
+                    throw std::invalid_argument(
+                        "Empty node at offset " + std::to_string(this->tell()) + ", it is allowed only in binary trees.");
+                }
+            } else {
+                auto value = codec.read(*this);
+                this->skip_whitespaces();
+                this->expect(')');
+                this->skip_whitespaces();
+                if (this->peek() == '(') {
+                    ++this->position;
+                    builder.open(std::move(value));
+                    this->skip_whitespaces();
+                    continue;
+                }
+                builder.leaf(std::move(value));
+            }
+            // Either the next sibling or the end of the children of some nodes
+            while (builder.depth() > 0u) {
+                this->skip_whitespaces();
+                int c = this->peek();
+                if (c == ',') {
+                    ++this->position;
+                    this->skip_whitespaces();
+                    break;
+                } else if (c == ')') {
+                    ++this->position;
+                    builder.close();
+                } else {
+                    this->unexpected("',' or ')'");
+                }
+            }
+            if (builder.depth() == 0u) {
+                return builder.build();
+            }
+        }
+    }
+};
+
+} // namespace md
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>     // std::size_t
+#include <cstring>     // std::memcpy()
+#include <ostream>     // std::ostream
+#include <stdexcept>   // std::runtime_error
+#include <type_traits> // std::is_same_v, std::decay_t
+#include <vector>
+
+#include <TreeDS/node/binary_node.hpp>
+#include <TreeDS/serializer/text_codec.hpp>
+#include <TreeDS/tree_base.hpp>
+
+namespace md {
+
+/**
+ * @brief Formats trees in the same n(...) notation used to construct them in code.
+ * @details Unlike {@link print_tree}, which is meant for debugging, this writer has no limit on the number of nodes,
+ * does not recur and writes the text in a fixed size buffer that is flushed to the stream when full, when
+ * {@link #flush()} is called and when the writer is destroyed. The text can be read back by {@link text_reader}.
+ *
+ * With an indentation of 0 each tree is written on a single line:
+ * <code>n('a')(n('b'), n('c')(n('d')))</code>, otherwise each child starts on a new line, indented by the given
+ * number of spaces more than its parent. A binary node having only the right child is written with an empty left
+ * child: <code>n(1)(n(), n(2))</code>.
+ */
+class text_writer {
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    std::ostream& stream;
+    std::vector<char> buffer;
+    std::size_t position = 0u;
+    unsigned indentation;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    explicit text_writer(std::ostream& stream, unsigned indentation = 0u, std::size_t buffer_size = 1u << 16) :
+            stream(stream),
+            buffer(buffer_size < 64u ? 64u : buffer_size),
+            indentation(indentation) {
+    }
+
+    text_writer(const text_writer&) = delete;
+
+    ~text_writer() {
+        // Destructors must not throw, errors are visible on the stream state anyway
+        this->stream.write(this->buffer.data(), static_cast<std::streamsize>(this->position));
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    /**
+     * @brief Writes the content of the buffer to the stream.
+     * @throw std::runtime_error if the stream is in a failure state
+     */
+    void flush() {
+        this->stream.write(this->buffer.data(), static_cast<std::streamsize>(this->position));
+        this->position = 0u;
+        if (!this->stream) {
+            throw std::runtime_error("Failed to write the formatted tree to the stream.");
+        }
+    }
+
+    void write_text(const char* text, std::size_t count) {
+        while (this->buffer.size() - this->position < count) {
+            std::size_t available = this->buffer.size() - this->position;
+            std::memcpy(this->buffer.data() + this->position, text, available);
+            this->position = this->buffer.size();
+            text += available;
+            count -= available;
+            this->flush();
+        }
+        std::memcpy(this->buffer.data() + this->position, text, count);
+        this->position += count;
+    }
+
+    void write_char(char c) {
+        if (this->position == this->buffer.size()) {
+            this->flush();
+        }
+        this->buffer[this->position++] = c;
+    }
+
+    /**
+     * @brief Writes a tree (or a view) to the stream.
+     * @param tree the tree to write
+     * @param codec the object used to format the values, see {@link text_codec}
+     */
+    template <
+        typename Node,
+        typename Policy,
+        typename Allocator,
+        typename Codec = text_codec<std::decay_t<node_value_t<Node>>>>
+    void write(const tree_base<Node, Policy, Allocator>& tree, const Codec& codec = Codec()) {
+        constexpr bool is_binary = std::is_same_v<std::decay_t<Node>, binary_node<std::decay_t<node_value_t<Node>>>>;
+        const Node* root         = tree.raw_root_node();
+        const Node* node         = root;
+        std::size_t depth        = 0u;
+        if (root == nullptr) {
+            this->write_text("n()", 3u);
+        }
+        while (node != nullptr) {
+            this->write_text("n(", 2u);
+            codec.write(*this, node->get_value());
+            this->write_char(')');
+            if (node->get_first_child()) {
+                this->write_char('(');
+                this->write_separator(++depth, false);
+                node = node->get_first_child();
+                if constexpr (is_binary) {
+                    if (node->is_right_child()) {
+                        this->write_text("n()", 3u);
+                        this->write_separator(depth, true);
+                    }
+                }
+                continue;
+            }
+            // Close the children lists ended by this node, never leaving the subtree of root
+            while (node != root && node->get_next_sibling() == nullptr) {
+                this->write_char(')');
+                node = node->get_parent();
+                --depth;
+            }
+            if (node == root) {
+                break;
+            }
+            this->write_separator(depth, true);
+            node = node->get_next_sibling();
+        }
+    }
+
+    protected:
+    void write_separator(std::size_t depth, bool comma) {
+        if (comma) {
+            this->write_char(',');
+        }
+        if (this->indentation == 0u) {
+            if (comma) {
+                this->write_char(' ');
+            }
+            return;
+        }
+        this->write_char('\n');
+        for (std::size_t spaces = depth * this->indentation; spaces > 0u; --spaces) {
+            this->write_char(' ');
+        }
+    }
+};
+
+} // namespace md
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>   // std::min()
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint64_t
+#include <string>      // std::basic_string
+#include <type_traits> // std::is_trivially_copyable_v, std::enable_if_t
+
+namespace md {
+
+/**
+ * @brief Describes how values of type T are written to and read from the binary format.
+ * @details A codec has two functions: <code>write(Writer&, const T&)</code> and <code>T read(Reader&)</code>. The
+ * writer offers <code>write_bytes(const void*, std::size_t)</code> and <code>write_varint(std::uint64_t)</code>, the
+ * reader offers the corresponding <code>read_bytes(void*, std::size_t)</code> and <code>read_varint()</code>. Users
+ * can specialize this template for their types or pass any other object having the same interface to the
+ * {@link binary_writer} and the {@link binary_reader}.
+ *
+ * Trivially copyable types are written as raw bytes, in the byte order of the machine that wrote the file.
+ *
+ * @tparam T the type of the values
+ */
+template <typename T, typename = void>
+struct value_codec {
+    static_assert(
+        std::is_trivially_copyable_v<T>,
+        "No value_codec for this type: specialize md::value_codec or provide a custom codec.");
+};
+
+template <typename T>
+struct value_codec<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+
+    template <typename Writer>
+    void write(Writer& writer, const T& value) const {
+        writer.write_bytes(&value, sizeof(T));
+    }
+
+    template <typename Reader>
+    T read(Reader& reader) const {
+        T value;
+        reader.read_bytes(&value, sizeof(T));
+        return value;
+    }
+};
+
+/// @brief Strings are written as their length followed by their characters.
+template <typename Char, typename Traits, typename Allocator>
+struct value_codec<std::basic_string<Char, Traits, Allocator>> {
+    using string_type = std::basic_string<Char, Traits, Allocator>;
+
+    /// @brief Characters read at a time, the memory allocated is bounded by the input actually available.
+    static constexpr std::size_t CHUNK_SIZE = 4096u;
+
+    template <typename Writer>
+    void write(Writer& writer, const string_type& value) const {
+        writer.write_varint(value.size());
+        writer.write_bytes(value.data(), value.size() * sizeof(Char));
+    }
+
+    template <typename Reader>
+    string_type read(Reader& reader) const {
+        // The declared length comes from the input: the string grows while its characters are read
+        const std::uint64_t length = reader.read_varint();
+        string_type value;
+        while (value.size() < length) {
+            const std::size_t offset = value.size();
+            const std::size_t count  = static_cast<std::size_t>(std::min<std::uint64_t>(length - offset, CHUNK_SIZE));
+            value.resize(offset + count);
+            reader.read_bytes(value.data() + offset, count * sizeof(Char));
+        }
+        return value;
+    }
+};
+
+} // namespace md
@@ -0,0 +1,609 @@
+#pragma once
+
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <functional>  // std::hash
+#include <iterator>    // std::forward_iterator_tag
+#include <memory>      // std::allocator, std::allocator_traits
+#include <stdexcept>   // std::invalid_argument
+#include <type_traits> // std::is_convertible_v, std::enable_if_t
+#include <unordered_map>
+#include <utility> // std::move(), std::forward(), std::declval(), std::pair
+#include <vector>
+
+#include <TreeDS/allocator_utility.hpp>
+#include <TreeDS/nary_tree.hpp>
+#include <TreeDS/node/navigator/shared_navigator.hpp>
+#include <TreeDS/node/shared_node.hpp>
+#include <TreeDS/node/struct_node.hpp>
+#include <TreeDS/policy/fixed.hpp>
+#include <TreeDS/tree_builder.hpp>
+#include <TreeDS/utility.hpp>
+
+namespace md {
+
+/**
+ * @brief Constant iterator over the expanded tree of a {@link shared_tree}.
+ * @details It wraps an instance of the traversal policy working on {@link shared_node_pointer}, therefore every node
+ * is visited once for each of its occurrences.
+ */
+template <typename Tree, typename Policy>
+class shared_tree_iterator {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = const typename Tree::value_type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = value_type*;
+    using reference         = value_type&;
+    using node_pointer      = typename Tree::node_pointer;
+    using navigator_type    = typename Tree::navigator_type;
+    using actual_policy     = decltype(std::declval<Policy>().get_instance(
+        std::declval<node_pointer>(),
+        std::declval<navigator_type>(),
+        std::declval<typename Tree::allocator_type>()));
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    const Tree* tree = nullptr;
+    actual_policy policy;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    shared_tree_iterator() {
+    }
+
+    shared_tree_iterator(const Tree& tree, const node_pointer& current) :
+            tree(&tree),
+            policy(Policy().get_instance(
+                current,
+                navigator_type(node_pointer(tree.raw_root_node())),
+                tree.get_allocator())) {
+    }
+
+    /*   ---   METHODS   ---   */
+    public:
+    node_pointer get_node_pointer() const {
+        return this->policy.get_current_node();
+    }
+
+    reference operator*() const {
+        return this->policy.get_current_node().get_value();
+    }
+
+    pointer operator->() const {
+        return &**this;
+    }
+
+    shared_tree_iterator& operator++() {
+        if (this->policy.get_current_node()) {
+            this->policy.increment();
+        } else if (this->tree != nullptr && this->tree->raw_root_node() != nullptr) {
+            // Incremented from end(), go to the first element
+            this->policy.go_first();
+        }
+        return *this;
+    }
+
+    shared_tree_iterator operator++(int) {
+        shared_tree_iterator it(*this);
+        this->operator++();
+        return it;
+    }
+
+    bool operator==(const shared_tree_iterator& other) const {
+        return this->tree == other.tree && this->policy.get_current_node() == other.policy.get_current_node();
+    }
+
+    bool operator!=(const shared_tree_iterator& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief N-ary tree that stores every distinct subtree once, as a DAG of {@link shared_node}.
+ * @details Identical subtrees (same values, same shape) are interned into a single node kept alive by a reference
+ * count, which makes the memory proportional to the number of distinct subtrees rather than to the number of nodes.
+ * Trees with many repetitions (ASTs with repeated expressions, generated documents, configurations) shrink by orders
+ * of magnitude. The tree is iterated as if it was expanded: iterators take the same policies of any other tree and walk
+ * through a {@link shared_navigator}. A step costs several times more than on an nary_tree because the position carries
+ * the path and descending allocates a frame for it, the tree trades traversal speed for memory.
+ *
+ * Nodes are never modified in place. Modifying a node through {@link #insert_over()}, {@link #emplace_over()},
+ * {@link #insert_child_back()} and the like creates again (copy on write) the path from that node to the root, the
+ * other occurrences of the subtrees along the path are left untouched. The new nodes are interned as well, thus the
+ * tree stays maximally shared. Iterators are invalidated by any modification, the ones returned point into the new
+ * tree.
+ *
+ * @code
+ * shared_tree<char> t(n('a')(n('b')(n('c')), n('b')(n('c'))));
+ * t.size();          // 5
+ * t.distinct_size(); // 3: a, b(c), c
+ * nary_tree<char> expanded = t.expand();
+ * @endcode
+ *
+ * @tparam T the type of value hold by this tree, it must be equality comparable
+ * @tparam Policy default traversal algorithm
+ * @tparam Allocator the allocater used to allocate nodes
+ * @tparam Hash hash function of the values
+ */
+template <
+    typename T,
+    typename Policy    = default_policy,
+    typename Allocator = std::allocator<T>,
+    typename Hash      = std::hash<T>>
+class shared_tree {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using value_type          = T;
+    using const_reference     = const T&;
+    using size_type           = std::size_t;
+    using node_type           = shared_node<T>;
+    using node_pointer        = shared_node_pointer<T>;
+    using navigator_type      = shared_navigator<T>;
+    using policy_type         = Policy;
+    using allocator_type      = Allocator;
+    using node_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<node_type>;
+    template <typename P>
+    using const_iterator = shared_tree_iterator<shared_tree, P>;
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    node_allocator_type allocator;
+    Hash hasher;
+    /// @brief Every distinct node of the tree, by the hash of its subtree.
+    std::unordered_multimap<std::size_t, node_type*> interned;
+    node_type* root_node = nullptr;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    explicit shared_tree(const Allocator& allocator = Allocator(), const Hash& hasher = Hash()) :
+            allocator(allocator),
+            hasher(hasher) {
+    }
+
+    /// @brief Compresses the given tree, which is not modified.
+    template <typename OtherPolicy, typename OtherAllocator>
+    explicit shared_tree(
+        const nary_tree<T, OtherPolicy, OtherAllocator>& tree,
+        const Allocator& allocator = Allocator(),
+        const Hash& hasher         = Hash()) :
+            allocator(allocator),
+            hasher(hasher) {
+        if (tree.raw_root_node() != nullptr) {
+            this->root_node = this->intern_subtree(*tree.raw_root_node());
+        }
+    }
+
+    template <
+        typename ConvertibleV,
+        typename... Children,
+        typename = std::enable_if_t<std::is_convertible_v<ConvertibleV, value_type>>>
+    shared_tree(const struct_node<ConvertibleV, Children...>& root) :
+            shared_tree(nary_tree<T, Policy, Allocator>(root)) {
+    }
+
+    shared_tree(const shared_tree& other) :
+            allocator(other.allocator),
+            hasher(other.hasher) {
+        if (other.root_node != nullptr) {
+            this->root_node = this->copy_subtree(other.root_node);
+        }
+    }
+
+    shared_tree(shared_tree&& other) :
+            allocator(std::move(other.allocator)),
+            hasher(std::move(other.hasher)),
+            interned(std::move(other.interned)),
+            root_node(other.root_node) {
+        other.interned.clear();
+        other.root_node = nullptr;
+    }
+
+    ~shared_tree() {
+        this->clear();
+    }
+
+    /*   ---   ASSIGNMENT   ---   */
+    shared_tree& operator=(const shared_tree& other) {
+        if (this != &other) {
+            shared_tree copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    shared_tree& operator=(shared_tree&& other) {
+        if (this != &other) {
+            this->clear();
+            // The nodes are released by the allocator that created them
+            this->allocator = std::move(other.allocator);
+            this->hasher    = std::move(other.hasher);
+            this->interned  = std::move(other.interned);
+            this->root_node = other.root_node;
+            other.interned.clear();
+            other.root_node = nullptr;
+        }
+        return *this;
+    }
+
+    /*   ---   METHODS   ---   */
+    protected:
+    /*
+     * Returns the node having the given value and children, creating it if no such node exists. The caller gives away
+     * one reference to each child and receives one reference to the node returned.
+     */
+    node_type* intern(T&& value, std::vector<node_type*>&& children) {
+        std::size_t hash = this->hasher(value);
+        std::size_t size = 1u;
+        for (node_type* child : children) {
+            hash = detail::hash_combine(hash, child->hash_value);
+            size += child->subtree_size;
+        }
+        hash       = detail::hash_combine(hash, children.size());
+        auto range = this->interned.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            node_type* candidate = it->second;
+            if (candidate->children == children && candidate->value == value) {
+                // The candidate already holds its own references to the children
+                for (node_type* child : children) {
+                    --child->references;
+                }
+                ++candidate->references;
+                return candidate;
+            }
+        }
+        node_type* result   = allocate(this->allocator, std::move(children), std::move(value)).release();
+        result->hash_value   = hash;
+        result->subtree_size = size;
+        result->references   = 1u;
+        this->interned.emplace(hash, result);
+        return result;
+    }
+
+    // Drops one reference to the node, destroying the nodes that are no more referenced
+    void release(node_type* node) {
+        if (node == nullptr || --node->references > 0u) {
+            return;
+        }
+        std::vector<node_type*> unreferenced {node};
+        while (!unreferenced.empty()) {
+            node_type* current = unreferenced.back();
+            unreferenced.pop_back();
+            auto range = this->interned.equal_range(current->hash_value);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == current) {
+                    this->interned.erase(it);
+                    break;
+                }
+            }
+            for (node_type* child : current->children) {
+                if (--child->references == 0u) {
+                    unreferenced.push_back(child);
+                }
+            }
+            deallocate(this->allocator, current);
+        }
+    }
+
+    // Interns every subtree of the given node, children before their parent
+    node_type* intern_subtree(const nary_node<T>& root) {
+        struct frame {
+            const nary_node<T>* node;
+            const nary_node<T>* next_child;
+            std::size_t first_result;
+        };
+        std::vector<node_type*> results;
+        std::vector<frame> stack {{&root, root.get_first_child(), 0u}};
+        while (!stack.empty()) {
+            frame& top = stack.back();
+            if (top.next_child != nullptr) {
+                const nary_node<T>* child = top.next_child;
+                top.next_child            = child->get_next_sibling();
+                stack.push_back({child, child->get_first_child(), results.size()});
+                continue;
+            }
+            std::vector<node_type*> children(results.begin() + top.first_result, results.end());
+            results.resize(top.first_result);
+            results.push_back(this->intern(T(top.node->get_value()), std::move(children)));
+            stack.pop_back();
+        }
+        return results.front();
+    }
+
+    // Copies the DAG of another tree node by node, it is already maximally shared
+    node_type* copy_subtree(const node_type* root) {
+        std::unordered_map<const node_type*, node_type*> copies;
+        std::vector<std::pair<const node_type*, std::size_t>> stack {{root, 0u}};
+        while (!stack.empty()) {
+            const node_type* node = stack.back().first;
+            std::size_t next      = stack.back().second;
+            if (next < node->children.size()) {
+                ++stack.back().second;
+                if (copies.count(node->children[next]) == 0u) {
+                    stack.emplace_back(node->children[next], 0u);
+                }
+                continue;
+            }
+            std::vector<node_type*> children;
+            children.reserve(node->children.size());
+            for (const node_type* child : node->children) {
+                children.push_back(copies.find(child)->second);
+            }
+            node_type* copy   = allocate(this->allocator, std::move(children), node->value).release();
+            copy->hash_value   = node->hash_value;
+            copy->subtree_size = node->subtree_size;
+            copy->references   = node->references.load();
+            this->interned.emplace(copy->hash_value, copy);
+            copies.emplace(node, copy);
+            stack.pop_back();
+        }
+        return copies.find(root)->second;
+    }
+
+    /*
+     * Replaces the subtree at position with replacement (the caller gives away its reference), or removes it if
+     * replacement is null. Every ancestor of position is interned again with the new child, the old path is released.
+     * Returns the pointer to the replacement in the new tree.
+     */
+    node_pointer replace(const node_pointer& position, node_type* replacement) {
+        if (!position) {
+            if (this->root_node == nullptr && replacement != nullptr) {
+                this->root_node = replacement;
+                return node_pointer(this->root_node);
+            }
+            this->release(replacement);
+            throw std::invalid_argument("Tried to modify a shared_tree at a position that is not a node.");
+        }
+        std::vector<node_pointer> path;
+        for (node_pointer node = position; node; node = node.get_parent()) {
+            path.push_back(node);
+        }
+        if (path.back().get_node() != this->root_node) {
+            this->release(replacement);
+            throw std::invalid_argument("Tried to modify a shared_tree through an iterator of another tree.");
+        }
+        node_type* current = replacement;
+        for (std::size_t i = 1u; i < path.size(); ++i) {
+            const node_type* parent = path[i].get_node();
+            const std::size_t index = path[i - 1u].get_index();
+            std::vector<node_type*> children;
+            children.reserve(parent->children.size());
+            for (std::size_t j = 0u; j < parent->children.size(); ++j) {
+                if (j != index) {
+                    ++parent->children[j]->references;
+                    children.push_back(parent->children[j]);
+                } else if (current != nullptr) {
+                    children.push_back(current);
+                }
+            }
+            current = this->intern(T(parent->value), std::move(children));
+        }
+        this->release(this->root_node);
+        this->root_node = current;
+        if (replacement == nullptr) {
+            return node_pointer();
+        }
+        node_pointer result(this->root_node);
+        for (std::size_t i = path.size() - 1u; i-- > 0u;) {
+            result = result.get_child(path[i].get_index());
+        }
+        return result;
+    }
+
+    // Replaces the node at position with a copy having child as first or last child
+    template <bool Front>
+    node_pointer add_child(const node_pointer& position, node_type* child) {
+        if (!position) {
+            this->release(child);
+            throw std::invalid_argument("Tried to modify a shared_tree at a position that is not a node.");
+        }
+        const node_type* node = position.get_node();
+        std::vector<node_type*> children;
+        children.reserve(node->children.size() + 1u);
+        if (Front) {
+            children.push_back(child);
+        }
+        for (node_type* other : node->children) {
+            ++other->references;
+            children.push_back(other);
+        }
+        if (!Front) {
+            children.push_back(child);
+        }
+        node_type* replacement = this->intern(T(node->value), std::move(children));
+        node_pointer result    = this->replace(position, replacement);
+        return Front ? result.get_first_child() : result.get_last_child();
+    }
+
+    template <typename ConvertibleV, typename... Children>
+    node_type* intern_struct(const struct_node<ConvertibleV, Children...>& node) {
+        nary_tree<T, Policy, Allocator> tree(node);
+        return this->intern_subtree(*tree.raw_root_node());
+    }
+
+    public:
+    template <typename P = Policy>
+    const_iterator<P> begin(P = P()) const {
+        return ++const_iterator<P>(*this, node_pointer());
+    }
+
+    template <typename P = Policy>
+    const_iterator<P> end(P = P()) const {
+        return const_iterator<P>(*this, node_pointer());
+    }
+
+    const_iterator<policy::fixed> root() const {
+        return const_iterator<policy::fixed>(*this, node_pointer(this->root_node));
+    }
+
+    /// @brief Replaces the subtree at position with a single node having the given value.
+    template <typename P>
+    const_iterator<P> insert_over(const const_iterator<P>& position, const T& value) {
+        node_type* node = this->intern(T(value), {});
+        return const_iterator<P>(*this, this->replace(position.get_node_pointer(), node));
+    }
+
+    /// @brief Replaces the subtree at position with the given structure.
+    template <
+        typename P,
+        typename ConvertibleV,
+        typename... Children,
+        typename = std::enable_if_t<std::is_convertible_v<ConvertibleV, value_type>>>
+    const_iterator<P> insert_over(const const_iterator<P>& position, const struct_node<ConvertibleV, Children...>& node) {
+        node_type* subtree = this->intern_struct(node);
+        return const_iterator<P>(*this, this->replace(position.get_node_pointer(), subtree));
+    }
+
+    template <typename P, typename... Args>
+    const_iterator<P> emplace_over(const const_iterator<P>& position, Args&&... args) {
+        node_type* node = this->intern(T(std::forward<Args>(args)...), {});
+        return const_iterator<P>(*this, this->replace(position.get_node_pointer(), node));
+    }
+
+    template <typename P>
+    const_iterator<P> insert_child_front(const const_iterator<P>& position, const T& value) {
+        node_type* child = this->intern(T(value), {});
+        return const_iterator<P>(*this, this->template add_child<true>(position.get_node_pointer(), child));
+    }
+
+    template <
+        typename P,
+        typename ConvertibleV,
+        typename... Children,
+        typename = std::enable_if_t<std::is_convertible_v<ConvertibleV, value_type>>>
+    const_iterator<P> insert_child_front(
+        const const_iterator<P>& position,
+        const struct_node<ConvertibleV, Children...>& node) {
+        node_type* child = this->intern_struct(node);
+        return const_iterator<P>(*this, this->template add_child<true>(position.get_node_pointer(), child));
+    }
+
+    template <typename P, typename... Args>
+    const_iterator<P> emplace_child_front(const const_iterator<P>& position, Args&&... args) {
+        node_type* child = this->intern(T(std::forward<Args>(args)...), {});
+        return const_iterator<P>(*this, this->template add_child<true>(position.get_node_pointer(), child));
+    }
+
+    template <typename P>
+    const_iterator<P> insert_child_back(const const_iterator<P>& position, const T& value) {
+        node_type* child = this->intern(T(value), {});
+        return const_iterator<P>(*this, this->template add_child<false>(position.get_node_pointer(), child));
+    }
+
+    template <
+        typename P,
+        typename ConvertibleV,
+        typename... Children,
+        typename = std::enable_if_t<std::is_convertible_v<ConvertibleV, value_type>>>
+    const_iterator<P> insert_child_back(
+        const const_iterator<P>& position,
+        const struct_node<ConvertibleV, Children...>& node) {
+        node_type* child = this->intern_struct(node);
+        return const_iterator<P>(*this, this->template add_child<false>(position.get_node_pointer(), child));
+    }
+
+    template <typename P, typename... Args>
+    const_iterator<P> emplace_child_back(const const_iterator<P>& position, Args&&... args) {
+        node_type* child = this->intern(T(std::forward<Args>(args)...), {});
+        return const_iterator<P>(*this, this->template add_child<false>(position.get_node_pointer(), child));
+    }
+
+    /// @brief Removes the subtree at position.
+    template <typename P>
+    void erase(const const_iterator<P>& position) {
+        this->replace(position.get_node_pointer(), nullptr);
+    }
+
+    /// @brief Removes every node.
+    void clear() {
+        this->release(this->root_node);
+        this->root_node = nullptr;
+    }
+
+    /// @brief Decompresses the tree, each occurrence of a shared node becomes a distinct node.
+    nary_tree<T, Policy, Allocator> expand() const {
+        if (this->root_node == nullptr) {
+            return nary_tree<T, Policy, Allocator>();
+        }
+        tree_builder<nary_tree<T, Policy, Allocator>> builder;
+        std::vector<std::pair<const node_type*, std::size_t>> stack {{this->root_node, 0u}};
+        builder.open(this->root_node->value);
+        while (!stack.empty()) {
+            const node_type* node = stack.back().first;
+            std::size_t next      = stack.back().second;
+            if (next < node->children.size()) {
+                ++stack.back().second;
+                builder.open(node->children[next]->value);
+                stack.emplace_back(node->children[next], 0u);
+                continue;
+            }
+            builder.close();
+            stack.pop_back();
+        }
+        return builder.build();
+    }
+
+    /*   ---   GETTERS   ---   */
+    public:
+    const node_type* raw_root_node() const {
+        return this->root_node;
+    }
+
+    /// @brief Number of nodes of the expanded tree.
+    size_type size() const {
+        return this->root_node != nullptr ? this->root_node->subtree_size : 0u;
+    }
+
+    /// @brief Number of distinct subtrees, which is the number of nodes actually allocated.
+    size_type distinct_size() const {
+        return this->interned.size();
+    }
+
+    bool empty() const {
+        return this->root_node == nullptr;
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_type(this->allocator);
+    }
+
+    /*   ---   COMPARISON   ---   */
+    public:
+    /// @brief Whether the two trees, once expanded, are equal. Each pair of distinct nodes is compared once.
+    bool operator==(const shared_tree& other) const {
+        if (this->root_node == nullptr || other.root_node == nullptr) {
+            return this->root_node == other.root_node;
+        }
+        // Both trees are maximally shared: a node can be equal to only one node of the other tree
+        std::unordered_map<const node_type*, const node_type*> matched;
+        std::vector<std::pair<const node_type*, const node_type*>> pending {{this->root_node, other.root_node}};
+        while (!pending.empty()) {
+            auto [left, right] = pending.back();
+            pending.pop_back();
+            auto it = matched.find(left);
+            if (it != matched.end()) {
+                if (it->second != right) {
+                    return false;
+                }
+                continue;
+            }
+            if (left->hash_value != right->hash_value || left->subtree_size != right->subtree_size
+                || left->children.size() != right->children.size() || !(left->value == right->value)) {
+                return false;
+            }
+            matched.emplace(left, right);
+            for (std::size_t i = 0u; i < left->children.size(); ++i) {
+                pending.emplace_back(left->children[i], right->children[i]);
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const shared_tree& other) const {
+        return !(*this == other);
+    }
+};
+
+} // namespace md
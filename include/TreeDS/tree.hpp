@@ -1,12 +1,16 @@
 #pragma once
 
-#include <iterator>    // std::make_reverse_iterator
-#include <stdexcept>   // std::logic_error
+#include <algorithm>   // std::max()
+#include <iterator>    // std::make_reverse_iterator, std::size()
+#include <limits>      // std::numeric_limits
+#include <stdexcept>   // std::logic_error, std::invalid_argument
 #include <tuple>       // make_from_tuple
 #include <type_traits> // std::enable_if
 #include <utility>     // std::move(), std::forward()
+#include <vector>
 
 #include <TreeDS/allocator_utility.hpp>
+#include <TreeDS/change_log.hpp>
 #include <TreeDS/node/struct_node.hpp>
 #include <TreeDS/policy/post_order.hpp>
 #include <TreeDS/policy/pre_order.hpp>
@@ -43,6 +47,12 @@ class tree : public tree_base<Node, Policy, Allocator> {
     template <typename, typename, typename>
     friend class tree;
 
+    template <typename>
+    friend class tree_builder;
+
+    template <typename...>
+    friend class rewriter;
+
     /*   ---   TYPES   ---   */
     public:
     DECLARE_TREEDS_TYPES(Node, Policy, Allocator)
@@ -53,6 +63,11 @@ class tree : public tree_base<Node, Policy, Allocator> {
         is_tag_of_policy<Policy>,
         "\"Policy\" template parameter is expected to be an actual policy tag.");
 
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    // Receives the modifications, it belongs to this object and is neither copied nor moved with the nodes
+    change_log<Node>* changes = nullptr;
+
     /*   ---   CONSTRUCTORS   ---   */
     protected:
     tree(node_type* root, size_type size, size_type arity) :
@@ -279,6 +294,19 @@ class tree : public tree_base<Node, Policy, Allocator> {
         return iterator<policy::fixed>(*this, this->root_node, this->get_navigator());
     }
 
+    change_log<Node>* get_change_log() const {
+        return this->changes;
+    }
+
+    /**
+     * @brief Starts reporting the modifications of this tree to a log, or stops if it is null.
+     * @details The log must outlive the tree or be detached before being destroyed. Modifications of the values through
+     * iterators are not reported, use change_log::touch().
+     */
+    void set_change_log(change_log<Node>* log) {
+        this->changes = log;
+    }
+
     /*   ---   MODIFIERS   ---   */
     protected:
     unique_ptr_alloc<node_allocator_type> replace_node(
@@ -293,7 +321,10 @@ class tree : public tree_base<Node, Policy, Allocator> {
                 this->size_value  = replacement_size;
                 this->arity_value = replacement_arity;
             } else if (!replaced->has_children()) {
-                this->size_value += replacement_size - 1;
+                // A size of zero means unknown, it will be computed again when needed
+                if (this->size_value != 0u) {
+                    this->size_value += replacement_size - 1;
+                }
                 this->arity_value = 0u; // We don't have useful information
             } else {
                 this->size_value  = 0u;
@@ -324,7 +355,13 @@ class tree : public tree_base<Node, Policy, Allocator> {
             if (target == this->root_node) {
                 this->assign(replacement, replacement_size, replacement_arity);
             } else {
+                if (this->changes != nullptr) {
+                    this->changes->removing(*target);
+                }
                 this->replace_node(target, replacement, replacement_size, replacement_arity);
+                if (this->changes != nullptr && replacement != nullptr) {
+                    this->changes->inserted(*replacement);
+                }
             }
         } else if (this->root_node == nullptr) {
             this->assign(replacement, replacement_size, replacement_arity);
@@ -360,17 +397,62 @@ class tree : public tree_base<Node, Policy, Allocator> {
                 throw std::logic_error("Tried to add a children to a binary_node with 2 children.");
             }
         }
+        node_type* child = node.release();
         if constexpr (First) {
-            target->prepend_child(node.release());
+            target->prepend_child(child);
         } else {
-            target->append_child(node.release());
-        }
-        this->size_value += replacement_size;
-        // +1 because following_siblings() counts just the node that follow next
-        std::size_t local_arity = target->get_first_child()
-            ? target->get_first_child()->following_siblings() + 1
-            : 1u;
-        this->arity_value = std::max(replacement_arity, std::max(this->arity_value, local_arity));
+            target->append_child(child);
+        }
+        return this->template child_added<P>(target, child, replacement_size, replacement_arity);
+    }
+
+    template <typename T, typename P, typename N>
+    iterator<P> add_child_at(
+        tree_iterator<T, P, N> position,
+        std::size_t index,
+        unique_ptr_alloc<node_allocator_type> node,
+        size_type replacement_size,
+        size_type replacement_arity) {
+        static_assert(
+            !std::is_same_v<std::decay_t<node_type>, binary_node<value_type>>,
+            "Children can be inserted at a given index only in an nary_tree.");
+        // See add_child() for the const_cast
+        node_type* target = const_cast<node_type*>(position.get_raw_node());
+        if (target == nullptr) {
+            throw std::logic_error("The iterator points to a non valid position (end).");
+        }
+        if (index > target->children()) {
+            throw std::logic_error("Tried to insert a child past the last child of the node.");
+        }
+        if (node == nullptr) {
+            return iterator<P>(*this, target, this->get_navigator());
+        }
+        node_type* child = node.release();
+        target->insert_child(child, index);
+        return this->template child_added<P>(target, child, replacement_size, replacement_arity);
+    }
+
+    // Bookkeeping after child has been linked to target
+    template <typename P>
+    iterator<P> child_added(
+        node_type* target,
+        node_type* child,
+        size_type replacement_size,
+        size_type replacement_arity) {
+        if (this->changes != nullptr && child != nullptr) {
+            this->changes->inserted(*child);
+        }
+        // Zero means unknown for both the size and the arity, they will be computed again when needed
+        if (this->size_value != 0u) {
+            this->size_value += replacement_size;
+        }
+        if (this->arity_value != 0u) {
+            // +1 because following_siblings() counts just the node that follow next
+            std::size_t local_arity = target->get_first_child()
+                ? target->get_first_child()->following_siblings() + 1
+                : 1u;
+            this->arity_value = std::max(replacement_arity, std::max(this->arity_value, local_arity));
+        }
         return iterator<P>(*this, target, this->get_navigator());
     }
 
@@ -390,6 +472,9 @@ class tree : public tree_base<Node, Policy, Allocator> {
             if (target == this->root_node) {
                 this->clear();
             } else {
+                if (this->changes != nullptr) {
+                    this->changes->removing(*target);
+                }
                 this->replace_node(target, nullptr, 0u, 0u);
             }
         } else if (this->root_node != nullptr) {
@@ -398,6 +483,9 @@ class tree : public tree_base<Node, Policy, Allocator> {
     }
 
     void assign(node_type* root, size_type size, size_type arity) {
+        if (this->changes != nullptr) {
+            this->changes->replaced();
+        }
         if (this->root_node != nullptr) {
             deallocate(this->allocator, this->root_node);
         }
@@ -408,12 +496,165 @@ class tree : public tree_base<Node, Policy, Allocator> {
     }
 
     void nullify() {
+        if (this->changes != nullptr) {
+            this->changes->replaced();
+        }
         this->root_node   = nullptr; // Weallocation was already node somewhere else
         this->size_value  = 0u;
         this->arity_value = 0u;
         this->navigator   = navigator_type();
     }
 
+    /*   ---   BULK CONSTRUCTION   ---   */
+    protected:
+    static constexpr size_type max_children() {
+        return std::is_same_v<std::decay_t<node_type>, binary_node<value_type>>
+            ? 2u
+            : std::numeric_limits<size_type>::max();
+    }
+
+    // Link child as the next child of parent, following is the number of siblings that will be linked after it
+    static void link_next_child(node_type& parent, node_type* child, size_type following) {
+        if constexpr (std::is_same_v<std::decay_t<node_type>, binary_node<value_type>>) {
+            // A single child goes to the left, just like in the n(...) notation
+            parent.link_child(child, parent.left == nullptr);
+        } else {
+            parent.link_last_child(child, following);
+        }
+    }
+
+    /*
+     * Replace the content of this tree with the one described by a pre-order sequence of values where each value is
+     * paired with the number of children of its node. Nodes are linked in a single pass and size and arity are known
+     * exactly at the end. Every node allocated is immediately linked into the root, so that it will be deallocated if
+     * something throws.
+     */
+    template <typename Values, typename ChildCounts>
+    void assign_preorder(const Values& values, const ChildCounts& child_counts) {
+        const size_type size = std::size(values);
+        if (size != static_cast<size_type>(std::size(child_counts))) {
+            throw std::invalid_argument("Values and child counts must have the same length.");
+        }
+        if (size == 0u) {
+            this->clear();
+            return;
+        }
+        auto value_it   = std::begin(values);
+        auto count_it   = std::begin(child_counts);
+        size_type arity = 0u;
+        // Nodes still expecting children, paired with the number of children they miss
+        std::vector<std::pair<node_type*, size_type>> open_nodes;
+        auto open_node = [&](node_type* node) {
+            const size_type children = static_cast<size_type>(*count_it++);
+            if (children > max_children()) {
+                throw std::invalid_argument("A binary_node can have at most 2 children.");
+            }
+            arity = std::max(arity, children);
+            if (children > 0u) {
+                open_nodes.emplace_back(node, children);
+            }
+        };
+        unique_ptr_alloc<node_allocator_type> root = allocate(this->allocator, *value_it++);
+        open_node(root.get());
+        for (size_type i = 1u; i < size; ++i) {
+            while (!open_nodes.empty() && open_nodes.back().second == 0u) {
+                open_nodes.pop_back();
+            }
+            if (open_nodes.empty()) {
+                throw std::invalid_argument("Child counts describe fewer nodes than the values provided.");
+            }
+            node_type* parent = open_nodes.back().first;
+            size_type missing = --open_nodes.back().second;
+            node_type* child  = allocate(this->allocator, *value_it++).release();
+            link_next_child(*parent, child, missing);
+            open_node(child);
+        }
+        for (const auto& open : open_nodes) {
+            if (open.second > 0u) {
+                throw std::invalid_argument("Child counts describe more nodes than the values provided.");
+            }
+        }
+        this->assign(root.release(), size, arity);
+    }
+
+    /*
+     * Replace the content of this tree with the one described by an array of values paired with the index of their
+     * parent. The root is the only node having an index out of range (for example -1). Children keep the relative order
+     * of their indexes. The children of each node are first grouped using a counting sort, then the tree is allocated by
+     * a pre-order visit from the root: nodes not reachable from the root (cycles) are detected at the end.
+     */
+    template <typename Values, typename ParentIndexes>
+    void assign_parent_indices(const Values& values, const ParentIndexes& parents) {
+        const size_type size = std::size(values);
+        if (size != static_cast<size_type>(std::size(parents))) {
+            throw std::invalid_argument("Values and parent indexes must have the same length.");
+        }
+        if (size == 0u) {
+            this->clear();
+            return;
+        }
+        size_type root_index = size;
+        // offsets[i] will be the index in children where the children of the i-th node start
+        std::vector<size_type> offsets(size + 1u, 0u);
+        for (size_type i = 0u; i < size; ++i) {
+            const size_type parent = static_cast<size_type>(parents[i]);
+            if (parent < size) {
+                ++offsets[parent];
+            } else if (root_index == size) {
+                root_index = i;
+            } else {
+                throw std::invalid_argument("Parent indexes describe more than one root.");
+            }
+        }
+        if (root_index == size) {
+            throw std::invalid_argument("Parent indexes do not describe any root.");
+        }
+        for (size_type i = 1u; i < size; ++i) {
+            offsets[i] += offsets[i - 1];
+        }
+        offsets[size] = size - 1u;
+        std::vector<size_type> children(size - 1u);
+        // Visited backward so that offsets end up pointing to the beginning and children keep the index order
+        for (size_type i = size; i-- > 0u;) {
+            const size_type parent = static_cast<size_type>(parents[i]);
+            if (parent < size) {
+                children[--offsets[parent]] = i;
+            }
+        }
+        size_type arity   = 0u;
+        size_type visited = 1u;
+        // Nodes being visited, paired with the range of their children still to be visited
+        std::vector<std::tuple<node_type*, size_type, size_type>> open_nodes;
+        auto open_node = [&](node_type* node, size_type index) {
+            const size_type begin = offsets[index];
+            const size_type end   = offsets[index + 1u];
+            if (end - begin > max_children()) {
+                throw std::invalid_argument("A binary_node can have at most 2 children.");
+            }
+            arity = std::max(arity, end - begin);
+            open_nodes.emplace_back(node, begin, end);
+        };
+        unique_ptr_alloc<node_allocator_type> root = allocate(this->allocator, values[root_index]);
+        open_node(root.get(), root_index);
+        while (!open_nodes.empty()) {
+            auto& [parent, next, end] = open_nodes.back();
+            if (next == end) {
+                open_nodes.pop_back();
+                continue;
+            }
+            node_type* parent_node = parent;
+            const size_type index  = children[next++];
+            node_type* child       = allocate(this->allocator, values[index]).release();
+            link_next_child(*parent_node, child, end - next);
+            ++visited;
+            open_node(child, index);
+        }
+        if (visited != size) {
+            throw std::invalid_argument("Parent indexes describe nodes not reachable from the root.");
+        }
+        this->assign(root.release(), size, arity);
+    }
+
     public:
     /**
      * @brief Removes all elements from the tree.
@@ -439,6 +680,12 @@ class tree : public tree_base<Node, Policy, Allocator> {
         std::swap(this->size_value, other.size_value);
         std::swap(this->arity_value, other.arity_value);
         std::swap(this->navigator, other.navigator);
+        if (this->changes != nullptr) {
+            this->changes->replaced();
+        }
+        if (other.changes != nullptr) {
+            other.changes->replaced();
+        }
     }
 
     /**
@@ -584,8 +831,12 @@ class tree : public tree_base<Node, Policy, Allocator> {
     insert_child_front(
         const tree_iterator<T, P, N>& position,
         struct_node<ConvertibleV, First, Next> value) {
-        // Last allocator is forwarded to Node constructor to allocate its children
-        return this->add_child<true>(position, allocate(this->allocator, value, this->allocator), 1u, 0u);
+        return this->add_child<true>(
+            position,
+            // Last allocator is forwarded to Node constructor to allocate its children
+            allocate(this->allocator, value, this->allocator),
+            value.subtree_size(),
+            value.subtree_arity());
     }
 
     template <typename T, typename P, typename N, typename OtherP>
@@ -597,8 +848,8 @@ class tree : public tree_base<Node, Policy, Allocator> {
             !other.empty()
                 ? allocate(this->allocator, *other.root_node, this->allocator)
                 : nullptr,
-            1u,
-            0u);
+            other.size(),
+            other.arity());
     }
 
     template <typename T, typename P, typename N, typename OtherP>
@@ -610,11 +861,13 @@ class tree : public tree_base<Node, Policy, Allocator> {
                 throw std::logic_error("Cannot move from yourself and create a recursive tree.");
             }
         }
-        iterator<P> result = this->add_child<true>(
+        const size_type size  = other.size();
+        const size_type arity = other.arity();
+        iterator<P> result    = this->add_child<true>(
             position,
             other.replace_node(other.root_node, nullptr, 0u, 0u),
-            1u,
-            0u);
+            size,
+            arity);
         other.nullify();
         return result;
     }
@@ -660,10 +913,10 @@ class tree : public tree_base<Node, Policy, Allocator> {
         return this->add_child<false>(
             position,
             !other.empty()
-                ? allocate(this->allocator, *other.root_node)
+                ? allocate(this->allocator, *other.root_node, this->allocator)
                 : nullptr,
-            1u,
-            0u);
+            other.size(),
+            other.arity());
     }
 
     template <typename T, typename P, typename N, typename OtherP>
@@ -675,15 +928,93 @@ class tree : public tree_base<Node, Policy, Allocator> {
                 throw std::logic_error("Cannot move from yourself and create a recursive tree.");
             }
         }
-        iterator<P> result = this->add_child<false>(
+        const size_type size  = other.size();
+        const size_type arity = other.arity();
+        iterator<P> result    = this->add_child<false>(
             position,
             other.replace_node(other.root_node, nullptr, 0u, 0u),
-            1u,
-            0u);
+            size,
+            arity);
         other.nullify();
         return result;
     }
 
+    /**
+     * @brief Inserts a node as the child number index of the node at position, the children from index onward are
+     * shifted by one. Only for trees having nary_node.
+     * @return an iterator to the node at position
+     * @throw std::logic_error if position is end() or index is greater than the number of children
+     */
+    template <typename T, typename P, typename N>
+    iterator<P> insert_child(
+        const tree_iterator<T, P, N>& position,
+        std::size_t index,
+        const value_type& value) {
+        return this->add_child_at(position, index, allocate(this->allocator, value), 1u, 0u);
+    }
+
+    template <typename T, typename P, typename N>
+    iterator<P> insert_child(
+        const tree_iterator<T, P, N>& position,
+        std::size_t index,
+        value_type&& value) {
+        return this->add_child_at(position, index, allocate(this->allocator, std::move(value)), 1u, 0u);
+    }
+
+    template <
+        typename T,
+        typename P,
+        typename N,
+        typename ConvertibleV,
+        typename First,
+        typename Next,
+        typename = std::enable_if_t<std::is_convertible_v<ConvertibleV, value_type>>>
+    iterator<P> insert_child(
+        const tree_iterator<T, P, N>& position,
+        std::size_t index,
+        struct_node<ConvertibleV, First, Next> value) {
+        return this->add_child_at(
+            position,
+            index,
+            // Last allocator is forwarded to Node constructor to allocate its children
+            allocate(this->allocator, value, this->allocator),
+            value.subtree_size(),
+            value.subtree_arity());
+    }
+
+    template <typename T, typename P, typename N, typename OtherP>
+    iterator<P> insert_child(
+        const tree_iterator<T, P, N>& position,
+        std::size_t index,
+        const tree_base<Node, OtherP, Allocator>& other) {
+        return this->add_child_at(
+            position,
+            index,
+            !other.empty()
+                ? allocate(this->allocator, *other.root_node, this->allocator)
+                : nullptr,
+            other.size(),
+            other.arity());
+    }
+
+    template <typename T, typename P, typename N, typename OtherP>
+    iterator<P> insert_child(
+        const tree_iterator<T, P, N>& position,
+        std::size_t index,
+        tree<Node, OtherP, Allocator>&& other) {
+        if constexpr (std::is_same_v<policy_type, OtherP>) {
+            if (this == &other) {
+                throw std::logic_error("Cannot move from yourself and create a recursive tree.");
+            }
+        }
+        const size_type size  = other.size();
+        const size_type arity = other.arity();
+        // Other releases its nodes first, they are not deallocated twice if the position is not valid
+        unique_ptr_alloc<node_allocator_type> root = other.replace_node(other.root_node, nullptr, 0u, 0u);
+        other.nullify();
+        return this->add_child_at(position, index, std::move(root), size, arity);
+    }
+
     template <
         typename T,
         typename P,
@@ -770,14 +1101,19 @@ class tree : public tree_base<Node, Policy, Allocator> {
     template <typename T, typename P, typename N>
     tree<Node, Policy, Allocator>
     detach_subtree(const tree_iterator<T, P, N>& position) {
-        if (position.pointed_tree != this) {
-            throw std::logic_error("Tried to modify the tree (detach subtree) with an iterator not belonging to it.");
-        }
-        node_type* target = const_cast<node_type*>(position.get_node());
+        // See add_child() for the const_cast
+        node_type* target = const_cast<node_type*>(position.get_raw_node());
         if (target == nullptr) {
             throw std::logic_error("The iterator points to a non valid position (end).");
         }
-        return {this->replace_node(target, nullptr, 0, 0).release()};
+        if (target == this->root_node) {
+            return tree(std::move(*this));
+        }
+        if (this->changes != nullptr) {
+            this->changes->removing(*target);
+        }
+        // The sizes are unknown (zero), they will be computed when needed
+        return tree(this->replace_node(target, nullptr, 0u, 0u));
     }
 
     /*  ---   COMPARISON   ---   */
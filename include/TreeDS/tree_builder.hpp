@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm> // std::max()
+#include <cstddef>   // std::size_t
+#include <memory>    // std::allocator_traits
+#include <stdexcept> // std::logic_error
+#include <utility>   // std::forward()
+#include <vector>
+
+#include <TreeDS/allocator_utility.hpp>
+#include <TreeDS/node/binary_node.hpp>
+#include <TreeDS/node/nary_node.hpp>
+
+namespace md {
+
+/**
+ * @brief Incremental builder that creates a tree from a stream of events.
+ * @details This class is meant to be fed by streaming producers (SAX parsers, AST walkers, deserializers) that emit an
+ * event for each node in pre-order: {@link #open(Args&&...) open()} starts a node that will have children,
+ * {@link #leaf(Args&&...) leaf()} adds a node without children and {@link #close() close()} ends the most recently
+ * opened node. The builder keeps a plain stack of the open nodes and links every new node directly as the last child
+ * of the top one, without going through iterators and tree::add_child(). The sibling bookkeeping of a node is done
+ * once, when it is closed. At the end, {@link #build() build()} hands off the tree with its exact size and arity.
+ *
+ * @code
+ * tree_builder<nary_tree<char>> builder;
+ * builder.open('a').leaf('b').open('c').leaf('d').close().close();
+ * nary_tree<char> t = builder.build(); // n('a')(n('b'), n('c')(n('d')))
+ * @endcode
+ *
+ * @tparam Tree the type of tree to build, either nary_tree or binary_tree
+ */
+template <typename Tree>
+class tree_builder {
+
+    /*   ---   TYPES   ---   */
+    public:
+    using tree_type           = Tree;
+    using node_type           = typename Tree::node_type;
+    using value_type          = typename Tree::value_type;
+    using size_type           = typename Tree::size_type;
+    using allocator_type      = typename Tree::allocator_type;
+    using node_allocator_type = typename Tree::node_allocator_type;
+
+    private:
+    static constexpr bool IS_BINARY = std::is_same_v<std::decay_t<node_type>, binary_node<value_type>>;
+
+    // A node that is still receiving children
+    struct open_node {
+        node_type* node;
+        size_type positions; // Child positions used so far (skipped positions included)
+    };
+
+    /*   ---   ATTRIBUTES   ---   */
+    protected:
+    /// @brief Allocator object used to allocate the nodes.
+    node_allocator_type allocator;
+    /// @brief Root of the tree being built, it owns every node linked so far.
+    unique_ptr_alloc<node_allocator_type> root;
+    /// @brief Stack of the nodes opened and not yet closed, the top is the parent of the next node.
+    std::vector<open_node> open_nodes;
+    size_type size_value  = 0u;
+    size_type arity_value = 0u;
+
+    /*   ---   CONSTRUCTORS   ---   */
+    public:
+    explicit tree_builder(const allocator_type& allocator = allocator_type()) :
+            allocator(allocator),
+            root(nullptr, deleter(this->allocator)) {
+    }
+
+    tree_builder(const tree_builder&) = delete;
+    tree_builder(tree_builder&&)      = default;
+
+    /*   ---   METHODS   ---   */
+    private:
+    template <typename... Args>
+    node_type* add_node(Args&&... args) {
+        if (this->open_nodes.empty()) {
+            if (this->root) {
+                throw std::logic_error("Tried to add a second root to the tree being built.");
+            }
+            this->root = allocate(this->allocator, std::forward<Args>(args)...);
+            ++this->size_value;
+            return this->root.get();
+        }
+        open_node& parent = this->open_nodes.back();
+        if constexpr (IS_BINARY) {
+            if (parent.positions == 2u) {
+                throw std::logic_error("Tried to add a children to a binary_node with 2 children.");
+            }
+        }
+        node_type* node = allocate(this->allocator, std::forward<Args>(args)...).release();
+        if constexpr (IS_BINARY) {
+            parent.node->link_child(node, parent.positions == 0u);
+        } else {
+            // Siblings that follow will be fixed at close()
+            parent.node->link_last_child(node, 0u);
+        }
+        ++parent.positions;
+        ++this->size_value;
+        return node;
+    }
+
+    public:
+    /**
+     * @brief Adds a node that will receive the children added until the matching {@link #close()}.
+     * @param args arguments forwarded to the constructor of the value
+     */
+    template <typename... Args>
+    tree_builder& open(Args&&... args) {
+        node_type* node = this->add_node(std::forward<Args>(args)...);
+        this->open_nodes.push_back({node, 0u});
+        return *this;
+    }
+
+    /**
+     * @brief Adds a node without children.
+     * @param args arguments forwarded to the constructor of the value
+     */
+    template <typename... Args>
+    tree_builder& leaf(Args&&... args) {
+        this->add_node(std::forward<Args>(args)...);
+        return *this;
+    }
+
+    /**
+     * @brief Leaves the next child position of the current node empty, like n() does in the n(...) notation.
+     * @details Available for binary trees only, it is the way to obtain a node having just the right child.
+     */
+    tree_builder& skip() {
+        static_assert(IS_BINARY, "Only binary nodes have positional children.");
+        if (this->open_nodes.empty() || this->open_nodes.back().positions == 2u) {
+            throw std::logic_error("There is no child position to skip.");
+        }
+        ++this->open_nodes.back().positions;
+        return *this;
+    }
+
+    /// @brief Ends the most recently opened node.
+    tree_builder& close() {
+        if (this->open_nodes.empty()) {
+            throw std::logic_error("Tried to close a node but there is no open node.");
+        }
+        node_type* node = this->open_nodes.back().node;
+        this->open_nodes.pop_back();
+        size_type children = 0u;
+        if constexpr (IS_BINARY) {
+            children = node->children();
+        } else {
+            // Visit the children backward, each one knows now how many siblings follow it
+            for (node_type* child = node->last_child; child != nullptr; child = child->prev_sibling) {
+                child->following_size = children++;
+            }
+        }
+        this->arity_value = std::max(this->arity_value, children);
+        return *this;
+    }
+
+    /// @brief Returns the number of nodes opened and not yet closed.
+    size_type depth() const {
+        return this->open_nodes.size();
+    }
+
+    /// @brief Returns the number of nodes added so far.
+    size_type size() const {
+        return this->size_value;
+    }
+
+    /// @brief Returns true when a root was added and every node opened was closed.
+    bool complete() const {
+        return this->root != nullptr && this->open_nodes.empty();
+    }
+
+    /**
+     * @brief Hands off the tree built, leaving this builder ready to build another tree.
+     * @throw std::logic_error if some node is still open
+     */
+    Tree build() {
+        if (!this->open_nodes.empty()) {
+            throw std::logic_error("Tried to build a tree while some nodes are still open.");
+        }
+        Tree result(static_cast<allocator_type>(this->allocator));
+        result.assign(this->root.release(), this->size_value, this->arity_value);
+        this->size_value  = 0u;
+        this->arity_value = 0u;
+        return result;
+    }
+};
+
+} // namespace md
@@ -2,6 +2,7 @@
 
 #include <cassert>     // assert
 #include <cstddef>     // std::size_t
+#include <cstdint>     // std::uintptr_t
 #include <functional>  // std::invoke()
 #include <tuple>       // std::std::make_from_tuple
 #include <type_traits> // std::decay_t, std::std::enable_if_t, std::is_invocable_v, std::void_t
@@ -28,6 +29,9 @@ class generative_navigator;
 template <typename, typename...>
 class multiple_node_pointer;
 
+template <typename>
+class tree_builder;
+
 /*   ---   TYPE TRAITS   ---   */
 template <typename T, typename = void>
 constexpr bool is_equality_comparable = false;
@@ -139,6 +143,18 @@ struct type_value {
 
 namespace detail {
     struct empty_t {};
+
+    /// @brief Mixes a value into a hash, the result depends on the order of the values mixed.
+    inline std::size_t hash_combine(std::size_t seed, std::size_t value) {
+        return seed ^ (value + 0x9E3779B97F4A7C15u + (seed << 6) + (seed >> 2));
+    }
+
+    /// @brief Slot of a pointer in a table of 2^bits slots (bits > 0) using Fibonacci hashing.
+    inline std::size_t fibonacci_slot(const void* pointer, unsigned bits) {
+        // The low bits of addresses are mostly equal because of alignment, the product spreads them in the high bits
+        constexpr std::size_t FACTOR = static_cast<std::size_t>(0x9E3779B97F4A7C15ull);
+        return (reinterpret_cast<std::uintptr_t>(pointer) * FACTOR) >> (sizeof(std::size_t) * 8u - bits);
+    }
 } // namespace detail
 
 template <typename X>
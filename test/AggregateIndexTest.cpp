@@ -0,0 +1,213 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include <TreeDS/index>
+#include <TreeDS/tree>
+
+using namespace md;
+using namespace std;
+
+class AggregateIndexTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void sums();
+    void minMaxCount();
+    void order();
+    void update();
+    void binaryTree();
+    void sameAsRebuild();
+};
+
+// Not commutative: the values in pre-order
+struct concat_monoid {
+    using result_type = string;
+
+    string identity() const {
+        return "";
+    }
+
+    string lift(char value) const {
+        return string(1u, value);
+    }
+
+    string combine(const string& lhs, const string& rhs) const {
+        return lhs + rhs;
+    }
+};
+
+nary_tree<int> make_tree() {
+    return n(1)(
+        n(2)(
+            n(3),
+            n(4)),
+        n(5)(
+            n(6)),
+        n(7));
+}
+
+void AggregateIndexTest::sums() {
+    nary_tree<int> tree = make_tree();
+    aggregate_index<nary_tree<int>, sum_monoid<int>> index(tree);
+    QCOMPARE(index.size(), 7u);
+    QCOMPARE(index.aggregate(), 28);
+    const nary_node<int>* root = tree.raw_root_node();
+    QCOMPARE(index.aggregate(*root), 28);
+    QCOMPARE(index.aggregate(*root->get_child(0)), 9);
+    QCOMPARE(index.aggregate(*root->get_child(1)), 11);
+    QCOMPARE(index.aggregate(*root->get_last_child()), 7);
+    QCOMPARE(index.aggregate(tree.root()), 28);
+    QCOMPARE(index.aggregate(tree.begin(policy::post_order())), 3);
+    QVERIFY_EXCEPTION_THROWN(index.aggregate(tree.end(policy::pre_order())), invalid_argument);
+    nary_tree<int> other(tree);
+    QVERIFY_EXCEPTION_THROWN(index.aggregate(*other.raw_root_node()), invalid_argument);
+    QVERIFY(index.is_index_of(tree));
+    QVERIFY(!index.is_index_of(other));
+    nary_tree<int> empty;
+    aggregate_index<nary_tree<int>, sum_monoid<int>> empty_index(empty);
+    QCOMPARE(empty_index.size(), 0u);
+    QCOMPARE(empty_index.aggregate(), 0);
+}
+
+void AggregateIndexTest::minMaxCount() {
+    nary_tree<int> tree = make_tree();
+    aggregate_index<nary_tree<int>, min_monoid<int>> minimums(tree);
+    aggregate_index<nary_tree<int>, max_monoid<int>> maximums(tree);
+    aggregate_index<nary_tree<int>, count_monoid<int>> counts(tree);
+    const nary_node<int>* second = tree.raw_root_node()->get_child(1);
+    QCOMPARE(minimums.aggregate(), 1);
+    QCOMPARE(minimums.aggregate(*second), 5);
+    QCOMPARE(maximums.aggregate(), 7);
+    QCOMPARE(maximums.aggregate(*second), 6);
+    QCOMPARE(counts.aggregate(), 7u);
+    QCOMPARE(counts.aggregate(*second), 2u);
+    nary_tree<int> empty;
+    QCOMPARE((aggregate_index<nary_tree<int>, min_monoid<int>>(empty).aggregate()), numeric_limits<int>::max());
+    QCOMPARE((aggregate_index<nary_tree<int>, count_monoid<int>>(empty).aggregate()), 0u);
+}
+
+void AggregateIndexTest::order() {
+    nary_tree<char> tree {n('a')(n('b')(n('c'), n('d')), n('e'))};
+    aggregate_index<nary_tree<char>, concat_monoid> index(tree);
+    QCOMPARE(index.aggregate(), string("abcde"));
+    QCOMPARE(index.aggregate(*tree.raw_root_node()->get_first_child()), string("bcd"));
+}
+
+void AggregateIndexTest::update() {
+    change_log<nary_node<int>> log;
+    nary_tree<int> tree = make_tree();
+    tree.set_change_log(&log);
+    aggregate_index<nary_tree<int>, sum_monoid<int>> index(tree);
+    nary_node<int>* root   = tree.raw_root_node();
+    nary_node<int>* second = root->get_child(1);
+    // A child inserted
+    tree.emplace_child_back(tree.root().other_node(second), 10);
+    index.update(log);
+    log.clear();
+    QCOMPARE(index.size(), 8u);
+    QCOMPARE(index.aggregate(*second), 21);
+    QCOMPARE(index.aggregate(), 38);
+    // A value modified through an iterator and reported to the log
+    auto position = tree.root().other_node(second->get_first_child());
+    *position     = 100;
+    log.touch(*position.get_raw_node());
+    index.update(log);
+    log.clear();
+    QCOMPARE(index.aggregate(position), 100);
+    QCOMPARE(index.aggregate(*second), 115);
+    QCOMPARE(index.aggregate(), 132);
+    // A subtree replaced
+    tree.insert_over(tree.root().other_node(root->get_child(0)), n(1)(n(1)));
+    index.update(log);
+    log.clear();
+    QCOMPARE(index.size(), 7u);
+    QCOMPARE(index.aggregate(*root->get_child(0)), 2);
+    QCOMPARE(index.aggregate(), 125);
+    // A subtree erased
+    tree.erase(tree.begin(policy::post_order()).other_node(second));
+    index.update(log);
+    log.clear();
+    QCOMPARE(index.size(), 4u);
+    QCOMPARE(index.aggregate(), 10);
+    // The whole tree replaced
+    tree = make_tree();
+    index.update(log);
+    log.clear();
+    QCOMPARE(index.aggregate(), 28);
+    tree.clear();
+    index.update(log);
+    log.clear();
+    QCOMPARE(index.size(), 0u);
+    QCOMPARE(index.aggregate(), 0);
+    tree.set_change_log(nullptr);
+}
+
+void AggregateIndexTest::binaryTree() {
+    binary_tree<int> tree(
+        n(1)(
+            n(),
+            n(2)(
+                n(3),
+                n(4))));
+    aggregate_index<binary_tree<int>, sum_monoid<int>> index(tree);
+    QCOMPARE(index.aggregate(), 10);
+    QCOMPARE(index.aggregate(*tree.raw_root_node()->get_right_child()), 9);
+}
+
+void AggregateIndexTest::sameAsRebuild() {
+    mt19937 random(7);
+    for (int i = 0; i < 50; ++i) {
+        change_log<nary_node<int>> log;
+        nary_tree<int> tree(n(1));
+        tree.set_change_log(&log);
+        aggregate_index<nary_tree<int>, sum_monoid<int>> sums(tree);
+        aggregate_index<nary_tree<int>, min_monoid<int>> minimums(tree);
+        for (int step = 0; step < 60; ++step) {
+            int edits = 1 + static_cast<int>(random() % 3);
+            for (int j = 0; j < edits && !tree.empty(); ++j) {
+                auto it = tree.begin(policy::pre_order());
+                std::advance(it, random() % tree.size());
+                int value = static_cast<int>(random() % 100);
+                switch (random() % 6) {
+                case 0:
+                case 1:
+                    tree.emplace_child_back(it, value);
+                    break;
+                case 2:
+                    tree.insert_child_front(it, n(value)(n(value + 1)));
+                    break;
+                case 3:
+                    tree.insert_over(it, value);
+                    break;
+                case 4:
+                    *it = value;
+                    log.touch(*it.get_raw_node());
+                    break;
+                case 5:
+                    if (it.get_raw_node() != tree.raw_root_node()) {
+                        tree.erase(tree.begin(policy::post_order()).other_node(it.get_raw_node()));
+                    }
+                    break;
+                }
+            }
+            sums.update(log);
+            minimums.update(log);
+            log.clear();
+            aggregate_index<nary_tree<int>, sum_monoid<int>> expected_sums(tree);
+            aggregate_index<nary_tree<int>, min_monoid<int>> expected_minimums(tree);
+            QCOMPARE(sums.size(), expected_sums.size());
+            for (auto it = tree.begin(policy::pre_order()); it != tree.end(policy::pre_order()); ++it) {
+                QCOMPARE(sums.aggregate(it), expected_sums.aggregate(it));
+                QCOMPARE(minimums.aggregate(it), expected_minimums.aggregate(it));
+            }
+        }
+        tree.set_change_log(nullptr);
+    }
+}
+
+QTEST_MAIN(AggregateIndexTest)
+
+#include "AggregateIndexTest.moc"
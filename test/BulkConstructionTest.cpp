@@ -0,0 +1,175 @@
+#include <QtTest/QtTest>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <TreeDS/tree>
+
+using namespace std;
+using namespace md;
+
+class BulkConstructionTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void naryPreorder();
+    void binaryPreorder();
+    void naryParentIndices();
+    void binaryParentIndices();
+    void empty();
+    void invalidInput();
+    void large();
+};
+
+void BulkConstructionTest::naryPreorder() {
+    nary_tree<char> tree = nary_tree<char>::from_preorder(
+        vector<char> {'a', 'b', 'd', 'e', 'h', 'f', 'c', 'g', 'i', 'j', 'k'},
+        vector<int> {2, 3, 0, 1, 0, 0, 1, 3, 0, 0, 0});
+    QCOMPARE(tree.size(), 11);
+    QCOMPARE(tree.arity(), 3);
+    QVERIFY(
+        tree
+        == n('a')(
+            n('b')(
+                n('d'),
+                n('e')(
+                    n('h')),
+                n('f')),
+            n('c')(
+                n('g')(
+                    n('i'),
+                    n('j'),
+                    n('k')))));
+    // The tree must be as good as any other, modifiers included
+    tree.emplace_child_back(find(tree.begin(), tree.end(), 'g'), 'l');
+    QCOMPARE(tree.size(), 12);
+    QCOMPARE(tree.arity(), 4);
+    vector<char> expected {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l'};
+    QCOMPARE(vector<char>(tree.begin(), tree.end()), expected);
+    vector<char> post_order(tree.begin(policy::post_order()), tree.end(policy::post_order()));
+    QCOMPARE(post_order, (vector<char> {'d', 'h', 'e', 'f', 'b', 'i', 'j', 'k', 'l', 'g', 'c', 'a'}));
+}
+
+void BulkConstructionTest::binaryPreorder() {
+    binary_tree<int> tree = binary_tree<int>::from_preorder(
+        vector<int> {1, 2, 4, 5, 3, 6},
+        vector<unsigned> {2, 2, 0, 0, 1, 0});
+    QCOMPARE(tree.size(), 6);
+    QCOMPARE(tree.arity(), 2);
+    QVERIFY(
+        tree
+        == n(1)(
+            n(2)(
+                n(4),
+                n(5)),
+            n(3)(
+                n(6))));
+    QVERIFY(tree.raw_root_node()->get_right_child()->get_left_child() != nullptr);
+    QVERIFY(tree.raw_root_node()->get_right_child()->get_right_child() == nullptr);
+}
+
+void BulkConstructionTest::naryParentIndices() {
+    // Nodes are given in no particular order
+    nary_tree<string> tree = nary_tree<string>::from_parent_indices(
+        vector<string> {"c", "root", "b", "c1", "a", "b1", "c2"},
+        vector<long> {1, -1, 1, 0, 1, 2, 0});
+    QCOMPARE(tree.size(), 7);
+    QCOMPARE(tree.arity(), 3);
+    QVERIFY(
+        tree
+        == n("root")(
+            n("c")(
+                n("c1"),
+                n("c2")),
+            n("b")(
+                n("b1")),
+            n("a")));
+}
+
+void BulkConstructionTest::binaryParentIndices() {
+    binary_tree<int> tree = binary_tree<int>::from_parent_indices(
+        vector<int> {10, 20, 30, 40},
+        vector<size_t> {size_t(-1), 0, 0, 2});
+    QCOMPARE(tree.size(), 4);
+    QCOMPARE(tree.arity(), 2);
+    QVERIFY(
+        tree
+        == n(10)(
+            n(20),
+            n(30)(
+                n(40))));
+}
+
+void BulkConstructionTest::empty() {
+    QVERIFY(nary_tree<int>::from_preorder(vector<int>(), vector<int>()).empty());
+    QVERIFY(binary_tree<int>::from_parent_indices(vector<int>(), vector<int>()).empty());
+    nary_tree<int> single = nary_tree<int>::from_preorder(vector<int> {7}, vector<int> {0});
+    QCOMPARE(single.size(), 1);
+    QCOMPARE(single.arity(), 0);
+    QVERIFY(single == n(7));
+}
+
+void BulkConstructionTest::invalidInput() {
+    // Different length
+    QVERIFY_EXCEPTION_THROWN(
+        nary_tree<int>::from_preorder(vector<int> {1, 2}, vector<int> {1}),
+        std::invalid_argument);
+    // Too few nodes described
+    QVERIFY_EXCEPTION_THROWN(
+        nary_tree<int>::from_preorder(vector<int> {1, 2, 3}, vector<int> {1, 0, 0}),
+        std::invalid_argument);
+    // Too many nodes described
+    QVERIFY_EXCEPTION_THROWN(
+        nary_tree<int>::from_preorder(vector<int> {1, 2, 3}, vector<int> {2, 0, 1}),
+        std::invalid_argument);
+    // Too many children for a binary node
+    QVERIFY_EXCEPTION_THROWN(
+        binary_tree<int>::from_preorder(vector<int> {1, 2, 3, 4}, vector<int> {3, 0, 0, 0}),
+        std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(
+        binary_tree<int>::from_parent_indices(vector<int> {1, 2, 3, 4}, vector<int> {-1, 0, 0, 0}),
+        std::invalid_argument);
+    // Two roots
+    QVERIFY_EXCEPTION_THROWN(
+        nary_tree<int>::from_parent_indices(vector<int> {1, 2, 3}, vector<int> {-1, 0, -1}),
+        std::invalid_argument);
+    // No root
+    QVERIFY_EXCEPTION_THROWN(
+        nary_tree<int>::from_parent_indices(vector<int> {1, 2}, vector<int> {1, 0}),
+        std::invalid_argument);
+    // Cycle not reachable from the root
+    QVERIFY_EXCEPTION_THROWN(
+        nary_tree<int>::from_parent_indices(vector<int> {1, 2, 3, 4}, vector<int> {-1, 0, 3, 2}),
+        std::invalid_argument);
+}
+
+void BulkConstructionTest::large() {
+    // Complete ternary tree described by parent indexes, then the same tree in pre-order
+    const int size = 100000;
+    vector<int> values(size);
+    vector<int> parents(size);
+    for (int i = 0; i < size; ++i) {
+        values[i]  = i;
+        parents[i] = (i - 1) / 3;
+    }
+    parents[0]               = -1;
+    nary_tree<int> by_parent = nary_tree<int>::from_parent_indices(values, parents);
+    QCOMPARE(by_parent.size(), size);
+    QCOMPARE(by_parent.arity(), 3);
+    vector<int> preorder_values;
+    vector<int> preorder_counts;
+    for (auto it = by_parent.begin(policy::pre_order()); it != by_parent.end(policy::pre_order()); ++it) {
+        preorder_values.push_back(*it);
+        preorder_counts.push_back(it.get_raw_node()->children());
+    }
+    nary_tree<int> by_preorder = nary_tree<int>::from_preorder(preorder_values, preorder_counts);
+    QCOMPARE(by_preorder.size(), size);
+    QCOMPARE(by_preorder.arity(), 3);
+    QVERIFY(by_parent == by_preorder);
+    // Breadth-first order of a complete tree built from (i - 1) / 3 is the index order
+    QVERIFY(std::equal(by_preorder.begin(policy::breadth_first()), by_preorder.end(policy::breadth_first()), values.begin()));
+}
+
+QTEST_MAIN(BulkConstructionTest);
+#include "BulkConstructionTest.moc"
@@ -0,0 +1,229 @@
+#include <QtTest/QtTest>
+#include <stdexcept>
+#include <vector>
+
+#include <TreeDS/tree>
+#include <TreeDS/view>
+
+using namespace md;
+using namespace std;
+
+class CowTreeTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void construct();
+    void copyShares();
+    void modifyCopies();
+    void modifyInPlace();
+    void oldIterators();
+    void erase();
+    void writeThroughIterators();
+    void mutableIterators();
+    void binaryTree();
+};
+
+template <typename Tree>
+vector<char> values(const Tree& tree) {
+    vector<char> result;
+    for (auto it = tree.begin(policy::pre_order()); it != tree.end(policy::pre_order()); ++it) {
+        result.push_back(*it);
+    }
+    return result;
+}
+
+void CowTreeTest::construct() {
+    const cow_tree<nary_tree<char>> empty;
+    QVERIFY(empty.empty());
+    QCOMPARE(empty.size(), 0u);
+    QVERIFY(empty.begin() == empty.end());
+    QVERIFY(!empty.is_shared());
+    nary_tree<char> tree(n('a')(n('b')(n('c'), n('d')), n('e')));
+    const cow_tree<nary_tree<char>> copied(tree);
+    QVERIFY(copied.get() == tree);
+    QVERIFY(copied.raw_root_node() != tree.raw_root_node());
+    const nary_node<char>* root = tree.raw_root_node();
+    const cow_tree<nary_tree<char>> moved(std::move(tree));
+    QCOMPARE(moved.raw_root_node(), root);
+    QVERIFY(tree.empty());
+    const cow_tree<nary_tree<char>> from_struct(n('a')(n('b')(n('c'), n('d')), n('e')));
+    QVERIFY(from_struct == copied);
+    QVERIFY(from_struct != empty);
+    QCOMPARE(from_struct.size(), 5u);
+    QCOMPARE(from_struct.arity(), 2u);
+    QCOMPARE(values(from_struct), (vector<char> {'a', 'b', 'c', 'd', 'e'}));
+    cow_tree<nary_tree<char>> inserted;
+    inserted.insert_over(inserted.cend(), 'x');
+    QCOMPARE(*inserted.croot(), 'x');
+}
+
+void CowTreeTest::copyShares() {
+    const cow_tree<nary_tree<char>> tree(n('a')(n('b')(n('c'), n('d')), n('e')));
+    cow_tree<nary_tree<char>> copy(tree);
+    QVERIFY(tree.is_shared());
+    QVERIFY(copy.is_shared());
+    QCOMPARE(copy.raw_root_node(), tree.raw_root_node());
+    // Reading through the constant methods does not copy
+    const cow_tree<nary_tree<char>>& reader = copy;
+    QCOMPARE(values(reader), values(tree));
+    QCOMPARE(*reader.root(), 'a');
+    QCOMPARE(reader.size(), 5u);
+    QCOMPARE(copy.raw_root_node(), tree.raw_root_node());
+    // A view refers to the shared nodes
+    nary_tree_view<char> view(copy.get());
+    QCOMPARE(view.raw_root_node(), tree.raw_root_node());
+    QCOMPARE(view.size(), 5u);
+    copy = cow_tree<nary_tree<char>>();
+    QVERIFY(!tree.is_shared());
+}
+
+void CowTreeTest::modifyCopies() {
+    const cow_tree<nary_tree<char>> tree(n('a')(n('b')(n('c'), n('d')), n('e')));
+    cow_tree<nary_tree<char>> copy(tree);
+    auto it = copy.insert_child_back(copy.croot(), 'f');
+    QCOMPARE(*it, 'a');
+    QVERIFY(!tree.is_shared());
+    QVERIFY(!copy.is_shared());
+    QVERIFY(copy.raw_root_node() != tree.raw_root_node());
+    QCOMPARE(values(tree), (vector<char> {'a', 'b', 'c', 'd', 'e'}));
+    QCOMPARE(values(copy), (vector<char> {'a', 'b', 'c', 'd', 'e', 'f'}));
+    QCOMPARE(copy.size(), 6u);
+    QCOMPARE(tree.size(), 5u);
+    // Every modifying method copies a shared tree
+    cow_tree<nary_tree<char>> second(tree);
+    second.insert_over(second.croot(), n('x')(n('y')));
+    QVERIFY(second.get() == nary_tree<char>(n('x')(n('y'))));
+    cow_tree<nary_tree<char>> third(tree);
+    third.emplace_child_front(third.croot(), 'z');
+    third.insert_child(third.croot(), 1u, n('w'));
+    QCOMPARE(values(third), (vector<char> {'a', 'z', 'w', 'b', 'c', 'd', 'e'}));
+    cow_tree<nary_tree<char>> fourth(tree);
+    fourth.clear();
+    QVERIFY(fourth.empty());
+    QCOMPARE(values(tree), (vector<char> {'a', 'b', 'c', 'd', 'e'}));
+    cow_tree<nary_tree<char>> fifth(tree);
+    fifth.detach().raw_root_node()->get_value() = 'q';
+    QCOMPARE(*fifth.croot(), 'q');
+    QCOMPARE(*tree.croot(), 'a');
+}
+
+void CowTreeTest::modifyInPlace() {
+    cow_tree<nary_tree<char>> tree(n('a')(n('b')(n('c'), n('d')), n('e')));
+    const nary_node<char>* root = tree.raw_root_node();
+    tree.insert_child_back(tree.croot(), 'f');
+    tree.emplace_over(tree.croot().go_first_child(), 'g');
+    QCOMPARE(tree.raw_root_node(), root);
+    QCOMPARE(values(tree), (vector<char> {'a', 'g', 'e', 'f'}));
+    {
+        // A copy destroyed before the modification does not cause a copy
+        cow_tree<nary_tree<char>> copy(tree);
+        QVERIFY(tree.is_shared());
+    }
+    tree.insert_child_front(tree.croot(), 'h');
+    QCOMPARE(tree.raw_root_node(), root);
+}
+
+void CowTreeTest::oldIterators() {
+    const cow_tree<nary_tree<char>> tree(n('a')(n('b')(n('c'), n('d'), n('e')), n('f')(n('g'))));
+    cow_tree<nary_tree<char>> copy(tree);
+    // Obtained before the copy, they point to the shared nodes
+    auto e = copy.cbegin(policy::pre_order());
+    while (*e != 'e') {
+        ++e;
+    }
+    auto g = copy.cbegin(policy::post_order());
+    while (*g != 'g') {
+        ++g;
+    }
+    const auto result = copy.insert_over(e, 'x');
+    QCOMPARE(*result, 'x');
+    QVERIFY(result.get_raw_node() != e.get_raw_node());
+    QCOMPARE(result.get_raw_node()->get_root(), copy.raw_root_node());
+    QCOMPARE(values(copy), (vector<char> {'a', 'b', 'c', 'd', 'x', 'f', 'g'}));
+    // The iterator returned continues the traversal in the new tree
+    auto next = result;
+    QCOMPARE(*++next, 'f');
+    // g refers to the tree shared before, it must be obtained again now that copy owns its nodes
+    QVERIFY_EXCEPTION_THROWN(copy.emplace_child_back(g, 'h'), invalid_argument);
+    g = copy.croot().go_last_child().go_first_child().other_policy(policy::post_order());
+    copy.emplace_child_back(g, 'h');
+    QCOMPARE(values(copy), (vector<char> {'a', 'b', 'c', 'd', 'x', 'f', 'g', 'h'}));
+    QCOMPARE(values(tree), (vector<char> {'a', 'b', 'c', 'd', 'e', 'f', 'g'}));
+    // An iterator of another tree is rejected
+    const cow_tree<nary_tree<char>> other(n('a'));
+    cow_tree<nary_tree<char>> shared(tree);
+    QVERIFY_EXCEPTION_THROWN(shared.insert_over(other.croot(), 'y'), invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(copy.insert_over(tree.croot(), 'y'), invalid_argument);
+}
+
+void CowTreeTest::erase() {
+    const cow_tree<nary_tree<char>> tree(n('a')(n('b')(n('c'), n('d')), n('e')));
+    cow_tree<nary_tree<char>> copy(tree);
+    auto b = copy.croot().go_first_child().other_policy(policy::post_order());
+    auto next = copy.erase(b);
+    QCOMPARE(*next, 'e');
+    QCOMPARE(values(copy), (vector<char> {'a', 'e'}));
+    QCOMPARE(values(tree), (vector<char> {'a', 'b', 'c', 'd', 'e'}));
+    cow_tree<nary_tree<char>> range(tree);
+    auto first = range.cbegin(policy::post_order());
+    auto last  = first;
+    ++++last; // b
+    next = range.erase(first, last);
+    QCOMPARE(*next, 'b');
+    QCOMPARE(values(range), (vector<char> {'a', 'b', 'e'}));
+    QCOMPARE(values(tree), (vector<char> {'a', 'b', 'c', 'd', 'e'}));
+    cow_tree<nary_tree<char>> whole(tree);
+    whole.erase(whole.croot().other_policy(policy::post_order()));
+    QVERIFY(whole.empty());
+    QCOMPARE(tree.size(), 5u);
+}
+
+void CowTreeTest::writeThroughIterators() {
+    const cow_tree<nary_tree<char>> tree(n('a')(n('b')(n('c'), n('d')), n('e')));
+    cow_tree<nary_tree<char>> copy(tree);
+    // Reading through a non constant object does not copy the tree, only the mutable iterators do
+    QCOMPARE(copy.root().get_raw_node(), tree.raw_root_node());
+    QVERIFY(copy.begin() != copy.end());
+    QVERIFY(copy.is_shared());
+    *copy.mutable_root() = 'z';
+    QVERIFY(!tree.is_shared());
+    cow_tree<nary_tree<char>> second(tree);
+    for (auto it = second.mutable_begin(); it != second.mutable_end(); ++it) {
+        *it = static_cast<char>(*it - 'a' + 'A');
+    }
+    QCOMPARE(values(copy), (vector<char> {'z', 'b', 'c', 'd', 'e'}));
+    QCOMPARE(values(second), (vector<char> {'A', 'B', 'C', 'D', 'E'}));
+    QCOMPARE(values(tree), (vector<char> {'a', 'b', 'c', 'd', 'e'}));
+}
+
+void CowTreeTest::mutableIterators() {
+    cow_tree<nary_tree<char>> tree(n('a')(n('b'), n('c')));
+    // Taken while the tree is not shared, the iterator points to the nodes that the copy will share
+    auto it = tree.mutable_begin();
+    cow_tree<nary_tree<char>> copy(tree);
+    QCOMPARE(it.get_raw_node(), copy.raw_root_node());
+    // Retaking it copies the tree, the old one still points to the nodes of the copy and must not be used anymore
+    auto retaken = tree.mutable_begin();
+    QVERIFY(!copy.is_shared());
+    QCOMPARE(retaken.get_raw_node(), tree.raw_root_node());
+    QVERIFY(retaken.get_raw_node() != it.get_raw_node());
+    *retaken = 'x';
+    QCOMPARE(values(tree), (vector<char> {'x', 'b', 'c'}));
+    QCOMPARE(values(copy), (vector<char> {'a', 'b', 'c'}));
+}
+
+void CowTreeTest::binaryTree() {
+    const cow_tree<binary_tree<char>> tree(n('a')(n(), n('b')(n('c'), n())));
+    cow_tree<binary_tree<char>> copy(tree);
+    // c is reached going right and then left
+    auto c = copy.croot().go_first_child().go_first_child();
+    QCOMPARE(*c, 'c');
+    copy.insert_child_back(c, 'd');
+    QVERIFY(copy.get() == binary_tree<char>(n('a')(n(), n('b')(n('c')(n(), n('d')), n()))));
+    QVERIFY(tree.get() == binary_tree<char>(n('a')(n(), n('b')(n('c'), n()))));
+}
+
+QTEST_MAIN(CowTreeTest)
+
+#include "CowTreeTest.moc"
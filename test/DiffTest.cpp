@@ -0,0 +1,214 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <vector>
+
+#include <TreeDS/tree>
+
+#include "Types.hpp"
+
+using namespace md;
+using namespace std;
+
+class DiffTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void equalTrees();
+    void emptyTrees();
+    void singleOperations();
+    void move();
+    void randomEdits();
+    void largeTree();
+    void customAllocator();
+};
+
+size_t count(const edit_script<char>& script, edit_kind kind) {
+    size_t result = 0u;
+    for (const edit_operation<char>& operation : script) {
+        result += operation.kind == kind ? 1u : 0u;
+    }
+    return result;
+}
+
+// Random tree of the given size, values taken among the first letters
+void DiffTest::equalTrees() {
+    nary_tree<char> a(n('a')(n('b')(n('c')), n('d')));
+    QVERIFY(diff(a, a).empty());
+    nary_tree<char> b(a);
+    QVERIFY(diff(a, b).empty());
+}
+
+void DiffTest::emptyTrees() {
+    nary_tree<char> empty;
+    nary_tree<char> tree(n('a')(n('b')));
+    QVERIFY(diff(empty, empty).empty());
+    edit_script<char> script = diff(empty, tree);
+    QCOMPARE(script.size(), 1u);
+    QVERIFY(script[0].kind == edit_kind::INSERT);
+    md::apply(empty, script);
+    QVERIFY(empty == tree);
+    script = diff(tree, nary_tree<char>());
+    QCOMPARE(script.size(), 1u);
+    QVERIFY(script[0].kind == edit_kind::REMOVE);
+    md::apply(tree, script);
+    QVERIFY(tree.empty());
+}
+
+void DiffTest::singleOperations() {
+    nary_tree<char> a(n('a')(n('b')(n('c'), n('d')), n('e')(n('f')), n('g')));
+    // Update
+    nary_tree<char> b(n('a')(n('b')(n('c'), n('x')), n('e')(n('f')), n('g')));
+    edit_script<char> script = diff(a, b);
+    QCOMPARE(script.size(), 1u);
+    QVERIFY(script[0].kind == edit_kind::UPDATE);
+    QCOMPARE(script[0].path, (vector<size_t> {0u, 1u}));
+    QCOMPARE(*script[0].value, 'x');
+    // Insert
+    b = n('a')(n('b')(n('c'), n('d')), n('h')(n('i'), n('j')), n('e')(n('f')), n('g'));
+    script = diff(a, b);
+    QCOMPARE(script.size(), 1u);
+    QVERIFY(script[0].kind == edit_kind::INSERT);
+    QCOMPARE(script[0].path, vector<size_t>());
+    QCOMPARE(script[0].index, 1u);
+    QVERIFY(script[0].subtree == nary_tree<char>(n('h')(n('i'), n('j'))));
+    // Remove
+    b = n('a')(n('b')(n('c'), n('d')), n('g'));
+    script = diff(a, b);
+    QCOMPARE(script.size(), 1u);
+    QVERIFY(script[0].kind == edit_kind::REMOVE);
+    QCOMPARE(script[0].path, vector<size_t> {1u});
+    // Every one applies
+    for (const nary_tree<char>& target :
+         {nary_tree<char>(n('a')(n('b')(n('c'), n('x')), n('e')(n('f')), n('g'))),
+          nary_tree<char>(n('z')(n('g'), n('b')(n('c'), n('d')))),
+          nary_tree<char>(n('a'))}) {
+        nary_tree<char> copy(a);
+        md::apply(copy, diff(a, target));
+        QVERIFY(copy == target);
+    }
+}
+
+void DiffTest::move() {
+    nary_tree<char> a(n('r')(n('x')(n('p')(n('q'), n('s'))), n('y')(n('z')), n('w')(n('v'))));
+    // The children of r reversed, p(q, s) moved under y
+    nary_tree<char> b(n('r')(n('w')(n('v')), n('y')(n('z'), n('p')(n('q'), n('s'))), n('x')));
+    edit_script<char> script = diff(a, b);
+    QCOMPARE(script.size(), 3u);
+    QCOMPARE(count(script, edit_kind::MOVE), 3u);
+    change_log<nary_node<char>> log;
+    a.set_change_log(&log);
+    md::apply(a, script);
+    QVERIFY(a == b);
+    QCOMPARE(a.size(), b.size());
+    // The nodes moved left the tree and came back
+    QVERIFY(!log.empty());
+    QVERIFY(log.get_removed().empty());
+    a.set_change_log(nullptr);
+    // A path that leads nowhere
+    script[0].path = {7u};
+    QVERIFY_EXCEPTION_THROWN(md::apply(a, script), std::invalid_argument);
+    QVERIFY(a == b);
+}
+
+void DiffTest::randomEdits() {
+    mt19937 random(5);
+    for (int i = 0; i < 300; ++i) {
+        const nary_tree<char> a = random_tree(random(), 1 + static_cast<int>(random() % 60), "abcd");
+        nary_tree<char> b(a);
+        const int edits = 1 + static_cast<int>(random() % 6);
+        for (int step = 0; step < edits; ++step) {
+            auto it = std::next(b.begin(policy::pre_order()), static_cast<int>(random() % b.size()));
+            switch (random() % 4) {
+            case 0:
+                b.insert_child(it, random() % (it.get_raw_node()->children() + 1u), n('x')(n('y')));
+                break;
+            case 1:
+                *it = static_cast<char>('a' + random() % 4);
+                break;
+            case 2:
+                if (it != b.root()) {
+                    b.erase(b.begin(policy::post_order()).other_node(it.get_raw_node()));
+                }
+                break;
+            case 3: {
+                // Move a subtree under a node outside of it
+                auto target = std::next(b.begin(policy::pre_order()), static_cast<int>(random() % b.size()));
+                bool inside = false;
+                for (auto node = target.get_raw_node(); node != nullptr; node = node->get_parent()) {
+                    inside |= node == it.get_raw_node();
+                }
+                if (!inside) {
+                    auto detached = b.detach_subtree(it);
+                    b.insert_child(target, random() % (target.get_raw_node()->children() + 1u), std::move(detached));
+                }
+                break;
+            }
+            }
+        }
+        nary_tree<char> copy(a);
+        edit_script<char> script = diff(a, b);
+        md::apply(copy, script);
+        QVERIFY(copy == b);
+        QCOMPARE(copy.size(), b.size());
+        // Also between unrelated trees
+        const nary_tree<char> other = random_tree(random(), 1 + static_cast<int>(random() % 30));
+        copy = a;
+        md::apply(copy, diff(a, other));
+        QVERIFY(copy == other);
+    }
+}
+
+void DiffTest::largeTree() {
+    mt19937 random(9);
+    tree_builder<nary_tree<char>> builder;
+    builder.open('r');
+    for (int i = 0; i < 300; ++i) {
+        builder.open('f');
+        for (int j = 0; j < 30; ++j) {
+            builder.open(static_cast<char>('a' + random() % 26));
+            builder.leaf(static_cast<char>('a' + random() % 26));
+            builder.leaf(static_cast<char>('a' + random() % 26));
+            builder.close();
+        }
+        builder.close();
+    }
+    builder.close();
+    const nary_tree<char> a = builder.build();
+    nary_tree<char> b(a);
+    // A function edited, one removed, one moved at the end
+    b.raw_root_node()->get_child(10u)->get_child(5u)->get_value() = '!';
+    b.erase(b.begin(policy::post_order()).other_node(b.raw_root_node()->get_child(100u)));
+    auto moved = b.detach_subtree(b.root().other_node(b.raw_root_node()->get_child(200u)));
+    b.insert_child_back(b.root(), std::move(moved));
+    edit_script<char> script = diff(a, b);
+    QCOMPARE(script.size(), 3u);
+    QCOMPARE(count(script, edit_kind::UPDATE), 1u);
+    QCOMPARE(count(script, edit_kind::REMOVE), 1u);
+    QCOMPARE(count(script, edit_kind::MOVE), 1u);
+    nary_tree<char> copy(a);
+    md::apply(copy, script);
+    QVERIFY(copy == b);
+}
+
+void DiffTest::customAllocator() {
+    using tree_type = nary_tree<char, default_policy, CustomAllocator<char>>;
+    {
+        tree_type a(n('a')(n('b')(n('c')), n('d')));
+        const tree_type b(n('a')(n('d'), n('x')(n('y')), n('b')(n('c'))));
+        edit_script<char> script = diff(a, b);
+        QVERIFY(!script.empty());
+        md::apply(a, script);
+        QVERIFY(a == b);
+        // Every node, the inserted ones included, comes from the allocator of the tree
+        QCOMPARE(CustomAllocator<nary_node<char>>::allocated.size(), a.size() + b.size());
+        tree_type empty;
+        md::apply(empty, diff(empty, b));
+        QVERIFY(empty == b);
+    }
+    QCOMPARE(CustomAllocator<nary_node<char>>::allocated.size(), 0u);
+}
+
+QTEST_MAIN(DiffTest)
+
+#include "DiffTest.moc"
@@ -0,0 +1,207 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+using namespace md;
+using namespace std;
+
+class IncrementalSearchTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void affected();
+    void removed();
+    void reset();
+    void singleEdit();
+    void sameAsSearchAll();
+    void searchAfterEdit();
+};
+
+nary_tree<char> make_tree() {
+    return n('a')(
+        n('b')(
+            n('c'),
+            n('d')(
+                n('e'))),
+        n('c')(
+            n('a')(
+                n('b'),
+                n('e'))),
+        n('b'));
+}
+
+void IncrementalSearchTest::affected() {
+    nary_tree<char> tree = make_tree();
+    change_log<nary_node<char>> log;
+    tree.set_change_log(&log);
+    QVERIFY(log.empty());
+    auto d = tree.begin(policy::pre_order());
+    std::advance(d, 3);
+    QCOMPARE(*d, 'd');
+    tree.insert_over(d, n('x')(n('y')));
+    QVERIFY(!log.empty());
+    vector<char> values;
+    log.for_each_affected([&](const nary_node<char>& node) {
+        values.push_back(node.get_value());
+    });
+    std::sort(values.begin(), values.end());
+    QCOMPARE(values, (vector<char> {'a', 'b', 'x', 'y'}));
+    log.clear();
+    QVERIFY(log.empty());
+    const nary_node<char>* e = tree.raw_root_node()->get_child(1)->get_child(0)->get_child(1);
+    log.touch(*e);
+    values.clear();
+    log.for_each_affected([&](const nary_node<char>& node) {
+        values.push_back(node.get_value());
+    });
+    QCOMPARE(values, (vector<char> {'e', 'a', 'c', 'a'}));
+    tree.set_change_log(nullptr);
+}
+
+void IncrementalSearchTest::removed() {
+    nary_tree<char> tree = make_tree();
+    change_log<nary_node<char>> log;
+    tree.set_change_log(&log);
+    const nary_node<char>* c = tree.raw_root_node()->get_child(1);
+    const nary_node<char>* a = c->get_child(0);
+    tree.erase(tree.begin(policy::post_order()).other_node(const_cast<nary_node<char>*>(c)));
+    QCOMPARE(log.get_removed().size(), 4u);
+    QVERIFY(log.get_removed().count(c) > 0u);
+    QVERIFY(log.get_removed().count(a) > 0u);
+    vector<char> values;
+    log.for_each_affected([&](const nary_node<char>& node) {
+        values.push_back(node.get_value());
+    });
+    QCOMPARE(values, (vector<char> {'a'}));
+    tree.set_change_log(nullptr);
+}
+
+void IncrementalSearchTest::reset() {
+    nary_tree<char> tree = make_tree();
+    change_log<nary_node<char>> log;
+    tree.set_change_log(&log);
+    pattern p(one('a')(one('b')));
+    incremental_search matches(p, tree);
+    QCOMPARE(matches.size(), 2u);
+    tree = n('a')(n('b'));
+    QVERIFY(log.is_reset());
+    matches.update(log);
+    log.clear();
+    QCOMPARE(matches.size(), 1u);
+    QVERIFY(matches.contains(tree.raw_root_node()));
+    tree.clear();
+    matches.update(log);
+    QCOMPARE(matches.size(), 0u);
+    tree.set_change_log(nullptr);
+}
+
+void IncrementalSearchTest::singleEdit() {
+    nary_tree<char> tree = make_tree();
+    change_log<nary_node<char>> log;
+    tree.set_change_log(&log);
+    pattern p(one('a')(one('b'), one('e')));
+    pattern q(one('b'));
+    incremental_search p_matches(p, tree);
+    incremental_search q_matches(q, tree);
+    QCOMPARE(p_matches.size(), 1u);
+    QCOMPARE(q_matches.size(), 3u);
+    // The last child of the root becomes 'e': the root now matches p, and q loses a match
+    auto last = tree.begin(policy::pre_order());
+    std::advance(last, 9);
+    QCOMPARE(last.get_raw_node(), tree.raw_root_node()->get_last_child());
+    tree.insert_over(last, 'e');
+    p_matches.update(log);
+    q_matches.update(log);
+    log.clear();
+    QCOMPARE(p_matches.size(), 2u);
+    QVERIFY(p_matches.contains(tree.raw_root_node()));
+    QCOMPARE(q_matches.size(), 2u);
+    tree.set_change_log(nullptr);
+}
+
+template <typename Make>
+void check(incremental_search<decltype(pattern(declval<Make>()())), nary_tree<char>>& matches, const nary_tree<char>& tree, Make make) {
+    pattern fresh(make());
+    unordered_set<const nary_node<char>*> expected;
+    for (const auto& match : fresh.search_all(tree)) {
+        expected.insert(match.get_node());
+    }
+    QVERIFY(matches.get_matches() == expected);
+}
+
+void IncrementalSearchTest::sameAsSearchAll() {
+    mt19937 random(11);
+    auto make_p = [] { return one('a')(one('b')); };
+    auto make_q = [] { return star()(one('c')(one('a')), one('b')); };
+    auto make_r = [] { return one()(opt('b'), one('c')); };
+    for (int i = 0; i < 50; ++i) {
+        change_log<nary_node<char>> log;
+        nary_tree<char> tree(n('a'));
+        tree.set_change_log(&log);
+        pattern p(make_p());
+        pattern q(make_q());
+        pattern r(make_r());
+        incremental_search p_matches(p, tree);
+        incremental_search q_matches(q, tree);
+        incremental_search r_matches(r, tree);
+        for (int step = 0; step < 60; ++step) {
+            // A few edits between two updates
+            int edits = 1 + static_cast<int>(random() % 3);
+            for (int j = 0; j < edits && !tree.empty(); ++j) {
+                auto it = tree.begin(policy::pre_order());
+                std::advance(it, random() % tree.size());
+                char value = "abc"[random() % 3];
+                switch (random() % 6) {
+                case 0:
+                case 1:
+                    tree.insert_child_back(it, value);
+                    break;
+                case 2:
+                    tree.insert_child_front(it, n(value)(n('b')));
+                    break;
+                case 3:
+                    tree.insert_over(it, value);
+                    break;
+                case 4:
+                    *it = value;
+                    log.touch(*it.get_raw_node());
+                    break;
+                case 5:
+                    if (it.get_raw_node() != tree.raw_root_node()) {
+                        tree.erase(tree.begin(policy::post_order()).other_node(it.get_raw_node()));
+                    }
+                    break;
+                }
+            }
+            p_matches.update(log);
+            q_matches.update(log);
+            r_matches.update(log);
+            log.clear();
+            check(p_matches, tree, make_p);
+            check(q_matches, tree, make_q);
+            check(r_matches, tree, make_r);
+        }
+        tree.set_change_log(nullptr);
+    }
+}
+
+void IncrementalSearchTest::searchAfterEdit() {
+    nary_tree<char> tree = make_tree();
+    pattern p(one('a')(one('e')));
+    QVERIFY(!p.search(tree));
+    tree.insert_child_back(tree.root(), 'e');
+    QVERIFY(p.search(tree));
+    const nary_tree<char>& constant = tree;
+    QVERIFY(p.search(constant));
+    tree.erase(tree.begin(policy::post_order()).other_node(tree.raw_root_node()->get_last_child()));
+    QVERIFY(!p.search(tree));
+}
+
+QTEST_MAIN(IncrementalSearchTest)
+
+#include "IncrementalSearchTest.moc"
@@ -0,0 +1,194 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <TreeDS/index>
+#include <TreeDS/tree>
+#include <TreeDS/view>
+
+using namespace md;
+using namespace std;
+
+class LcaIndexTest : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')(
+                    n('e'))),
+            n('f')(
+                n('g')(
+                    n('h'),
+                    n('i'))),
+            n('j'))};
+
+    private slots:
+    void numbering();
+    void ancestors();
+    void lowestCommonAncestor();
+    void emptyAndSingle();
+    void binaryTree();
+    void view();
+    void sameAsParentWalk();
+    void wrongTree();
+};
+
+// The reference answer, walking the parents
+template <typename Node>
+const Node* walk_lca(const Node* a, const Node* b, const Node* root) {
+    vector<const Node*> ancestors;
+    for (const Node* node = a;; node = node->get_parent()) {
+        ancestors.push_back(node);
+        if (node == root) {
+            break;
+        }
+    }
+    for (const Node* node = b;; node = node->get_parent()) {
+        if (find(ancestors.begin(), ancestors.end(), node) != ancestors.end()) {
+            return node;
+        }
+    }
+}
+
+void LcaIndexTest::numbering() {
+    preorder_numbering numbering(tree);
+    QCOMPARE(numbering.size(), 10u);
+    QVERIFY(numbering.is_index_of(tree));
+    vector<char> values;
+    for (size_t i = 0; i < numbering.size(); ++i) {
+        values.push_back(numbering.node(i)->get_value());
+        QCOMPARE(numbering.id(*numbering.node(i)), i);
+    }
+    QCOMPARE(values, (vector<char> {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j'}));
+    QCOMPARE(numbering.parent(0), preorder_numbering<nary_tree<char>>::NONE);
+    QCOMPARE(numbering.parent(4), 3u);
+    QCOMPARE(numbering.parent(9), 0u);
+    QCOMPARE(numbering.subtree_end(0), 10u);
+    QCOMPARE(numbering.subtree_end(1), 5u);
+    QCOMPARE(numbering.subtree_end(6), 9u);
+    QCOMPARE(numbering.subtree_end(9), 10u);
+}
+
+void LcaIndexTest::ancestors() {
+    lca_index index(tree);
+    const nary_node<char>* root = tree.raw_root_node();
+    const nary_node<char>* d    = root->get_first_child()->get_last_child();
+    const nary_node<char>* e    = d->get_first_child();
+    const nary_node<char>* g    = root->get_child(1)->get_first_child();
+    QVERIFY(index.is_ancestor(*root, *e));
+    QVERIFY(index.is_ancestor(*d, *e));
+    QVERIFY(index.is_ancestor(*e, *e));
+    QVERIFY(!index.is_ancestor(*e, *d));
+    QVERIFY(!index.is_ancestor(*g, *e));
+    QVERIFY(!index.is_ancestor(*d, *g));
+    QVERIFY(index.is_ancestor(0u, 9u));
+    QVERIFY(!index.is_ancestor(5u, 9u));
+}
+
+void LcaIndexTest::lowestCommonAncestor() {
+    lca_index index(tree);
+    const nary_node<char>* root = tree.raw_root_node();
+    const nary_node<char>* b    = root->get_first_child();
+    const nary_node<char>* c    = b->get_first_child();
+    const nary_node<char>* e    = b->get_last_child()->get_first_child();
+    const nary_node<char>* g    = root->get_child(1)->get_first_child();
+    const nary_node<char>* j    = root->get_last_child();
+    QCOMPARE(index.lowest_common_ancestor(*c, *e), b);
+    QCOMPARE(index.lowest_common_ancestor(*e, *c), b);
+    QCOMPARE(index.lowest_common_ancestor(*b, *e), b);
+    QCOMPARE(index.lowest_common_ancestor(*e, *b), b);
+    QCOMPARE(index.lowest_common_ancestor(*e, *e), e);
+    QCOMPARE(index.lowest_common_ancestor(*e, *g), root);
+    QCOMPARE(index.lowest_common_ancestor(*g->get_first_child(), *g->get_last_child()), g);
+    QCOMPARE(index.lowest_common_ancestor(*j, *c), root);
+    QCOMPARE(index.lowest_common_ancestor(*root, *root), root);
+    QCOMPARE(index.lowest_common_ancestor(7u, 8u), 6u);
+}
+
+void LcaIndexTest::emptyAndSingle() {
+    nary_tree<char> empty;
+    lca_index empty_index(empty);
+    QCOMPARE(empty_index.size(), 0u);
+    QCOMPARE(empty_index.find(*tree.raw_root_node()), lca_index<nary_tree<char>>::NONE);
+    nary_tree<char> single(n('a'));
+    lca_index index(single);
+    QCOMPARE(index.size(), 1u);
+    QCOMPARE(index.lowest_common_ancestor(*single.raw_root_node(), *single.raw_root_node()), single.raw_root_node());
+    QVERIFY(index.is_ancestor(*single.raw_root_node(), *single.raw_root_node()));
+}
+
+void LcaIndexTest::binaryTree() {
+    binary_tree<char> tree(
+        n('a')(
+            n('b')(
+                n(),
+                n('c')(
+                    n('d'),
+                    n('e'))),
+            n('f')));
+    lca_index index(tree);
+    QCOMPARE(index.size(), 6u);
+    const binary_node<char>* b = tree.raw_root_node()->get_left_child();
+    const binary_node<char>* c = b->get_right_child();
+    QCOMPARE(index.id(*c), 2u);
+    QCOMPARE(index.lowest_common_ancestor(*c->get_left_child(), *c->get_right_child()), c);
+    QCOMPARE(index.lowest_common_ancestor(*c->get_left_child(), *b), b);
+    QCOMPARE(index.lowest_common_ancestor(*c->get_left_child(), *tree.raw_root_node()->get_right_child()), tree.raw_root_node());
+}
+
+void LcaIndexTest::view() {
+    // A view of the subtree of b: its root has a parent in the tree, which is not indexed
+    const nary_node<char>* b = tree.raw_root_node()->get_first_child();
+    nary_tree_view<char> view(tree, tree.root().other_node(const_cast<nary_node<char>*>(b)));
+    lca_index index(view);
+    QCOMPARE(index.size(), 4u);
+    QCOMPARE(index.id(*b), 0u);
+    QCOMPARE(index.parent(0), lca_index<nary_tree_view<char>>::NONE);
+    QCOMPARE(index.lowest_common_ancestor(*b->get_first_child(), *b->get_last_child()->get_first_child()), b);
+    QVERIFY_EXCEPTION_THROWN(index.id(*tree.raw_root_node()), invalid_argument);
+}
+
+void LcaIndexTest::sameAsParentWalk() {
+    // Deep and wide parts, the ranges span many blocks
+    mt19937 random(1);
+    for (int size : {2, 31, 32, 33, 100, 5000}) {
+        vector<int> values(size);
+        vector<int> parents(size, -1);
+        for (int i = 1; i < size; ++i) {
+            values[i] = i;
+            // Mostly chains
+            parents[i] = random() % 4 == 0 ? static_cast<int>(random() % i) : i - 1;
+        }
+        nary_tree<int> random_tree = nary_tree<int>::from_parent_indices(values, parents);
+        lca_index index(random_tree);
+        QCOMPARE(index.size(), static_cast<size_t>(size));
+        vector<const nary_node<int>*> nodes;
+        for (auto it = random_tree.begin(policy::pre_order()); it != random_tree.end(policy::pre_order()); ++it) {
+            nodes.push_back(it.get_raw_node());
+        }
+        for (int i = 0; i < 2000; ++i) {
+            const nary_node<int>* a = nodes[random() % nodes.size()];
+            const nary_node<int>* b = nodes[random() % nodes.size()];
+            const nary_node<int>* expected = walk_lca(a, b, random_tree.raw_root_node());
+            QCOMPARE(index.lowest_common_ancestor(*a, *b), expected);
+            QCOMPARE(index.is_ancestor(*a, *b), expected == a);
+        }
+    }
+}
+
+void LcaIndexTest::wrongTree() {
+    nary_tree<char> other(tree);
+    lca_index index(other);
+    QVERIFY(!index.is_index_of(tree));
+    QCOMPARE(index.find(*tree.raw_root_node()), lca_index<nary_tree<char>>::NONE);
+    QVERIFY_EXCEPTION_THROWN(index.lowest_common_ancestor(*tree.raw_root_node(), *other.raw_root_node()), invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(index.is_ancestor(*other.raw_root_node(), *tree.raw_root_node()), invalid_argument);
+}
+
+QTEST_MAIN(LcaIndexTest)
+
+#include "LcaIndexTest.moc"
@@ -0,0 +1,164 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <TreeDS/index>
+#include <TreeDS/tree>
+#include <TreeDS/view>
+
+using namespace md;
+using namespace std;
+
+class LevelAncestorIndexTest : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')(
+                    n('e'))),
+            n('f')(
+                n('g')(
+                    n('h'),
+                    n('i'))),
+            n('j'))};
+
+    private slots:
+    void depths();
+    void ancestors();
+    void pastTheRoot();
+    void emptyAndSingle();
+    void binaryTree();
+    void view();
+    void sameAsParentWalk();
+    void wrongTree();
+};
+
+// The reference answer, walking the parents
+template <typename Node>
+const Node* walk_ancestor(const Node* node, size_t k) {
+    for (; node != nullptr && k > 0u; --k) {
+        node = node->get_parent();
+    }
+    return node;
+}
+
+void LevelAncestorIndexTest::depths() {
+    level_ancestor_index index(tree);
+    QCOMPARE(index.size(), 10u);
+    QCOMPARE(index.height(), 3u);
+    const nary_node<char>* root = tree.raw_root_node();
+    QCOMPARE(index.depth(*root), 0u);
+    QCOMPARE(index.depth(*root->get_first_child()->get_last_child()->get_first_child()), 3u);
+    QCOMPARE(index.depth(*root->get_last_child()), 1u);
+    QCOMPARE(index.depth(7u), 3u);
+}
+
+void LevelAncestorIndexTest::ancestors() {
+    level_ancestor_index index(tree);
+    const nary_node<char>* root = tree.raw_root_node();
+    const nary_node<char>* b    = root->get_first_child();
+    const nary_node<char>* d    = b->get_last_child();
+    const nary_node<char>* e    = d->get_first_child();
+    const nary_node<char>* g    = root->get_child(1)->get_first_child();
+    const nary_node<char>* i    = g->get_last_child();
+    QCOMPARE(index.ancestor(*e, 0u), e);
+    QCOMPARE(index.ancestor(*e, 1u), d);
+    QCOMPARE(index.ancestor(*e, 2u), b);
+    QCOMPARE(index.ancestor(*e, 3u), root);
+    QCOMPARE(index.ancestor(*i, 1u), g);
+    QCOMPARE(index.ancestor(*i, 2u), root->get_child(1));
+    QCOMPARE(index.ancestor(*root->get_last_child(), 1u), root);
+    QCOMPARE(index.ancestor_at_depth(index.id(*i), 1u), 5u);
+    QCOMPARE(index.ancestor(8u, 2u), 5u);
+}
+
+void LevelAncestorIndexTest::pastTheRoot() {
+    level_ancestor_index index(tree);
+    const nary_node<char>* e = tree.raw_root_node()->get_first_child()->get_last_child()->get_first_child();
+    QCOMPARE(index.ancestor(*e, 4u), static_cast<const nary_node<char>*>(nullptr));
+    QCOMPARE(index.ancestor(*tree.raw_root_node(), 1u), static_cast<const nary_node<char>*>(nullptr));
+    QCOMPARE(index.ancestor(4u, 100u), level_ancestor_index<nary_tree<char>>::NONE);
+    QCOMPARE(index.ancestor_at_depth(0u, 1u), level_ancestor_index<nary_tree<char>>::NONE);
+}
+
+void LevelAncestorIndexTest::emptyAndSingle() {
+    nary_tree<char> empty;
+    level_ancestor_index empty_index(empty);
+    QCOMPARE(empty_index.size(), 0u);
+    QCOMPARE(empty_index.height(), 0u);
+    nary_tree<char> single(n('a'));
+    level_ancestor_index index(single);
+    QCOMPARE(index.height(), 0u);
+    QCOMPARE(index.ancestor(*single.raw_root_node(), 0u), single.raw_root_node());
+    QCOMPARE(index.ancestor(*single.raw_root_node(), 1u), static_cast<const nary_node<char>*>(nullptr));
+}
+
+void LevelAncestorIndexTest::binaryTree() {
+    binary_tree<char> tree(
+        n('a')(
+            n('b')(
+                n(),
+                n('c')(
+                    n('d'),
+                    n('e'))),
+            n('f')));
+    level_ancestor_index index(tree);
+    QCOMPARE(index.height(), 3u);
+    const binary_node<char>* b = tree.raw_root_node()->get_left_child();
+    const binary_node<char>* e = b->get_right_child()->get_right_child();
+    QCOMPARE(index.ancestor(*e, 1u), b->get_right_child());
+    QCOMPARE(index.ancestor(*e, 2u), b);
+    QCOMPARE(index.ancestor(*e, 3u), tree.raw_root_node());
+}
+
+void LevelAncestorIndexTest::view() {
+    // A view of the subtree of b: the levels are counted from b, its parent is not indexed
+    const nary_node<char>* b = tree.raw_root_node()->get_first_child();
+    nary_tree_view<char> view(tree, tree.root().other_node(const_cast<nary_node<char>*>(b)));
+    level_ancestor_index index(view);
+    QCOMPARE(index.height(), 2u);
+    const nary_node<char>* e = b->get_last_child()->get_first_child();
+    QCOMPARE(index.depth(*e), 2u);
+    QCOMPARE(index.ancestor(*e, 2u), b);
+    QCOMPARE(index.ancestor(*e, 3u), static_cast<const nary_node<char>*>(nullptr));
+}
+
+void LevelAncestorIndexTest::sameAsParentWalk() {
+    mt19937 random(1);
+    for (int size : {2, 50, 3000, 20000}) {
+        vector<int> values(size);
+        vector<int> parents(size);
+        parents[0] = -1;
+        for (int i = 1; i < size; ++i) {
+            // Long chains with some branches
+            parents[i] = random() % 8 != 0 ? i - 1 : static_cast<int>(random() % i);
+        }
+        nary_tree<int> random_tree = nary_tree<int>::from_parent_indices(values, parents);
+        level_ancestor_index index(random_tree);
+        vector<const nary_node<int>*> nodes;
+        for (auto it = random_tree.begin(policy::pre_order()); it != random_tree.end(policy::pre_order()); ++it) {
+            nodes.push_back(it.get_raw_node());
+        }
+        for (int i = 0; i < 2000; ++i) {
+            const nary_node<int>* node = nodes[random() % nodes.size()];
+            const size_t depth         = index.depth(*node);
+            const size_t k             = random() % (depth + 2u);
+            QCOMPARE(index.ancestor(*node, k), walk_ancestor(node, k));
+        }
+    }
+}
+
+void LevelAncestorIndexTest::wrongTree() {
+    nary_tree<char> other(tree);
+    level_ancestor_index index(other);
+    QVERIFY_EXCEPTION_THROWN(index.ancestor(*tree.raw_root_node(), 0u), invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(index.depth(*tree.raw_root_node()), invalid_argument);
+}
+
+QTEST_MAIN(LevelAncestorIndexTest)
+
+#include "LevelAncestorIndexTest.moc"
@@ -0,0 +1,220 @@
+#include <QtTest/QtTest>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <TreeDS/match>
+#include <TreeDS/serialize>
+#include <TreeDS/tree>
+#include <TreeDS/view>
+
+#include "Types.hpp"
+
+using namespace std;
+using namespace md;
+
+class MappedTreeTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void navigation();
+    void iteration();
+    void file();
+    void search();
+    void views();
+    void invalidData();
+};
+
+// Keeps the data aligned like a mapped file would be
+struct aligned_buffer {
+    vector<std::uint64_t> storage;
+    size_t length;
+
+    template <typename Source>
+    aligned_buffer(const Source& source) {
+        stringstream stream;
+        {
+            mapped_writer writer(stream);
+            writer.write(source);
+        }
+        string data = stream.str();
+        length      = data.size();
+        storage.resize(length / sizeof(std::uint64_t) + 1);
+        memcpy(storage.data(), data.data(), length);
+    }
+};
+
+const nary_tree<char> reference(
+    n('a')(
+        n('b')(
+            n('d'),
+            n('e')(
+                n('h')),
+            n('f')),
+        n('c')(
+            n('g')(
+                n('i'),
+                n('j'),
+                n('k')))));
+
+void MappedTreeTest::navigation() {
+    aligned_buffer buffer(reference);
+    mapped_tree<char> tree(buffer.storage.data(), buffer.length);
+    tree.validate();
+    QCOMPARE(tree.size(), 11);
+    QCOMPARE(tree.arity(), 3);
+    const mapped_node<char>* a = tree.raw_root_node();
+    QCOMPARE(a->get_value(), 'a');
+    QVERIFY(a->is_root());
+    QVERIFY(a->get_parent() == nullptr);
+    QVERIFY(a->get_next_sibling() == nullptr);
+    QCOMPARE(a->children(), 2u);
+    const mapped_node<char>* b = a->get_first_child();
+    const mapped_node<char>* c = a->get_last_child();
+    QCOMPARE(b->get_value(), 'b');
+    QCOMPARE(c->get_value(), 'c');
+    QVERIFY(b->get_next_sibling() == c);
+    QVERIFY(c->get_prev_sibling() == b);
+    QVERIFY(b->get_prev_sibling() == nullptr);
+    QVERIFY(b->is_first_child() && !b->is_last_child());
+    QVERIFY(c->is_last_child() && !c->is_first_child());
+    QVERIFY(c->get_parent() == a);
+    QCOMPARE(b->children(), 3u);
+    QCOMPARE(b->get_child(1)->get_value(), 'e');
+    QCOMPARE(b->get_last_child()->get_value(), 'f');
+    QCOMPARE(b->get_child(1)->get_first_child()->get_value(), 'h');
+    QVERIFY(b->get_child(1)->get_first_child()->is_unique_child());
+    const mapped_node<char>* g = c->get_first_child();
+    QCOMPARE(g->get_last_child()->get_value(), 'k');
+    QCOMPARE(g->get_last_child()->get_prev_sibling()->get_value(), 'j');
+    QVERIFY(g->get_last_child()->get_parent() == g);
+}
+
+void MappedTreeTest::iteration() {
+    aligned_buffer buffer(reference);
+    mapped_tree<char> tree(buffer.storage.data(), buffer.length);
+    QCOMPARE(
+        vector<char>(tree.begin(policy::pre_order()), tree.end(policy::pre_order())),
+        vector<char>(reference.begin(policy::pre_order()), reference.end(policy::pre_order())));
+    QCOMPARE(
+        vector<char>(tree.begin(policy::post_order()), tree.end(policy::post_order())),
+        vector<char>(reference.begin(policy::post_order()), reference.end(policy::post_order())));
+    QCOMPARE(
+        vector<char>(tree.begin(policy::breadth_first()), tree.end(policy::breadth_first())),
+        vector<char>(reference.begin(policy::breadth_first()), reference.end(policy::breadth_first())));
+    QCOMPARE(
+        vector<char>(tree.begin(policy::leaves()), tree.end(policy::leaves())),
+        vector<char>(reference.begin(policy::leaves()), reference.end(policy::leaves())));
+    QCOMPARE(
+        vector<char>(tree.rbegin(policy::pre_order()), tree.rend(policy::pre_order())),
+        vector<char>(reference.rbegin(policy::pre_order()), reference.rend(policy::pre_order())));
+    QCOMPARE(*tree.root(), 'a');
+}
+
+void MappedTreeTest::file() {
+    // 4-ary complete tree of depth 7
+    nary_tree<long> source = complete_tree<nary_tree<long>>(4, 7);
+    const string path      = "MappedTreeTest.tree";
+    {
+        ofstream output(path, ios::binary);
+        mapped_writer writer(output);
+        writer.write(source);
+    }
+    {
+        mapped_tree<long> tree(path);
+        QCOMPARE(tree.size(), source.size());
+        QCOMPARE(tree.arity(), 4);
+        QVERIFY(std::equal(
+            tree.begin(policy::post_order()),
+            tree.end(policy::post_order()),
+            source.begin(policy::post_order()),
+            source.end(policy::post_order())));
+        // Moved trees keep the mapping alive
+        mapped_tree<long> moved(std::move(tree));
+        QVERIFY(tree.empty());
+        QCOMPARE(*moved.root(), 0l);
+        QVERIFY(std::equal(moved.begin(), moved.end(), source.begin(), source.end()));
+    }
+    // Wrong value type
+    QVERIFY_EXCEPTION_THROWN(mapped_tree<char> {path}, std::invalid_argument);
+    std::remove(path.c_str());
+    QVERIFY_EXCEPTION_THROWN(mapped_tree<long> {path}, std::runtime_error);
+}
+
+void MappedTreeTest::search() {
+    aligned_buffer buffer(reference);
+    mapped_tree<char> tree(buffer.storage.data(), buffer.length);
+    pattern p(star()(one('b')(star(), one('e'))));
+    QVERIFY(p.search(tree));
+    pattern q(one('a')(one('c')(one('g')(one('j')))));
+    QVERIFY(q.search(tree));
+    pattern r(one('a')(one('c')(one('b'))));
+    QVERIFY(!r.search(tree));
+}
+
+void MappedTreeTest::views() {
+    nary_tree_view<char> view(reference, find(reference.begin(), reference.end(), 'b'));
+    aligned_buffer buffer(view);
+    mapped_tree<char> tree(buffer.storage.data(), buffer.length);
+    QCOMPARE(tree.size(), 5);
+    QCOMPARE(tree.arity(), 3);
+    QVERIFY(tree.raw_root_node()->get_next_sibling() == nullptr);
+    QCOMPARE(
+        vector<char>(tree.begin(policy::pre_order()), tree.end(policy::pre_order())),
+        (vector<char> {'b', 'd', 'e', 'h', 'f'}));
+    aligned_buffer empty_buffer(nary_tree<char>{});
+    mapped_tree<char> empty(empty_buffer.storage.data(), empty_buffer.length);
+    empty.validate();
+    QVERIFY(empty.empty());
+    QCOMPARE(empty.size(), 0);
+    QVERIFY(empty.begin() == empty.end());
+}
+
+void MappedTreeTest::invalidData() {
+    aligned_buffer buffer(reference);
+    // Truncated
+    QVERIFY_EXCEPTION_THROWN(mapped_tree<char>(buffer.storage.data(), buffer.length - 1), std::invalid_argument);
+    // Misaligned
+    vector<char> shifted(buffer.length + 1);
+    memcpy(shifted.data() + 1, buffer.storage.data(), buffer.length);
+    QVERIFY_EXCEPTION_THROWN(
+        mapped_tree<char>(shifted.data() + (reinterpret_cast<uintptr_t>(shifted.data()) % 8 == 0 ? 1 : 0), buffer.length),
+        std::invalid_argument);
+    // Not a mapped tree
+    stringstream stream;
+    {
+        binary_writer writer(stream);
+        writer.write(reference);
+    }
+    string data = stream.str();
+    QVERIFY_EXCEPTION_THROWN(mapped_tree<char>(data.data(), data.size()), std::invalid_argument);
+    // Corrupted distances, the 5 integers after the value are the parent, previous sibling and last child distances,
+    // the subtree size and the number of following siblings. Opening trusts them, validate() reads them.
+    auto corrupt = [&](size_t node, size_t field, std::uint64_t value) {
+        aligned_buffer copy(reference);
+        auto* bytes = reinterpret_cast<unsigned char*>(copy.storage.data()) + binary_format::MAPPED_HEADER_SIZE;
+        binary_format::write_integer(bytes + (node + 1) * sizeof(mapped_node<char>) - (5 - field) * 8, value);
+        mapped_tree<char> tree(copy.storage.data(), copy.length);
+        tree.validate();
+        return tree.size();
+    };
+    QCOMPARE(corrupt(0, 3, 11), 11);
+    // The root is a, then b, d, e, h, f, c
+    QVERIFY_EXCEPTION_THROWN(corrupt(6, 0, 100), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(corrupt(6, 0, 0), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(corrupt(6, 1, 7), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(corrupt(0, 2, 1u << 30), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(corrupt(0, 2, 1), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(corrupt(1, 3, 1000), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(corrupt(1, 3, 0), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(corrupt(0, 3, 10), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(corrupt(2, 4, 5), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(corrupt(6, 4, 1), std::invalid_argument);
+}
+
+QTEST_MAIN(MappedTreeTest);
+#include "MappedTreeTest.moc"
@@ -0,0 +1,119 @@
+#include <QtTest/QtTest>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+#include <TreeDS/view>
+
+#include "Types.hpp"
+
+using namespace md;
+using namespace std;
+
+class MatchIteratorTest : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')(
+                    n('e'))),
+            n('c')(
+                n('a')(
+                    n('b'),
+                    n('e'))),
+            n('b'))};
+
+    private slots:
+    void values();
+    void captures();
+    void emptyTree();
+    void multiPass();
+    void sameAsRerooting();
+};
+
+void MatchIteratorTest::values() {
+    pattern p(one('b'));
+    vector<const nary_node<char>*> found;
+    for (const auto& match : p.search_all(tree)) {
+        QCOMPARE(match.get_node()->get_value(), 'b');
+        found.push_back(match.get_node());
+    }
+    QCOMPARE(found.size(), 3u);
+    QCOMPARE(found[0], tree.raw_root_node()->get_child(0));
+    QCOMPARE(found[1], tree.raw_root_node()->get_child(1)->get_child(0)->get_child(0));
+    QCOMPARE(found[2], tree.raw_root_node()->get_child(2));
+    // The pattern matches the subtree of each node
+    pattern q(star()(one('e')));
+    QCOMPARE(distance(q.search_all(tree).begin(), q.search_all(tree).end()), 7);
+}
+
+void MatchIteratorTest::captures() {
+    pattern p(one()(cpt(const_name<'x'>(), one('b')), cpt(one('e'))));
+    auto matches = p.search_all(tree);
+    auto it      = matches.begin();
+    QVERIFY(it != matches.end());
+    QCOMPARE(it->get_node()->get_value(), 'a');
+    QCOMPARE(it->get_mark(const_name<'x'>()), tree.raw_root_node()->get_child(1)->get_child(0)->get_child(0));
+    QCOMPARE(it->get_mark(const_index<2>()), tree.raw_root_node()->get_child(1)->get_child(0)->get_child(1));
+    QCOMPARE(it->mark_count(), 2u);
+    ++it;
+    QVERIFY(it == matches.end());
+}
+
+void MatchIteratorTest::emptyTree() {
+    nary_tree<char> empty;
+    pattern p(star());
+    auto matches = p.search_all(empty);
+    QVERIFY(matches.begin() == matches.end());
+}
+
+void MatchIteratorTest::multiPass() {
+    pattern p(one('c'));
+    auto matches = p.search_all(tree);
+    auto first   = matches.begin();
+    auto second  = first;
+    ++first;
+    QCOMPARE(second->get_node(), tree.raw_root_node()->get_child(0)->get_child(0));
+    QCOMPARE(first->get_node(), tree.raw_root_node()->get_child(1));
+    ++second;
+    QVERIFY(first == second);
+    QCOMPARE((*second).get_node(), tree.raw_root_node()->get_child(1));
+    ++first;
+    QVERIFY(first == matches.end());
+}
+
+template <typename Make>
+void compare_with_rerooting(const nary_tree<char>& tree, Make make) {
+    pattern all(make());
+    auto matches = all.search_all(tree);
+    auto match   = matches.begin();
+    for (auto it = tree.begin(policy::pre_order()); it != tree.end(policy::pre_order()); ++it) {
+        nary_tree_view<char> view(tree, it);
+        pattern single(make());
+        if (single.search(view)) {
+            QVERIFY(match != matches.end());
+            QCOMPARE(match->get_node(), it.get_raw_node());
+            ++match;
+        }
+    }
+    QVERIFY(match == matches.end());
+}
+
+void MatchIteratorTest::sameAsRerooting() {
+    mt19937 random(3);
+    for (int i = 0; i < 200; ++i) {
+        nary_tree<char> tree = random_tree(random(), 1 + static_cast<int>(random() % 30));
+        compare_with_rerooting(tree, [] { return one('a')(one('b')); });
+        compare_with_rerooting(tree, [] { return star()(one('a')(one('b')), one('c')); });
+        compare_with_rerooting(tree, [] { return one()(star('a')(one('c')), opt('b')(one('a'))); });
+    }
+}
+
+QTEST_MAIN(MatchIteratorTest)
+
+#include "MatchIteratorTest.moc"
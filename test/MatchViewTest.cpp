@@ -0,0 +1,155 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <vector>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+#include <TreeDS/view>
+
+#include "Types.hpp"
+
+using namespace md;
+using namespace std;
+
+class MatchViewTest : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')(
+                    n('e'))),
+            n('c')(
+                n('a')(
+                    n('b'),
+                    n('e'))),
+            n('b'))};
+
+    private slots:
+    void resultView();
+    void markView();
+    void matchView();
+    void sameAsReluctantResult();
+    void binaryTree();
+    void wrongTree();
+};
+
+template <typename Builder, typename View, typename Node>
+void build_from(Builder& builder, const View& view, const Node* node) {
+    auto navigator = view.get_navigator();
+    const Node* child = navigator.get_first_child(node);
+    if (child == nullptr) {
+        builder.leaf(node->get_value());
+        return;
+    }
+    builder.open(node->get_value());
+    for (; child != nullptr; child = navigator.get_next_sibling(child)) {
+        build_from(builder, view, child);
+    }
+    builder.close();
+}
+
+// Copies the nodes shown by the view, only used to check its shape
+template <typename View>
+nary_tree<char> copy_of(const View& view) {
+    tree_builder<nary_tree<char>> builder;
+    if (!view.empty()) {
+        build_from(builder, view, view.raw_root_node());
+    }
+    return builder.build();
+}
+
+void MatchViewTest::resultView() {
+    pattern p(one('a')(one('c')(one('a'))));
+    QVERIFY(p.search(tree));
+    auto view = p.result_view(tree);
+    // Same nodes of the tree, not a copy
+    QCOMPARE(view.raw_root_node(), tree.raw_root_node());
+    QCOMPARE(view, nary_tree_view<char>(tree));
+    vector<char> values(view.begin(policy::pre_order()), view.end(policy::pre_order()));
+    QCOMPARE(values, vector<char>(tree.begin(policy::pre_order()), tree.end(policy::pre_order())));
+}
+
+void MatchViewTest::markView() {
+    pattern p(one('a')(cpt(const_name<'x'>(), one('b')(one('d'))), cpt(one('c'))));
+    QVERIFY(p.search(tree));
+    auto x = p.mark_view(const_name<'x'>(), tree);
+    QCOMPARE(x.raw_root_node(), tree.raw_root_node()->get_child(0));
+    QVERIFY(x == n('b')(n('c'), n('d')(n('e'))));
+    auto second = p.mark_view(const_index<2>(), tree);
+    QCOMPARE(second.raw_root_node(), tree.raw_root_node()->get_child(1));
+    nary_tree<char> copy;
+    p.assign_mark(const_index<2>(), copy);
+    QVERIFY(second == n('c')(n('a')(n('b'), n('e'))));
+    QCOMPARE(copy, nary_tree<char>(n('c')));
+}
+
+void MatchViewTest::matchView() {
+    pattern p(one('a')(one('b')(one('d')), cpt(const_name<'y'>(), one('c')(one('a')(one('e'))))));
+    QVERIFY(p.search(tree));
+    auto view = p.result_match_view(tree);
+    QCOMPARE(view.raw_root_node(), tree.raw_root_node());
+    vector<char> values(view.begin(policy::pre_order()), view.end(policy::pre_order()));
+    QCOMPARE(values, (vector<char> {'a', 'b', 'd', 'c', 'a', 'e'}));
+    vector<char> post(view.begin(policy::post_order()), view.end(policy::post_order()));
+    QCOMPARE(post, (vector<char> {'d', 'b', 'e', 'a', 'c', 'a'}));
+    vector<char> breadth(view.begin(policy::breadth_first()), view.end(policy::breadth_first()));
+    QCOMPARE(breadth, (vector<char> {'a', 'b', 'c', 'd', 'a', 'e'}));
+    QVERIFY(view.contains(tree.raw_root_node()->get_child(1)->get_child(0)->get_child(1)));
+    QVERIFY(!view.contains(tree.raw_root_node()->get_child(1)->get_child(0)->get_child(0)));
+    QVERIFY(!view.contains(tree.raw_root_node()->get_child(2)));
+
+    auto mark = p.mark_match_view(const_name<'y'>(), tree);
+    QCOMPARE(copy_of(mark), nary_tree<char>(n('c')(n('a')(n('e')))));
+    QCOMPARE(mark.raw_root_node(), tree.raw_root_node()->get_child(1));
+}
+
+void MatchViewTest::sameAsReluctantResult() {
+    mt19937 random(5);
+    for (int i = 0; i < 200; ++i) {
+        nary_tree<char> tree = random_tree(random(), 1 + static_cast<int>(random() % 30));
+        pattern p(star<quantifier::RELUCTANT>()(
+            cpt(one('a')(one('b'), star<quantifier::RELUCTANT>()(one('c')))),
+            opt<quantifier::RELUCTANT>('b')));
+        if (!p.search(tree)) {
+            continue;
+        }
+        nary_tree<char> result;
+        p.assign_result(result);
+        QCOMPARE(copy_of(p.result_match_view(tree)), result);
+        nary_tree<char> mark;
+        p.assign_mark(const_index<1>(), mark);
+        QCOMPARE(copy_of(p.mark_match_view(const_index<1>(), tree)), mark);
+    }
+}
+
+void MatchViewTest::binaryTree() {
+    binary_tree<char> binary {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')),
+            n('e')(
+                n('f')))};
+    pattern p(one('a')(one('e')(one('f'))));
+    QVERIFY(p.search(binary));
+    binary_tree_view<char> view = p.result_view(binary);
+    QCOMPARE(view.raw_root_node(), binary.raw_root_node());
+    auto matched = p.result_match_view(binary);
+    vector<char> values(matched.begin(policy::in_order()), matched.end(policy::in_order()));
+    QCOMPARE(values, (vector<char> {'a', 'f', 'e'}));
+}
+
+void MatchViewTest::wrongTree() {
+    pattern p(one('a'));
+    nary_tree<char> other(tree);
+    QVERIFY(p.search(tree));
+    QVERIFY_EXCEPTION_THROWN(p.result_view(other), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(p.result_match_view(other), std::invalid_argument);
+}
+
+QTEST_MAIN(MatchViewTest)
+
+#include "MatchViewTest.moc"
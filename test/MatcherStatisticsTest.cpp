@@ -0,0 +1,112 @@
+#define MD_MATCHER_STATISTICS 1
+
+#include <QtTest/QtTest>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+using namespace md;
+using namespace std;
+
+class MatcherStatisticsTest : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')(
+                    n('e'))),
+            n('c')(
+                n('a')(
+                    n('b'),
+                    n('e'))),
+            n('b'))};
+
+    private slots:
+    void steps();
+    void backtracks();
+    void allocations();
+    void searchAll();
+    void cleared();
+    void storage();
+};
+
+void MatcherStatisticsTest::steps() {
+    pattern p(one('a')(one('c'), one('b')));
+    QVERIFY(p.search(tree));
+    auto statistics = p.get_statistics();
+    QCOMPARE(statistics.matchers.size(), 3u);
+    // The root is tried only on the root of the tree
+    QCOMPARE(statistics.matchers[0].steps, 1u);
+    // one('c') tries the first 'b' then matches 'c', one('b') matches the last child
+    QCOMPARE(statistics.matchers[1].steps, 2u);
+    QCOMPARE(statistics.matchers[2].steps, 1u);
+    // Each one() builds the iterator over the children of its node
+    QCOMPARE(statistics.matchers[0].iterator_rebuilds, 1u);
+    QCOMPARE(statistics.total().steps, 4u);
+    QCOMPARE(statistics.total().backtracks, 0u);
+    QCOMPARE(statistics.total().allocations, 0u);
+    QVERIFY(statistics.elapsed.count() > 0);
+}
+
+void MatcherStatisticsTest::backtracks() {
+    // opt('b') takes the first 'b', then gives it up because one('b') one('c') cannot match after it
+    pattern p(one('a')(opt('b'), one('b'), one('c')));
+    QVERIFY(p.search(tree));
+    auto statistics = p.get_statistics();
+    QCOMPARE(statistics.matchers[1].backtracks, 1u);
+    QCOMPARE(statistics.total().backtracks, 1u);
+    nary_tree<char> result;
+    p.assign_result(result);
+    QCOMPARE(result, nary_tree<char>(n('a')(n('b'), n('c'))));
+}
+
+void MatcherStatisticsTest::allocations() {
+    pattern p(star()(one('b'), one('b')));
+    QVERIFY(p.search(tree));
+    QCOMPARE(p.get_statistics().total().allocations, 0u);
+    nary_tree<char> result;
+    p.assign_result(result);
+    QCOMPARE(p.get_statistics().total().allocations, result.size());
+    nary_tree<char> mark;
+    pattern q(one('a')(cpt(one('c')(one('a')))));
+    QVERIFY(q.search(tree));
+    q.assign_mark(const_index<1>(), mark);
+    QCOMPARE(q.get_statistics().total().allocations, mark.size());
+}
+
+void MatcherStatisticsTest::searchAll() {
+    pattern p(one('b'));
+    int matches = 0;
+    for (const auto& match : p.search_all(tree)) {
+        (void)match;
+        ++matches;
+    }
+    QCOMPARE(matches, 3);
+    // Every node of the tree was tried once as root
+    QCOMPARE(p.get_statistics().matchers[0].steps, tree.size());
+    QCOMPARE(p.get_statistics().matchers[0].iterator_rebuilds, 3u);
+}
+
+void MatcherStatisticsTest::cleared() {
+    pattern p(one('a')(one('c'), one('b')));
+    QVERIFY(p.search(tree));
+    nary_tree<char> other(n('a')(n('c'), n('b')));
+    QVERIFY(p.search(other));
+    auto statistics = p.get_statistics();
+    QCOMPARE(statistics.matchers[1].steps, 1u);
+    QCOMPARE(statistics.total().steps, 3u);
+}
+
+// When disabled, the matchers and the patterns inherit empty storages that take no space
+void MatcherStatisticsTest::storage() {
+    QVERIFY((is_empty_v<detail::matcher_statistics_storage<int, false>>));
+    QVERIFY((is_empty_v<detail::search_time_storage<int, false>>));
+    QCOMPARE(sizeof(detail::matcher_statistics_storage<int>), sizeof(matcher_statistics));
+}
+
+QTEST_MAIN(MatcherStatisticsTest)
+
+#include "MatcherStatisticsTest.moc"
@@ -0,0 +1,175 @@
+#include <QtTest/QtTest>
+#include <random>
+
+#include <TreeDS/index>
+#include <TreeDS/tree>
+
+using namespace md;
+using namespace std;
+
+class MerkleIndexTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void hashes();
+    void equal();
+    void update();
+    void binaryTree();
+    void sameAsRebuild();
+};
+
+nary_tree<char> make_tree() {
+    return n('a')(
+        n('b')(
+            n('c'),
+            n('d')),
+        n('e')(
+            n('b')(
+                n('c'),
+                n('d'))),
+        n('f'));
+}
+
+void MerkleIndexTest::hashes() {
+    nary_tree<char> tree = make_tree();
+    merkle_index index(tree);
+    QCOMPARE(index.size(), 9u);
+    const nary_node<char>* root = tree.raw_root_node();
+    // Equal subtrees have equal hashes
+    QCOMPARE(index.hash(*root->get_child(0)), index.hash(*root->get_child(1)->get_child(0)));
+    QVERIFY(index.hash(*root->get_child(0)) != index.hash(*root->get_child(1)));
+    QCOMPARE(index.hash(*root), index.hash());
+    // The order and the nesting of the children matter
+    nary_tree<char> swapped {n('a')(n('c'), n('b'))};
+    nary_tree<char> ordered {n('a')(n('b'), n('c'))};
+    nary_tree<char> nested {n('a')(n('b')(n('c')))};
+    merkle_index swapped_index(swapped);
+    merkle_index ordered_index(ordered);
+    merkle_index nested_index(nested);
+    QVERIFY(swapped_index.hash() != ordered_index.hash());
+    QVERIFY(nested_index.hash() != ordered_index.hash());
+    nary_tree<char> empty;
+    merkle_index empty_index(empty);
+    QCOMPARE(empty_index.size(), 0u);
+    QVERIFY(empty_index.hash() != ordered_index.hash());
+    QVERIFY_EXCEPTION_THROWN(index.hash(*swapped.raw_root_node()), std::invalid_argument);
+    QVERIFY(index.is_index_of(tree));
+    QVERIFY(!index.is_index_of(swapped));
+}
+
+void MerkleIndexTest::equal() {
+    nary_tree<char> tree = make_tree();
+    nary_tree<char> copy(tree);
+    nary_tree<char> other {n('a')(n('b')(n('c'), n('d')), n('e')(n('b')(n('c'), n('x'))), n('f'))};
+    merkle_index index(tree);
+    merkle_index copy_index(copy);
+    merkle_index other_index(other);
+    QCOMPARE(index.hash(), copy_index.hash());
+    QVERIFY(index.equal(copy_index));
+    QVERIFY(index.hash() != other_index.hash());
+    QVERIFY(!index.equal(other_index));
+    QVERIFY(!other_index.equal(index));
+}
+
+void MerkleIndexTest::update() {
+    change_log<nary_node<char>> log;
+    nary_tree<char> tree = make_tree();
+    tree.set_change_log(&log);
+    merkle_index index(tree);
+    const size_t before = index.hash();
+    // Insert then remove the same child
+    tree.insert_child_back(tree.root(), 'g');
+    index.update(log);
+    log.clear();
+    QVERIFY(index.hash() != before);
+    QCOMPARE(index.size(), 10u);
+    tree.erase(tree.begin(policy::post_order()).other_node(tree.raw_root_node()->get_last_child()));
+    index.update(log);
+    log.clear();
+    QCOMPARE(index.hash(), before);
+    QCOMPARE(index.size(), 9u);
+    // A value modified through an iterator and reported to the log
+    nary_node<char>* f = tree.raw_root_node()->get_last_child();
+    f->get_value()     = 'x';
+    log.touch(*f);
+    index.update(log);
+    log.clear();
+    QCOMPARE(index.hash(), merkle_index(tree).hash());
+    // Making the two subtrees b(c, d) different
+    nary_node<char>* b = tree.raw_root_node()->get_child(0);
+    tree.insert_over(tree.begin(policy::pre_order()).other_node(b->get_child(1)), 'y');
+    index.update(log);
+    log.clear();
+    QVERIFY(index.hash(*b) != index.hash(*tree.raw_root_node()->get_child(1)->get_child(0)));
+    QCOMPARE(index.hash(), merkle_index(tree).hash());
+    // The whole tree replaced
+    tree = make_tree();
+    index.update(log);
+    log.clear();
+    QCOMPARE(index.hash(), before);
+    tree.set_change_log(nullptr);
+}
+
+void MerkleIndexTest::binaryTree() {
+    binary_tree<char> left {n('a')(n('b'))};
+    binary_tree<char> right {n('a')(n(), n('b'))};
+    binary_tree<char> other_left {n('a')(n('b'), n())};
+    merkle_index left_index(left);
+    merkle_index right_index(right);
+    merkle_index other_index(other_left);
+    QVERIFY(left_index.hash() != right_index.hash());
+    QVERIFY(!left_index.equal(right_index));
+    QVERIFY(left_index.equal(other_index));
+}
+
+void MerkleIndexTest::sameAsRebuild() {
+    mt19937 random(13);
+    for (int i = 0; i < 50; ++i) {
+        change_log<nary_node<char>> log;
+        nary_tree<char> tree(n('a'));
+        tree.set_change_log(&log);
+        merkle_index index(tree);
+        for (int step = 0; step < 60; ++step) {
+            int edits = 1 + static_cast<int>(random() % 3);
+            for (int j = 0; j < edits && !tree.empty(); ++j) {
+                auto it = tree.begin(policy::pre_order());
+                std::advance(it, random() % tree.size());
+                char value = "abc"[random() % 3];
+                switch (random() % 6) {
+                case 0:
+                case 1:
+                    tree.insert_child_back(it, value);
+                    break;
+                case 2:
+                    tree.insert_child_front(it, n(value)(n('b')));
+                    break;
+                case 3:
+                    tree.insert_over(it, value);
+                    break;
+                case 4:
+                    *it = value;
+                    log.touch(*it.get_raw_node());
+                    break;
+                case 5:
+                    if (it.get_raw_node() != tree.raw_root_node()) {
+                        tree.erase(tree.begin(policy::post_order()).other_node(it.get_raw_node()));
+                    }
+                    break;
+                }
+            }
+            index.update(log);
+            log.clear();
+            merkle_index expected(tree);
+            QCOMPARE(index.size(), expected.size());
+            for (auto it = tree.begin(policy::pre_order()); it != tree.end(policy::pre_order()); ++it) {
+                QCOMPARE(index.hash(*it.get_raw_node()), expected.hash(*it.get_raw_node()));
+            }
+        }
+        tree.set_change_log(nullptr);
+    }
+}
+
+QTEST_MAIN(MerkleIndexTest)
+
+#include "MerkleIndexTest.moc"
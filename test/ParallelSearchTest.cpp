@@ -0,0 +1,139 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <vector>
+
+#include <TreeDS/match>
+#include <TreeDS/parallel>
+#include <TreeDS/tree>
+
+#include "Types.hpp"
+
+using namespace md;
+using namespace std;
+
+class ParallelSearchTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void simple();
+    void empty();
+    void sameAsSearchAll();
+    void binaryTree();
+    void exception();
+};
+
+// Comparing the value '!' throws
+struct Fragile {
+    char value;
+};
+
+bool operator==(const Fragile& a, const Fragile& b) {
+    if (a.value == '!' || b.value == '!') {
+        throw runtime_error("Compared a fragile value.");
+    }
+    return a.value == b.value;
+}
+
+// Compares the occurrences found by many threads with the ones found by search_all(), the pattern has a capture
+template <typename Pattern, typename Tree>
+void compare(Pattern& p, const Tree& tree, size_t threads) {
+    using match_type = pattern_match<typename Tree::node_type, typename Pattern::captures_type>;
+    vector<match_type> expected;
+    for (const auto& match : p.search_all(tree)) {
+        expected.push_back(match);
+    }
+    vector<match_type> actual = p.search_all(tree, parallel(threads));
+    QCOMPARE(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        QCOMPARE(actual[i].get_node(), expected[i].get_node());
+        QCOMPARE(actual[i].get_mark(const_index<1>()), expected[i].get_mark(const_index<1>()));
+    }
+}
+
+void ParallelSearchTest::simple() {
+    nary_tree<char> tree {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('a')(
+                    n('b'))),
+            n('c')(
+                n('a')(
+                    n('b'),
+                    n('e'))),
+            n('b'))};
+    pattern p(one('a')(cpt(one('b'))));
+    auto matches = p.search_all(tree, parallel(4));
+    QCOMPARE(matches.size(), 3u);
+    const nary_node<char>* root = tree.raw_root_node();
+    QCOMPARE(matches[0].get_node(), root);
+    QCOMPARE(matches[0].get_mark(const_index<1>()), root->get_child(0));
+    QCOMPARE(matches[1].get_node(), root->get_child(0)->get_child(1));
+    QCOMPARE(matches[2].get_node(), root->get_child(1)->get_child(0));
+    QCOMPARE(matches[2].get_mark(const_index<1>()), root->get_child(1)->get_child(0)->get_child(0));
+    QVERIFY(parallel().threads >= 1u);
+}
+
+void ParallelSearchTest::empty() {
+    nary_tree<char> tree;
+    pattern p(one('a'));
+    QVERIFY(p.search_all(tree, parallel(3)).empty());
+    nary_tree<char> other {n('b')(n('c'))};
+    QVERIFY(p.search_all(other, parallel(3)).empty());
+}
+
+void ParallelSearchTest::sameAsSearchAll() {
+    mt19937 random(11);
+    for (int i = 0; i < 20; ++i) {
+        nary_tree<char> tree = random_tree(random(), 1 + static_cast<int>(random() % 5000));
+        pattern p1(one('a')(cpt(one('b')), star()(one('c'))));
+        pattern p2(star('a')(cpt(one('b')(one('c'))), opt('a')));
+        pattern p3(one()(star<quantifier::RELUCTANT>()(cpt(one('c')))));
+        for (size_t threads : {1u, 2u, 3u, 8u}) {
+            compare(p1, tree, threads);
+            compare(p2, tree, threads);
+            compare(p3, tree, threads);
+        }
+    }
+}
+
+void ParallelSearchTest::binaryTree() {
+    binary_tree<char> tree {
+        n('a')(
+            n('b')(
+                n('a')(
+                    n('b'),
+                    n('c')),
+                n('d')),
+            n('a')(
+                n(),
+                n('b')))};
+    pattern p(one('a')(cpt(one('b'))));
+    compare(p, tree, 3u);
+    QCOMPARE(p.search_all(tree, parallel(2)).size(), 3u);
+}
+
+void ParallelSearchTest::exception() {
+    // Complete 4-ary tree of 'a', where a single node deep in the tree is '!'
+    vector<Fragile> values(2000, Fragile {'a'});
+    vector<int> parents(values.size(), -1);
+    for (size_t i = 1; i < values.size(); ++i) {
+        parents[i] = static_cast<int>(i - 1) / 4;
+    }
+    values[1500].value = '!';
+
+    nary_tree<Fragile> tree = nary_tree<Fragile>::from_parent_indices(values, parents);
+    pattern p(one(Fragile {'a'})(one(Fragile {'b'})));
+    // The error reaches the caller, whichever thread met the node
+    for (size_t threads : {1u, 2u, 8u}) {
+        QVERIFY_EXCEPTION_THROWN(p.search_all(tree, parallel(threads)), runtime_error);
+    }
+    values[1500].value = 'a';
+    tree               = nary_tree<Fragile>::from_parent_indices(values, parents);
+    QVERIFY(p.search_all(tree, parallel(8)).empty());
+}
+
+QTEST_MAIN(ParallelSearchTest)
+
+#include "ParallelSearchTest.moc"
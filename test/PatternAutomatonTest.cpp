@@ -0,0 +1,177 @@
+#include <QtTest/QtTest>
+#include <cstring>
+#include <random>
+#include <sstream>
+
+#include <TreeDS/match>
+#include <TreeDS/serialize>
+#include <TreeDS/tree>
+
+#include "Types.hpp"
+
+using namespace md;
+using namespace std;
+
+class PatternAutomatonTest : public QObject {
+
+    Q_OBJECT
+
+    binary_tree<char> binary {
+        n('x')(
+            n('a')(
+                n('a')(
+                    n(),
+                    n('a')(
+                        n('a')(
+                            n('a'),
+                            n('a')),
+                        n('a')(
+                            n('a')(
+                                n(),
+                                n('y')),
+                            n('a')))),
+                n('b')(
+                    n('b'),
+                    n('b')(
+                        n('y')))),
+            n('a'))};
+    nary_tree<char> nary {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')(
+                    n('e'))),
+            n('c')(
+                n('a')(
+                    n('b'),
+                    n('e'))),
+            n('f'))};
+
+    private slots:
+    void one();
+    void star();
+    void opt();
+    void quantifiers();
+    void captures();
+    void emptyTree();
+    void mappedTree();
+    void sameAsBacktracking();
+};
+
+void PatternAutomatonTest::one() {
+    QVERIFY(pattern_automaton(md::one('a')).search(nary));
+    QVERIFY(!pattern_automaton(md::one('b')).search(nary));
+    QVERIFY(pattern_automaton(md::one('a')(md::one('b'), md::one('f'))).search(nary));
+    QVERIFY(pattern_automaton(md::one('a')(md::one('b')(md::one('d')(md::one('e'))))).search(nary));
+    // Children must be in the same order
+    QVERIFY(!pattern_automaton(md::one('a')(md::one('c'), md::one('b'))).search(nary));
+    QVERIFY(!pattern_automaton(md::one('a')(md::one('b'), md::one('b'))).search(nary));
+    QVERIFY(pattern_automaton(md::one()(md::one(), md::one(), md::one())).search(nary));
+    QVERIFY(!pattern_automaton(md::one()(md::one(), md::one(), md::one(), md::one())).search(nary));
+    QVERIFY(pattern_automaton(md::one('x')(md::one('a'), md::one('a'))).search(binary));
+}
+
+void PatternAutomatonTest::star() {
+    QVERIFY(pattern_automaton(md::star()(md::one('e'))).search(nary));
+    QVERIFY(!pattern_automaton(md::star()(md::one('g'))).search(nary));
+    QVERIFY(pattern_automaton(md::star()(md::one('d')(md::one('e')), md::one('a'))).search(nary));
+    // Matched subtrees must be disjoint and in pre-order
+    QVERIFY(!pattern_automaton(md::star()(md::one('c')(md::one('a')), md::one('b'))).search(nary));
+    QVERIFY(!pattern_automaton(md::star()(md::one('e'), md::one('d'))).search(nary));
+    QVERIFY(pattern_automaton(md::star()(md::one('b'), md::one('b'))).search(nary));
+    // The children match only below nodes accepted by the star
+    QVERIFY(pattern_automaton(md::star('a')(md::one('b'), md::one('c'))).search(nary));
+    QVERIFY(!pattern_automaton(md::star('a')(md::one('e'))).search(nary));
+    QVERIFY(pattern_automaton(md::star()(md::star('a')(md::one('y'), md::one('b')))).search(binary));
+    QVERIFY(!pattern_automaton(md::star()(md::star('a')(md::one('b'), md::one('y')))).search(binary));
+    // A single child can take the node of the star
+    QVERIFY(pattern_automaton(md::star('z')(md::one('a'))).search(nary));
+    QVERIFY(pattern_automaton(md::star()(md::star(), md::one('x'), md::star())).search(binary));
+}
+
+void PatternAutomatonTest::opt() {
+    QVERIFY(pattern_automaton(md::opt('z')).search(nary));
+    QVERIFY(pattern_automaton(md::one('a')(md::opt('z'), md::one('c'), md::opt('z'))).search(nary));
+    QVERIFY(pattern_automaton(md::one('a')(md::opt('b')(md::one('d')), md::one('f'))).search(nary));
+    QVERIFY(!pattern_automaton(md::one('a')(md::opt('b')(md::one('a')), md::one('f'))).search(nary));
+    // The child of the opt takes the node
+    QVERIFY(pattern_automaton(md::one('a')(md::opt('z')(md::one('b')), md::one('c'))).search(nary));
+}
+
+void PatternAutomatonTest::quantifiers() {
+    QVERIFY(pattern_automaton(md::star()(md::star<quantifier::RELUCTANT>('a')(md::one('y'), md::one('b')))).search(binary));
+    QVERIFY(pattern_automaton(md::star()(md::star<quantifier::GREEDY>('a')(md::one('y'), md::one('b')))).search(binary));
+    QVERIFY(pattern_automaton(md::star<quantifier::POSSESSIVE>('a')(md::one('b'), md::one('c'))).search(nary));
+    // Possessive stars leave to their children only the nodes they do not accept
+    QVERIFY(pattern_automaton(md::star<quantifier::GREEDY>('a')(md::one('a'))).search(nary));
+    QVERIFY(!pattern_automaton(md::star<quantifier::POSSESSIVE>('a')(md::one('a'))).search(nary));
+}
+
+void PatternAutomatonTest::captures() {
+    pattern_automaton automaton(
+        md::star()(
+            cpt(const_name<'P'>(),
+                md::star('a')(
+                    md::one('a')(
+                        md::one('a'),
+                        md::one('a')))),
+            cpt(const_name<'b'>(),
+                md::star('b')(
+                    cpt(md::one('y'))))));
+    QCOMPARE(automaton.state_count(), 7u);
+    QVERIFY(automaton.search(binary));
+    QVERIFY(!automaton.search(nary));
+}
+
+void PatternAutomatonTest::emptyTree() {
+    QVERIFY(pattern_automaton(md::star()).search(nary_tree<char>()));
+    QVERIFY(pattern_automaton(md::opt()).search(nary_tree<char>()));
+    QVERIFY(!pattern_automaton(md::one()).search(nary_tree<char>()));
+    QVERIFY(!pattern_automaton(md::star()(md::one('a'))).search(binary_tree<char>()));
+}
+
+void PatternAutomatonTest::mappedTree() {
+    ostringstream stream;
+    {
+        mapped_writer writer(stream);
+        writer.write(nary);
+    }
+    const string data = stream.str();
+    // Aligned like a mapped file would be
+    vector<std::uint64_t> storage(data.size() / sizeof(std::uint64_t) + 1);
+    memcpy(storage.data(), data.data(), data.size());
+    mapped_tree<char> mapped(storage.data(), data.size());
+    QVERIFY(pattern_automaton(md::star()(md::one('d')(md::one('e')), md::one('a'))).search(mapped));
+    QVERIFY(!pattern_automaton(md::star()(md::one('e'), md::one('d'))).search(mapped));
+}
+
+template <typename Tree, typename Make>
+void compare_with_backtracking(mt19937& random, int arity, Make make) {
+    for (int i = 0; i < 500; ++i) {
+        Tree tree = random_tree<Tree>(random(), 1 + random() % 14, "abcxy", arity);
+        pattern backtracking(make());
+        pattern_automaton automaton(make());
+        QCOMPARE(automaton.search(tree), backtracking.search(tree));
+    }
+}
+
+void PatternAutomatonTest::sameAsBacktracking() {
+    mt19937 random(42);
+    auto check = [&](auto make) {
+        compare_with_backtracking<nary_tree<char>>(random, 3, make);
+        compare_with_backtracking<binary_tree<char>>(random, 2, make);
+    };
+    check([] { return md::one('a')(md::one('b'), md::one('c')); });
+    check([] { return md::star()(md::one('a')(md::one('b')(md::one('c')))); });
+    check([] { return md::star()(md::star('a')(md::one('b'), md::one('c'))); });
+    check([] { return md::one()(md::opt('a')(md::one('b')), md::one('c')); });
+    check([] { return md::one('a')(md::opt('x')(md::one('b'))); });
+    check([] { return md::star()(md::star<quantifier::RELUCTANT>('a')(md::one('y'), md::one('b'))); });
+    check([] { return md::star()(md::star<quantifier::GREEDY>('a')(md::one('y'), md::one('b'))); });
+    check([] { return md::star()(md::star<quantifier::POSSESSIVE>('a')(md::one('y'), md::one('b'))); });
+    check([] { return md::star()(cpt(md::one('a')(md::one('b'))), md::one('c')); });
+}
+
+QTEST_MAIN(PatternAutomatonTest)
+
+#include "PatternAutomatonTest.moc"
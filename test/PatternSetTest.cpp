@@ -0,0 +1,159 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+#include "Types.hpp"
+
+using namespace md;
+using namespace std;
+
+class PatternSetTest : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')(
+                    n('e'))),
+            n('c')(
+                n('a')(
+                    n('b'),
+                    n('e'))),
+            n('f'))};
+
+    private slots:
+    void matched();
+    void sharedStates();
+    void occurrences();
+    void predicates();
+    void sameAsAutomaton();
+};
+
+void PatternSetTest::matched() {
+    pattern_set<char> set;
+    QCOMPARE(set.insert(one('a')(one('b'), one('c'))), 0u);
+    QCOMPARE(set.insert(one('b')), 1u);
+    QCOMPARE(set.insert(star()(one('d')(one('e')), one('a'))), 2u);
+    QCOMPARE(set.insert(star()(one('e'), one('d'))), 3u);
+    QCOMPARE(set.insert(opt('z')), 4u);
+    QCOMPARE(set.insert(pattern(star()(cpt(one('f'))))), 5u);
+    QCOMPARE(set.size(), 6u);
+    QCOMPARE(set.search(tree), 4u);
+    QVERIFY(set.matched(0));
+    QVERIFY(!set.matched(1));
+    QVERIFY(set.matched(2));
+    QVERIFY(!set.matched(3));
+    QVERIFY(set.matched(4));
+    QVERIFY(set.matched(5));
+    QCOMPARE(set.search(nary_tree<char>()), 1u);
+    QVERIFY(!set.matched(0));
+    QVERIFY(set.matched(4));
+}
+
+void PatternSetTest::sharedStates() {
+    pattern_set<char> set;
+    set.insert(one('a')(one('b')));
+    QCOMPARE(set.state_count(), 2u);
+    set.insert(one('a')(one('b')));
+    QCOMPARE(set.state_count(), 2u);
+    // Same subpattern below another root
+    set.insert(star()(one('a')(one('b'))));
+    QCOMPARE(set.state_count(), 3u);
+    // The quantifier matters only when possessive
+    set.insert(star<quantifier::GREEDY>()(one('a')(one('b'))));
+    QCOMPARE(set.state_count(), 3u);
+    set.insert(star<quantifier::POSSESSIVE>()(one('a')(one('b'))));
+    QCOMPARE(set.state_count(), 4u);
+    // Captures and matchers that can match nothing do not have a state
+    set.insert(one('a')(cpt(one('b')), opt('c')));
+    QCOMPARE(set.state_count(), 4u);
+    set.insert(one('a')(one('c')));
+    QCOMPARE(set.state_count(), 6u);
+    QCOMPARE(set.search(tree), 6u);
+    // The possessive star leaves no node to its child
+    QVERIFY(!set.matched(4));
+}
+
+void PatternSetTest::occurrences() {
+    pattern_set<char> set;
+    set.insert(one('a')(one('b')));
+    set.insert(one('b'));
+    set.insert(star()(one('e')));
+    vector<pair<size_t, char>> found;
+    set.search(tree, [&](size_t index, const auto& node) {
+        found.emplace_back(index, node.get_value());
+    });
+    // Post-order: c e d b b e a c f a
+    vector<pair<size_t, char>> expected {
+        {2, 'e'},
+        {2, 'd'},
+        {1, 'b'},
+        {2, 'b'},
+        {1, 'b'},
+        {2, 'e'},
+        {0, 'a'},
+        {2, 'a'},
+        {2, 'c'},
+        {0, 'a'},
+        {2, 'a'}};
+    QCOMPARE(found, expected);
+}
+
+void PatternSetTest::predicates() {
+    nary_tree<string> words {
+        n(string("sentence"))(
+            n(string("the")),
+            n(string("quick")),
+            n(string("fox")))};
+    pattern_set<string> set;
+    auto length = [](const string& word) {
+        return word.size();
+    };
+    set.insert(one()(one(having(3u, length)), one(having(5u, length))));
+    set.insert(one()(one(having(5u, length)), one(having(5u, length))));
+    set.insert(star()(one(string("fox"))));
+    QCOMPARE(set.search(words), 2u);
+    QVERIFY(set.matched(0));
+    QVERIFY(!set.matched(1));
+    QVERIFY(set.matched(2));
+}
+
+void PatternSetTest::sameAsAutomaton() {
+    mt19937 random(7);
+    const char values[] = "abc";
+    pattern_set<char> set;
+    vector<pattern_automaton<decltype(star()(one('a')(one('a')), one('a')))>> stars;
+    vector<pattern_automaton<decltype(one('a')(opt('a')(one('a')), one('a')))>> ones;
+    for (char x : values) {
+        for (char y : values) {
+            for (char z : values) {
+                if (!x || !y || !z) {
+                    continue;
+                }
+                set.insert(star()(one(x)(one(y)), one(z)));
+                stars.emplace_back(star()(one(x)(one(y)), one(z)));
+                set.insert(one(x)(opt(y)(one(z)), one(x)));
+                ones.emplace_back(one(x)(opt(y)(one(z)), one(x)));
+            }
+        }
+    }
+    for (int i = 0; i < 300; ++i) {
+        nary_tree<char> tree = random_tree(random(), 1 + random() % 20);
+        set.search(tree);
+        for (size_t j = 0; j < stars.size(); ++j) {
+            QCOMPARE(set.matched(2 * j), stars[j].search(tree));
+            QCOMPARE(set.matched(2 * j + 1), ones[j].search(tree));
+        }
+    }
+}
+
+QTEST_MAIN(PatternSetTest)
+
+#include "PatternSetTest.moc"
@@ -167,9 +167,21 @@ void PatternTest2::test6() {
 }
 
 void PatternTest2::test7() {
+    pattern p(star()(one('a')(star('a')(one('a')(star('a')(one('b')))))));
+    nary_tree<char> chain {n('a')(n('a')(n('a')(n('a')(n('a')))))};
+    QVERIFY(!p.search(chain));
+    // The nodes where the matchers failed before must not be remembered, even if their addresses are reused
+    chain = n('a')(n('a')(n('a')(n('a')(n('b')))));
+    QVERIFY(p.search(chain));
 }
 
 void PatternTest2::test8() {
+    pattern p(star()(cpt(one('a')(one('b'))), one('c')));
+    // The first 'a' takes the last child 'b', leaving no node to one('c'), the deeper 'a' must be tried
+    nary_tree<char> tree {n('a')(n('a')(n('a')(n('b')), n('c'), n('b')))};
+    QVERIFY(p.search(tree));
+    p.assign_result(result);
+    QCOMPARE(result, n('a')(n('a')(n('a')(n('b')), n('c'))));
 }
 
 void PatternTest2::test9() {
@@ -0,0 +1,261 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <TreeDS/tree>
+
+using namespace md;
+using namespace std;
+
+class PersistentTreeTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void construct();
+    void snapshot();
+    void pathCopying();
+    void inPlace();
+    void erase();
+    void sameAsNaryTree();
+    void concurrentSnapshots();
+};
+
+template <typename Tree>
+vector<char> values(const Tree& tree) {
+    vector<char> result;
+    for (auto it = tree.begin(policy::pre_order()); it != tree.end(policy::pre_order()); ++it) {
+        result.push_back(*it);
+    }
+    return result;
+}
+
+void PersistentTreeTest::construct() {
+    nary_tree<char> tree(n('a')(n('b')(n('c'), n('d')), n('e')));
+    persistent_tree<char> persistent(tree);
+    QCOMPARE(persistent.size(), 5u);
+    QVERIFY(persistent.to_nary_tree() == tree);
+    QCOMPARE(values(persistent), values(tree));
+    persistent_tree<char> from_struct(n('a')(n('b')(n('c'), n('d')), n('e')));
+    QVERIFY(from_struct == persistent);
+    QVERIFY(from_struct.raw_root_node() != persistent.raw_root_node());
+    persistent_tree<char> empty;
+    QVERIFY(empty.empty());
+    QCOMPARE(empty.size(), 0u);
+    QVERIFY(empty.begin() == empty.end());
+    QVERIFY(empty.to_nary_tree().empty());
+    QVERIFY(empty != persistent);
+    empty.insert_over(empty.end(policy::pre_order()), 'x');
+    QCOMPARE(*empty.root(), 'x');
+}
+
+void PersistentTreeTest::snapshot() {
+    persistent_tree<char> tree(n('a')(n('b')(n('c'), n('d')), n('e')));
+    persistent_tree<char> snapshot(tree);
+    // Same nodes
+    QCOMPARE(snapshot.raw_root_node(), tree.raw_root_node());
+    QCOMPARE(tree.raw_root_node()->get_references(), 2u);
+    tree.insert_child_back(tree.root(), 'f');
+    QVERIFY(snapshot.to_nary_tree() == nary_tree<char>(n('a')(n('b')(n('c'), n('d')), n('e'))));
+    QVERIFY(tree.to_nary_tree() == nary_tree<char>(n('a')(n('b')(n('c'), n('d')), n('e'), n('f'))));
+    QCOMPARE(snapshot.size(), 5u);
+    QCOMPARE(tree.size(), 6u);
+    QCOMPARE(snapshot.raw_root_node()->get_references(), 1u);
+    // Assignment shares the nodes as well
+    snapshot = tree;
+    QCOMPARE(snapshot.raw_root_node(), tree.raw_root_node());
+    QVERIFY(snapshot == tree);
+    persistent_tree<char> moved(std::move(snapshot));
+    QVERIFY(snapshot.empty());
+    QCOMPARE(tree.raw_root_node()->get_references(), 2u);
+    moved.clear();
+    QCOMPARE(tree.raw_root_node()->get_references(), 1u);
+}
+
+void PersistentTreeTest::pathCopying() {
+    persistent_tree<char> tree(n('a')(n('b')(n('c'), n('d')), n('e')(n('f'))));
+    persistent_tree<char> snapshot(tree);
+    const shared_node<char>* b = tree.raw_root_node()->get_children()[0];
+    const shared_node<char>* e = tree.raw_root_node()->get_children()[1];
+    const shared_node<char>* d = b->get_children()[1];
+    // Replace c: a and b are copied, d and e are shared
+    auto position = std::next(tree.begin(policy::pre_order()), 2);
+    QCOMPARE(*position, 'c');
+    auto result = tree.insert_over(position, n('x')(n('y')));
+    QCOMPARE(*result, 'x');
+    QCOMPARE(result.get_node_pointer().get_parent().get_value(), 'b');
+    QVERIFY(tree.raw_root_node() != snapshot.raw_root_node());
+    QVERIFY(tree.raw_root_node()->get_children()[0] != b);
+    QCOMPARE(tree.raw_root_node()->get_children()[1], e);
+    QCOMPARE(tree.raw_root_node()->get_children()[0]->get_children()[1], d);
+    QCOMPARE(e->get_references(), 2u);
+    QCOMPARE(d->get_references(), 2u);
+    QCOMPARE(tree.size(), 7u);
+    QVERIFY(tree.to_nary_tree() == nary_tree<char>(n('a')(n('b')(n('x')(n('y')), n('d')), n('e')(n('f')))));
+    QVERIFY(snapshot.to_nary_tree() == nary_tree<char>(n('a')(n('b')(n('c'), n('d')), n('e')(n('f')))));
+    // Dropping the snapshot reclaims the old path, the shared nodes survive
+    snapshot.clear();
+    QCOMPARE(e->get_references(), 1u);
+    QCOMPARE(d->get_references(), 1u);
+    // Errors
+    persistent_tree<char> other(tree.to_nary_tree());
+    QVERIFY_EXCEPTION_THROWN(other.insert_over(tree.root(), 'z'), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(other.insert_child_back(other.end(), 'z'), std::invalid_argument);
+    QVERIFY(other == tree);
+}
+
+void PersistentTreeTest::inPlace() {
+    persistent_tree<char> tree(n('a')(n('b')(n('c')), n('d')));
+    const shared_node<char>* root = tree.raw_root_node();
+    const shared_node<char>* b    = root->get_children()[0];
+    // No snapshot: nothing is copied
+    tree.emplace_child_front(std::next(tree.begin(policy::pre_order()), 1), 'x');
+    tree.insert_child_back(tree.root(), n('y')(n('z')));
+    tree.emplace_over(std::next(tree.begin(policy::pre_order()), 4), 'w');
+    QCOMPARE(tree.raw_root_node(), root);
+    QCOMPARE(root->get_children()[0], b);
+    QCOMPARE(tree.size(), 7u);
+    QCOMPARE(b->get_subtree_size(), 3u);
+    QVERIFY(tree.to_nary_tree() == nary_tree<char>(n('a')(n('b')(n('x'), n('c')), n('w'), n('y')(n('z')))));
+    // Another tree shares the children of the root only
+    persistent_tree<char> other;
+    other.insert_over(other.end(policy::pre_order()), tree);
+    QCOMPARE(other.raw_root_node(), root);
+    other.insert_child_back(other.root(), 'q');
+    QVERIFY(other.raw_root_node() != root);
+    QCOMPARE(root->get_references(), 1u);
+    // The root is modified in place, y is shared thus copied
+    const shared_node<char>* y = root->get_children()[2];
+    tree.insert_child_back(std::next(tree.begin(policy::pre_order()), 5), 'v');
+    QCOMPARE(tree.raw_root_node(), root);
+    QVERIFY(root->get_children()[2] != y);
+    QCOMPARE(root->get_children()[0], b);
+    QCOMPARE(tree.size(), 8u);
+    QCOMPARE(other.size(), 8u);
+    QVERIFY(other.to_nary_tree() == nary_tree<char>(n('a')(n('b')(n('x'), n('c')), n('w'), n('y')(n('z')), n('q'))));
+}
+
+void PersistentTreeTest::erase() {
+    persistent_tree<char> tree(n('a')(n('b')(n('c'), n('d')), n('e')));
+    persistent_tree<char> snapshot(tree);
+    tree.erase(std::next(tree.begin(policy::pre_order()), 1));
+    QVERIFY(tree.to_nary_tree() == nary_tree<char>(n('a')(n('e'))));
+    QCOMPARE(tree.size(), 2u);
+    QCOMPARE(snapshot.size(), 5u);
+    tree.erase(tree.root());
+    QVERIFY(tree.empty());
+    QCOMPARE(snapshot.raw_root_node()->get_references(), 1u);
+    // In place
+    snapshot.erase(std::next(snapshot.begin(policy::pre_order()), 3));
+    QVERIFY(snapshot.to_nary_tree() == nary_tree<char>(n('a')(n('b')(n('c')), n('e'))));
+    QCOMPARE(snapshot.size(), 4u);
+}
+
+void PersistentTreeTest::sameAsNaryTree() {
+    mt19937 random(23);
+    for (int i = 0; i < 40; ++i) {
+        nary_tree<char> tree(n('a'));
+        persistent_tree<char> persistent(tree);
+        // Some versions are kept alive, with the nary_tree they should be equal to
+        vector<pair<persistent_tree<char>, nary_tree<char>>> versions;
+        for (int step = 0; step < 100; ++step) {
+            if (tree.empty()) {
+                tree.insert_over(tree.end(), 'a');
+                persistent.insert_over(persistent.end(policy::pre_order()), 'a');
+            }
+            if (random() % 4 == 0) {
+                versions.emplace_back(persistent, tree);
+            }
+            if (!versions.empty() && random() % 5 == 0) {
+                versions.erase(versions.begin() + static_cast<int>(random() % versions.size()));
+            }
+            const int offset = static_cast<int>(random() % tree.size());
+            auto it          = std::next(tree.begin(policy::pre_order()), offset);
+            auto position    = std::next(persistent.begin(policy::pre_order()), offset);
+            char value       = static_cast<char>('a' + random() % 5);
+            switch (random() % 6) {
+            case 0:
+                tree.emplace_child_back(it, value);
+                persistent.emplace_child_back(position, value);
+                break;
+            case 1:
+                tree.insert_child_front(it, n(value)(n('b')));
+                persistent.insert_child_front(position, n(value)(n('b')));
+                break;
+            case 2:
+                tree.insert_over(it, value);
+                persistent.insert_over(position, value);
+                break;
+            case 3:
+                tree.insert_over(it, n(value)(n('a'), n('b')));
+                persistent.insert_over(position, n(value)(n('a'), n('b')));
+                break;
+            case 4:
+                tree.insert_child_back(it, value);
+                persistent.insert_child_back(position, value);
+                break;
+            case 5:
+                tree.erase(tree.begin(policy::post_order()).other_node(it.get_raw_node()));
+                persistent.erase(position);
+                break;
+            }
+            QCOMPARE(persistent.size(), tree.size());
+            QVERIFY(persistent.to_nary_tree() == tree);
+            for (const auto& [version, expected] : versions) {
+                QCOMPARE(version.size(), expected.size());
+                QVERIFY(version.to_nary_tree() == expected);
+            }
+        }
+    }
+}
+
+void PersistentTreeTest::concurrentSnapshots() {
+    using iterator = persistent_tree<int>::const_iterator<policy::pre_order>;
+    tree_builder<nary_tree<int>> builder;
+    builder.open(0);
+    for (int i = 0; i < 100; ++i) {
+        builder.open(i);
+        for (int j = 0; j < 20; ++j) {
+            builder.leaf(j);
+        }
+        builder.close();
+    }
+    builder.close();
+    persistent_tree<int> tree(builder.build());
+    // The snapshot k has k more leaves having value 1
+    vector<persistent_tree<int>> snapshots;
+    for (int k = 0; k < 8; ++k) {
+        snapshots.push_back(tree);
+        tree.emplace_child_back(tree.root(), 1);
+    }
+    // Each reader sums its snapshot and destroys it while the writer keeps modifying the tree
+    vector<long> sums(snapshots.size(), 0);
+    vector<thread> readers;
+    for (size_t k = 0; k < snapshots.size(); ++k) {
+        readers.emplace_back([&, k]() {
+            persistent_tree<int> snapshot(std::move(snapshots[k]));
+            for (int value : snapshot) {
+                sums[k] += value;
+            }
+        });
+    }
+    mt19937 random(3);
+    for (int i = 0; i < 2000; ++i) {
+        iterator position(tree, tree.root().get_node_pointer().get_child(random() % 100));
+        tree.erase(tree.emplace_child_back(position, 1));
+    }
+    for (thread& reader : readers) {
+        reader.join();
+    }
+    // Sum of the children (0 to 99) and of their leaves (0 to 19)
+    const long expected = 4950 + 100 * 190;
+    for (size_t k = 0; k < sums.size(); ++k) {
+        QCOMPARE(sums[k], expected + static_cast<long>(k));
+    }
+    QCOMPARE(tree.size(), 2109u);
+}
+
+QTEST_MAIN(PersistentTreeTest)
+
+#include "PersistentTreeTest.moc"
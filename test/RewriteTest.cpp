@@ -0,0 +1,274 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+using namespace md;
+using namespace std;
+
+class RewriteTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void simple();
+    void fixedPoint();
+    void root();
+    void moved();
+    void copied();
+    void marks();
+    void binaryTree();
+    void changeLog();
+    void sameAsReference();
+};
+
+// x + 0 => x, 0 + x => x, x * 1 => x, x * 0 => 0
+auto make_simplifier() {
+    return rewriter(
+        rewrite(one('+')(cpt(one()), one('0')), n(const_index<1>())),
+        rewrite(one('+')(one('0'), cpt(one())), n(const_index<1>())),
+        rewrite(one('*')(cpt(one()), one('1')), n(const_index<1>())),
+        rewrite(one('*')(one(), one('0')), n('0')));
+}
+
+void RewriteTest::simple() {
+    nary_tree<char> tree {
+        n('-')(
+            n('+')(
+                n('x'),
+                n('0')),
+            n('y'))};
+    auto simplify = make_simplifier();
+    QCOMPARE(simplify.size(), 4u);
+    QCOMPARE(simplify.apply(tree), 1u);
+    QCOMPARE(tree, n('-')(n('x'), n('y')));
+    QCOMPARE(tree.size(), 3u);
+    QCOMPARE(simplify.apply(tree), 0u);
+    nary_tree<char> empty;
+    QCOMPARE(simplify.apply(empty), 0u);
+}
+
+void RewriteTest::fixedPoint() {
+    // ((x + 0) * 1) + (0 + (y * 0)) => x + 0 => x
+    nary_tree<char> tree {
+        n('+')(
+            n('*')(
+                n('+')(
+                    n('x'),
+                    n('0')),
+                n('1')),
+            n('+')(
+                n('0'),
+                n('*')(
+                    n('y'),
+                    n('0'))))};
+    auto simplify = make_simplifier();
+    QCOMPARE(simplify.apply(tree), 5u);
+    QCOMPARE(tree, n('x'));
+    QCOMPARE(tree.size(), 1u);
+    // The nodes created by a replacement are rewritten as well
+    rewriter expand(
+        rewrite(one('d')(cpt(one())), n('+')(n(const_index<1>()), n('z'))),
+        rewrite(one('z'), n('0')),
+        rewrite(one('+')(cpt(one()), one('0')), n(const_index<1>())));
+    nary_tree<char> nested {n('d')(n('d')(n('d')(n('y'))))};
+    QCOMPARE(expand.apply(nested), 9u);
+    QCOMPARE(nested, n('y'));
+}
+
+void RewriteTest::root() {
+    nary_tree<char> tree {n('*')(n('+')(n('x'), n('y')), n('0'))};
+    auto simplify = make_simplifier();
+    QCOMPARE(simplify.apply(tree), 1u);
+    QCOMPARE(tree, n('0'));
+    QCOMPARE(tree.size(), 1u);
+    QCOMPARE(*tree.begin(), '0');
+}
+
+void RewriteTest::moved() {
+    nary_tree<char> tree {
+        n('f')(
+            n('+')(
+                n('a')(
+                    n('b'),
+                    n('c')),
+                n('0')),
+            n('z'))};
+    const nary_node<char>* a = tree.raw_root_node()->get_child(0)->get_child(0);
+    const nary_node<char>* b = a->get_child(0);
+    auto simplify            = make_simplifier();
+    QCOMPARE(simplify.apply(tree), 1u);
+    QCOMPARE(tree, n('f')(n('a')(n('b'), n('c')), n('z')));
+    // The captured subtree was moved, not copied
+    QCOMPARE(tree.raw_root_node()->get_child(0), a);
+    QCOMPARE(a->get_child(0), b);
+    QCOMPARE(a->get_parent(), tree.raw_root_node());
+    QCOMPARE(a->following_siblings(), 1u);
+    QCOMPARE(tree.raw_root_node()->get_last_child()->get_prev_sibling(), a);
+    QCOMPARE(tree.size(), 5u);
+}
+
+void RewriteTest::copied() {
+    // x * 2 => x + x: the second reference is a copy
+    rewriter twice(rewrite(one('*')(cpt(one()), one('2')), n('+')(n(const_index<1>()), n(const_index<1>()))));
+    nary_tree<char> tree {n('-')(n('*')(n('a')(n('b')), n('2')))};
+    const nary_node<char>* a = tree.raw_root_node()->get_child(0)->get_child(0);
+    QCOMPARE(twice.apply(tree), 1u);
+    QCOMPARE(tree, n('-')(n('+')(n('a')(n('b')), n('a')(n('b')))));
+    QCOMPARE(tree.raw_root_node()->get_child(0)->get_child(0), a);
+    QVERIFY(tree.raw_root_node()->get_child(0)->get_child(1) != a);
+    QCOMPARE(tree.size(), 6u);
+    // A capture inside another one referenced is copied, the match itself as well
+    rewriter nested(rewrite(
+        cpt(one('p')(cpt(one('q')(cpt(one()))))),
+        n('r')(n(const_index<3>()), n(const_index<2>()), n(const_index<1>()))));
+    nary_tree<char> other {n('p')(n('q')(n('s')))};
+    QCOMPARE(nested.apply(other), 1u);
+    QCOMPARE(other, n('r')(n('s'), n('q')(n('s')), n('p')(n('q')(n('s')))));
+    QCOMPARE(other.size(), 7u);
+}
+
+void RewriteTest::marks() {
+    // Named marks and a capture that matched nothing
+    rewriter swap(rewrite(
+        one('s')(cpt(const_name<'a'>(), one()), cpt(const_name<'b'>(), opt('o'))),
+        n('t')(n(const_name<'b'>()), n('m'), n(const_name<'a'>()))));
+    nary_tree<char> tree {n('s')(n('x')(n('y')), n('o'))};
+    QCOMPARE(swap.apply(tree), 1u);
+    QCOMPARE(tree, n('t')(n('o'), n('m'), n('x')(n('y'))));
+    nary_tree<char> missing {n('s')(n('x'))};
+    QCOMPARE(swap.apply(missing), 1u);
+    QCOMPARE(missing, n('t')(n('m'), n('x')));
+    QCOMPARE(missing.size(), 3u);
+    QCOMPARE(missing.raw_root_node()->get_first_child()->following_siblings(), 1u);
+}
+
+void RewriteTest::binaryTree() {
+    binary_tree<char> tree {
+        n('-')(
+            n('+')(
+                n('0'),
+                n('x')(
+                    n(),
+                    n('y'))),
+            n('*')(
+                n('z'),
+                n('1')))};
+    auto simplify = make_simplifier();
+    QCOMPARE(simplify.apply(tree), 2u);
+    QCOMPARE(tree, n('-')(n('x')(n(), n('y')), n('z')));
+    QVERIFY(tree.raw_root_node()->get_left_child()->get_right_child() != nullptr);
+    QCOMPARE(tree.size(), 4u);
+    // The empty node keeps the left position free in the replacement
+    rewriter right(rewrite(one('r')(cpt(one())), n('q')(n(), n(const_index<1>()))));
+    binary_tree<char> other {n('r')(n('a'))};
+    QCOMPARE(right.apply(other), 1u);
+    QCOMPARE(other, n('q')(n(), n('a')));
+    QCOMPARE(other.raw_root_node()->get_left_child(), nullptr);
+}
+
+void RewriteTest::changeLog() {
+    nary_tree<char> tree {
+        n('f')(
+            n('+')(
+                n('a'),
+                n('0')),
+            n('*')(
+                n('b'),
+                n('1')),
+            n('+')(
+                n('c'),
+                n('d')))};
+    change_log<nary_node<char>> log;
+    tree.set_change_log(&log);
+    pattern p(one('f')(one('a'), one('b')));
+    incremental_search matches(p, tree);
+    QCOMPARE(matches.size(), 0u);
+    auto simplify = make_simplifier();
+    QCOMPARE(simplify.apply(tree), 2u);
+    matches.update(log);
+    log.clear();
+    QCOMPARE(matches.size(), 1u);
+    QVERIFY(matches.contains(tree.raw_root_node()));
+    tree.set_change_log(nullptr);
+}
+
+// Simplified expression computed on a plain structure
+struct expression {
+    char value;
+    vector<expression> operands;
+};
+
+expression simplify_reference(const nary_node<char>& node) {
+    expression result {node.get_value(), {}};
+    for (const nary_node<char>* child = node.get_first_child(); child; child = child->get_next_sibling()) {
+        result.operands.push_back(simplify_reference(*child));
+    }
+    if (result.operands.size() == 2u) {
+        const expression& left  = result.operands[0];
+        const expression& right = result.operands[1];
+        if (result.value == '+' && right.value == '0' && right.operands.empty()) {
+            return left;
+        } else if (result.value == '+' && left.value == '0' && left.operands.empty()) {
+            return right;
+        } else if (result.value == '*' && right.value == '1' && right.operands.empty()) {
+            return left;
+        } else if (result.value == '*' && right.value == '0' && right.operands.empty()) {
+            return {'0', {}};
+        }
+    }
+    return result;
+}
+
+bool same(const expression& expected, const nary_node<char>& node) {
+    if (expected.value != node.get_value() || expected.operands.size() != node.children()) {
+        return false;
+    }
+    const nary_node<char>* child = node.get_first_child();
+    for (const expression& operand : expected.operands) {
+        if (!same(operand, *child)) {
+            return false;
+        }
+        child = child->get_next_sibling();
+    }
+    return true;
+}
+
+nary_tree<char> random_expression(mt19937& random, int size) {
+    tree_builder<nary_tree<char>> builder;
+    int remaining = size;
+    auto generate = [&](auto& self) -> void {
+        if (remaining <= 0 || random() % 3 == 0) {
+            builder.leaf("0112xy"[random() % 6]);
+            return;
+        }
+        --remaining;
+        builder.open("+*"[random() % 2]);
+        self(self);
+        self(self);
+        builder.close();
+    };
+    generate(generate);
+    return builder.build();
+}
+
+void RewriteTest::sameAsReference() {
+    mt19937 random(5);
+    auto simplify = make_simplifier();
+    for (int i = 0; i < 200; ++i) {
+        nary_tree<char> tree = random_expression(random, static_cast<int>(random() % 60));
+        expression expected  = simplify_reference(*tree.raw_root_node());
+        simplify.apply(tree);
+        QVERIFY(same(expected, *tree.raw_root_node()));
+        const size_t size = tree.size();
+        QCOMPARE(size, calculate_size(*tree.raw_root_node()));
+        QCOMPARE(simplify.apply(tree), 0u);
+    }
+}
+
+QTEST_MAIN(RewriteTest)
+
+#include "RewriteTest.moc"
@@ -0,0 +1,241 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+#include "Types.hpp"
+
+using namespace md;
+using namespace std;
+
+class RuntimePatternTest : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')(
+                    n('e'))),
+            n('c')(
+                n('a')(
+                    n('b'),
+                    n('e'))),
+            n('b'))};
+
+    private slots:
+    void parse();
+    void parseErrors();
+    void search();
+    void marks();
+    void sameAsTemplate();
+    void binaryTree();
+    void forEachMatch();
+};
+
+void RuntimePatternTest::parse() {
+    pattern_program<char> program = parse_pattern<char>(
+        " one('a') ( star < reluctant > ( ) ( cpt ( x , one('b') ) ), opt<quantifier::POSSESSIVE>('c'), cpt(one()) )");
+    QCOMPARE(program.size(), 7u);
+    QCOMPARE(program.mark_count(), 2u);
+    QCOMPARE(program[0].kind, instruction_kind::ONE);
+    QCOMPARE(program[0].end, 7u);
+    QCOMPARE(program[1].kind, instruction_kind::STAR);
+    QCOMPARE(program[1].quantifier_value, quantifier::RELUCTANT);
+    QCOMPARE(program[1].value, pattern_instruction::NONE);
+    QCOMPARE(program[1].next_sibling, 4u);
+    QCOMPARE(program[2].kind, instruction_kind::CAPTURE);
+    QCOMPARE(program.get_value(program[3].value), 'b');
+    QCOMPARE(program[4].quantifier_value, quantifier::POSSESSIVE);
+    QVERIFY(program[4].has(pattern_instruction::MATCHES_NULL));
+    QCOMPARE(program[4].next_sibling, 5u);
+    QCOMPARE(program[5].next_sibling, pattern_instruction::NONE);
+    // The reluctant star needs its child, so it does not prefer to match nothing
+    QVERIFY(!program[1].has(pattern_instruction::MATCHES_NULL));
+    QVERIFY(!program[1].has(pattern_instruction::PREFERS_NULL));
+    QVERIFY(program[1].has(pattern_instruction::MAY_STEAL));
+    QCOMPARE(program.find_capture("x"), 1u);
+    QCOMPARE(program.find_capture("y"), 0u);
+    QCOMPARE(program.get_capture(2u), 5u);
+
+    pattern_program<int> numbers = parse_pattern<int>("star(-12)(one(7), opt<greedy>())");
+    QCOMPARE(numbers.get_value(numbers[0].value), -12);
+    QCOMPARE(numbers.get_value(numbers[1].value), 7);
+    QVERIFY(numbers[2].has(pattern_instruction::PREFERS_NULL) == false);
+    QVERIFY(numbers[2].has(pattern_instruction::MATCHES_NULL));
+
+    pattern_program<string> strings = parse_pattern<string>(R"x(one("a, b")(one("c)")))x");
+    QCOMPARE(strings.get_value(strings[0].value), string("a, b"));
+    QCOMPARE(strings.get_value(strings[1].value), string("c)"));
+}
+
+void RuntimePatternTest::parseErrors() {
+    QVERIFY_EXCEPTION_THROWN(parse_pattern<char>(""), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_pattern<char>("two('a')"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_pattern<char>("one('a'"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_pattern<char>("one('a')(one('b')"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_pattern<char>("one('a'), one('b')"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_pattern<char>("one<greedy>('a')"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_pattern<char>("star<eager>('a')"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_pattern<char>("one(a)"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_pattern<int>("one(1x)"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_pattern<char>("cpt(one('a'))(one('b'))"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(
+        parse_pattern<char>("one()(cpt(x, one('a')), cpt(x, one('b')))"),
+        std::invalid_argument);
+    string message;
+    try {
+        parse_pattern<char>("one('a')(opt('b') one('c'))");
+    } catch (const std::invalid_argument& e) {
+        message = e.what();
+    }
+    QCOMPARE(message, string("Expected ')' at offset 18 but found 'o'."));
+}
+
+void RuntimePatternTest::search() {
+    runtime_pattern<char> p("one('a')(one('c')(one('a')(one('e'))))");
+    QVERIFY(p.search(tree));
+    auto view = p.result_view(tree);
+    QCOMPARE(view.raw_root_node(), tree.raw_root_node());
+    runtime_pattern<char> q("one('a')(one('c')(one('b')))");
+    QVERIFY(!q.search(tree));
+    // Anchored at the root, like pattern::search()
+    runtime_pattern<char> r("one('c')");
+    QVERIFY(!r.search(tree));
+    runtime_pattern<char> s("star()(one('d')(one('e')))");
+    QVERIFY(s.search(tree));
+    QCOMPARE(s.get_matched_nodes(tree)[1], tree.raw_root_node()->get_child(0)->get_child(1));
+    nary_tree<char> other(tree);
+    QVERIFY_EXCEPTION_THROWN(s.result_view(other), std::invalid_argument);
+    nary_tree<char> empty;
+    QVERIFY(!p.search(empty));
+    QVERIFY(runtime_pattern<char>("opt('x')").search(empty));
+    // The first 'a' takes the last child 'b', leaving no node to one('c'), the deeper 'a' must be tried
+    runtime_pattern<char> t("star()(cpt(one('a')(one('b'))), one('c'))");
+    nary_tree<char> backtracking {n('a')(n('a')(n('a')(n('b')), n('c'), n('b')))};
+    QVERIFY(t.search(backtracking));
+    const nary_node<char>* deeper = backtracking.raw_root_node()->get_first_child();
+    QCOMPARE(t.get_mark(1u, backtracking), deeper->get_first_child());
+    QCOMPARE(t.get_matched_nodes(backtracking)[4], deeper->get_child(1));
+}
+
+void RuntimePatternTest::marks() {
+    runtime_pattern<char> p("one('a')(cpt(first, one('b')(one('d'))), cpt(one('c')(cpt(third, one()))))");
+    QCOMPARE(p.mark_count(), 3u);
+    QVERIFY(p.search(tree));
+    const nary_node<char>* root = tree.raw_root_node();
+    QCOMPARE(p.get_mark("first", tree), root->get_child(0));
+    QCOMPARE(p.get_mark(1u, tree), root->get_child(0));
+    QCOMPARE(p.get_mark(2u, tree), root->get_child(1));
+    QCOMPARE(p.get_mark("third", tree), root->get_child(1)->get_child(0));
+    QVERIFY(p.mark_view("first", tree) == n('b')(n('c'), n('d')(n('e'))));
+    QVERIFY(p.mark_view(3u, tree) == n('a')(n('b'), n('e')));
+    QVERIFY_EXCEPTION_THROWN(p.get_mark("fourth", tree), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(p.get_mark(4u, tree), std::invalid_argument);
+}
+
+// Compares the nodes matched by the runtime pattern with those matched by the same pattern written in the code
+template <typename PatternTree>
+void compare(PatternTree&& pattern_tree, const char* text, const vector<nary_tree<char>>& trees) {
+    pattern compiled(std::move(pattern_tree));
+    runtime_pattern<char> interpreted(text);
+    QCOMPARE(interpreted.get_program().size(), compiled.get_pattern().subtree_size());
+    QCOMPARE(interpreted.mark_count(), compiled.mark_count());
+    for (const nary_tree<char>& tree : trees) {
+        bool expected = compiled.search(tree);
+        QCOMPARE(interpreted.search(tree), expected);
+        if (!expected) {
+            continue;
+        }
+        auto allocator = tree.get_node_allocator();
+        auto nodes     = compiled.get_pattern().matched_nodes(allocator);
+        vector<const nary_node<char>*> expected_nodes(nodes.begin(), nodes.end());
+        QVERIFY(interpreted.get_matched_nodes(tree) == expected_nodes);
+    }
+}
+
+void RuntimePatternTest::sameAsTemplate() {
+    mt19937 random(17);
+    vector<nary_tree<char>> trees;
+    for (int i = 0; i < 300; ++i) {
+        trees.push_back(random_tree(i, 1 + static_cast<int>(random() % 40)));
+    }
+    compare(one('a')(one('b'), one('c')), "one('a')(one('b'), one('c'))", trees);
+    compare(one()(opt('b'), one('c')), "one()(opt('b'), one('c'))", trees);
+    compare(one()(opt<quantifier::RELUCTANT>('b'), one('c')), "one()(opt<reluctant>('b'), one('c'))", trees);
+    compare(one('a')(opt<quantifier::POSSESSIVE>()(one('b'))), "one('a')(opt<possessive>()(one('b')))", trees);
+    compare(star()(one('c')(one('a')), one('b')), "star()(one('c')(one('a')), one('b'))", trees);
+    compare(star('a')(one('b'), one('c')), "star('a')(one('b'), one('c'))", trees);
+    compare(
+        star<quantifier::RELUCTANT>()(cpt(one('a')(one('b'))), one('c')),
+        "star<reluctant>()(cpt(one('a')(one('b'))), one('c'))",
+        trees);
+    compare(
+        star<quantifier::GREEDY>('a')(cpt(const_name<'x'>(), one('b')), opt('c'), one('a')),
+        "star<greedy>('a')(cpt(x, one('b')), opt('c'), one('a'))",
+        trees);
+    compare(
+        star<quantifier::POSSESSIVE>('a')(one('b'), one('c')),
+        "star<possessive>('a')(one('b'), one('c'))",
+        trees);
+    compare(
+        star<quantifier::POSSESSIVE>('a')(opt('b'), one('c'), star<quantifier::POSSESSIVE>()),
+        "star<possessive>('a')(opt('b'), one('c'), star<possessive>())",
+        trees);
+    compare(
+        one()(star('b')(one('c')), cpt(opt<quantifier::RELUCTANT>('a')(one('b'))), star()(one('a'))),
+        "one()(star('b')(one('c')), cpt(opt<reluctant>('a')(one('b'))), star()(one('a')))",
+        trees);
+    compare(
+        star()(star('a')(one('b')), opt('c')(one('a')), star<quantifier::RELUCTANT>('b')),
+        "star()(star('a')(one('b')), opt('c')(one('a')), star<reluctant>('b'))",
+        trees);
+    compare(
+        opt('a')(star()(one('b'), one('b')), cpt(one('c'))),
+        "opt('a')(star()(one('b'), one('b')), cpt(one('c')))",
+        trees);
+}
+
+void RuntimePatternTest::binaryTree() {
+    binary_tree<char> binary {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')),
+            n('e')(
+                n('f')))};
+    runtime_pattern<char> p("one('a')(one(), cpt(e, one('e')(one('f'))))");
+    QVERIFY(p.search(binary));
+    QCOMPARE(p.get_mark("e", binary), binary.raw_root_node()->get_right_child());
+    binary_tree_view<char> view = p.mark_view("e", binary);
+    QCOMPARE(view.raw_root_node(), binary.raw_root_node()->get_right_child());
+    runtime_pattern<char> q("star()(one('d'), one('f'))");
+    QVERIFY(q.search(binary));
+    runtime_pattern<char> r("star()(one('f'), one('d'))");
+    QVERIFY(!r.search(binary));
+}
+
+void RuntimePatternTest::forEachMatch() {
+    for (int i = 0; i < 50; ++i) {
+        nary_tree<char> tree = random_tree(i, 61);
+        pattern compiled(one('a')(cpt(one('b')), star()(one('c'))));
+        runtime_pattern<char> interpreted("one('a')(cpt(one('b')), star()(one('c')))");
+        vector<pair<const nary_node<char>*, const nary_node<char>*>> expected;
+        for (const auto& match : compiled.search_all(tree)) {
+            expected.emplace_back(match.get_node(), match.get_mark(const_index<1>()));
+        }
+        vector<pair<const nary_node<char>*, const nary_node<char>*>> actual;
+        interpreted.for_each_match(tree, [&](const nary_node<char>* node) {
+            actual.emplace_back(node, interpreted.get_mark(1u, tree));
+        });
+        QCOMPARE(actual, expected);
+    }
+}
+
+QTEST_MAIN(RuntimePatternTest)
+
+#include "RuntimePatternTest.moc"
@@ -0,0 +1,235 @@
+#include <QtTest/QtTest>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <TreeDS/serialize>
+#include <TreeDS/tree>
+#include <TreeDS/view>
+
+#include "Types.hpp"
+
+using namespace std;
+using namespace md;
+
+struct point {
+    short x;
+    short y;
+    bool operator==(const point& other) const {
+        return x == other.x && y == other.y;
+    }
+    bool operator!=(const point& other) const {
+        return !(*this == other);
+    }
+};
+
+// Writes just the low byte of each value
+struct byte_codec {
+    template <typename Writer>
+    void write(Writer& writer, int value) const {
+        auto byte = static_cast<std::uint8_t>(value);
+        writer.write_bytes(&byte, 1u);
+    }
+    template <typename Reader>
+    int read(Reader& reader) const {
+        std::uint8_t byte;
+        reader.read_bytes(&byte, 1u);
+        return byte;
+    }
+};
+
+class SerializationTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void nary();
+    void binary();
+    void conversions();
+    void codecs();
+    void views();
+    void manyTrees();
+    void invalidData();
+    void large();
+};
+
+template <typename Tree, typename Source>
+Tree round_trip(const Source& source) {
+    stringstream stream;
+    {
+        binary_writer writer(stream);
+        writer.write(source);
+    }
+    binary_reader reader(stream);
+    return reader.read<Tree>();
+}
+
+template <typename Tree>
+Tree read_tree(const string& bytes) {
+    stringstream input(bytes);
+    binary_reader reader(input);
+    return reader.read<Tree>();
+}
+
+void SerializationTest::nary() {
+    nary_tree<string> tree(
+        n("a")(
+            n("b")(
+                n("d"),
+                n("e")(
+                    n("h")),
+                n("f")),
+            n("c")(
+                n("g")(
+                    n("i"),
+                    n(""),
+                    n("a longer string than the others")))));
+    nary_tree<string> copy = round_trip<nary_tree<string>>(tree);
+    QVERIFY(copy == tree);
+    QCOMPARE(copy.size(), tree.size());
+    QCOMPARE(copy.arity(), tree.arity());
+    QVERIFY(round_trip<nary_tree<string>>(nary_tree<string>()).empty());
+}
+
+void SerializationTest::binary() {
+    binary_tree<int> tree(
+        n(1)(
+            n(2)(
+                n(4),
+                n()),
+            n(3)(
+                n(),
+                n(6)(
+                    n(7),
+                    n(8)))));
+    binary_tree<int> copy = round_trip<binary_tree<int>>(tree);
+    QVERIFY(copy == tree);
+    QVERIFY(copy.raw_root_node()->get_right_child()->get_left_child() == nullptr);
+    QVERIFY(copy.raw_root_node()->get_right_child()->get_right_child() != nullptr);
+    QVERIFY(copy.raw_root_node()->get_left_child()->get_left_child() != nullptr);
+}
+
+void SerializationTest::conversions() {
+    binary_tree<int> binary(
+        n(1)(
+            n(),
+            n(3)(
+                n(4))));
+    // The empty position is lost
+    nary_tree<int> nary = round_trip<nary_tree<int>>(binary);
+    QVERIFY(nary == n(1)(n(3)(n(4))));
+    binary_tree<int> back = round_trip<binary_tree<int>>(nary);
+    QVERIFY(back == n(1)(n(3)(n(4))));
+    QVERIFY(back.raw_root_node()->get_left_child() != nullptr);
+    nary_tree<int> wide(n(1)(n(2), n(3), n(4)));
+    QVERIFY_EXCEPTION_THROWN(round_trip<binary_tree<int>>(wide), std::invalid_argument);
+}
+
+void SerializationTest::codecs() {
+    nary_tree<point> points(n(point {1, 2})(n(point {-3, 4}), n(point {5, -6})));
+    QVERIFY(round_trip<nary_tree<point>>(points) == points);
+
+    nary_tree<int> tree(n(1)(n(2), n(300)));
+    stringstream stream;
+    {
+        binary_writer writer(stream);
+        writer.write(tree, byte_codec());
+    }
+    // Header, then for each node one byte for the shape and one for the value
+    QCOMPARE(stream.str().size(), size_t(16 + 3 * 2));
+    binary_reader reader(stream);
+    QVERIFY(reader.read<nary_tree<int>>(byte_codec()) == n(1)(n(2), n(300 % 256)));
+}
+
+void SerializationTest::views() {
+    nary_tree<char> tree(
+        n('a')(
+            n('b')(
+                n('d'),
+                n('e')),
+            n('c')(
+                n('f'))));
+    nary_tree_view<char> view(tree, find(tree.begin(), tree.end(), 'b'));
+    nary_tree<char> subtree = round_trip<nary_tree<char>>(view);
+    QVERIFY(subtree == n('b')(n('d'), n('e')));
+    nary_tree_view<char> leaf(tree, find(tree.begin(), tree.end(), 'f'));
+    QVERIFY(round_trip<nary_tree<char>>(leaf) == n('f'));
+}
+
+void SerializationTest::manyTrees() {
+    stringstream stream;
+    {
+        binary_writer writer(stream, 32u);
+        for (int i = 0; i < 100; ++i) {
+            writer.write(nary_tree<int>(n(i)(n(i + 1), n(i + 2)(n(i + 3)))));
+        }
+        writer.write(nary_tree<int>());
+    }
+    binary_reader reader(stream, 32u);
+    for (int i = 0; i < 100; ++i) {
+        QVERIFY(reader.read<nary_tree<int>>() == n(i)(n(i + 1), n(i + 2)(n(i + 3))));
+    }
+    QVERIFY(reader.read<nary_tree<int>>().empty());
+    QVERIFY_EXCEPTION_THROWN(reader.read<nary_tree<int>>(), std::invalid_argument);
+}
+
+void SerializationTest::invalidData() {
+    stringstream stream;
+    {
+        binary_writer writer(stream);
+        writer.write(nary_tree<int>(n(1)(n(2), n(3))));
+    }
+    const string data = stream.str();
+    auto read = [](const string& bytes) {
+        stringstream input(bytes);
+        binary_reader reader(input);
+        return reader.read<nary_tree<int>>();
+    };
+    QVERIFY(read(data) == n(1)(n(2), n(3)));
+    // Wrong magic
+    string corrupted = data;
+    corrupted[0]     = 'X';
+    QVERIFY_EXCEPTION_THROWN(read(corrupted), std::invalid_argument);
+    // Unknown version
+    corrupted    = data;
+    corrupted[4] = 99;
+    QVERIFY_EXCEPTION_THROWN(read(corrupted), std::invalid_argument);
+    // Truncated
+    QVERIFY_EXCEPTION_THROWN(read(data.substr(0, data.size() - 1)), std::invalid_argument);
+    // Declared size too small
+    corrupted    = data;
+    corrupted[8] = 2;
+    QVERIFY_EXCEPTION_THROWN(read(corrupted), std::invalid_argument);
+    // Declared size too big
+    corrupted    = data + data.substr(16);
+    corrupted[8] = 4;
+    QVERIFY_EXCEPTION_THROWN(read(corrupted), std::invalid_argument);
+    // String longer than the input, 2^62 characters are declared but the allocation follows the characters read
+    stringstream strings;
+    {
+        binary_writer writer(strings);
+        writer.write(nary_tree<string>(n(string(10000, 'x'))));
+    }
+    string text = strings.str();
+    QVERIFY(read_tree<nary_tree<string>>(text) == n(string(10000, 'x')));
+    // The header and the shape of the node take 17 bytes, then the length is a varint of 2 bytes
+    text.replace(17, 2, "\x80\x80\x80\x80\x80\x80\x80\x80\x40", 9);
+    QVERIFY_EXCEPTION_THROWN(read_tree<nary_tree<string>>(text), std::invalid_argument);
+}
+
+void SerializationTest::large() {
+    // 4-ary complete tree of depth 9, about 350k nodes
+    nary_tree<std::uint64_t> tree = complete_tree<nary_tree<std::uint64_t>>(4, 9);
+    // Values spread over every byte
+    for (std::uint64_t& value : tree) {
+        value *= 0x9E3779B97F4A7C15u;
+    }
+    nary_tree<std::uint64_t> copy = round_trip<nary_tree<std::uint64_t>>(tree);
+    QCOMPARE(copy.size(), tree.size());
+    QCOMPARE(copy.arity(), 4);
+    QVERIFY(copy == tree);
+}
+
+QTEST_MAIN(SerializationTest);
+#include "SerializationTest.moc"
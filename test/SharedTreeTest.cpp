@@ -0,0 +1,292 @@
+#include <QtTest/QtTest>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <TreeDS/tree>
+
+using namespace md;
+using namespace std;
+
+class SharedTreeTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void compress();
+    void iterate();
+    void copyOnWrite();
+    void erase();
+    void copyAndCompare();
+    void sameAsNaryTree();
+    void moveAssignAllocator();
+};
+
+// Allocator counting the objects alive in its arena, the copies share the arena
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    shared_ptr<long> alive;
+
+    explicit ArenaAllocator(shared_ptr<long> alive) :
+            alive(std::move(alive)) {
+    }
+
+    template <typename Other>
+    ArenaAllocator(const ArenaAllocator<Other>& other) :
+            alive(other.alive) {
+    }
+
+    T* allocate(size_t count) {
+        *this->alive += static_cast<long>(count);
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        *this->alive -= static_cast<long>(count);
+        std::allocator<T>().deallocate(pointer, count);
+    }
+
+    bool operator==(const ArenaAllocator& other) const {
+        return this->alive == other.alive;
+    }
+
+    bool operator!=(const ArenaAllocator& other) const {
+        return this->alive != other.alive;
+    }
+};
+
+nary_tree<char> make_tree() {
+    return n('a')(
+        n('b')(
+            n('c'),
+            n('d')),
+        n('e')(
+            n('b')(
+                n('c'),
+                n('d'))),
+        n('b')(
+            n('c'),
+            n('d')));
+}
+
+template <typename P, typename Tree>
+vector<char> values(const Tree& tree, P policy) {
+    vector<char> result;
+    for (auto it = tree.begin(policy); it != tree.end(policy); ++it) {
+        result.push_back(*it);
+    }
+    return result;
+}
+
+void SharedTreeTest::compress() {
+    nary_tree<char> tree = make_tree();
+    shared_tree<char> shared(tree);
+    QCOMPARE(shared.size(), tree.size());
+    // a, b(c, d), c, d, e(b(c, d))
+    QCOMPARE(shared.distinct_size(), 5u);
+    const shared_node<char>* root = shared.raw_root_node();
+    QCOMPARE(root->get_children()[0], root->get_children()[2]);
+    QCOMPARE(root->get_children()[0], root->get_children()[1]->get_children()[0]);
+    QCOMPARE(root->get_children()[0]->get_references(), 3u);
+    QCOMPARE(root->get_references(), 1u);
+    QVERIFY(shared.expand() == tree);
+    // Constructed directly from a structure
+    shared_tree<char> other(n('x')(n('y'), n('y'), n('y')(n('y'))));
+    QCOMPARE(other.size(), 5u);
+    QCOMPARE(other.distinct_size(), 3u);
+    shared_tree<char> empty;
+    QVERIFY(empty.empty());
+    QCOMPARE(empty.size(), 0u);
+    QVERIFY(empty.expand().empty());
+    QVERIFY(empty.begin() == empty.end());
+}
+
+void SharedTreeTest::iterate() {
+    nary_tree<char> tree = make_tree();
+    shared_tree<char> shared(tree);
+    QCOMPARE(values(shared, policy::pre_order()), values(tree, policy::pre_order()));
+    QCOMPARE(values(shared, policy::post_order()), values(tree, policy::post_order()));
+    QCOMPARE(values(shared, policy::breadth_first()), values(tree, policy::breadth_first()));
+    QCOMPARE(values(shared, policy::leaves()), values(tree, policy::leaves()));
+    QCOMPARE(values(shared, policy::siblings()), values(tree, policy::siblings()));
+    QCOMPARE(*shared.root(), 'a');
+    // The occurrences of the same node are distinct positions
+    auto it     = shared.begin(policy::pre_order());
+    auto first  = std::next(it, 1);
+    auto second = std::next(it, 5);
+    QCOMPARE(*first, 'b');
+    QCOMPARE(*second, 'b');
+    QCOMPARE(first.get_node_pointer().get_node(), second.get_node_pointer().get_node());
+    QVERIFY(first != second);
+    QVERIFY(first == std::next(shared.begin(policy::pre_order()), 1));
+}
+
+void SharedTreeTest::copyOnWrite() {
+    shared_tree<char> shared(make_tree());
+    const shared_node<char>* b = shared.raw_root_node()->get_children()[0];
+    // Modify the b(c, d) under e, the other two occurrences are untouched
+    auto position = std::next(shared.begin(policy::pre_order()), 6);
+    QCOMPARE(*position, 'c');
+    auto result = shared.insert_over(position, 'x');
+    QCOMPARE(*result, 'x');
+    QCOMPARE(result.get_node_pointer().get_parent().get_value(), 'b');
+    nary_tree<char> expected {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')),
+            n('e')(
+                n('b')(
+                    n('x'),
+                    n('d'))),
+            n('b')(
+                n('c'),
+                n('d')))};
+    QVERIFY(shared.expand() == expected);
+    QCOMPARE(shared.raw_root_node()->get_children()[0], b);
+    QCOMPARE(shared.raw_root_node()->get_children()[2], b);
+    QCOMPARE(b->get_references(), 2u);
+    // a, b(c, d), c, d, e(b(x, d)), b(x, d), x
+    QCOMPARE(shared.distinct_size(), 7u);
+    // Making it equal again shares it again
+    shared.emplace_over(result, 'c');
+    QVERIFY(shared.expand() == make_tree());
+    QCOMPARE(shared.distinct_size(), 5u);
+    QCOMPARE(b->get_references(), 3u);
+    // Children inserted
+    auto child = shared.insert_child_back(shared.root(), n('b')(n('c'), n('d')));
+    QCOMPARE(*child, 'b');
+    QCOMPARE(child.get_node_pointer().get_node(), b);
+    QCOMPARE(b->get_references(), 4u);
+    auto front = shared.emplace_child_front(std::next(shared.begin(policy::pre_order()), 4), 'f');
+    QCOMPARE(*front, 'f');
+    QCOMPARE(front.get_node_pointer().get_parent().get_value(), 'e');
+    shared.insert_child_front(shared.root(), 'g');
+    nary_tree<char> grown = make_tree();
+    grown.insert_child_back(grown.root(), n('b')(n('c'), n('d')));
+    grown.insert_child_front(std::next(grown.begin(policy::pre_order()), 4), 'f');
+    grown.insert_child_front(grown.root(), 'g');
+    QVERIFY(shared.expand() == grown);
+    QCOMPARE(shared.size(), grown.size());
+    // The whole tree replaced
+    shared.insert_over(shared.root(), n('z')(n('z')));
+    QCOMPARE(shared.size(), 2u);
+    QCOMPARE(shared.distinct_size(), 2u);
+    // Positions of another tree
+    shared_tree<char> other(make_tree());
+    QVERIFY_EXCEPTION_THROWN(shared.insert_over(other.root(), 'x'), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(shared.insert_over(shared.end(), 'x'), std::invalid_argument);
+    QCOMPARE(shared.distinct_size(), 2u);
+}
+
+void SharedTreeTest::erase() {
+    shared_tree<char> shared(make_tree());
+    shared.erase(std::next(shared.begin(policy::pre_order()), 4));
+    nary_tree<char> expected {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')),
+            n('b')(
+                n('c'),
+                n('d')))};
+    QVERIFY(shared.expand() == expected);
+    // a, b(c, d), c, d
+    QCOMPARE(shared.distinct_size(), 4u);
+    shared.erase(shared.root());
+    QVERIFY(shared.empty());
+    QCOMPARE(shared.distinct_size(), 0u);
+    shared.insert_over(shared.end(policy::pre_order()), 'a');
+    QCOMPARE(shared.size(), 1u);
+    QCOMPARE(*shared.root(), 'a');
+}
+
+void SharedTreeTest::copyAndCompare() {
+    shared_tree<char> shared(make_tree());
+    shared_tree<char> copy(shared);
+    QVERIFY(copy == shared);
+    QCOMPARE(copy.distinct_size(), shared.distinct_size());
+    QVERIFY(copy.raw_root_node() != shared.raw_root_node());
+    copy.insert_over(std::next(copy.begin(policy::pre_order()), 3), 'x');
+    QVERIFY(copy != shared);
+    QVERIFY(shared.expand() == make_tree());
+    shared_tree<char> moved(std::move(copy));
+    QVERIFY(copy.empty());
+    QCOMPARE(moved.size(), 11u);
+    copy = moved;
+    QVERIFY(copy == moved);
+    copy = shared_tree<char>();
+    QVERIFY(copy != moved);
+    QVERIFY(copy == shared_tree<char>());
+}
+
+void SharedTreeTest::sameAsNaryTree() {
+    mt19937 random(17);
+    for (int i = 0; i < 50; ++i) {
+        nary_tree<char> tree(n('a'));
+        shared_tree<char> shared(tree);
+        for (int step = 0; step < 80; ++step) {
+            if (tree.empty()) {
+                tree.insert_over(tree.end(), 'a');
+                shared.insert_over(shared.end(policy::pre_order()), 'a');
+            }
+            const int offset = static_cast<int>(random() % tree.size());
+            auto it          = std::next(tree.begin(policy::pre_order()), offset);
+            auto position    = std::next(shared.begin(policy::pre_order()), offset);
+            // Few values to have many repeated subtrees
+            char value = "ab"[random() % 2];
+            switch (random() % 6) {
+            case 0:
+            case 1:
+                tree.insert_child_back(it, value);
+                shared.insert_child_back(position, value);
+                break;
+            case 2:
+                tree.insert_child_front(it, n(value)(n('b')));
+                shared.insert_child_front(position, n(value)(n('b')));
+                break;
+            case 3:
+                tree.insert_over(it, value);
+                shared.insert_over(position, value);
+                break;
+            case 4:
+                tree.insert_over(it, n(value)(n('a'), n('b')));
+                shared.insert_over(position, n(value)(n('a'), n('b')));
+                break;
+            case 5:
+                tree.erase(tree.begin(policy::post_order()).other_node(it.get_raw_node()));
+                shared.erase(position);
+                break;
+            }
+            QCOMPARE(shared.size(), tree.size());
+            QVERIFY(shared.expand() == tree);
+            QVERIFY(shared == shared_tree<char>(tree));
+            QCOMPARE(shared.distinct_size(), shared_tree<char>(tree).distinct_size());
+        }
+    }
+}
+
+void SharedTreeTest::moveAssignAllocator() {
+    using tree_type = shared_tree<char, default_policy, ArenaAllocator<char>>;
+    auto first      = make_shared<long>(0);
+    auto second     = make_shared<long>(0);
+    {
+        tree_type a(make_tree(), ArenaAllocator<char>(first));
+        tree_type b(nary_tree<char>(n('x')(n('y'))), ArenaAllocator<char>(second));
+        QCOMPARE(*first, 5l);
+        QCOMPARE(*second, 2l);
+        b = std::move(a);
+        // The nodes moved are still released by the allocator that created them
+        QCOMPARE(*second, 0l);
+        QCOMPARE(*first, 5l);
+        QCOMPARE(values(b, policy::pre_order()), values(make_tree(), policy::pre_order()));
+    }
+    QCOMPARE(*first, 0l);
+    QCOMPARE(*second, 0l);
+}
+
+QTEST_MAIN(SharedTreeTest)
+
+#include "SharedTreeTest.moc"
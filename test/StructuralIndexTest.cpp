@@ -0,0 +1,169 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <vector>
+
+#include <TreeDS/index>
+#include <TreeDS/match>
+#include <TreeDS/tree>
+
+#include "Types.hpp"
+
+using namespace md;
+using namespace std;
+
+class StructuralIndexTest : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')(
+                    n('e'))),
+            n('c')(
+                n('a')(
+                    n('b'),
+                    n('e'))),
+            n('b'))};
+
+    private slots:
+    void signatures();
+    void required();
+    void searchAll();
+    void sameAsSearchAll();
+    void binaryTree();
+    void wrongTree();
+};
+
+void StructuralIndexTest::signatures() {
+    structural_index index(tree);
+    QCOMPARE(index.size(), 10u);
+    QCOMPARE(index.get_nodes().front(), tree.raw_root_node());
+    const structural_signature& root = index.get_signatures()[0];
+    QCOMPARE(root.size, 10u);
+    QCOMPARE(root.height, 4u);
+    QCOMPARE(root.value, structural_signature::value_bit(index.hash('a')));
+    // Node d(e)
+    const structural_signature& d = index.get_signatures()[3];
+    QCOMPARE(index.get_nodes()[3]->get_value(), 'd');
+    QCOMPARE(d.size, 2u);
+    QCOMPARE(d.height, 2u);
+    QCOMPARE(
+        d.values,
+        structural_signature::value_bit(index.hash('d')) | structural_signature::value_bit(index.hash('e')));
+    QCOMPARE(d.edges, structural_signature::edge_bit(index.hash('d'), index.hash('e')));
+    // A signature covers the ones of its subtrees, except for the value of the node itself
+    for (size_t i = 0; i < index.size(); ++i) {
+        structural_signature subtree = index.get_signatures()[i];
+        QCOMPARE(subtree.size, calculate_size(*index.get_nodes()[i]));
+        subtree.value = 0u;
+        QVERIFY(root.covers(subtree));
+    }
+    structural_index<nary_tree<char>> empty;
+    QCOMPARE(empty.size(), 0u);
+    empty.rebuild(nary_tree<char>());
+    QCOMPARE(empty.size(), 0u);
+}
+
+void StructuralIndexTest::required() {
+    structural_index index(tree);
+    auto concrete = cpt(one('a')(one('b')(one('c')), star(), one('e')));
+    structural_signature signature = concrete.required_structure(index);
+    QCOMPARE(signature.size, 4u);
+    QCOMPARE(signature.height, 3u);
+    QCOMPARE(signature.value, structural_signature::value_bit(index.hash('a')));
+    QCOMPARE(
+        signature.edges,
+        structural_signature::edge_bit(index.hash('a'), index.hash('b'))
+            | structural_signature::edge_bit(index.hash('b'), index.hash('c'))
+            | structural_signature::edge_bit(index.hash('a'), index.hash('e')));
+    // Neither the optional nodes nor the ones below them are required, one() requires a node of any value
+    auto partial = one()(opt('x')(one('y')), star('z'), one());
+    signature    = partial.required_structure(index);
+    QCOMPARE(signature.size, 2u);
+    QCOMPARE(signature.height, 2u);
+    QCOMPARE(signature.value, 0u);
+    QCOMPARE(signature.values, 0u);
+    QCOMPARE(signature.edges, 0u);
+    QVERIFY(index.get_signatures()[1].covers(signature));
+    QVERIFY(!index.get_signatures()[2].covers(signature));
+}
+
+void StructuralIndexTest::searchAll() {
+    structural_index index(tree);
+    pattern p(cpt(one('a')(one('b'))));
+    vector<const nary_node<char>*> found;
+    for (const auto& match : p.search_all(tree, index)) {
+        found.push_back(match.get_node());
+        QCOMPARE(match.get_mark(const_index<1>()), match.get_node());
+    }
+    vector<const nary_node<char>*> expected {tree.raw_root_node(), tree.raw_root_node()->get_child(1)->get_child(0)};
+    QCOMPARE(found, expected);
+    pattern missing(one('b')(one('e')));
+    auto matches = missing.search_all(tree, index);
+    QVERIFY(matches.begin() == matches.end());
+}
+
+template <typename Tree, typename Make>
+void compare_with_scan(const Tree& tree, const structural_index<Tree>& index, Make make) {
+    using node_type = typename Tree::node_type;
+    pattern scan(make());
+    pattern indexed(make());
+    vector<const node_type*> expected;
+    for (const auto& match : scan.search_all(tree)) {
+        expected.push_back(match.get_node());
+    }
+    vector<const node_type*> found;
+    for (const auto& match : indexed.search_all(tree, index)) {
+        found.push_back(match.get_node());
+    }
+    QCOMPARE(found, expected);
+}
+
+void StructuralIndexTest::sameAsSearchAll() {
+    mt19937 random(11);
+    for (int i = 0; i < 200; ++i) {
+        nary_tree<char> tree = random_tree(random(), 1 + static_cast<int>(random() % 60), "abcd");
+        structural_index index(tree);
+        compare_with_scan(tree, index, [] { return one('a')(one('b')(one('c')), one('d')); });
+        compare_with_scan(tree, index, [] { return cpt(one('c')(star()(one('d')))); });
+        compare_with_scan(tree, index, [] { return one()(one('a'), one('c')(one())); });
+        compare_with_scan(tree, index, [] { return star('b')(one('a')); });
+        compare_with_scan(tree, index, [] { return one('b')(opt('d')(one('a')), cpt(one('c'))); });
+        compare_with_scan(tree, index, [] { return one('a')(one('a')(one('a')), one('a')); });
+    }
+}
+
+void StructuralIndexTest::binaryTree() {
+    binary_tree<char> tree {
+        n('a')(
+            n('b')(
+                n(),
+                n('a')(
+                    n('c'),
+                    n('b'))),
+            n('b')(
+                n('c')))};
+    structural_index index(tree);
+    QCOMPARE(index.get_signatures()[0].size, 7u);
+    QCOMPARE(index.get_signatures()[0].height, 4u);
+    compare_with_scan(tree, index, [] { return one('a')(one('b')); });
+    compare_with_scan(tree, index, [] { return one('b')(one('c')); });
+    compare_with_scan(tree, index, [] { return one('a')(one('c'), one('b')); });
+    pattern p(one('b')(one('a')(one('c'))));
+    auto matches = p.search_all(tree, index);
+    QVERIFY(matches.begin() != matches.end());
+    QCOMPARE(matches.begin()->get_node(), tree.raw_root_node()->get_left_child());
+}
+
+void StructuralIndexTest::wrongTree() {
+    nary_tree<char> other(tree);
+    structural_index index(other);
+    pattern p(one('a'));
+    QVERIFY_EXCEPTION_THROWN(p.search_all(tree, index), std::invalid_argument);
+}
+
+QTEST_MAIN(StructuralIndexTest)
+
+#include "StructuralIndexTest.moc"
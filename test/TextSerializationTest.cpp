@@ -0,0 +1,193 @@
+#include <QtTest/QtTest>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <TreeDS/serialize>
+#include <TreeDS/tree>
+#include <TreeDS/view>
+
+#include "Types.hpp"
+
+using namespace std;
+using namespace md;
+
+class TextSerializationTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void format();
+    void indentation();
+    void parse();
+    void binary();
+    void values();
+    void manyTrees();
+    void invalidText();
+    void large();
+};
+
+template <typename Source>
+string format_tree(const Source& source, unsigned indentation = 0u) {
+    ostringstream stream;
+    {
+        text_writer writer(stream, indentation);
+        writer.write(source);
+    }
+    return stream.str();
+}
+
+template <typename Tree>
+Tree parse_tree(const string& text) {
+    istringstream stream(text);
+    text_reader reader(stream);
+    return reader.read<Tree>();
+}
+
+void TextSerializationTest::format() {
+    nary_tree<char> tree(
+        n('a')(
+            n('b')(
+                n('d'),
+                n('e')),
+            n('c')(
+                n('f'))));
+    QCOMPARE(format_tree(tree), string("n('a')(n('b')(n('d'), n('e')), n('c')(n('f')))"));
+    QCOMPARE(format_tree(nary_tree<char>()), string("n()"));
+    QCOMPARE(format_tree(nary_tree<char>(n('x'))), string("n('x')"));
+    // Views stop at their root
+    nary_tree_view<char> view(tree, find(tree.begin(), tree.end(), 'b'));
+    QCOMPARE(format_tree(view), string("n('b')(n('d'), n('e'))"));
+    binary_tree<int> binary(
+        n(1)(
+            n(),
+            n(2)(
+                n(3))));
+    QCOMPARE(format_tree(binary), string("n(1)(n(), n(2)(n(3)))"));
+}
+
+void TextSerializationTest::indentation() {
+    nary_tree<int> tree(
+        n(1)(
+            n(2)(
+                n(3)),
+            n(4)));
+    QCOMPARE(
+        format_tree(tree, 4u),
+        string(
+            "n(1)(\n"
+            "    n(2)(\n"
+            "        n(3)),\n"
+            "    n(4))"));
+    // The indented text is parsed back
+    QVERIFY(parse_tree<nary_tree<int>>(format_tree(tree, 4u)) == tree);
+}
+
+void TextSerializationTest::parse() {
+    nary_tree<string> tree = parse_tree<nary_tree<string>>(
+        "  n(\"root\") (\n"
+        "\tn( \"a\" ),\n"
+        "    n(\"b\")(n(\"b1\") , n(\"b2\")) ,n(\"c\")\n"
+        ")  ");
+    QVERIFY(
+        tree
+        == n("root")(
+            n("a"),
+            n("b")(
+                n("b1"),
+                n("b2")),
+            n("c")));
+    QCOMPARE(tree.size(), 6);
+    QCOMPARE(tree.arity(), 3);
+    QVERIFY(parse_tree<nary_tree<string>>("n()").empty());
+    QVERIFY(parse_tree<nary_tree<string>>("n(\"x\")") == n("x"));
+}
+
+void TextSerializationTest::binary() {
+    binary_tree<int> tree = parse_tree<binary_tree<int>>("n(1)(n(), n(2)(n(3), n(4)(n())))");
+    QVERIFY(
+        tree
+        == n(1)(
+            n(),
+            n(2)(
+                n(3),
+                n(4))));
+    QVERIFY(tree.raw_root_node()->get_left_child() == nullptr);
+    QCOMPARE(format_tree(tree), string("n(1)(n(), n(2)(n(3), n(4)))"));
+    // A single child is the left one
+    binary_tree<int> left = parse_tree<binary_tree<int>>("n(1)(n(2))");
+    QVERIFY(left.raw_root_node()->get_left_child() != nullptr);
+    QVERIFY_EXCEPTION_THROWN(parse_tree<binary_tree<int>>("n(1)(n(2), n(3), n(4))"), std::logic_error);
+    QVERIFY_EXCEPTION_THROWN(parse_tree<nary_tree<int>>("n(1)(n(), n(2))"), std::invalid_argument);
+}
+
+void TextSerializationTest::values() {
+    nary_tree<string> strings(n(string("quote\"s"))(n(string("back\\slash")), n(string("new\nline\x01")), n(string())));
+    QCOMPARE(
+        format_tree(strings),
+        string(R"(n("quote\"s")(n("back\\slash"), n("new\nline\x01"), n("")))"));
+    QVERIFY(parse_tree<nary_tree<string>>(format_tree(strings)) == strings);
+
+    nary_tree<char> chars(n('\'')(n('\\'), n('\t'), n(')')));
+    QCOMPARE(format_tree(chars), string(R"(n('\'')(n('\\'), n('\t'), n(')')))"));
+    QVERIFY(parse_tree<nary_tree<char>>(format_tree(chars)) == chars);
+
+    nary_tree<double> doubles(n(0.1)(n(-2.5e300), n(3.0)));
+    QCOMPARE(format_tree(doubles), string("n(0.1)(n(-2.5e+300), n(3))"));
+    QVERIFY(parse_tree<nary_tree<double>>(format_tree(doubles)) == doubles);
+
+    nary_tree<bool> bools(n(true)(n(false)));
+    QCOMPARE(format_tree(bools), string("n(true)(n(false))"));
+    QVERIFY(parse_tree<nary_tree<bool>>(format_tree(bools)) == bools);
+
+    nary_tree<long long> longs(n(-9223372036854775807ll - 1)(n(9223372036854775807ll)));
+    QVERIFY(parse_tree<nary_tree<long long>>(format_tree(longs)) == longs);
+}
+
+void TextSerializationTest::manyTrees() {
+    stringstream stream;
+    {
+        text_writer writer(stream, 0u, 64u);
+        for (int i = 0; i < 100; ++i) {
+            writer.write(nary_tree<int>(n(i)(n(i + 1), n(i + 2)(n(i + 3)))));
+            writer.write_char('\n');
+        }
+    }
+    text_reader reader(stream, 16u);
+    for (int i = 0; i < 100; ++i) {
+        QVERIFY(reader.read<nary_tree<int>>() == n(i)(n(i + 1), n(i + 2)(n(i + 3))));
+    }
+}
+
+void TextSerializationTest::invalidText() {
+    QVERIFY_EXCEPTION_THROWN(parse_tree<nary_tree<int>>(""), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_tree<nary_tree<int>>("m(1)"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_tree<nary_tree<int>>("n(1)(n(2)"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_tree<nary_tree<int>>("n(1)(n(2) n(3))"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_tree<nary_tree<int>>("n(1)()"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_tree<nary_tree<int>>("n(x1)"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_tree<nary_tree<int>>("n(99999999999999999999)"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_tree<nary_tree<bool>>("n(maybe)"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_tree<nary_tree<char>>("n('ab')"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_tree<nary_tree<string>>("n(\"unterminated)"), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(parse_tree<nary_tree<string>>("n(\"\\q\")"), std::invalid_argument);
+    // The offset is reported
+    try {
+        parse_tree<nary_tree<int>>("n(1)(n(2);");
+        QVERIFY(false);
+    } catch (const std::invalid_argument& e) {
+        QVERIFY(string(e.what()).find("offset 9") != string::npos);
+    }
+}
+
+void TextSerializationTest::large() {
+    // 5-ary complete tree of depth 7, well over the 10 nodes printed by print_tree
+    nary_tree<int> tree = complete_tree<nary_tree<int>>(5, 7);
+    nary_tree<int> copy = parse_tree<nary_tree<int>>(format_tree(tree));
+    QCOMPARE(copy.size(), tree.size());
+    QVERIFY(copy == tree);
+    QCOMPARE(format_tree(copy, 2u), format_tree(tree, 2u));
+}
+
+QTEST_MAIN(TextSerializationTest);
+#include "TextSerializationTest.moc"
@@ -0,0 +1,145 @@
+#include <QtTest/QtTest>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <TreeDS/tree>
+
+#include "Types.hpp"
+
+using namespace std;
+using namespace md;
+
+class TreeBuilderTest : public QObject {
+
+    Q_OBJECT
+
+    private slots:
+    void nary();
+    void binary();
+    void reuse();
+    void invalidEvents();
+    void large();
+};
+
+void TreeBuilderTest::nary() {
+    tree_builder<nary_tree<string>> builder;
+    builder
+        .open("a")
+        .open("b")
+        .leaf("d")
+        .open("e")
+        .leaf("h")
+        .close()
+        .leaf("f")
+        .close()
+        .open("c")
+        .open("g")
+        .leaf("i")
+        .leaf("j")
+        .leaf("k")
+        .close()
+        .close();
+    QCOMPARE(builder.depth(), 1);
+    builder.close();
+    QVERIFY(builder.complete());
+    QCOMPARE(builder.size(), 11);
+    nary_tree<string> tree = builder.build();
+    QCOMPARE(tree.size(), 11);
+    QCOMPARE(tree.arity(), 3);
+    QVERIFY(
+        tree
+        == n("a")(
+            n("b")(
+                n("d"),
+                n("e")(
+                    n("h")),
+                n("f")),
+            n("c")(
+                n("g")(
+                    n("i"),
+                    n("j"),
+                    n("k")))));
+    // Siblings must be linked correctly, modifiers rely on it
+    tree.emplace_child_front(find(tree.begin(), tree.end(), "g"), "z");
+    QCOMPARE(tree.arity(), 4);
+    vector<string> post_order(tree.begin(policy::post_order()), tree.end(policy::post_order()));
+    QCOMPARE(post_order, (vector<string> {"d", "h", "e", "f", "b", "z", "i", "j", "k", "g", "c", "a"}));
+}
+
+void TreeBuilderTest::binary() {
+    tree_builder<binary_tree<int>> builder;
+    builder
+        .open(1)
+        .open(2)
+        .leaf(4)
+        .close()
+        .open(3)
+        .skip()
+        .leaf(6)
+        .close()
+        .close();
+    binary_tree<int> tree = builder.build();
+    QCOMPARE(tree.size(), 5);
+    QCOMPARE(tree.arity(), 2);
+    QVERIFY(
+        tree
+        == n(1)(
+            n(2)(
+                n(4)),
+            n(3)(
+                n(),
+                n(6))));
+    QVERIFY(tree.raw_root_node()->get_left_child()->get_left_child() != nullptr);
+    QVERIFY(tree.raw_root_node()->get_right_child()->get_left_child() == nullptr);
+    QVERIFY(tree.raw_root_node()->get_right_child()->get_right_child() != nullptr);
+}
+
+void TreeBuilderTest::reuse() {
+    tree_builder<nary_tree<int>> builder;
+    QVERIFY(!builder.complete());
+    QVERIFY(builder.build().empty());
+    builder.leaf(1);
+    nary_tree<int> first = builder.build();
+    QVERIFY(first == n(1));
+    QCOMPARE(first.arity(), 0);
+    builder.open(2).leaf(3).close();
+    nary_tree<int> second = builder.build();
+    QVERIFY(second == n(2)(n(3)));
+    QCOMPARE(second.size(), 2);
+    QCOMPARE(second.arity(), 1);
+    QVERIFY(first == n(1));
+}
+
+void TreeBuilderTest::invalidEvents() {
+    tree_builder<binary_tree<int>> builder;
+    QVERIFY_EXCEPTION_THROWN(builder.close(), std::logic_error);
+    QVERIFY_EXCEPTION_THROWN(builder.skip(), std::logic_error);
+    builder.open(1).leaf(2).leaf(3);
+    QVERIFY_EXCEPTION_THROWN(builder.leaf(4), std::logic_error);
+    QVERIFY_EXCEPTION_THROWN(builder.skip(), std::logic_error);
+    QVERIFY_EXCEPTION_THROWN(builder.build(), std::logic_error);
+    builder.close();
+    QVERIFY_EXCEPTION_THROWN(builder.leaf(5), std::logic_error);
+    QCOMPARE(builder.build().size(), 3);
+    // Unfinished trees are released by the builder
+    tree_builder<nary_tree<int>> unfinished;
+    unfinished.open(1).open(2).leaf(3);
+}
+
+void TreeBuilderTest::large() {
+    // Complete 4-ary tree of depth 8
+    nary_tree<int> tree = complete_tree<nary_tree<int>>(4, 8);
+    const int size      = 87381; // (4^9 - 1) / 3
+    QCOMPARE(tree.size(), size);
+    QCOMPARE(tree.arity(), 4);
+    // Values were assigned in pre-order
+    vector<int> values(tree.begin(policy::pre_order()), tree.end(policy::pre_order()));
+    QCOMPARE(values.size(), static_cast<size_t>(size));
+    for (int i = 0; i < size; ++i) {
+        QCOMPARE(values[i], i);
+    }
+}
+
+QTEST_MAIN(TreeBuilderTest);
+#include "TreeBuilderTest.moc"
@@ -25,6 +25,9 @@ class TreeTest : public QObject {
     void binaryTree();
     void binaryTree2();
     void nonCopyable();
+    void detachSubtree();
+    void insertTreeSize();
+    void insertChild();
 };
 
 void TreeTest::naryTree() {
@@ -321,6 +324,25 @@ void TreeTest::naryTree2() {
     QCOMPARE(it.get_raw_node()->following_siblings(), 0);
     QCOMPARE(it.get_raw_node()->get_prev_sibling()->get_value(), Foo(-4, -5));
     QCOMPARE(it.get_raw_node()->get_next_sibling(), nullptr);
+
+    // Erase the first and the last child
+    const auto* parent = it.get_raw_node()->get_parent();
+    tree.erase(std::find(tree.begin(), tree.end(), Foo(-2, -3)).other_policy(policy::post_order()));
+    QCOMPARE(parent->get_first_child()->get_value(), Foo(-3, -4));
+    QCOMPARE(parent->get_first_child()->following_siblings(), 2);
+    QCOMPARE(parent->get_first_child()->get_prev_sibling(), nullptr);
+    tree.erase(std::find(tree.begin(), tree.end(), Foo(-5, -6)).other_policy(policy::post_order()));
+    QCOMPARE(parent->get_last_child()->get_value(), Foo(-4, -5));
+    QCOMPARE(parent->get_last_child()->get_next_sibling(), nullptr);
+    QCOMPARE(tree.size(), 6);
+    QCOMPARE(
+        tree,
+        n(Foo(0, 0))(
+            n(Foo(2, 5)),
+            n(Foo(-1, -2))(
+                n(Foo(-3, -4))(
+                    n(Foo(-7, -8))),
+                n(Foo(-4, -5)))));
 }
 
 void TreeTest::binaryTree() {
@@ -425,5 +447,61 @@ void TreeTest::nonCopyable() {
     QCOMPARE(it, itEnd);
 }
 
+void TreeTest::detachSubtree() {
+    nary_tree<char> tree(n('a')(n('b')(n('c'), n('d')), n('e')));
+    auto detached = tree.detach_subtree(tree.root().other_node(tree.raw_root_node()->get_child(0u)));
+    QVERIFY(detached == nary_tree<char>(n('b')(n('c'), n('d'))));
+    QCOMPARE(detached.size(), 3u);
+    QVERIFY(tree == nary_tree<char>(n('a')(n('e'))));
+    QCOMPARE(tree.size(), 2u);
+    auto whole = tree.detach_subtree(tree.root());
+    QVERIFY(tree.empty());
+    QCOMPARE(whole.size(), 2u);
+    QVERIFY_EXCEPTION_THROWN(whole.detach_subtree(whole.end()), std::logic_error);
+}
+
+void TreeTest::insertTreeSize() {
+    nary_tree<char> tree(n('a')(n('b')));
+    nary_tree<char> other(n('c')(n('d'), n('e'), n('f')));
+    tree.insert_child_back(tree.root(), other);
+    QCOMPARE(tree.size(), 6u);
+    QCOMPARE(tree.arity(), 3u);
+    tree.insert_child_front(tree.root(), std::move(other));
+    QVERIFY(other.empty());
+    QCOMPARE(tree.size(), 10u);
+    QCOMPARE(tree.arity(), 3u);
+    tree.insert_child_back(tree.root(), nary_tree<char>());
+    QCOMPARE(tree.size(), 10u);
+    // Size updated after the size became unknown
+    tree.detach_subtree(tree.root().other_node(tree.raw_root_node()->get_first_child()));
+    tree.insert_child_back(tree.root(), 'g');
+    QCOMPARE(tree.size(), 7u);
+    tree.insert_over(tree.root().other_node(tree.raw_root_node()->get_last_child()), n('h')(n('i')));
+    QCOMPARE(tree.size(), 8u);
+}
+
+void TreeTest::insertChild() {
+    nary_tree<char> tree(n('a')(n('b'), n('c')));
+    tree.insert_child(tree.root(), 1u, 'x');
+    tree.insert_child(tree.root(), 0u, n('y')(n('z')));
+    tree.insert_child(tree.root(), 4u, 'w');
+    nary_tree<char> expected(n('a')(n('y')(n('z')), n('b'), n('x'), n('c'), n('w')));
+    QVERIFY(tree == expected);
+    QCOMPARE(tree.size(), 7u);
+    QCOMPARE(tree.arity(), 5u);
+    // The number of following siblings is kept
+    QCOMPARE(tree.raw_root_node()->get_child(2u)->following_siblings(), 2u);
+    QCOMPARE(tree.raw_root_node()->get_child(4u)->get_value(), 'w');
+    QVERIFY_EXCEPTION_THROWN(tree.insert_child(tree.root(), 6u, 'v'), std::logic_error);
+    QVERIFY_EXCEPTION_THROWN(tree.insert_child(tree.end(), 0u, 'v'), std::logic_error);
+    QCOMPARE(tree.size(), 7u);
+    // Moved from another tree
+    nary_tree<char> other(n('m')(n('n')));
+    tree.insert_child(tree.root().other_node(tree.raw_root_node()->get_child(1u)), 0u, std::move(other));
+    QVERIFY(other.empty());
+    QCOMPARE(tree.size(), 9u);
+    QCOMPARE(tree.raw_root_node()->get_child(1u)->get_child(0u)->get_value(), 'm');
+}
+
 QTEST_MAIN(TreeTest);
 #include "TreeTest.moc"
@@ -2,9 +2,14 @@
 
 #include <QtTest/QtTest>
 #include <algorithm>
+#include <cstring> // std::strlen()
 #include <deque>
 #include <memory>
+#include <random>
 #include <string>
+#include <vector>
+
+#include <TreeDS/tree>
 
 struct NonCopyable {
     char a;
@@ -152,3 +157,68 @@ int CustomAllocator<T>::total_allocated = 0;
 
 template <typename T>
 int CustomAllocator<T>::total_deallocated = 0;
+
+/*
+ * Random tree of at most size nodes (the root at least), the same seed gives the same tree. The values are taken among
+ * the characters of values and each node has up to arity children, drawn in pre-order.
+ */
+template <typename Tree = md::nary_tree<char>>
+Tree random_tree(unsigned seed, int size, const char* values = "abc", int arity = 3) {
+    std::mt19937 random(seed);
+    const std::size_t letters = std::strlen(values);
+    md::tree_builder<Tree> builder;
+    int remaining = size - 1;
+    // Children still to be added to each node open
+    std::vector<int> pending;
+    auto add = [&]() {
+        char value   = values[random() % letters];
+        int children = remaining > 0 ? static_cast<int>(random() % (arity + 1)) : 0;
+        children     = std::min(children, remaining);
+        remaining -= children;
+        if (children == 0) {
+            builder.leaf(value);
+        } else {
+            builder.open(value);
+            pending.push_back(children);
+        }
+    };
+    add();
+    while (!pending.empty()) {
+        if (pending.back() == 0) {
+            builder.close();
+            pending.pop_back();
+        } else {
+            --pending.back();
+            add();
+        }
+    }
+    return builder.build();
+}
+
+// Complete tree whose internal nodes have arity children, the values are 0, 1, 2... in pre-order
+template <typename Tree>
+Tree complete_tree(int arity, int depth) {
+    md::tree_builder<Tree> builder;
+    typename Tree::value_type counter {};
+    // Children still to be added to each node open, one per level
+    std::vector<int> pending;
+    auto add = [&]() {
+        if (static_cast<int>(pending.size()) == depth) {
+            builder.leaf(counter++);
+        } else {
+            builder.open(counter++);
+            pending.push_back(arity);
+        }
+    };
+    add();
+    while (!pending.empty()) {
+        if (pending.back() == 0) {
+            builder.close();
+            pending.pop_back();
+        } else {
+            --pending.back();
+            add();
+        }
+    }
+    return builder.build();
+}
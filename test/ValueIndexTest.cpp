@@ -0,0 +1,119 @@
+#include <QtTest/QtTest>
+#include <random>
+#include <vector>
+
+#include <TreeDS/index>
+#include <TreeDS/match>
+#include <TreeDS/tree>
+#include <TreeDS/view>
+
+#include "Types.hpp"
+
+using namespace md;
+using namespace std;
+
+class ValueIndexTest : public QObject {
+
+    Q_OBJECT
+
+    nary_tree<char> tree {
+        n('a')(
+            n('b')(
+                n('c'),
+                n('d')(
+                    n('e'))),
+            n('c')(
+                n('a')(
+                    n('b'),
+                    n('e'))),
+            n('b'))};
+
+    private slots:
+    void index();
+    void rebuild();
+    void searchAll();
+    void sameAsSearchAll();
+    void wrongTree();
+};
+
+void ValueIndexTest::index() {
+    value_index index(tree);
+    QCOMPARE(index.size(), 5u);
+    QCOMPARE(index.count('b'), 3u);
+    QCOMPARE(index.count('x'), 0u);
+    QVERIFY(index.find('x').empty());
+    const nary_node<char>* root = tree.raw_root_node();
+    vector<const nary_node<char>*> expected {
+        root->get_child(0),
+        root->get_child(1)->get_child(0)->get_child(0),
+        root->get_child(2)};
+    QCOMPARE(index.find('b'), expected);
+    QVERIFY(index.is_index_of(tree));
+}
+
+void ValueIndexTest::rebuild() {
+    value_index<nary_tree<char>> index;
+    QCOMPARE(index.size(), 0u);
+    nary_tree<char> other(tree);
+    index.rebuild(other);
+    QVERIFY(index.is_index_of(other));
+    QVERIFY(!index.is_index_of(tree));
+    *other.root() = 'z';
+    index.rebuild(other);
+    QCOMPARE(index.count('z'), 1u);
+    QCOMPARE(index.count('a'), 1u);
+}
+
+void ValueIndexTest::searchAll() {
+    value_index index(tree);
+    pattern p(cpt(one('a')(one('b'))));
+    vector<const nary_node<char>*> found;
+    for (const auto& match : p.search_all(tree, index)) {
+        found.push_back(match.get_node());
+        QCOMPARE(match.get_mark(const_index<1>()), match.get_node());
+    }
+    vector<const nary_node<char>*> expected {tree.raw_root_node(), tree.raw_root_node()->get_child(1)->get_child(0)};
+    QCOMPARE(found, expected);
+    pattern missing(one('x'));
+    auto matches = missing.search_all(tree, index);
+    QVERIFY(matches.begin() == matches.end());
+}
+
+template <typename Make>
+void compare_with_scan(const nary_tree<char>& tree, const value_index<nary_tree<char>>& index, Make make) {
+    pattern scan(make());
+    pattern indexed(make());
+    vector<const nary_node<char>*> expected;
+    for (const auto& match : scan.search_all(tree)) {
+        expected.push_back(match.get_node());
+    }
+    vector<const nary_node<char>*> found;
+    for (const auto& match : indexed.search_all(tree, index)) {
+        found.push_back(match.get_node());
+    }
+    QCOMPARE(found, expected);
+}
+
+void ValueIndexTest::sameAsSearchAll() {
+    mt19937 random(7);
+    for (int i = 0; i < 200; ++i) {
+        nary_tree<char> tree = random_tree(random(), 1 + static_cast<int>(random() % 40), "abcd");
+        value_index index(tree);
+        compare_with_scan(tree, index, [] { return one('a')(one('b')); });
+        compare_with_scan(tree, index, [] { return cpt(one('c')(star()(one('d')))); });
+        compare_with_scan(tree, index, [] { return one()(one('a'), one('c')); });
+        compare_with_scan(tree, index, [] { return star('b')(one('a')); });
+        compare_with_scan(tree, index, [] { return opt('d')(one('a')); });
+    }
+}
+
+void ValueIndexTest::wrongTree() {
+    nary_tree<char> other(tree);
+    value_index index(other);
+    pattern p(one('a'));
+    QVERIFY_EXCEPTION_THROWN(p.search_all(tree, index), std::invalid_argument);
+}
+
+QTEST_MAIN(ValueIndexTest)
+
+#include "ValueIndexTest.moc"